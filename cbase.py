@@ -9,27 +9,171 @@ sys.path.append(os.path.join(_MYDIR, 'lib'))
 from codebase import *
 from cparser import *
 import analyze
+import incremental
+import symindex
 
-def find_decl(name):
+def find_decl(name, path='../torque/4.2-EA'):
     category = 'udt'
     if '(' in name:
         category = 'prototype'
         name = name[0:name.find('(')]
-    cb = Codebase(path='../torque/4.2-EA', visit_filter=only_header_files, recurse_filter=skip_tests_and_vcs)
-    found = []
+    cb = Codebase(path=path, visit_filter=only_header_files, recurse_filter=skip_tests_and_vcs)
+    # Only headers that changed since the last run are re-parsed (on all cores).
+    index = symindex.SymbolIndex(symindex.default_index_path(cb.root, 'headers'))
+    index.update(cb, jobs=None)
+    for sym in index.find(name, category):
+        print 'found %s for %s at %s line %d' % (sym['category'], sym['signature'], sym['path'], sym['line'])
+    index.close()
+
+def time_find_decl(args):
+    '''
+    Benchmark the symbol index behind find_decl on every C/C++ file in a tree
+    (default: test/sample_code): cold build, no-op update, one-file update and
+    lookups, compared with parsing every file and scanning for each name.
+    The benchmark runs on a temporary copy of the tree, so the mtime bump
+    used for the one-file update never touches the original.
+    '''
+    import random
+    import shutil
+    import tempfile
+    import time
+    folder = os.path.join(_MYDIR, 'test', 'sample_code')
+    if len(args) > 2:
+        folder = args[2]
+    tmp = tempfile.mkdtemp()
+    try:
+        copy = os.path.join(tmp, 'tree')
+        shutil.copytree(folder, copy)
+        # Make the copy a codebase root of its own.
+        os.mkdir(os.path.join(copy, '.git'))
+        if not is_root(copy):
+            open(os.path.join(copy, 'Makefile'), 'w').close()
+            os.mkdir(os.path.join(copy, 'src'))
+        cb = Codebase(path=copy, recurse_filter=skip_tests_and_vcs)
+        start = time.time()
+        index = symindex.SymbolIndex(os.path.join(tmp, 'symbols.db'))
+        index.update(cb)
+        print('cold build: %.2f s (%d files, %d symbols)' % (time.time() - start, index.file_count, index.symbol_count))
+        start = time.time()
+        index.update(cb)
+        print('no-op update: %.3f s' % (time.time() - start))
+        touched = sorted(cb.files)[0]
+        os.utime(cb.abspath(touched), None)
+        start = time.time()
+        count = index.update(cb)
+        print('update after touching %s: %.3f s (%d re-indexed)' % (touched, time.time() - start, count))
+        names = [row[0] for row in index.db.execute('SELECT DISTINCT name FROM symbols')]
+        random.seed(1)
+        queries = [random.choice(names) for i in range(1000)]
+        start = time.time()
+        for name in queries:
+            index.find(name)
+        elapsed = time.time() - start
+        print('lookup: %.3f ms/query (%d queries)' % (1000 * elapsed / len(queries), len(queries)))
+        index.close()
+        # The old find_decl parsed every file on each run, then scanned.
+        start = time.time()
+        parsed = [p for f, p in cb.parsed_files(use_cache=False)]
+        parse_secs = time.time() - start
+        start = time.time()
+        for name in queries[0:10]:
+            for p in parsed:
+                [b for b in p.blocks if b.name == name]
+        scan_secs = (time.time() - start) / 10
+        print('old find_decl: parse %.2f s + scan %.3f ms/query (10 queries)' % (parse_secs, 1000 * scan_secs))
+    finally:
+        shutil.rmtree(tmp)
+
+def time_parse(args):
+    '''
+    Report how fast cparser parses a tree (default: test/sample_code), in
+    seconds per MB, along with the slowest files and peak memory.
+    '''
+    import resource
+    import time
+    folder = os.path.join(_MYDIR, 'test', 'sample_code')
+    if len(args) > 2:
+        folder = args[2]
+    cb = Codebase(path=folder)
+    total_bytes = 0
+    total_secs = 0.0
+    timings = []
     for f in cb.files:
-        parsed = ParsedFile(cb.abspath(f), cb)
-        #print('%s has %d blocks' % (f, len(parsed.blocks)))
-        for block in parsed.blocks_by_category(category):
-            if block.name == name:
-                found.append(block)
-    for block in found:
-        if block.parent:
-            print('parent = %s' % block.parent)
-            relpath = block.parent.relpath
-        else:
-            relpath = 'unknown'
-        print 'found %s for %s at %s line %d' % (block.category, block, relpath, block.at_line_num)
+        path = cb.abspath(f)
+        size = os.path.getsize(path)
+        start = time.time()
+        ParsedFile(path, cb)
+        elapsed = time.time() - start
+        total_bytes += size
+        total_secs += elapsed
+        timings.append((elapsed, size, f))
+    mb = total_bytes / 1048576.0
+    print('%d files, %.2f MB, %.2f s, %.3f s/MB' % (len(timings), mb, total_secs, total_secs / mb))
+    # ru_maxrss is in KB on Linux.
+    print('peak RSS %.1f MB' % (resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024.0))
+    timings.sort(reverse=True)
+    for elapsed, size, f in timings[0:5]:
+        print('  %s: %.2f MB, %.3f s, %.3f s/MB' % (f, size / 1048576.0, elapsed, elapsed / (size / 1048576.0)))
+
+def log_calls(args):
+    '''
+    Report how MLog is called across a tree (default: test/sample_code).
+    Usage: cbase.py log_calls [folder] [--jobs N] [--json]
+    '''
+    import time
+    parser = argparse.ArgumentParser(prog='cbase.py log_calls')
+    parser.add_argument('folder', nargs='?', default=os.path.join(_MYDIR, 'test', 'sample_code'))
+    parser.add_argument('--jobs', type=int, default=None, help='worker processes (default: one per CPU)')
+    parser.add_argument('--json', action='store_true', help='print machine-readable JSON')
+    opts = parser.parse_args(args[2:])
+    cb = Codebase(path=opts.folder, recurse_filter=skip_tests_and_vcs)
+    gist = analyze.Gist(cb)
+    start = time.time()
+    gist.include_files([cb.abspath(f) for f in cb.files], opts.jobs)
+    elapsed = time.time() - start
+    if opts.json:
+        print(gist.to_json())
+    else:
+        gist.summarize()
+        print
+        print('%d files analyzed in %.2f s' % (gist.file_count, elapsed))
+
+def precommit(args):
+    '''
+    Report MLog usage in the functions and UDTs that the working copy's
+    uncommitted changes touch, against an incrementally maintained model of
+    the whole tree (default: test/sample_code). The first run builds the
+    model; later runs only re-analyze what changed.
+    Usage: cbase.py precommit [folder] [--jobs N] [--json]
+    '''
+    import json
+    import time
+    parser = argparse.ArgumentParser(prog='cbase.py precommit')
+    parser.add_argument('folder', nargs='?', default=os.path.join(_MYDIR, 'test', 'sample_code'))
+    parser.add_argument('--jobs', type=int, default=None, help='worker processes (default: one per CPU)')
+    parser.add_argument('--json', action='store_true', help='print machine-readable JSON')
+    opts = parser.parse_args(args[2:])
+    start = time.time()
+    cb = Codebase(path=opts.folder, recurse_filter=skip_tests_and_vcs)
+    model = incremental.TreeModel(cb, incremental.default_model_path(cb.root))
+    touched = model.check(opts.jobs)
+    elapsed = time.time() - start
+    blocks = [{'path': relpath,
+               'category': b.category,
+               'name': b.name,
+               'line': b.line,
+               'end_line': b.end_line,
+               'calls': b.summary.call_count,
+               'by_level': b.summary.by_level,
+               'by_described_category': b.summary.by_described_category}
+              for relpath, b in touched]
+    if opts.json:
+        print(json.dumps({'touched': blocks, 'tree': model.gist().as_dict()}, indent=2, sort_keys=True))
+        return
+    for b in blocks:
+        print('%s:%d-%d %s %s: %d MLog calls' % (b['path'], b['line'], b['end_line'], b['category'], b['name'], b['calls']))
+    print('%d blocks touched; %d re-analyzed; %d files in model; %.3f s' % (
+        len(blocks), model.reanalyzed, len(model.files), elapsed))
 
 def test(args):
     find_decl('getpwnam_ext()')
@@ -1,3 +1,5 @@
+import json
+import multiprocessing
 import os
 import operator
 import re
@@ -16,46 +18,117 @@ class Gist:
         self.codebase = codebase
         self.file_count = 0
         self.files = {}
+        self.by_dc = {}
+        self.by_fac = {}
+        self.by_lvl = {}
+        self.by_ff = {}
         
     def include(self, parser):
-        '''Add another file to the scope of our analysis.'''
+        '''Add another file (a Parser or its FileSummary) to the scope of our analysis.'''
+        if not isinstance(parser, FileSummary):
+            parser = FileSummary(parser)
         self.file_count += 1
-        if parser.logcalls:
+        if parser.call_count:
             self.files[parser.path] = parser
+            _count_dicts(parser, self.by_dc, self.by_fac, self.by_lvl, self.by_ff)
+
+    def include_files(self, paths, jobs=None):
+        '''
+        Parse and include many files, fanned out over a pool of jobs worker
+        processes (None means one per CPU). Only the per-file counts come back
+        from the workers, so the result is the same as calling include() on
+        each file in turn.
+        '''
+        if jobs is None:
+            jobs = multiprocessing.cpu_count()
+        paths = list(paths)
+        if jobs > 1 and len(paths) > 1:
+            pool = multiprocessing.Pool(min(jobs, len(paths)))
+            try:
+                chunksize = max(1, len(paths) / (jobs * 4))
+                for summary in pool.imap_unordered(summarize_file, paths, chunksize):
+                    self.include(summary)
+            finally:
+                pool.close()
+                pool.join()
+        else:
+            for path in paths:
+                self.include(summarize_file(path))
+
+    def _ranked_files(self):
+        return sorted(self.files.itervalues(), key=lambda x: (-x.call_count, x.path))
+
+    def _relpath(self, path):
+        if self.codebase and path.startswith(self.codebase.root):
+            return path[len(self.codebase.root):]
+        return path
+
+    def as_dict(self, top=10):
+        '''Everything summarize() reports, as plain data (e.g., for json.dumps).'''
+        return {
+            'file_count': self.file_count,
+            'files_calling_mlog': len(self.files),
+            'by_described_category': self.by_dc,
+            'by_facility': self.by_fac,
+            'by_level': self.by_lvl,
+            'by_filter_func': self.by_ff,
+            'top_files': [{'path': self._relpath(f.path),
+                           'calls': f.call_count,
+                           'by_described_category': f.by_described_category}
+                          for f in self._ranked_files()[0:top]]}
+
+    def to_json(self, top=10):
+        return json.dumps(self.as_dict(top), indent=2, sort_keys=True)
             
     def summarize(self):
         print
         print('%s: %d' % (_get_label('# files'), self.file_count))
         print('%s: %d' % (_get_label('# files calling MLog'), len(self.files)))
         
-        # Compile some data.
-        parsers = sorted([self.files[p] for p in self.files], key=lambda x:len(x.logcalls), reverse=True)
-        by_dc = {}
-        by_fac = {}
-        by_lvl = {}
-        by_ff = {}
-        for parser in parsers:
-            _count_dicts(parser, by_dc, by_fac, by_lvl, by_ff)
-            
-        _print_desc(by_dc, '# calls to log %s')
-        _print_desc(by_fac, '# calls to facility %s')
-        _print_desc(by_lvl, '# calls with level %s')
-        _print_desc(by_ff, '# calls filtered by %s')
+        _print_desc(self.by_dc, '# calls to log %s')
+        _print_desc(self.by_fac, '# calls to facility %s')
+        _print_desc(self.by_lvl, '# calls with level %s')
+        _print_desc(self.by_ff, '# calls filtered by %s')
         
         print
         print("Top 10 files:")
-        root = parsers[0].codebase.root
-        rootlen = len(root)
-        pcount = 0
-        for f in parsers:
-            pcount += 1
-            if pcount > 10:
-                break
-            relpath = f.path[rootlen:]
-            print('  %s: %d' % (relpath, len(f.logcalls)))
+        for f in self._ranked_files()[0:10]:
+            print('  %s: %d' % (self._relpath(f.path), f.call_count))
             for cat in f.by_described_category:
-                n = len(f.by_described_category[cat])
+                n = f.by_described_category[cat]
                 print('    %s: %d' % (cat, n))
+
+class FileSummary:
+    '''
+    The MLog counts for one file. Unlike a Parser, which holds the file's
+    text and every LogCall, this is small and cheap to pickle, so it is what
+    worker processes send back. With no parser, the summary starts out
+    empty (for path), ready to add() others to.
+    '''
+    def __init__(self, parser=None, path=None):
+        if parser is None:
+            self.path = path
+            self.call_count = 0
+            self.by_described_category = {}
+            self.by_facility = {}
+            self.by_level = {}
+            self.by_filter_func = {}
+            return
+        self.path = parser.path
+        self.call_count = len(parser.logcalls)
+        self.by_described_category = _counts(parser.by_described_category)
+        self.by_facility = _counts(parser.by_facility)
+        self.by_level = _counts(parser.by_level)
+        self.by_filter_func = _counts(parser.by_filter_func)
+
+    def add(self, other):
+        '''Fold another summary (e.g., of one block of this file) into this one.'''
+        self.call_count += other.call_count
+        _count_dicts(other, self.by_described_category, self.by_facility, self.by_level, self.by_filter_func)
+
+def summarize_file(path):
+    '''Parse one file and return its FileSummary. (Worker entry point.)'''
+    return FileSummary(Parser(path))
         
 class LogCall:
     '''
@@ -137,12 +210,17 @@ class Parser:
     '''
     Parse a complete file and extract any calls to MLog.
     '''
-    def __init__(self, path, codebase=None):
+    def __init__(self, path, codebase=None, txt=None):
+        '''
+        If txt is given, it is parsed instead of the file's content (e.g., to
+        analyze a single function of path).
+        '''
         self.codebase = codebase
         self.path = path
-        f = open(path, 'r')
-        txt = f.read()
-        f.close()
+        if txt is None:
+            f = open(path, 'r')
+            txt = f.read()
+            f.close()
         self._parse(txt)
 
     def _parse(self, txt):
@@ -174,12 +252,14 @@ class Parser:
 def _get_label(lbl):
     return lbl.ljust(30)
 
+def _counts(src_dict):
+    return dict((key, len(src_dict[key])) for key in src_dict)
+
 def _count_dict(src_dict, count_dict):
     for key in src_dict:
         if not count_dict.has_key(key):
             count_dict[key] = 0
-        n = len(src_dict[key])
-        count_dict[key] += n
+        count_dict[key] += src_dict[key]
         
 def _count_dicts(parser, by_dc, by_fac, by_lvl, by_ff):
     _count_dict(parser.by_described_category, by_dc)
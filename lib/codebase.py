@@ -2,6 +2,7 @@ import os
 import ioutil
 import re
 import sys
+import vcs
 
 VCS_FOLDER_PAT = re.compile('\.(hg|bzr|svn|git)$')
 TEST_FOLDER_PAT = re.compile('tests?$', re.IGNORECASE)
@@ -80,6 +81,39 @@ class Codebase:
             for item in self.by_folder[folder]:
                 if not item.endswith('/'):
                     yield item
+
+    def change_spec(self):
+        '''
+        Return {relpath: [(first_line, line_count), ...]} for the files in this
+        codebase that have uncommitted changes (see vcs.get_change_spec()).
+        '''
+        top = vcs.get_root(self.root)
+        wanted = set(self.files)
+        spec = {}
+        for fname, hunks in vcs.get_change_spec(self.root).iteritems():
+            path = ioutil.norm_seps(os.path.join(top, fname))
+            if path.startswith(self.root):
+                relpath = path[len(self.root):]
+                if relpath in wanted:
+                    spec[relpath] = hunks
+        return spec
+
+    def parsed_files(self, jobs=1, cache_folder=None, use_cache=True):
+        '''
+        Yield (relpath, cparser.ParsedFile) for every file in the codebase.
+
+        @param jobs Number of worker processes; None means one per CPU.
+        @param cache_folder Where parse results are cached between runs.
+               Defaults to a folder under ~/.cache specific to this root.
+        @param use_cache If False, parse everything and cache nothing.
+        '''
+        import parsecache
+        cache = None
+        if use_cache:
+            if not cache_folder:
+                cache_folder = parsecache.default_cache_folder(self.root)
+            cache = parsecache.ParseCache(cache_folder)
+        return parsecache.parse_files(self, self.files, jobs, cache)
     
     def _discover(self, recurse_filter, visit_filter):
         for root, dirs, files in os.walk(self.root):
@@ -14,19 +14,23 @@ wholly outside a function, or wholly around a function, for example. If you put
 of one function and the beginning of another inside a single #ifdef block, it will
 become inaccurate. Certain unusual macro constracts may cause problems as well.
 
+Files are memory-mapped and split into tokens by ctokens.py; the block recognizer
+here walks that token stream rather than the text itself.
+
 Basic usage:
 
 Create an instance of ParsedFile(path, codebase), then access its properties to
 understand the structure in the file.
 '''
 
+import bisect
+import mmap
+import os
 import re
 import sys
 import weakref
 
-_DEFINE_PAT = re.compile(r'#\s*define\s+.*')
-_ELSE_PAT = re.compile(r'#\s*else')
-_ENDIF_PAT = re.compile(r'^#\s*endif', re.MULTILINE)
+import ctokens
 _ID = '[_a-zA-Z][_a-zA-Z0-9:]*'
 _UDT_PAT = re.compile(r'(typedef\s+)?(struct|class)\s+(' + _ID + ')\s*(?::.*)?$', re.MULTILINE)
 _FUNC_PAT = re.compile(r'((?:' + _ID + ')[^-()=+!<>/|^]*?(?:\s+|\*|\?))(' + _ID + ')\s*\(([^()]*?)\)(\s*const)?\s*$')
@@ -40,11 +44,34 @@ _RESERVED_WORDS_PAT = re.compile(r'(for|do|while|if|else|switch|case|namespace)[
 '''Turn this on to spit out verbose messages as code is parsed.'''
 enable_debug = False
 
+'''
+Bump this whenever a change to the parser changes what it produces, so that
+parse results cached on disk (see parsecache.py) are discarded.
+'''
+PARSE_VERSION = 3
+
 def debug(msg):
     if enable_debug:
         sys.stdout.write(msg + '\n')
         sys.stdout.flush()
         
+class _DetachedRef:
+    '''
+    Stands in for a weakref that could not survive pickling. Like a dead
+    weakref, it is truthy but dereferences to None.
+    '''
+    def __call__(self):
+        return None
+
+_DETACHED_REF = _DetachedRef()
+
+def _blank(txt, begin, end, fill):
+    '''Return the text that replaces an erased span; same length, same line count.'''
+    if fill == 'x':
+        return 'x' * (end - begin)
+    line_count = ctokens.count_newlines(txt, begin, end)
+    return (fill * (end - begin - line_count)) + ('\n' * line_count)
+
 def norm_param(param):
     '''Convert a parameter to a canonical format.'''
     param = param.replace('*', ' * ').replace('&', ' & ')
@@ -76,6 +103,26 @@ class BlockInfo:
             self._parent = None
             self.depth = 0
             
+    def __getstate__(self):
+        '''
+        Support pickling (parse cache, worker processes). Parent links and the
+        text buffer are not stored; ParsedFile restores them on load.
+        '''
+        state = self.__dict__.copy()
+        state['_flc'] = self.full_line_count
+        state['_parent'] = None
+        state.pop('txt', None)
+        if state.get('preceding_block_comment'):
+            state['preceding_block_comment'] = _DETACHED_REF
+        return state
+
+    def _attach(self, parent, txt):
+        if parent:
+            self._parent = weakref.ref(parent)
+        self.txt = txt
+        for block in self.blocks:
+            block._attach(self, txt)
+
     @property
     def full_line_count(self):
         '''How many full lines (lines ending with \n') are contained in this block?'''
@@ -149,6 +196,10 @@ class ParsedBlockInfo(BlockInfo):
         self._line = line
         self._cc = 0
         self._cbytes = 0
+        # Spans erased during the parse, as parallel lists in ascending order.
+        # See erase_block().
+        self._erased_begins = []
+        self._erased = []
 
     def complain(self, msg, severity='Error'):
         sys.stderr.write('%s, line %s: %s. %s\n' % (self.path, self._line, severity, msg))
@@ -178,24 +229,16 @@ class ParsedBlockInfo(BlockInfo):
         '''
         assert self.txt[self._idx - 1] == '"'
         self._last_block_comment = None
-        i = self._idx
-        debug('string_literal at %s (line %s): <...%s...>' % (self._idx, self._line, self.txt[self._idx-3:self._idx+3]))
-        debug('i = %d, self.end = %d' % (i, self.end))
-        while i < self.end:
-            c = self.txt[i]
-            if c == '\\':
-                i += 1
-            elif c == '\r' or c == '\n':
-                self.complain('Line ended before string literal ended.')
-                self._idx = i
-                return False
-            elif c == '"':
-                self.erase_string_literal(self._idx - 1, i + 1)
-                self._idx = i + 1
-                return True
-            i += 1
-        return False       
-    
+        kind, end = ctokens.string_end(self.txt, self._idx - 1)
+        if kind == ctokens.STRING:
+            self.erase_string_literal(self._idx - 1, end)
+            self._idx = end
+            return True
+        if kind == ctokens.UNTERMINATED_STRING:
+            self.complain('Line ended before string literal ended.')
+            self._idx = end
+        return False
+
     def add_block(self, block):
         debug('adding block %s at %s (Im at line %s, block starts at line %s and ends at %s)' % (
             str(block), self._idx, self._line, block.at_line_num, block.end))
@@ -210,8 +253,6 @@ class ParsedBlockInfo(BlockInfo):
         self._idx = block.end
         if isinstance(block, ParsedBlockInfo):
             self._line = block._line
-        else:
-            self._line += block.full_line_count
                
     def finish_line(self):
         '''
@@ -239,58 +280,44 @@ class ParsedBlockInfo(BlockInfo):
         '''
         #debug('preproc_directive at %s (line %s)' % (self._idx, self._line))
         try:
-            fragment = self.txt[self._idx:self._idx + 20]
-            if _DEFINE_PAT.match(fragment):
-                # Look for line continuation (possibly followed by whitespace) at end of #define ...
-                another = True
-                while another:
-                    i = self._idx
-                    if not self.finish_line():
-                        return False
-                    # Position on char before \n
-                    j = self._idx - 2
-                    while j > i:
-                        c = self.txt[j]
-                        if c == '\\':
-                            break
-                        # Handle trailing spaces
-                        elif not c.isspace():
-                            another = False
-                            break
-                        j -= 1
-                return True
-            elif _ELSE_PAT.match(fragment):
-                # This gets a bit tricky. It's possible to introduce uneven nesting of { ... } with #ifdef's.
-                # For example, you could have code that looks like this:
-                #     if (something)
-                #     #ifdef FOO
-                #        { ...
-                #     #else
-                #        { ...
-                #     endif
-                #     }
-                # The *right* way to accomodate this problem is to analyze each possible expansion of the
-                # code after running a preprocessor through it. This seems prohibitively complicated. A
-                # simpler way is to eliminate the #else branch of any #if, on the theory that it won't
-                # change our analysis of sub-blocks in any material way. We're doing that here.
-                m = _ENDIF_PAT.search(self.txt, self._idx)
-                if m:
-                    self.erase_block(self._idx, m.end())
-                else:
-                    self.complain('#else without matching #endif')
-                    self.finish_line()
-            else:
-                return self.finish_line()
+            kind, end, ended_with_newline = ctokens.directive_end(self.txt, self._idx)
+            self.directive(kind, self._idx, end)
+            self._line += ctokens.count_newlines(self.txt, self._idx, end)
+            self._idx = end
+            if kind == ctokens.DIRECTIVE:
+                return ended_with_newline
         finally:
             # Technically, this is incorrect. It's entirely possible to have a #if ... #else ... #endif right
             # in the middle of an expression. However, this complicates parsing so much that I'm going to
             # ignore it for now.
             self._expr_begin = -1
-        
+
+    def directive(self, kind, begin, end):
+        '''
+        Account for a preprocessor directive found by ctokens.directive_end().
+        '''
+        if kind == ctokens.ELSE_DIRECTIVE:
+            # This gets a bit tricky. It's possible to introduce uneven nesting of { ... } with #ifdef's.
+            # For example, you could have code that looks like this:
+            #     if (something)
+            #     #ifdef FOO
+            #        { ...
+            #     #else
+            #        { ...
+            #     endif
+            #     }
+            # The *right* way to accomodate this problem is to analyze each possible expansion of the
+            # code after running a preprocessor through it. This seems prohibitively complicated. A
+            # simpler way is to eliminate the #else branch of any #if, on the theory that it won't
+            # change our analysis of sub-blocks in any material way. We're doing that here.
+            self.erase_block(begin, end)
+        elif kind == ctokens.ELSE_WITHOUT_ENDIF:
+            self.complain('#else without matching #endif')
+
     def anonymous_block(self):
         #debug('anonymous_block at %s (line %s)' % (self._idx, self._line))
         block = ParsedBlockInfo(name='', parent=self, txt=self.txt, line=self._line, begin=self._idx, category='unnamed')
-        block.parse(self.txt, self._idx)
+        block.parse(self.txt, self._idx, tokens=self._tokens)
         self._last_block_comment = None
         self.add_block(block)
         
@@ -325,23 +352,60 @@ class ParsedBlockInfo(BlockInfo):
         self.erase_block(begin, end)
     
     def erase_block(self, begin, end):
-        '''Remove a block (e.g., comment, #else block) so we can parse with confidence.'''
-        cbytes = end - begin
-        self._cbytes += cbytes
-        line_count = self.txt.count('\n', begin, end)
-        spaces = (' ' * (cbytes - line_count)) + ('\n' * line_count)
-        before_len = len(self.txt)
-        x = self.txt[0:begin] + spaces + self.txt[end:]
-        assert len(x) == before_len
-        self.txt = x
-        
+        '''
+        Remove a block (e.g., comment, #else block) so we can parse with confidence.
+
+        The text itself is not touched while parsing -- rebuilding the whole
+        buffer for every comment makes the parse quadratic. Instead the span
+        is recorded, applied to the (short) slices that the parse inspects
+        via erased_text(), and applied to the whole file once, at the end,
+        by ParsedFile.
+        '''
+        self._cbytes += end - begin
+        self._add_erased(begin, end, ' ')
+
     def erase_string_literal(self, begin, end):
-        '''Remove comments so we can use regexes with confidence.'''
-        before_len = len(self.txt)
-        x = self.txt[0:begin] + ('x'*(end - begin)) + self.txt[end:]
-        assert len(x) == before_len
-        self.txt = x
-        
+        '''Remove string literals so we can use regexes with confidence.'''
+        self._add_erased(begin, end, 'x')
+
+    def _add_erased(self, begin, end, fill):
+        # Spans are found in the order they are scanned, so this stays sorted.
+        self._erased_begins.append(begin)
+        self._erased.append((begin, end, fill))
+
+    def erased_text(self, begin, end):
+        '''Return txt[begin:end], with any spans erased so far blanked out.'''
+        if begin < 0:
+            return ''
+        txt = self.txt[begin:end]
+        if not self._erased:
+            return txt
+        i = max(0, bisect.bisect_right(self._erased_begins, begin) - 1)
+        pieces = []
+        at = begin
+        for span_begin, span_end, fill in self._erased[i:]:
+            if span_begin >= end:
+                break
+            if span_end <= at:
+                continue
+            pieces.append(self.txt[at:max(at, span_begin)])
+            pieces.append(_blank(self.txt, span_begin, span_end, fill)[max(at, span_begin) - span_begin:min(end, span_end) - span_begin])
+            at = min(end, span_end)
+        if not pieces:
+            return txt
+        pieces.append(self.txt[at:end])
+        return ''.join(pieces)
+
+    def _all_erased(self, spans):
+        '''Collect the spans erased by this block and all blocks beneath it.'''
+        spans.extend(self._erased)
+        del self._erased
+        del self._erased_begins
+        for block in self.blocks:
+            if isinstance(block, ParsedBlockInfo):
+                block._all_erased(spans)
+        return spans
+
     @property
     def path(self):
         p = self.parent
@@ -357,7 +421,7 @@ class ParsedBlockInfo(BlockInfo):
     
     def block_header(self, header_line):
         try:
-            header = self.txt[self._expr_begin:self._idx]
+            header = self.erased_text(self._expr_begin, self._idx)
             if _RESERVED_WORDS_PAT.match(header):
                 debug('found reserved word in "%s"; returning' % header[0:min(10, len(header))])
                 return
@@ -410,7 +474,14 @@ class ParsedBlockInfo(BlockInfo):
         finally:
             self._expr_begin = -1
                     
-    def parse(self, txt, idx=0, line=0):
+    def parse(self, txt, idx=0, line=0, tokens=None):
+        '''
+        Recognize the blocks in txt, starting at idx.
+
+        @param tokens The ctokens stream to consume. Nested blocks share their
+               parent's stream, picking up right after the opening brace and
+               handing it back right after the closing one.
+        '''
         self.end = len(txt)
         self.txt = txt
         self._expr_begin = -1
@@ -418,79 +489,75 @@ class ParsedBlockInfo(BlockInfo):
         self._last_block_comment = None
         if line > 0:
             self._line = line
+        if tokens is None:
+            parent = self.parent
+            if parent:
+                tokens = getattr(parent, '_tokens', None)
+            if tokens is None:
+                tokens = ctokens.tokenize(txt, idx, max(self._line, 1))
+        self._tokens = tokens
         header_line = -1
 
         try:
-            end = len(self.txt)
-            while self._idx < end:
-                i = self._idx
-                c = self.txt[i]
-                if c == '\n':
-                    self.finish_line()
-                else:
-                    if c.isspace():
+            for i, end, kind, line in tokens:
+                self._idx = i
+                self._line = line
+                if kind == ctokens.WORD:
+                    if self._expr_begin == -1:
+                        self._expr_begin = i
+                        header_line = line
+                        debug('expr_begin at %s (line %s)' % (i, line))
+                elif kind == ctokens.SEMI:
+                    if self._expr_begin != -1:
+                        expr = self.erased_text(self._expr_begin, i)
+                        m = _FUNC_PAT.match(expr)
+                        if m:
+                            returned = norm_param(m.group(1))
+                            func_name = m.group(2)
+                            params = [norm_param(p) for p in m.group(3).split(',')]
+                            postfix = ''
+                            if m.group(4):
+                                postfix = ' const'
+                            #returned, name, params, postfix, parent, txt, line, begin, end
+                            self.add_block(Prototype(
+                                returned, func_name, params, 
+                                postfix, self, self.txt, 
+                                line, self._expr_begin, i))
+                    debug('resetting _expr_begin at %s (line %s)' % (i, line))
+                    self._expr_begin = -1
+                elif kind == ctokens.LBRACE:
+                    debug('calling block_header at %s with header_line = %s' % (i, header_line))
+                    name = self.block_header(header_line)
+                    if not name:
                         self._idx += 1
-                    else:
-                        if c == '/':
-                            next_c = self.txt[i + 1]
-                            if next_c == '/':
-                                self._idx += 2
-                                self.finish_line()
-                                self.erase_comment(i, self._idx - 1)
-                            elif next_c == '*':
-                                self._idx += 2
-                                self.multiline_comment()
-                                self.erase_comment(i, self._idx)
-                            else:
-                                if self._expr_begin == -1:
-                                    self.complain("Unexpected / char.")
-                                self._idx += 1
-                        elif c == ';':
-                            self._idx = i + 1
-                            expr = self.txt[self._expr_begin:i]
-                            m = _FUNC_PAT.match(expr)
-                            if m:
-                                returned = norm_param(m.group(1))
-                                func_name = m.group(2)
-                                params = [norm_param(p) for p in m.group(3).split(',')]
-                                postfix = ''
-                                if m.group(4):
-                                    postfix = ' const'
-                                #returned, name, params, postfix, parent, txt, line, begin, end
-                                #print('parent = %s' % self)
-                                self.add_block(Prototype(
-                                    returned, func_name, params, 
-                                    postfix, self, self.txt, 
-                                    self._line, self._expr_begin, i))
-                            debug('resetting _expr_begin at %s (line %s)' % (i, self._line))
-                            self._expr_begin = -1
-                        elif c == '{':
-                            debug('calling block_header at %s with header_line = %s' % (self._idx, header_line))
-                            name = self.block_header(header_line)
-                            if not name:
-                                self._idx += 1
-                                self.anonymous_block()
-                            debug('_idx is now %s' % self._idx)
-                        elif c == '}':
-                            self.end = i + 1
-                            debug('ending block at %s (line %s; full lines = %s)' % (self.end, self._line, self.full_line_count))
-                            return
-                        elif c == '#':
-                            self.preproc_directive()
-                        elif c == '"':
-                            self._idx += 1
-                            self.string_literal()
-                        elif c == "'":
-                            next_c = self.txt[i + 1]
-                            if next_c == '\\':
-                                self._idx += 1
-                            self._idx += 2
-                        else:
-                            if self._expr_begin == -1:
-                                self._expr_begin = i
-                                header_line = self._line
-                                debug('expr_begin at %s (line %s)' % (self._idx, self._line))
-                            self._idx += 1
+                        self.anonymous_block()
+                elif kind == ctokens.RBRACE:
+                    self.end = i + 1
+                    debug('ending block at %s (line %s)' % (self.end, line))
+                    return
+                elif kind == ctokens.LINE_COMMENT:
+                    self.erase_comment(i, end)
+                elif kind == ctokens.BLOCK_COMMENT:
+                    self.add_block(BlockCommentInfo(parent=self, txt=self.txt, line=line, begin=i, end=end))
+                    self.erase_comment(i, end)
+                elif kind == ctokens.UNTERMINATED_BLOCK_COMMENT:
+                    self.complain('File ended before comment ended.')
+                    self.erase_comment(i, end)
+                elif kind == ctokens.SLASH:
+                    if self._expr_begin == -1:
+                        self.complain("Unexpected / char.")
+                elif kind == ctokens.STRING:
+                    self._last_block_comment = None
+                    self.erase_string_literal(i, end)
+                elif kind == ctokens.UNTERMINATED_STRING:
+                    self._last_block_comment = None
+                    self.complain('Line ended before string literal ended.')
+                elif kind == ctokens.STRAY_QUOTE:
+                    self._last_block_comment = None
+                else:
+                    self.directive(kind, i, end)
+                    # See preproc_directive().
+                    self._expr_begin = -1
         finally:
             # Remove clutter that was only needed during parse phase.
             # This is not especially necessary (eventually, gc will release
@@ -499,6 +566,7 @@ class ParsedBlockInfo(BlockInfo):
             del self._expr_begin
             del self._idx
             del self._last_block_comment        
+            del self._tokens
     
 class BlockCommentInfo(BlockInfo):
     '''
@@ -554,12 +622,32 @@ class ParsedFile(ParsedBlockInfo):
     def __init__(self, path=None, codebase=None):
         ParsedBlockInfo.__init__(self, name=path, parent=None, txt='', line=0, begin=0, category='file')
         if path:
-            f = open(path, 'r')
-            txt = f.read()
-            f.close()
-            self.parse(txt)
+            # Tokenize straight out of the page cache; the only copy of the
+            # text we keep is the cleaned-up one built at the end of parse().
+            f = open(path, 'rb')
+            try:
+                if os.fstat(f.fileno()).st_size:
+                    buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+                    try:
+                        self.parse(buf)
+                    finally:
+                        buf.close()
+                else:
+                    self.parse('')
+            finally:
+                f.close()
         self.codebase = codebase
         
+    def __getstate__(self):
+        state = ParsedBlockInfo.__getstate__(self)
+        state['txt'] = self.txt
+        state['codebase'] = None
+        return state
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self._attach(None, self.txt)
+
     @property
     def relpath(self):
         if self.codebase:
@@ -582,4 +670,17 @@ class ParsedFile(ParsedBlockInfo):
         self._line = 1
         if idx:
             self._line += txt.count(0, idx)
-        ParsedBlockInfo.parse(self, txt, idx)
\ No newline at end of file
+        ParsedBlockInfo.parse(self, txt, idx)
+        # Apply every erasure, from every block, in one pass; all blocks then
+        # share the same cleaned-up text.
+        pieces = []
+        at = 0
+        for begin, end, fill in sorted(self._all_erased([])):
+            if end <= at:
+                continue
+            begin = max(begin, at)
+            pieces.append(txt[at:begin])
+            pieces.append(_blank(txt, begin, end, fill))
+            at = end
+        pieces.append(txt[at:])
+        self._attach(None, ''.join(pieces))
\ No newline at end of file
@@ -0,0 +1,164 @@
+'''
+Split C/C++ source into the handful of token kinds that cparser's block
+recognizer cares about, so that it can work one token at a time instead of
+one character at a time.
+
+Whitespace, identifiers, operators and so on are not interesting to the
+recognizer individually; a run of them is a single WORD token, and only its
+beginning matters (it starts an expression). Character literals are skipped
+entirely. Everything else -- braces, semicolons, comments, string literals
+and preprocessor directives -- gets a token of its own.
+
+The buffer may be a string or an mmap, so a file never has to be read into
+memory as a whole. Tokens are produced lazily, as (offset, end, kind, line)
+tuples, where line is the 1-based line number of offset.
+
+Basic usage:
+
+    for offset, end, kind, line in tokenize(buf):
+        ...
+'''
+
+import re
+
+WORD = 1
+SEMI = 2
+LBRACE = 3
+RBRACE = 4
+LINE_COMMENT = 5
+BLOCK_COMMENT = 6
+UNTERMINATED_BLOCK_COMMENT = 7
+SLASH = 8
+STRING = 9
+UNTERMINATED_STRING = 10
+STRAY_QUOTE = 11
+DIRECTIVE = 12
+ELSE_DIRECTIVE = 13
+ELSE_WITHOUT_ENDIF = 14
+
+DEFINE_PAT = re.compile(r'#\s*define\s+.*')
+ELSE_PAT = re.compile(r'#\s*else')
+ENDIF_PAT = re.compile(r'^#\s*endif', re.MULTILINE)
+
+# One group per alternative; m.lastindex picks the kind out of _GROUP_KINDS.
+_TOKEN_PAT = re.compile(r'''
+     ([^\s/;{}\#"'][^/;{}\#"']*)
+    |(;)
+    |(\{)
+    |(\})
+    |(//[^\n]*)
+    |(/\*[\s\S]*?\*/)
+    |(/\*[\s\S]*)
+    |(/)
+    |("[^"\\\r\n]*(?:\\[\s\S][^"\\\r\n]*)*")
+    |("[^"\\\r\n]*(?:\\[\s\S][^"\\\r\n]*)*(?=[\r\n]))
+    |(")
+    |(\#)
+    |('(?:\\?[\s\S])?)
+''', re.VERBOSE)
+
+# Character literals (the last group) produce no token.
+_GROUP_KINDS = (None, WORD, SEMI, LBRACE, RBRACE, LINE_COMMENT, BLOCK_COMMENT,
+                UNTERMINATED_BLOCK_COMMENT, SLASH, STRING, UNTERMINATED_STRING,
+                STRAY_QUOTE, DIRECTIVE, None)
+
+_STRING_PAT = re.compile(r'''
+     ("[^"\\\r\n]*(?:\\[\s\S][^"\\\r\n]*)*")
+    |("[^"\\\r\n]*(?:\\[\s\S][^"\\\r\n]*)*(?=[\r\n]))
+''', re.VERBOSE)
+
+def count_newlines(buf, begin, end):
+    '''Count newlines in buf[begin:end]; works for strings and mmaps.'''
+    if isinstance(buf, str):
+        return buf.count('\n', begin, end)
+    return buf[begin:end].count('\n')
+
+def string_end(buf, begin):
+    '''
+    Find the end of the string literal whose opening quote is at begin.
+    Return (kind, end): STRING if it ends normally, UNTERMINATED_STRING (end
+    is the end of the line) if the line ends first, or STRAY_QUOTE (end is just past
+    the quote) if the file ends first.
+    '''
+    m = _STRING_PAT.match(buf, begin)
+    if m:
+        if m.lastindex == 1:
+            return STRING, m.end()
+        return UNTERMINATED_STRING, m.end()
+    return STRAY_QUOTE, begin + 1
+
+def directive_end(buf, begin):
+    '''
+    Find the end of the preprocessor directive whose # is at begin.
+    Return (kind, end, ended_with_newline).
+
+    A #define ends at the first line that isn't continued with a backslash.
+    An #else is taken to run through its #endif (ELSE_DIRECTIVE), so that
+    only one branch of the conditional is seen; if there is no #endif, it
+    ends with its line (ELSE_WITHOUT_ENDIF). Anything else ends with its line.
+    '''
+    fragment = buf[begin:begin + 20]
+    if DEFINE_PAT.match(fragment):
+        # Look for line continuation (possibly followed by whitespace) at end of #define ...
+        pos = begin
+        another = True
+        while another:
+            i = pos
+            nl = buf.find('\n', pos)
+            if nl == -1:
+                return DIRECTIVE, len(buf), False
+            pos = nl + 1
+            # Position on char before \n
+            j = pos - 2
+            while j > i:
+                c = buf[j]
+                if c == '\\':
+                    break
+                # Handle trailing spaces
+                elif not c.isspace():
+                    another = False
+                    break
+                j -= 1
+        return DIRECTIVE, pos, True
+    kind = DIRECTIVE
+    if ELSE_PAT.match(fragment):
+        # It's possible to introduce uneven nesting of { ... } with #ifdef's; see
+        # cparser. We simply skip the #else branch of any #if.
+        m = ENDIF_PAT.search(buf, begin)
+        if m:
+            return ELSE_DIRECTIVE, m.end(), False
+        kind = ELSE_WITHOUT_ENDIF
+    nl = buf.find('\n', begin)
+    if nl == -1:
+        return kind, len(buf), False
+    return kind, nl + 1, True
+
+def tokenize(buf, pos=0, line=1):
+    '''
+    Generate (offset, end, kind, line) for each token in buf, starting at pos
+    (which is on line number line).
+
+    For LINE_COMMENT, end excludes the newline. (If the file ends without one,
+    end also excludes the last character, as cparser always has.)
+    '''
+    search = _TOKEN_PAT.search
+    kinds = _GROUP_KINDS
+    size = len(buf)
+    counted = pos
+    while pos < size:
+        m = search(buf, pos)
+        if not m:
+            return
+        kind = kinds[m.lastindex]
+        begin = m.start()
+        pos = end = m.end()
+        if kind is None:
+            continue
+        if kind == LINE_COMMENT and end == size:
+            end -= 1
+        elif kind == DIRECTIVE:
+            kind, end, ended_with_newline = directive_end(buf, begin)
+            pos = end
+        line += count_newlines(buf, counted, begin)
+        counted = begin
+        yield begin, end, kind, line
@@ -0,0 +1,226 @@
+'''
+Keep a whole-tree model of how MLog is called up to date incrementally, so
+that a pre-commit check doesn't have to re-analyze the whole tree.
+
+The model remembers, for every file, the MLog counts of each top-level
+function and user-defined type, plus those of whatever lies between them.
+When a file changes, only that file is re-parsed, and only the blocks whose
+text actually changed are re-analyzed; everything else is reused from the
+model. The tree-wide totals are then rebuilt from the per-file summaries.
+
+check() ties this to the working copy: it refreshes the model, then reports
+the blocks whose line spans intersect the hunks that vcs.get_change_spec()
+finds, i.e. exactly what the pending commit touches.
+
+Basic usage:
+
+    model = TreeModel(cb, default_model_path(cb.root))
+    touched = model.check()
+    for relpath, block in touched:
+        print('%s:%d %s: %d calls' % (relpath, block.line, block.name, block.summary.call_count))
+    model.gist().summarize()
+'''
+
+import cPickle
+import hashlib
+import os
+
+import analyze
+import cparser
+import parsecache
+
+# Bump whenever FileModel/BlockModel change shape.
+_FORMAT = 1
+_CATEGORIES = ('function', 'udt')
+
+def default_model_path(root, name='mlog'):
+    '''Where to keep the model for a codebase rooted at root.'''
+    return os.path.join(parsecache.default_cache_folder(root), name + '.model')
+
+def intersects(hunks, first, last):
+    '''
+    Does any hunk (first_line, line_count) touch lines first..last? A hunk
+    with a count of 0 is a deletion just after its first_line, so it touches
+    a block that begins on the following line.
+    '''
+    for start, count in hunks:
+        if count:
+            if start <= last and start + count - 1 >= first:
+                return True
+        elif start + 1 >= first and start <= last:
+            return True
+    return False
+
+class BlockModel:
+    '''What the model remembers about one top-level function or UDT.'''
+    def __init__(self, key, block, digest, summary):
+        self.key = key
+        self.category = block.category
+        self.name = block.name
+        self.line = block.at_line_num
+        self.end_line = block.end_line_num
+        self.digest = digest
+        self.summary = summary
+
+class FileModel:
+    '''What the model remembers about one file.'''
+    def __init__(self, relpath, key):
+        self.relpath = relpath
+        self.key = key
+        self.blocks = []
+        self.residual_digest = None
+        self.residual = None
+        self.summary = None
+
+def _summarize(path, txt):
+    return analyze.FileSummary(analyze.Parser(path, txt=txt))
+
+def analyze_file(path, relpath, key, parsed, txt, old=None):
+    '''
+    Build the FileModel for a freshly parsed file, reusing the summaries of
+    any blocks in old (the previous FileModel, if any) whose text is
+    unchanged. Return (model, keys of the blocks that were re-analyzed).
+    '''
+    cached = {}
+    if old:
+        for b in old.blocks:
+            cached[b.key] = b
+    fm = FileModel(relpath, key)
+    seen = {}
+    reanalyzed = []
+    residual = []
+    at = 0
+    for block in parsed.blocks:
+        if block.category not in _CATEGORIES:
+            continue
+        # #ifdef'd alternatives can define the same name more than once.
+        n = seen.get((block.category, block.name), 0)
+        seen[(block.category, block.name)] = n + 1
+        bkey = (block.category, block.name, n)
+        text = txt[block.begin:block.end]
+        digest = hashlib.md5(text).digest()
+        prev = cached.get(bkey)
+        if prev and prev.digest == digest:
+            summary = prev.summary
+        else:
+            summary = _summarize(path, text)
+            reanalyzed.append(bkey)
+        fm.blocks.append(BlockModel(bkey, block, digest, summary))
+        # Blank the block out of the residual, keeping offsets intact.
+        residual.append(txt[at:block.begin])
+        residual.append(' ' * (block.end - block.begin))
+        at = block.end
+    residual.append(txt[at:])
+    residual = ''.join(residual)
+    fm.residual_digest = hashlib.md5(residual).digest()
+    if old and old.residual_digest == fm.residual_digest:
+        fm.residual = old.residual
+    else:
+        fm.residual = _summarize(path, residual)
+    fm.summary = analyze.FileSummary(path=path)
+    fm.summary.add(fm.residual)
+    for b in fm.blocks:
+        fm.summary.add(b.summary)
+    return fm, reanalyzed
+
+class TreeModel:
+    '''
+    MLog counts for every file in a codebase, by top-level block, persisted
+    between runs. Paths are relative to the codebase root.
+    '''
+    def __init__(self, codebase, path=None):
+        self.codebase = codebase
+        self.path = path
+        self.files = {}
+        self.reanalyzed = 0
+        if path and os.path.isfile(path):
+            try:
+                f = open(path, 'rb')
+                try:
+                    fmt, version, files = cPickle.load(f)
+                finally:
+                    f.close()
+                if (fmt, version) == (_FORMAT, cparser.PARSE_VERSION):
+                    self.files = files
+            except Exception:
+                # Unreadable or truncated; rebuild from scratch.
+                self.files = {}
+
+    def save(self):
+        if not self.path:
+            return
+        folder = os.path.dirname(self.path)
+        if folder and not os.path.isdir(folder):
+            os.makedirs(folder)
+        tmp = self.path + '.tmp'
+        f = open(tmp, 'wb')
+        try:
+            cPickle.dump((_FORMAT, cparser.PARSE_VERSION, self.files), f, cPickle.HIGHEST_PROTOCOL)
+        finally:
+            f.close()
+        os.rename(tmp, self.path)
+
+    def update(self, jobs=1, cache=None):
+        '''
+        Bring the model up to date with every file in the codebase; only
+        files whose size or mtime changed are re-parsed (on jobs processes,
+        through the ParseCache cache if given). Return the relpaths that
+        were re-parsed.
+        '''
+        gone = set(self.files)
+        stale = []
+        keys = {}
+        for relpath in self.codebase.files:
+            gone.discard(relpath)
+            key = parsecache.file_key(self.codebase.abspath(relpath))
+            fm = self.files.get(relpath)
+            if not fm or fm.key != key:
+                stale.append(relpath)
+                keys[relpath] = key
+        for relpath in gone:
+            del self.files[relpath]
+        self.reanalyzed = 0
+        for relpath, parsed in parsecache.parse_files(self.codebase, stale, jobs, cache):
+            path = self.codebase.abspath(relpath)
+            f = open(path, 'r')
+            txt = f.read()
+            f.close()
+            fm, reanalyzed = analyze_file(path, relpath, keys[relpath], parsed, txt, self.files.get(relpath))
+            self.files[relpath] = fm
+            self.reanalyzed += len(reanalyzed)
+        if cache:
+            cache.save()
+        if stale or gone:
+            self.save()
+        return stale
+
+    def touched_blocks(self, spec):
+        '''
+        Given a change spec ({relpath: [(first_line, line_count), ...]}, as
+        from Codebase.change_spec()), return (relpath, BlockModel) for each
+        block whose lines intersect a hunk, in file and line order.
+        '''
+        touched = []
+        for relpath in sorted(spec):
+            fm = self.files.get(relpath)
+            if not fm:
+                continue
+            for b in fm.blocks:
+                if intersects(spec[relpath], b.line, b.end_line):
+                    touched.append((relpath, b))
+        return touched
+
+    def check(self, jobs=1, cache=None):
+        '''
+        Refresh the model and return the blocks that the working copy's
+        uncommitted changes touch (see touched_blocks()).
+        '''
+        self.update(jobs, cache)
+        return self.touched_blocks(self.codebase.change_spec())
+
+    def gist(self):
+        '''Return an analyze.Gist of the whole tree, built from the model.'''
+        gist = analyze.Gist(self.codebase)
+        for relpath in sorted(self.files):
+            gist.include(self.files[relpath].summary)
+        return gist
@@ -0,0 +1,192 @@
+'''
+Parse every file in a Codebase, optionally across several processes, and
+remember the results on disk so that later runs only re-parse files that
+have changed.
+
+Basic usage:
+
+    cb = Codebase(path)
+    for relpath, parsed in cb.parsed_files(jobs=None):
+        ...
+
+Each cache entry is keyed by the file's absolute path, size and mtime. The
+cache index is a small pickled dict; each parsed file lives in its own
+pickle beside it, so a warm run only unpickles what it actually yields.
+Everything is discarded if cparser.PARSE_VERSION changes.
+'''
+
+import cPickle
+import hashlib
+import multiprocessing
+import os
+
+import cparser
+
+_FORMAT = 1
+_INDEX_NAME = 'index.pickle'
+
+def default_cache_folder(root):
+    '''Where to keep the cache for a codebase rooted at root.'''
+    home = os.path.expanduser('~')
+    tag = hashlib.md5(root).hexdigest()
+    return os.path.join(home, '.cache', 'cbase', tag)
+
+def file_key(path):
+    '''Return the (size, mtime) pair that a cache entry for path must match.'''
+    st = os.stat(path)
+    return (st.st_size, st.st_mtime)
+
+def _parse_to_bytes(path):
+    '''
+    Worker entry point. Parse a file and return it pickled, so the parent
+    process can store it without pickling it a second time.
+    '''
+    key = file_key(path)
+    parsed = cparser.ParsedFile(path)
+    return path, key, cPickle.dumps(parsed, cPickle.HIGHEST_PROTOCOL)
+
+class ParseCache:
+    '''
+    An on-disk map from a source file to its ParsedFile.
+    '''
+    def __init__(self, folder):
+        self.folder = folder
+        self.hits = 0
+        self.misses = 0
+        self._dirty = False
+        self._index = None
+        if not os.path.isdir(folder):
+            os.makedirs(folder)
+        self._load_index()
+
+    def _load_index(self):
+        index = None
+        try:
+            f = open(os.path.join(self.folder, _INDEX_NAME), 'rb')
+            try:
+                index = cPickle.load(f)
+            finally:
+                f.close()
+        except (IOError, EOFError, cPickle.UnpicklingError):
+            pass
+        if (not index) or index.get('version') != (_FORMAT, cparser.PARSE_VERSION):
+            index = {'version': (_FORMAT, cparser.PARSE_VERSION), 'files': {}}
+            self._dirty = True
+        self._index = index
+
+    def _entry_path(self, path):
+        return os.path.join(self.folder, hashlib.md5(path).hexdigest() + '.pickle')
+
+    def is_fresh(self, path, key=None):
+        '''Is there an entry for path that matches the file as it is now?'''
+        if key is None:
+            key = file_key(path)
+        return self._index['files'].get(path) == key
+
+    def load(self, path, key=None):
+        '''
+        Return the cached ParsedFile for path, or None if there is no fresh
+        entry for it.
+        '''
+        if self.is_fresh(path, key):
+            try:
+                f = open(self._entry_path(path), 'rb')
+                try:
+                    parsed = cPickle.load(f)
+                finally:
+                    f.close()
+                self.hits += 1
+                return parsed
+            except (IOError, EOFError, cPickle.UnpicklingError):
+                self.forget(path)
+        self.misses += 1
+        return None
+
+    def store_bytes(self, path, key, data):
+        '''Record an already-pickled ParsedFile for path.'''
+        f = open(self._entry_path(path), 'wb')
+        try:
+            f.write(data)
+        finally:
+            f.close()
+        self._index['files'][path] = key
+        self._dirty = True
+
+    def store(self, path, parsed, key=None):
+        if key is None:
+            key = file_key(path)
+        self.store_bytes(path, key, cPickle.dumps(parsed, cPickle.HIGHEST_PROTOCOL))
+
+    def forget(self, path):
+        if path in self._index['files']:
+            del self._index['files'][path]
+            self._dirty = True
+        entry = self._entry_path(path)
+        if os.path.isfile(entry):
+            os.remove(entry)
+
+    def save(self):
+        '''Write the index, if anything changed. Done safely (tmp + rename).'''
+        if not self._dirty:
+            return
+        index_path = os.path.join(self.folder, _INDEX_NAME)
+        tmp = index_path + '.tmp'
+        f = open(tmp, 'wb')
+        try:
+            cPickle.dump(self._index, f, cPickle.HIGHEST_PROTOCOL)
+        finally:
+            f.close()
+        os.rename(tmp, index_path)
+        self._dirty = False
+
+def parse_files(codebase, relpaths, jobs=1, cache=None):
+    '''
+    Parse relpaths (relative to codebase.root) and yield (relpath, ParsedFile)
+    in the same order.
+
+    @param jobs Number of worker processes; None means one per CPU. Files are
+           only handed to workers if they are not already in the cache.
+    @param cache A ParseCache, a cache folder, or None for no caching.
+    '''
+    if jobs is None:
+        jobs = multiprocessing.cpu_count()
+    if cache is not None and not isinstance(cache, ParseCache):
+        cache = ParseCache(cache)
+    relpaths = list(relpaths)
+    results = {}
+    stale = []
+    for relpath in relpaths:
+        path = codebase.abspath(relpath)
+        parsed = None
+        if cache:
+            parsed = cache.load(path)
+        if parsed is None:
+            stale.append(path)
+        else:
+            results[path] = parsed
+    if stale:
+        if jobs > 1 and len(stale) > 1:
+            pool = multiprocessing.Pool(min(jobs, len(stale)))
+            try:
+                chunksize = max(1, len(stale) / (jobs * 4))
+                parsed_bytes = pool.imap_unordered(_parse_to_bytes, stale, chunksize)
+                for path, key, data in parsed_bytes:
+                    if cache:
+                        cache.store_bytes(path, key, data)
+                    results[path] = cPickle.loads(data)
+            finally:
+                pool.close()
+                pool.join()
+        else:
+            for path in stale:
+                key = file_key(path)
+                parsed = cparser.ParsedFile(path)
+                if cache:
+                    cache.store(path, parsed, key)
+                results[path] = parsed
+    if cache:
+        cache.save()
+    for relpath in relpaths:
+        parsed = results[codebase.abspath(relpath)]
+        parsed.codebase = codebase
+        yield relpath, parsed
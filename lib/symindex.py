@@ -0,0 +1,168 @@
+'''
+A persistent index of the prototypes, function definitions and user-defined
+types in a Codebase, so that "where is X declared?" doesn't require parsing
+the whole tree.
+
+The index is an SQLite database. Each file's symbols are replaced whenever
+the file's size or mtime changes (update()), or whenever the VCS reports it
+as modified (update_from_vcs(), which skips the stat of every file).
+
+Basic usage:
+
+    index = SymbolIndex(default_index_path(cb.root))
+    index.update(cb)
+    for sym in index.find('MJobGetPE', 'prototype'):
+        print('%s:%d %s' % (sym['path'], sym['line'], sym['signature']))
+'''
+
+import os
+import sqlite3
+
+import cparser
+import parsecache
+
+_CATEGORIES = ('prototype', 'function', 'udt')
+
+_SCHEMA = '''
+CREATE TABLE IF NOT EXISTS files (
+    id INTEGER PRIMARY KEY,
+    path TEXT UNIQUE NOT NULL,
+    size INTEGER NOT NULL,
+    mtime REAL NOT NULL);
+CREATE TABLE IF NOT EXISTS symbols (
+    file_id INTEGER NOT NULL,
+    name TEXT NOT NULL,
+    category TEXT NOT NULL,
+    line INTEGER NOT NULL,
+    end_line INTEGER NOT NULL,
+    returned TEXT,
+    params TEXT,
+    signature TEXT NOT NULL);
+CREATE INDEX IF NOT EXISTS symbols_by_name ON symbols (name);
+CREATE INDEX IF NOT EXISTS symbols_by_file ON symbols (file_id);
+'''
+
+def default_index_path(root, name='symbols'):
+    '''
+    Where to keep the index for a codebase rooted at root. Use a different
+    name for each different set of files (visit_filter) that gets indexed.
+    '''
+    return os.path.join(parsecache.default_cache_folder(root), name + '.db')
+
+def _symbols(block):
+    '''Yield every indexable block beneath block, at any depth.'''
+    for b in block.blocks:
+        if b.category in _CATEGORIES:
+            yield b
+        for sub in _symbols(b):
+            yield sub
+
+class SymbolIndex:
+    '''
+    Map symbol names to where they are declared or defined.
+    Paths are stored relative to the codebase root.
+    '''
+    def __init__(self, path):
+        folder = os.path.dirname(path)
+        if folder and not os.path.isdir(folder):
+            os.makedirs(folder)
+        self.path = path
+        self.db = sqlite3.connect(path)
+        self.db.row_factory = sqlite3.Row
+        version = self.db.execute('PRAGMA user_version').fetchone()[0]
+        if version != cparser.PARSE_VERSION:
+            # Symbols came from a different parser; start over.
+            self.db.executescript('DROP TABLE IF EXISTS symbols; DROP TABLE IF EXISTS files;')
+            self.db.execute('PRAGMA user_version = %d' % cparser.PARSE_VERSION)
+        self.db.executescript(_SCHEMA)
+        self.db.commit()
+
+    def close(self):
+        self.db.close()
+
+    def find(self, name, category=None):
+        '''Return rows (path, line, end_line, category, name, returned, params, signature) for name.'''
+        sql = ('SELECT files.path, symbols.line, symbols.end_line, symbols.category, symbols.name, '
+               'symbols.returned, symbols.params, symbols.signature '
+               'FROM symbols JOIN files ON files.id = symbols.file_id WHERE symbols.name = ?')
+        args = [name]
+        if category:
+            sql += ' AND symbols.category = ?'
+            args.append(category)
+        return self.db.execute(sql + ' ORDER BY files.path, symbols.line', args).fetchall()
+
+    @property
+    def file_count(self):
+        return self.db.execute('SELECT COUNT(*) FROM files').fetchone()[0]
+
+    @property
+    def symbol_count(self):
+        return self.db.execute('SELECT COUNT(*) FROM symbols').fetchone()[0]
+
+    def update(self, codebase, jobs=1):
+        '''
+        Bring the index up to date with every file in codebase, re-indexing
+        only those whose size or mtime changed. Return the number re-indexed.
+        '''
+        indexed = {}
+        for row in self.db.execute('SELECT path, size, mtime FROM files'):
+            indexed[row[0]] = (row[1], row[2])
+        stale = []
+        for relpath in codebase.files:
+            key = parsecache.file_key(codebase.abspath(relpath))
+            if indexed.pop(relpath, None) != key:
+                stale.append(relpath)
+        # Whatever is left in indexed no longer exists.
+        return self._reindex(codebase, stale, indexed.keys(), jobs)
+
+    def update_changed(self, codebase, relpaths, jobs=1):
+        '''
+        Re-index just relpaths (relative to codebase.root); files that no
+        longer exist are dropped. Return the number re-indexed.
+        '''
+        present = []
+        gone = []
+        for relpath in relpaths:
+            if os.path.isfile(codebase.abspath(relpath)):
+                present.append(relpath)
+            else:
+                gone.append(relpath)
+        return self._reindex(codebase, present, gone, jobs)
+
+    def update_from_vcs(self, codebase, jobs=1):
+        '''
+        Re-index the files that codebase.change_spec() reports as modified in
+        the working copy. This is much cheaper than update() on a big tree,
+        but it only knows about uncommitted edits to files that already
+        exist; use update() after switching branches, pulling, etc.
+        '''
+        return self.update_changed(codebase, codebase.change_spec().keys(), jobs)
+
+    def _reindex(self, codebase, stale, gone, jobs):
+        db = self.db
+        for relpath in gone:
+            self._forget(relpath)
+        # Take the keys before parsing, so an edit made meanwhile is noticed next time.
+        keys = dict((relpath, parsecache.file_key(codebase.abspath(relpath))) for relpath in stale)
+        for relpath, parsed in parsecache.parse_files(codebase, stale, jobs):
+            self._forget(relpath)
+            size, mtime = keys[relpath]
+            cursor = db.execute('INSERT INTO files (path, size, mtime) VALUES (?, ?, ?)', (relpath, size, mtime))
+            file_id = cursor.lastrowid
+            rows = []
+            for b in _symbols(parsed):
+                returned = getattr(b, 'returned', None)
+                params = getattr(b, 'params', None)
+                if params is not None:
+                    params = ', '.join(params)
+                signature = str(b).replace('/* ... */\n', '')
+                rows.append((file_id, b.name, b.category, b.at_line_num, b.end_line_num, returned, params, signature))
+            db.executemany('INSERT INTO symbols VALUES (?, ?, ?, ?, ?, ?, ?, ?)', rows)
+        db.commit()
+        return len(stale)
+
+    def _forget(self, relpath):
+        row = self.db.execute('SELECT id FROM files WHERE path = ?', (relpath,)).fetchone()
+        if row:
+            self.db.execute('DELETE FROM symbols WHERE file_id = ?', (row[0],))
+            self.db.execute('DELETE FROM files WHERE id = ?', (row[0],))
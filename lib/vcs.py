@@ -7,13 +7,32 @@ HG_CMD = 'hg'
 GIT_CMD = 'git --no-pager'
 LOG_DATE_PAT = re.compile(r'[dD]ate:\s+((Sun|Mon|Tue|Wed|Thu|Fri|Sat) (Jan|Feb|Mar|Apr|May|Jun|Jul|Aug|Sep|Oct|Nov|Dec) \d+ \d+:\d\d:\d\d \d\d\d\d( ?(Z|[A-Z][A-Z][A-Z]|[-+]\d\d\d\d))?).*')
 FILE_DATE_PAT = re.compile(r'\s+(Sun|Mon|Tue|Wed|Thu|Fri|Sat) (Jan|Feb|Mar|Apr|May|Jun|Jul|Aug|Sep|Oct|Nov|Dec) \d+ \d+:\d\d:\d\d \d\d\d\d.*')
-HUNK_PAT = re.compile('@@ ([-+]\d+),(\d+) ([-+]\d+),(\d+) @@.*')
+# With -U0, a hunk of exactly one line omits its ",count".
+HUNK_PAT = re.compile(r'@@ ([-+]\d+)(?:,(\d+))? ([-+]\d+)(?:,(\d+))? @@.*')
 
 def choose_vcs_cmd(folder):
     if os.path.isdir(os.path.join(folder, '.hg')):
         return HG_CMD
     return GIT_CMD
 
+def get_root(folder):
+    '''
+    Return the top of the working copy that contains folder (the folder that
+    paths in get_change_spec() are relative to), with a trailing slash.
+    '''
+    cmd = choose_vcs_cmd(folder)
+    if cmd == HG_CMD:
+        cmd += ' root'
+    else:
+        cmd += ' rev-parse --show-toplevel'
+    old_folder = os.getcwd()
+    os.chdir(folder)
+    try:
+        root = subprocess.check_output(cmd, shell=True, universal_newlines=True).strip()
+    finally:
+        os.chdir(old_folder)
+    return os.path.abspath(root).replace('\\', '/').rstrip('/') + '/'
+
 def get_most_recent_commit_date(folder):
     cmd = choose_vcs_cmd(folder)
     if cmd == HG_CMD:
@@ -63,7 +82,10 @@ def get_change_spec(folder):
                 n = 3
                 if match.group(1).startswith('+'):
                     n = 1
-                change_spec[fname].append((int(match.group(n)[1:]), int(match.group(n+1))))
+                count = match.group(n+1)
+                if count is None:
+                    count = 1
+                change_spec[fname].append((int(match.group(n)[1:]), int(count)))
     return change_spec
 
 if __name__ == '__main__':
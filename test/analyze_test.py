@@ -0,0 +1,33 @@
+import json
+import os
+import unittest
+
+import paths
+import analyze
+import codebase
+
+SAMPLE_DIR = os.path.join(paths.TESTDIR, 'sample_code')
+
+class GistTest(unittest.TestCase):
+
+    def setUp(self):
+        self.cb = codebase.Codebase(SAMPLE_DIR)
+        self.paths = [self.cb.abspath(f) for f in ['moab/MJobXML.c', 'moab/MNodeShow.c', 'include/MUURL.h']]
+
+    def test_parallel_matches_serial(self):
+        serial = analyze.Gist(self.cb)
+        for path in self.paths:
+            serial.include(analyze.Parser(path, self.cb))
+        parallel = analyze.Gist(self.cb)
+        parallel.include_files(self.paths, jobs=2)
+        self.assertEqual(serial.as_dict(), parallel.as_dict())
+
+    def test_json(self):
+        gist = analyze.Gist(self.cb)
+        gist.include_files(self.paths, jobs=1)
+        report = json.loads(gist.to_json())
+        self.assertEqual(3, report['file_count'])
+        calls = sum(f['calls'] for f in report['top_files'])
+        self.assertEqual(calls, sum(report['by_level'].values()))
+        self.assertTrue(calls > 0)
+        self.assertEqual('moab/', report['top_files'][0]['path'][0:5])
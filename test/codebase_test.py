@@ -10,7 +10,7 @@ class CodebaseTest(unittest.TestCase):
     
     def test_file_enum(self):
         cb = codebase.Codebase(SAMPLE_DIR)
-        self.assertEqual(69, len(cb.by_ext['.h']))
+        self.assertEqual(72, len(cb.by_ext['.h']))
         for item in cb.by_ext['.h']:
             self.assertTrue(item in cb.by_folder['include/'])
         self.assertEqual(2, len(cb.by_folder['']))
@@ -210,5 +210,31 @@ void nothing() { }
         descrip = ';'.join([str((b.category,b.at_line_num)) for b in p.blocks])
         self.assertEqual("('function', 1);('function', 21)", descrip)
 
+    def test_erasure_applied_once(self):
+        txt = '''int f(int a /* first */, char * b) {
+  g("{ not a block }");
+#if X
+  h(1);
+#else
+  h(2);
+#endif
+  return 0; // done
+}
+'''
+        p = cparser.ParsedFile()
+        p.parse(txt)
+        self.assertEqual(1, len(p.blocks))
+        func = p.blocks[0]
+        self.assertEqual('f', func.name)
+        self.assertEqual(['int a', 'char * b'], func.params)
+        self.assertEqual(len(txt), len(p.txt))
+        self.assertEqual(txt.count('\n'), p.txt.count('\n'))
+        self.assertFalse('first' in p.txt)
+        self.assertFalse('not a block' in p.txt)
+        self.assertFalse('done' in p.txt)
+        self.assertFalse('h(2)' in p.txt)
+        self.assertEqual(9, func.end_line_num)
+        self.assertTrue(func.txt is p.txt)
+
 if __name__ == '__main__':
     print('This module is intended to be tested with nose.')
\ No newline at end of file
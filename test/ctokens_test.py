@@ -0,0 +1,53 @@
+import mmap
+import os
+import unittest
+
+import paths
+import ctokens
+
+SAMPLE_DIR = os.path.join(paths.TESTDIR, 'sample_code')
+
+def kinds(txt):
+    return [(txt[begin:end], kind, line) for begin, end, kind, line in ctokens.tokenize(txt)]
+
+class TokenizerTest(unittest.TestCase):
+
+    def test_basic_kinds(self):
+        txt = 'int f(char c) {\n  return c == 1; // x\n}\n'
+        self.assertEqual([
+            ('int f(char c) ', ctokens.WORD, 1),
+            ('{', ctokens.LBRACE, 1),
+            ('return c == 1', ctokens.WORD, 2),
+            (';', ctokens.SEMI, 2),
+            ('// x', ctokens.LINE_COMMENT, 2),
+            ('}', ctokens.RBRACE, 3)], kinds(txt))
+
+    def test_comments_and_strings(self):
+        txt = '/* a\nb */ "x\\"{" "open\n/* never'
+        self.assertEqual([
+            ('/* a\nb */', ctokens.BLOCK_COMMENT, 1),
+            ('"x\\"{"', ctokens.STRING, 2),
+            ('"open', ctokens.UNTERMINATED_STRING, 2),
+            ('/* never', ctokens.UNTERMINATED_BLOCK_COMMENT, 3)], kinds(txt))
+
+    def test_directives(self):
+        txt = '#define A(x) \\\n  { x }\n#if X\n{\n#else\n}\n#endif\n;'
+        self.assertEqual([
+            ('#define A(x) \\\n  { x }\n', ctokens.DIRECTIVE, 1),
+            ('#if X\n', ctokens.DIRECTIVE, 3),
+            ('{', ctokens.LBRACE, 4),
+            ('#else\n}\n#endif', ctokens.ELSE_DIRECTIVE, 5),
+            (';', ctokens.SEMI, 8)], kinds(txt))
+
+    def test_mmap_matches_string(self):
+        path = os.path.join(SAMPLE_DIR, 'moab', 'MVMShow.c')
+        f = open(path, 'rb')
+        try:
+            txt = f.read()
+            buf = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+            try:
+                self.assertEqual(list(ctokens.tokenize(txt)), list(ctokens.tokenize(buf)))
+            finally:
+                buf.close()
+        finally:
+            f.close()
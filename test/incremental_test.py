@@ -0,0 +1,86 @@
+import os
+import shutil
+import subprocess
+import tempfile
+import time
+import unittest
+
+import paths
+import analyze
+import codebase
+import incremental
+
+FOO = '''int MFoo(
+  int x)
+  {
+  MDB(3,fALL) MLog("INFO:     foo %d\\n",x);
+  return(x);
+  }
+
+int MBar(void)
+  {
+  MLog("ALERT:    bar\\n");
+  return(0);
+  }
+'''
+
+def write(path, txt, age=0):
+    f = open(path, 'w')
+    f.write(txt)
+    f.close()
+    when = time.time() - age
+    os.utime(path, (when, when))
+
+def git(root, *args):
+    subprocess.check_call(('git', '-c', 'user.name=t', '-c', 'user.email=t@t') + args, cwd=root,
+        stdout=open(os.devnull, 'w'))
+
+class IntersectsTest(unittest.TestCase):
+
+    def test_hunks(self):
+        self.assertTrue(incremental.intersects([(5, 1)], 5, 9))
+        self.assertTrue(incremental.intersects([(1, 5)], 5, 9))
+        self.assertFalse(incremental.intersects([(1, 4)], 5, 9))
+        self.assertFalse(incremental.intersects([(10, 2)], 5, 9))
+        # Deletions (count 0) sit just after their line.
+        self.assertTrue(incremental.intersects([(4, 0)], 5, 9))
+        self.assertFalse(incremental.intersects([(9, 0)], 1, 7))
+
+class TreeModelTest(unittest.TestCase):
+
+    def setUp(self):
+        self.root = tempfile.mkdtemp()
+        os.mkdir(os.path.join(self.root, 'include'))
+        write(os.path.join(self.root, 'Makefile'), '')
+        self.foo = os.path.join(self.root, 'foo.c')
+        write(self.foo, FOO, age=100)
+        git(self.root, 'init', '-q')
+        git(self.root, 'add', '.')
+        git(self.root, 'commit', '-q', '-m', 'x')
+        self.model_path = os.path.join(self.root, 'cache', 'mlog.model')
+
+    def tearDown(self):
+        shutil.rmtree(self.root)
+
+    def test_matches_full_analysis(self):
+        cb = codebase.Codebase(self.root)
+        model = incremental.TreeModel(cb, self.model_path)
+        self.assertEqual(['foo.c'], model.update())
+        self.assertEqual(2, model.reanalyzed)
+        full = analyze.Gist(cb)
+        full.include_files([self.foo], jobs=1)
+        self.assertEqual(full.as_dict(), model.gist().as_dict())
+        self.assertEqual([], incremental.TreeModel(cb, self.model_path).update())
+
+    def test_check(self):
+        cb = codebase.Codebase(self.root)
+        model = incremental.TreeModel(cb, self.model_path)
+        self.assertEqual([], model.check())
+        write(self.foo, FOO.replace('  return(0);', '  MLog("ERROR:    bar\\n");\n  return(0);'))
+        model = incremental.TreeModel(cb, self.model_path)
+        touched = model.check()
+        # Only MBar was re-analyzed; MFoo came from the saved model.
+        self.assertEqual(1, model.reanalyzed)
+        self.assertEqual([('foo.c', 'MBar', 8, 13, 2)],
+            [(p, b.name, b.line, b.end_line, b.summary.call_count) for p, b in touched])
+        self.assertEqual({'ALERT': 1, 'ERROR': 1, 'INFO': 1}, model.gist().by_dc)
@@ -0,0 +1,72 @@
+import os
+import shutil
+import tempfile
+import time
+import unittest
+
+import paths
+import codebase
+import cparser
+import parsecache
+
+SAMPLE_DIR = os.path.join(paths.TESTDIR, 'sample_code')
+
+def describe(block):
+    items = [(block.category, block.name, block.at_line_num, block.end_line_num)]
+    for b in block.blocks:
+        items.extend(describe(b))
+    return items
+
+class ParseCacheTest(unittest.TestCase):
+
+    def setUp(self):
+        self.cache_folder = tempfile.mkdtemp()
+        self.cb = codebase.Codebase(SAMPLE_DIR)
+        self.relpaths = ['moab/MVMShow.c', 'include/PluginBase.h', 'include/MUURL.h']
+
+    def tearDown(self):
+        shutil.rmtree(self.cache_folder)
+
+    def test_round_trip(self):
+        cache = parsecache.ParseCache(self.cache_folder)
+        first = list(parsecache.parse_files(self.cb, self.relpaths, cache=cache))
+        self.assertEqual(0, cache.hits)
+        self.assertEqual(3, cache.misses)
+        cache = parsecache.ParseCache(self.cache_folder)
+        second = list(parsecache.parse_files(self.cb, self.relpaths, cache=cache))
+        self.assertEqual(3, cache.hits)
+        for (relpath, a), (relpath2, b) in zip(first, second):
+            self.assertEqual(relpath, relpath2)
+            self.assertEqual(describe(a), describe(b))
+            self.assertEqual(a.comment_count, b.comment_count)
+            self.assertEqual(relpath, b.relpath)
+        pb = second[1][1]
+        self.assertEqual('/* ... */\nclass PluginException;/* ... */\nclass PluginBase',
+                         ';'.join([str(b) for b in pb.blocks]))
+        self.assertTrue(pb.blocks[0].parent is pb)
+
+    def test_stale_entry_reparsed(self):
+        tmp = tempfile.mkdtemp()
+        try:
+            src = os.path.join(tmp, 'x.c')
+            f = open(src, 'w')
+            f.write('void a() {\n}\n')
+            f.close()
+            cache = parsecache.ParseCache(self.cache_folder)
+            cache.store(src, cparser.ParsedFile(src))
+            self.assertTrue(cache.is_fresh(src))
+            f = open(src, 'w')
+            f.write('void a() {\n}\nvoid b() {\n}\n')
+            f.close()
+            os.utime(src, (time.time() + 10, time.time() + 10))
+            self.assertFalse(cache.is_fresh(src))
+            self.assertTrue(cache.load(src) is None)
+        finally:
+            shutil.rmtree(tmp)
+
+    def test_parallel_matches_serial(self):
+        serial = list(parsecache.parse_files(self.cb, self.relpaths, jobs=1))
+        parallel = list(parsecache.parse_files(self.cb, self.relpaths, jobs=2))
+        self.assertEqual([x[0] for x in serial], [x[0] for x in parallel])
+        for (relpath, a), (relpath2, b) in zip(serial, parallel):
+            self.assertEqual(describe(a), describe(b))
@@ -12,6 +12,7 @@
 
 #include "moab.h"
 
+int MUGenHash(char const *);
 int MUHTAdd(mhash_t *,char const *,void *,mbitmap_t *,int (*)(void **));
 int MUHTAddCI(mhash_t *,const char *,void *,mbitmap_t *,int (*)(void **));
 int MUHTAddInt(mhash_t *,int,void *,mbitmap_t *,int (*)(void **));
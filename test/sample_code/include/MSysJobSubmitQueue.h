@@ -7,7 +7,8 @@ int MSysJobSubmitQueueCreate(void);
 int MSysJobSubmitQueueFree(void);
 int MSysJobSubmitQueueMutexInit(void);
 
-int MSysAddJobSubmitToQueue(mjob_submit_t *,int *,mbool_t);
+int MSysAddJobSubmitToQueue(mjob_submit_t *,int *,mbool_t,mstring_t *);
 int MSysDequeueJobSubmit(mjob_submit_t **);
+int MSysDequeueJobSubmitBatch(mjob_submit_t **,int);
 
 #endif  /* __MSYSMJOBSUBMITQUEUE_H__ */
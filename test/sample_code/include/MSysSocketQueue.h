@@ -5,9 +5,10 @@
 
 int MSysSocketQueueCreate(void);
 int MSysSocketQueueFree(void);
-int MSysSocketQueueMutexInit(void);
 
 int MSysAddSocketToQueue(msocket_t *);
 int MSysDequeueSocket(msocket_t **);
+int MSysDequeueSocketBatch(msocket_t **,int);
+int MSysTransactionCountAdjust(int);
 
 #endif  /* __MSYSMSQUEUE_H__ */
@@ -0,0 +1,25 @@
+/* HEADER */
+
+/**
+ * @file MUArena.h
+ *
+ * declarations for per-iteration scratch arena functions
+ *
+ */
+
+#ifndef __MUARENA_H__
+#define __MUARENA_H__
+
+#include "moab.h"
+
+int MUArenaReset(marena_t *);
+int MUArenaDestroy(marena_t *);
+void *MUArenaCalloc(marena_t *,int,int);
+void *MUArenaMalloc(marena_t *,int);
+void *MUArenaHeapCalloc(marena_t *,int,int);
+int MUArenaFree(marena_t *,char **);
+int MUArenaMark(marena_t *,marenamark_t *);
+int MUArenaRelease(marena_t *,marenamark_t *);
+int MUArenaCommit(marena_t *,marenamark_t *);
+
+#endif /*  __MUARENA_H__ */
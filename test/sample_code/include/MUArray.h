@@ -19,17 +19,16 @@
  */
 
 
-#define MCONST_MARRAYEMPTYSIZE 5
-
 typedef struct marray_t {
 
   int ArraySize;   /* the size of the dynamically allocated array */
-  int NumItems;    /* the number of items in this array */
+  int NumItems;    /* the number of items in this array (including empty slots) */
   int ElementSize; /* the size of each element contained in the array */
 
-  /* small cache which lists which slots in the array are "empty" */
-  int EmptyTable[MCONST_MARRAYEMPTYSIZE];  
-  int NumEmptyItems;  /* number of empty indexes inide the EmptyTable cache */
+  /* stack of the slots in the array that are "empty" (see MUArrayListRemove()) */
+  int *FreeList;
+  int  NumFree;       /* number of empty slots on FreeList */
+  int  FreeListSize;  /* allocated size of FreeList */
 
   unsigned char *Array; /* g++ complains about void ptr arithmetic */
   } marray_t;
@@ -38,9 +37,12 @@ typedef struct marray_t {
 int   MUArrayListCreate(marray_t *,int,int);
 int   MUArrayListByteSize(marray_t *);
 int   MUArrayListResize(marray_t *,int);
+int   MUArrayListReserve(marray_t *,int);
 void *MUArrayListAppendEmpty(marray_t *);
 int   MUArrayListAppend(marray_t *,void *);
 int   MUArrayListAppendPtr(marray_t *,void *);
+int   MUArrayListAppendN(marray_t *,void *,int);
+int   MUArrayListInsertPtr(marray_t *,void *);
 int   MUArrayListInsertPtrAtIndex(marray_t *,void *,int);
 int   MUArrayListInsertAtIndex(marray_t *,void *,int);
 void *MUArrayListGet(marray_t *,int);
@@ -48,6 +50,8 @@ int   MUArrayListFree(marray_t *);
 int   MUArrayListFreePtrElements(marray_t *ArrayP);
 void *MUArrayListGetPtr(marray_t *,int);
 int   MUArrayListRemove(marray_t *,int,mbool_t);
+int   MUArrayListRemoveN(marray_t *,int *,int,mbool_t);
+int   MUArrayListCompact(marray_t *);
 int   MUArrayListClear(marray_t *);
 int   MUArrayListCopy(marray_t *,marray_t *);
 int   MUArrayListCopyPtrElements(marray_t *,marray_t *,mbool_t,int);
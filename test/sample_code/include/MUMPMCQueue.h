@@ -0,0 +1,24 @@
+/* HEADER */
+
+/**
+ * @file MUMPMCQueue.h
+ *
+ * declarations for bounded lock-free multi-producer/multi-consumer queue
+ * functions
+ *
+ */
+
+#ifndef __MUMPMCQUEUE_H__
+#define __MUMPMCQUEUE_H__
+
+#include "moab.h"
+
+mmpmcq_t *MUMPMCQueueCreate(unsigned int);
+void MUMPMCQueueFree(mmpmcq_t *);
+int MUMPMCQueueEnqueue(mmpmcq_t *,void *);
+int MUMPMCQueueEnqueueWait(mmpmcq_t *,void *);
+int MUMPMCQueueDequeue(mmpmcq_t *,void **);
+int MUMPMCQueueDequeueBatch(mmpmcq_t *,void **,int);
+int MUMPMCQueueSize(mmpmcq_t *);
+
+#endif /*  __MUMPMCQUEUE_H__ */
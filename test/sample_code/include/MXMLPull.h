@@ -0,0 +1,25 @@
+/* HEADER */
+
+/**
+ * @file MXMLPull.h
+ *
+ * declarations for the zero-copy XML pull parser and arena-backed XML trees
+ *
+ */
+
+#ifndef __MXMLPULL_H__
+#define __MXMLPULL_H__
+
+#include "moab.h"
+
+int MXMLPullInit(mxmlpull_t *,const char *,int);
+int MXMLPullNext(mxmlpull_t *,enum MXMLPullEventEnum *);
+int MXMLPullNextAttr(mxmlpull_t *,mxmlview_t *,mxmlview_t *);
+int MXMLPullGetAttr(mxmlpull_t *,const char *,mxmlview_t *);
+int MXMLPullSkip(mxmlpull_t *);
+mbool_t MXMLViewIs(const mxmlview_t *,const char *);
+int MXMLViewDecode(const mxmlview_t *,char *,int);
+int MXMLViewToMString(const mxmlview_t *,mstring_t *);
+int MXMLFromStringArena(mxml_t **,const char *,marena_t *,char **,char *);
+
+#endif /*  __MXMLPULL_H__ */
@@ -128,6 +128,9 @@ struct modbc_t {
   mpstmt_odbc_t DeleteVCStmt;
   mpstmt_odbc_t DeleteRequestsStmt;
   mpstmt_odbc_t DeleteNodesStmt;
+  mpstmt_odbc_t DeleteJobByIDStmt;
+  mpstmt_odbc_t DeleteRequestsByJobIDStmt;
+  mpstmt_odbc_t DeleteNodeByIDStmt;
   mpstmt_odbc_t InsertJobStmt;
   mpstmt_odbc_t InsertRsvStmt;
   mpstmt_odbc_t InsertTriggerStmt;
@@ -156,6 +159,9 @@ extern const char *MDBInsertTriggerStmtText;
 extern const char *MDBInsertVCStmtText;
 extern const char *MDBInsertRequestStmtText;
 extern const char *MDBInsertNodeStmtText;
+extern const char *MDBDeleteJobByIDStmtText;
+extern const char *MDBDeleteRequestsByJobIDStmtText;
+extern const char *MDBDeleteNodeByIDStmtText;
 extern const char *MDBSelectEventsStmtText;
 extern const char *MDBInsertGeneralStatsStmtText;
 extern char  MDBSelectGeneralStatsStmtText[];
@@ -179,24 +185,6 @@ extern char  MDBDeleteVCsStmtText[];
 extern char  MDBDeleteRequestsStmtText[];
 extern char  MDBDeleteNodesStmtText[];
 
-typedef enum MStmtType {
-  mstmtPrepared,
-  mstmtDirect
-} MStmtType;
-
-typedef union mstmt_union {
-  mstmt_sqlite3_t *SQLite3;
-  struct mstmt_odbc_t    *ODBC;
-  struct mpstmt_odbc_t   *PODBC;
-  struct mdstmt_odbc_t   *DODBC;
-} mstmt_union;
-
-typedef struct mstmt_t {
-  mstmt_union StmtUnion;
-  MDBTypeEnum DBType;
-  MStmtType StmtType;
-} mstmt_t;
-
 int MODBCPurgeCPStmt(modbc_t *,mstmt_t *);
 int MODBCStmtError(mstmt_odbc_t *,char const *,char *,enum MStatusCodeEnum *);
 int MODBCConnect(modbc_t *,char *);
@@ -260,12 +248,16 @@ int MODBCNumChangedRows(mstmt_odbc_t *,int *);
 int MODBCBindParamBlob(mstmt_odbc_t *,int,void *,int);
 int MODBCBeginTransaction(modbc_t *,char *);
 int MODBCEndTransaction(modbc_t *,char *,enum MStatusCodeEnum *);
+int MODBCRollbackTransaction(modbc_t *,char *,enum MStatusCodeEnum *);
 int MODBCDeleteJobsStmt(modbc_t *,mstmt_t *,char *);
 int MODBCDeleteRsvsStmt(modbc_t *,mstmt_t *,char *);
 int MODBCDeleteTriggersStmt(modbc_t *,mstmt_t *,char *);
 int MODBCDeleteVCsStmt(modbc_t *,mstmt_t *,char *);
 int MODBCDeleteRequestsStmt(modbc_t *,mstmt_t *,char *);
 int MODBCDeleteNodesStmt(modbc_t *,mstmt_t *,char *);
+int MODBCDeleteJobByIDStmt(modbc_t *,mstmt_t *,char *);
+int MODBCDeleteRequestsByJobIDStmt(modbc_t *,mstmt_t *,char *);
+int MODBCDeleteNodeByIDStmt(modbc_t *,mstmt_t *,char *);
 mbool_t MODBCInTransaction(modbc_t *);
 
 int MSQLite3SelectNodeStatsGenericResourcesStmt(msqlite3_t *,mstmt_t *,char *);
@@ -322,6 +314,10 @@ int MSQLite3PurgeCPStmt(msqlite3_t *,mstmt_t *);
 int MSQLite3StmtError(mstmt_sqlite3_t *,char const *,char *);
 int MSQLite3BeginTransaction(msqlite3_t *,char *);
 int MSQLite3EndTransaction(msqlite3_t *,char *);
+int MSQLite3RollbackTransaction(msqlite3_t *,char *);
+int MSQLite3SetSavepoint(msqlite3_t *,char *);
+int MSQLite3ReleaseSavepoint(msqlite3_t *,char *);
+int MSQLite3RollbackToSavepoint(msqlite3_t *,char *);
 mbool_t MSQLite3InTransaction(msqlite3_t *);
 int MSQLite3DeleteJobsStmt(msqlite3_t *,mstmt_t *,char *);
 int MSQLite3DeleteRsvsStmt(msqlite3_t *,mstmt_t *,char *);
@@ -329,6 +325,10 @@ int MSQLite3DeleteTriggersStmt(msqlite3_t *,mstmt_t *,char *);
 int MSQLite3DeleteVCsStmt(msqlite3_t *,mstmt_t *,char *);
 int MSQLite3DeleteRequestsStmt(msqlite3_t *,mstmt_t *,char *);
 int MSQLite3DeleteNodesStmt(msqlite3_t *,mstmt_t *,char *);
+int MSQLite3DeleteJobByIDStmt(msqlite3_t *,mstmt_t *,char *);
+int MSQLite3DeleteRequestsByJobIDStmt(msqlite3_t *,mstmt_t *,char *);
+int MSQLite3DeleteNodeByIDStmt(msqlite3_t *,mstmt_t *,char *);
+int MSQLite3SetStableParamStmt(mstmt_sqlite3_t *);
 
 int MDBBindParamText(mstmt_t *,int,char const *,int);
 void MSQLite3BindValue(msqlite3_value_t *,int,int,void const *,int);
@@ -392,6 +392,10 @@ int MDBInsertCP(mdb_t *,const char *,const char *,long unsigned int,const char *
 int MDBGetEventMessages(mdb_t *,enum MXMLOTypeEnum OType,char *OID,enum MRecordEventTypeEnum EType,int unsigned,char **Array,int const ArrSize);
 int MDBBeginTransaction(mdb_t *,char *);
 int MDBEndTransaction(mdb_t *,char *,enum MStatusCodeEnum *);
+int MDBRollbackTransaction(mdb_t *,char *,enum MStatusCodeEnum *);
+int MDBSetSavepoint(mdb_t *,char *);
+int MDBReleaseSavepoint(mdb_t *,char *);
+int MDBRollbackToSavepoint(mdb_t *,char *);
 int MDBDeleteJobs(mdb_t *,marray_t *,char *);
 int MDBDeleteRequests(mdb_t *, marray_t *,char *);
 int MDBDeleteNodes(mdb_t *,marray_t *,char *);
@@ -401,6 +405,10 @@ int MDBDeleteTriggersStmt(mdb_t *,mstmt_t *,char *);
 int MDBDeleteVCsStmt(mdb_t *,mstmt_t *,char *);
 int MDBDeleteRequestsStmt(mdb_t *,mstmt_t *, char *);
 int MDBDeleteNodesStmt(mdb_t *,mstmt_t *,char *);
+int MDBDeleteJobByIDStmt(mdb_t *,mstmt_t *,char *);
+int MDBDeleteRequestsByJobIDStmt(mdb_t *,mstmt_t *,char *);
+int MDBDeleteNodeByIDStmt(mdb_t *,mstmt_t *,char *);
+int MDBSetStableParamStmt(mstmt_t *);
 int MDBBindRequest(mstmt_t *,mtransreq_t *,char *,char *);
 int MDBBindJob(mstmt_t *,mtransjob_t *,char *,char *);
 mbool_t MDBInTransaction(mdb_t *);
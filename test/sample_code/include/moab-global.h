@@ -58,6 +58,7 @@ extern mmutex_t         MDBHandleHashLock;
 
 extern mqos_t           MQOS[];
 extern msched_t         MSched;
+extern marena_t         MSchedArena;  /* per-iteration scratch memory (see MUArena.c) */
 extern mrack_t          MRack[];
 extern mpar_t           MPar[];
 extern int              MParSize;
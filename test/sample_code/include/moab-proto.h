@@ -66,6 +66,8 @@ int __MNodeCompareLex(const void *, const void *);
 int __MNodeCompareIndex(const void *, const void *);
 int MCPWriteSystemStats(mckpt_t *);
 int MCPRestore(enum MCkptTypeEnum,const char *,void *,mbool_t *);
+int MCPGetLine(enum MCkptTypeEnum,const char *,char **);
+int MCPBuildHashTable(const char *);
 int MCPWriteTList(mckpt_t *);
 int MCPStoreCJobs(mckpt_t *);
 int MCPValidate(char *,mbool_t *,mbool_t *);
@@ -93,6 +95,7 @@ int MCPSubmitJournalLoad();
 int MCPSubmitJournalOpen(char *);
 int MCPSubmitJournalAddEntry(mstring_t *,mjob_submit_t *);
 int MCPSubmitJournalRemoveEntry(mulong);
+int MCPSubmitJournalDropEntry(mjob_submit_t *);
 int MCPSubmitJournalClear();
 int MCPSubmitJournalClose();
 
@@ -582,8 +585,10 @@ int MNLGetNodeAtIndex(const mnl_t *,int,mnode_t **);
 int MNLSetNodeAtIndex(mnl_t *,int,mnode_t *);
 int MNLSetTCAtIndex(mnl_t *,int,int);
 int MNLInit(mnl_t *);
+int MNLInitFromArena(mnl_t *,marena_t *);
 int MNLFree(mnl_t *);
 int MNLMultiInit(mnl_t **);
+int MNLMultiInitFromArena(mnl_t **,marena_t *);
 int MNLMultiInitCount(mnl_t **,int);
 int MNLMultiFree(mnl_t **);
 int MNLMultiFreeCount(mnl_t **,int);
@@ -882,6 +887,7 @@ int MJobSelectMNL(mjob_t *,const mpar_t *,mnl_t *,mnl_t **,char *,mbool_t,mbool_
 int MJobDistributeTasks(mjob_t *,mrm_t *,mbool_t,mnl_t *,int *,int);
 const char *MJobGetName(mjob_t *,const char *,mrm_t *,char *,int,enum MJobNameEnum);
 int MJobCalcStartPriority(mjob_t *,const mpar_t *,double *,enum MPrioDisplayEnum,mxml_t **,mstring_t *,enum MFormatModeEnum,mbool_t);
+int MJobCalcStartPriorityBatch(mjob_t **,int,const mpar_t *,double *);
 void MJobSetStartPriority(mjob_t *,int,long);
 int MJobGetRunPriority(mjob_t *,int,double *,double *,char *);
 int MUExpandPBSJobIDToJobName(char *,int,mjob_t *);
@@ -1174,6 +1180,8 @@ int MQueueInitialize(mjob_t **,const char *);
 int MQueueDestroy(mjob_t **);
 int MQueueScheduleIJobs(mjob_t **,mpar_t *);
 int MQueuePrioritizeJobs(mjob_t **,mbool_t,const mpar_t *);
+int MQueueSortStartPrio(mjob_t **,int);
+int MQueueStartPrioComp(mjob_t **,mjob_t **);
 int MQueueGetBestRQTime(mjob_t **,long *);
 int MQueueScheduleRJobs(mjob_t **,mpar_t *);
 int MQueueScheduleSJobs(mjob_t **,int *,char **);
@@ -1380,8 +1388,7 @@ int MSysEItrNext(mevent_itr_t *,mevent_t *);
 void *MSysCommThread(void *);
 void *MOCacheThread(void *);
 void *MOWebServicesThread(void *);
-int MSysAddJobSubmitToJournal(mjob_submit_t *); 
-int MSysAddJobSubmitToQueue(mjob_submit_t *,int *,mbool_t); 
+int MSysAddJobSubmitToQueue(mjob_submit_t *,int *,mbool_t,mstring_t *); 
 int MSysDequeueJobSubmit(mjob_submit_t **); 
 int MSysGetLastEventIDFromFile(int *);
 int MJobSubmitAllocate(mjob_submit_t **);
@@ -1893,6 +1900,11 @@ int MBFFirstFit(mjob_t **,enum MPolicyTypeEnum,mnl_t *,mulong,int,int,mpar_t *);
 int MBFBestFit(mjob_t **,enum MPolicyTypeEnum,mnl_t *,mulong,int,int,mpar_t *);
 int MBFGreedy(mjob_t **,enum MPolicyTypeEnum,mnl_t *,mulong,int,int,mpar_t *);
 int MBFGetWindow(mjob_t *,long,int *,int *,mnl_t *,long *,mbool_t,char *);
+int MBFSnapInit(mbfsnap_t *,const mnl_t *);
+int MBFSnapReserve(mbfsnap_t *,const mnl_t *);
+int MBFSnapRelease(mbfsnap_t *,const mnl_t *);
+const mnl_t *MBFSnapGetNL(mbfsnap_t *);
+int MBFSnapFree(mbfsnap_t *);
 
 
 /* PBS interface object (only pbs library independent code) */
@@ -1952,6 +1964,13 @@ int MUVarsToXML(mxml_t **,mhash_t *);
 #include "MUDLList.h"
 
 
+/* lock-free multi-producer/multi-consumer queue functions */
+
+#include "MUMPMCQueue.h"
+#include "MUArena.h"
+#include "MXMLPull.h"
+
+
 int MUCmpFromString(char *,int *);
 int MUCmpFromString2(char *);
 int MUSignalFromString(char *,int *);
@@ -2140,6 +2159,7 @@ int MXMLSetChild(mxml_t *,char *,mxml_t **);
 int MXMLAddChild(mxml_t *,char const *,char const *,mxml_t **);
 int MXMLToString(mxml_t *,char *,int,char **,mbool_t);
 int MXMLToXString(mxml_t *,char **,int *,int,char const **,mbool_t);
+int MXMLToStringSize(mxml_t *,long *);
 int MXMLGetAttr(mxml_t *,const char *,int *,char *,int);
 int MXMLGetAnyAttr(mxml_t *,char *,int *,char *,int);
 int MXMLGetAttrMString(mxml_t *,const char *,int *,mstring_t *);
@@ -2378,6 +2398,9 @@ char *MLogGetTimeNewFormat(void);
 int MLogGetName(char **);
 void MLogLevelAdjust(int);
 int MLogShutdown(void);
+int MLogAsyncStart(void);
+int MLogFlush(void);
+int MLogUpdateFacilityMask(void);
 
 #ifndef __MTEST
 int MLog(const char *,...);
@@ -2677,6 +2700,8 @@ int MMRsvQueryPostLoad(mxml_t *,mrm_t *,mbool_t);
 int MTPAddRequest(int,mthread_handler_t,void *);
 int MTPCreateThreadPool(int); 
 void MTPDestroyThreadPool();
+int MTPGetStats(mtpstats_t *);
+mdb_t *MTPGetThreadDB(void);
 
 int MGetMacAddress(char *);
 
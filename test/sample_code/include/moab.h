@@ -237,6 +237,11 @@ enum MDSProtoEnum {
 
 #define MDEF_TP_HANDLER_THREADS 2 /* default number of thread pool handler threads */
 #define MMAX_TP_HANDLER_THREADS 25 /* max number of thread pool handler threads */
+#define MDEF_TP_STEALBATCH      32    /* max requests moved by one steal */
+
+#define MDEF_NODESELECTTHREADS   1   /* threads used to evaluate the feasible node list in MNodeSelectIdleTasks() */
+#define MMAX_NODESELECTTHREADS   32
+#define MMIN_NODESELECTTHREADNODES 256 /* min nodes per thread before parallel evaluation is used */
 
 #define MDEF_DYNAMIC_RM_FAILURE_WAIT_TIME 300
 
@@ -925,6 +930,8 @@ enum MCfgParamEnum {
   mcoOLDSRHostList,
   mcoOLDRMType,
   mcoThreadPoolSize,
+  mcoNodeSelectThreads,
+  mcoDBWALMode,
   mcoVMCfg,
   mcoQOSDefaultOrder,
   mcoLAST };
@@ -2486,9 +2493,15 @@ enum MNodeAffinityTypeEnum {
 
 /* See MBitMaps.[ch] */
 
+#define MBM_INLINEWORDS  3  /* words held in place - covers job, sched and partition flag sets */
+
 typedef struct mbitmap_t {
-  unsigned char *BM;      /* calloc'd: Bit Map Array - Size bytes long */
-  unsigned int Size;      /* Number of bytes in BM array */
+  unsigned int Size;      /* number of mulong words in use (0 if empty) */
+
+  union {
+    mulong  Inline[MBM_INLINEWORDS]; /* Size <= MBM_INLINEWORDS */
+    mulong *Heap;                    /* calloc'd: Size > MBM_INLINEWORDS */
+    } Data;
 
   /* default constructor */
   mbitmap_t();
@@ -3386,16 +3399,27 @@ typedef char name_t[MMAX_NAME];
 
 enum MDBActionEnum { mdbLOGFILE, mdbNOTIFY, mdbSYSLOG };
 
-#define MDB(X,F) if ((mlog.Threshold >= (X)) && (bmisset(&mlog.FacilityBM,fALL) || bmisset(&mlog.FacilityBM,F)))
-#define MDBE(X,F) if ((mlog.Threshold == (X)) && (bmisset(&mlog.FacilityBM,fALL) || bmisset(&mlog.FacilityBM,F)))
-#define MDBO(X,O,F) if ((bmisset(&mlog.FacilityBM,fALL) || bmisset(&mlog.FacilityBM,F)) && ((mlog.Threshold >= (X)) || (((O) != NULL) && ((O)->LogLevel >= (X)))))
+/* highest log level compiled in - guards with a constant level above it are
+   removed by the compiler (build with ie -DMLOGMAXLEVEL=3) */
+
+#ifndef MLOGMAXLEVEL
+#define MLOGMAXLEVEL MMAX_LOGLEVEL
+#endif /* MLOGMAXLEVEL */
+
+/* facility check against the single-word mirror of mlog.FacilityBM */
+
+#define MDBFACILITY(F) (mlog.FacilityMask & ((1UL << (F)) | (1UL << fALL)))
+
+#define MDB(X,F) if (((X) <= MLOGMAXLEVEL) && (mlog.Threshold >= (X)) && MDBFACILITY(F))
+#define MDBE(X,F) if (((X) <= MLOGMAXLEVEL) && (mlog.Threshold == (X)) && MDBFACILITY(F))
+#define MDBO(X,O,F) if (((X) <= MLOGMAXLEVEL) && MDBFACILITY(F) && ((mlog.Threshold >= (X)) || (((O) != NULL) && ((O)->LogLevel >= (X)))))
 
 #ifdef __MTEST
 #define MLog printf
 #define MUSNPrintF(X,Y,...) printf(__VA_ARGS__)
 #endif /* __MTEST */
 
-#define MDEBUG(X) if (mlog.Threshold >= X)
+#define MDEBUG(X) if (((X) <= MLOGMAXLEVEL) && (mlog.Threshold >= (X)))
 
 #endif /* MDB */
 
@@ -3988,6 +4012,10 @@ typedef struct mnodea_s {
   } mnodea_t;
 
 
+/* lists with at least this many items get a hash index of their names (see MULLAdd()) */
+
+#define MDEF_LLINDEXTHRESHOLD 32
+
 typedef struct mln_s {
   char         *Name;      /* OID (alloc) */
   int           NameLen;   /* the strlen of the name (calculated at creation time only) */
@@ -3997,6 +4025,8 @@ typedef struct mln_s {
   mbitmap_t     BM;    /* generic BM */
 
   struct mln_s *Next;  /* next structure in list */
+
+  struct mlnindex_t *Index; /* name index (alloc, only on list head, private to MULinkedList.c) */
   } mln_t;
 
 
@@ -4150,23 +4180,45 @@ enum MSystemJobErrorFlagsEnum {
 
 /** @see designdoc HashTable */
 
-#define MDEF_HASHTABLESIZE 2 /* size in power of 2 (the actual size of the table is 2^MDEF_HASHTABLESIZE ... or 4 in this case) */
-#define MDEF_HASHCHAINMAX  4 /* the largest a hash's chain should get before the table is grown and rehashed */
+#define MDEF_HASHTABLESIZE  3  /* size in power of 2 (the actual size of the table is 2^MDEF_HASHTABLESIZE ... or 8 in this case) */
+#define MDEF_HASHMAXLOAD    80 /* percentage of slots that may be full before the table is grown and rehashed */
+#define MDEF_HASHREHASHSTEP 32 /* number of old slots migrated per add/remove while an incremental rehash is in progress */
+#define MDEF_HASHINLINEKEY  24 /* keys shorter than this are stored inline in the slot (no alloc) */
+
+/* open-addressed (robin hood) hash table slot */
+
+typedef struct mhashslot_t {
+  mbool_t       Used;       /* slot holds an item */
+  unsigned int  Dist;       /* distance from the slot's home bucket (probe length) */
+  uint32_t      Hash;       /* cached MUGenHash() of the key */
+  char         *LongName;   /* key (alloc) if it does not fit in ShortName, otherwise NULL */
+  char          ShortName[MDEF_HASHINLINEKEY]; /* key (inline) */
+  void         *Ptr;        /* object */
+  mbitmap_t     BM;         /* generic BM */
+  } mhashslot_t;
 
 struct mhash_t {
 
-  int NumCollisions;  /* used for performance tracking--counts num. bucket collisions */
-  int LongestChain;   /* used for performance tracking--keeps track of the longest chain in a single bucket */
-  int HashSize;       /* current size of hash table */
-  int NumItems;       /* number of items in this hash table */
+  int NumCollisions;  /* used for performance tracking--counts items that could not be stored in their home slot */
+  int LongestChain;   /* used for performance tracking--keeps track of the longest probe distance in Table */
+  int HashSize;       /* current size of hash table (power of 2) */
+  int NumItems;       /* number of items in this hash table (including those still in OldTable) */
+
+  mhashslot_t *Table; /* the table of slots (MHASHSIZE(HashSize) long) */
 
-  mln_t **Table;      /* the table of hash buckets (each possibly holding a linked list) */
+  /* incremental rehash state - OldTable is only non-NULL while its items are 
+     being migrated into Table a few slots at a time */
+
+  mhashslot_t *OldTable;
+  int          OldHashSize;
+  int          OldNumItems;     /* items not yet migrated out of OldTable */
+  int          OldLongestChain; /* longest probe distance in OldTable */
+  unsigned int RehashIndex;     /* next OldTable slot to migrate */
   };
 
 typedef struct mhashiter_t {
 
-  unsigned int Bucket;
-  mln_t *LLNode;
+  unsigned int Bucket;  /* next slot to visit (OldTable slots first, then Table) */
 
   } mhashiter_t;
 
@@ -5036,6 +5088,20 @@ typedef struct msocket_t {
     } msocket_request_t;
 
 typedef void (* mthread_handler_t)(void *);
+
+/* thread pool counters (see MTPGetStats()) */
+
+typedef struct mtpstats_t {
+  int    NumThreads;
+  int    QueueDepth;      /* requests waiting for a pool thread */
+  int    MaxQueueDepth;   /* largest backlog seen on a single pool thread */
+  mulong NumRequests;     /* requests handed to a pool thread */
+  mulong NumSteals;       /* requests taken from another thread's deque */
+  mulong TotalWaitUS;     /* summed queued-to-started time (microseconds) */
+  mulong AvgWaitUS;       /* mean queued-to-started time (microseconds) */
+  mulong MaxWaitUS;       /* max queued-to-started time (microseconds) */
+  } mtpstats_t;
+
 typedef int (*msuhandler_f)(msocket_t *);
 typedef void (*mtpdestructor_t)(void *);
 typedef int (*mfree_t)(void **);
@@ -5611,13 +5677,66 @@ typedef struct mnalloc_old_t {
   } mnalloc_old_t ;
 
 
+/* per-iteration scratch arena (see MUArena.c) */
+
+#define MDEF_ARENABLOCKSIZE  MDEF_MBYTE  /* default size of each arena block */
+#define MDEF_ARENANLSIZE     32          /* initial capacity of arena-backed node lists */
+
+typedef struct marenablock_t {
+  struct marenablock_t *Next;
+  mulong                Size;          /* usable bytes following the header */
+  mulong                Used;
+  } marenablock_t;
+
+typedef struct marena_t {
+  marenablock_t *Head;
+  marenablock_t *Cur;           /* block currently being carved */
+  mulong         BlockSize;     /* 0 uses MDEF_ARENABLOCKSIZE */
+  mulong         Owner;         /* only this thread may allocate (set by MUArenaReset()) */
+  mbool_t        IsActive;
+  int            Depth;         /* number of open MUArenaMark() scopes */
+
+  mulong         NumAllocs;     /* requests served from the arena */
+  mulong         NumFallbacks;  /* requests passed on to MUCalloc() */
+  mulong         NumBlocks;     /* blocks malloc'd over the arena's lifetime */
+  mulong         NumResets;
+  mulong         BytesInUse;
+  mulong         PeakBytes;
+  } marena_t;
+
+typedef struct marenamark_t {
+  marenablock_t *Block;
+  mulong         Used;
+  mulong         BytesInUse;
+  int            Depth;
+  mbool_t        IsValid;
+  } marenamark_t;
+
+
 typedef struct mnl_t {
   mnalloc_old_t *Array;
 
   int Size;
+
+  marena_t *Arena;    /* set if created by MNLInitFromArena() */
+  int       ArenaDepth; /* arena scope depth at which Array may grow within the arena */
   } mnl_t;
 
 
+/* copy-on-write view of a backfill window for what-if backfill trials (see
+   MBFSnapInit()) - trials reserve nodes in the snapshot instead of changing
+   live node state, so the window and the nodes are only ever read */
+
+typedef struct mbfsnap_t {
+  const mnl_t *Base;      /* window shared by all trials (not modified) */
+  mnl_t        NL;        /* private copy of Base less reserved nodes */
+  mbool_t      NLIsValid; /* NL reflects the current reservations */
+  char        *IsRsv;     /* indexed by node index, TRUE if reserved by a trial */
+  int          IsRsvSize;
+  int          RsvCount;  /* nodes currently reserved */
+  } mbfsnap_t;
+
+
 typedef struct mpoweroff_req_t {
   mnl_t    NodeList;       /* type mnl_t List of nodes to be powered off */
   marray_t Dependencies;   /* array of type mln_t *[]. List of list of job 
@@ -5658,6 +5777,33 @@ typedef struct mdllist_t {
   } mdllist_t;
 
 
+/* bounded lock-free multi-producer/multi-consumer queue (see MUMPMCQueue.c) */
+
+#define MDEF_JOBSUBMITQUEUESIZE  131072  /* must be a power of 2 */
+#define MDEF_SOCKETQUEUESIZE      16384  /* must be a power of 2 */
+#define MDEF_SOCKETDEQUEUEBATCH      64  /* sockets taken per MSysDequeueSocketBatch() in MUIAcceptRequests() */
+
+typedef struct mmpmcqcell_t {
+  volatile mulong  Seq;    /* ticket of the enqueue/dequeue allowed to use this cell next */
+  void            *Data;
+  } mmpmcqcell_t;
+
+typedef struct mmpmcq_t {
+  mmpmcqcell_t    *Cell;
+  mulong           Mask;              /* Size - 1 */
+  char             Pad0[64];          /* keep producer/consumer tickets on separate cache lines */
+  volatile mulong  EnqueuePos;
+  char             Pad1[64];
+  volatile mulong  DequeuePos;
+  char             Pad2[64];
+#ifdef MTHREADSAFE
+  volatile int     FullWaiters;       /* producers blocked in MUMPMCQueueEnqueueWait() */
+  mmutex_t         FullMutex;
+  pthread_cond_t   NotFull;           /* signalled by consumers when FullWaiters > 0 */
+#endif /* MTHREADSAFE */
+  } mmpmcq_t;
+
+
 /* timeline */
 
 typedef struct mtl_t {
@@ -8032,6 +8178,8 @@ typedef struct mxml_t {
 
   int     Type;        /* generic XML object type */
   mfst_t *TData;       /* optional extension data (alloc) */
+
+  marena_t *Arena;     /* set if built by MXMLFromStringArena() (read-only, freed with the arena) */
   } mxml_t;
 
 /* XML Node Value encoding of a '<' */
@@ -8040,6 +8188,49 @@ typedef struct mxml_t {
 #define XML_VALUE_ANGLE_BRACKET_STR       "\016"
 
 
+/* zero-copy XML pull parser (see MXMLPull.c) */
+
+#define MMAX_XMLDEPTH  64  /* deepest element nesting accepted by MXMLPullNext() */
+
+typedef struct mxmlview_t {
+  const char *Ptr;   /* points into the parsed buffer (NOT terminated) */
+  int         Len;
+  } mxmlview_t;
+
+/* sync w/MXMLPullNext() */
+
+enum MXMLPullEventEnum {
+  mxpeNONE = 0,
+  mxpeStart,         /* '<Name ...>' or '<Name .../>' */
+  mxpeText,          /* element value (still encoded) */
+  mxpeEnd,           /* '</Name>' (also reported after '<Name/>') */
+  mxpeEOF,
+  mxpeLAST };
+
+typedef struct mxmlpull_t {
+  const char *Buf;        /* start of input (not copied) */
+  const char *End;        /* one past the last byte of input */
+  const char *Ptr;        /* next byte to scan */
+
+  enum MXMLPullEventEnum Event; /* last event returned */
+
+  mxmlview_t  Name;       /* element name (mxpeStart/mxpeEnd) */
+  mxmlview_t  Text;       /* element value, leading whitespace removed (mxpeText) */
+
+  const char *AttrStart;  /* attributes of the current start tag */
+  const char *AttrPtr;    /* next attribute for MXMLPullNextAttr() */
+  const char *AttrEnd;
+
+  int         Depth;      /* number of open elements */
+  mbool_t     IsEmptyTag; /* last start tag was '<Name/>' (mxpeEnd pending) */
+  mbool_t     IsFailed;
+
+  mxmlview_t  Open[MMAX_XMLDEPTH]; /* names of open elements */
+
+  char        EMsg[MMAX_LINE];
+  } mxmlpull_t;
+
+
 
 /* sync w/MSAN[] */
 
@@ -13966,6 +14157,11 @@ typedef struct mlog_t {
   int            Threshold;      /* External */
   mbitmap_t      FacilityBM;
 
+  /* FacilityBM as one word for MDB() - call MLogUpdateFacilityMask() after 
+     every change to FacilityBM (NOTE: fALL must stay below 32) */
+
+  unsigned long  FacilityMask;
+
   FILE          *logfp;
 
   unsigned long  LogFileMaxSize; /* External */
@@ -13973,6 +14169,8 @@ typedef struct mlog_t {
 
   char          *LogDir;         /* External (alloc) */
 
+  mbool_t        IsAsync;        /* lines are queued in per-thread rings and written by the log writer thread */
+
   char           Buffer[MMAX_BUFFER];
 
   /* memory tracker control structure used for memory usage analysis */
@@ -13982,10 +14180,12 @@ typedef struct mlog_t {
     {
     State = mlsClosed;
     Threshold = 0;
+    FacilityMask = 0;
     logfp = NULL;
     LogFileMaxSize = 0;
     LogFileRollDepth = 0;
     LogDir = NULL;
+    IsAsync = FALSE;
     }
   } mlog_t;
 
@@ -14269,6 +14469,24 @@ enum MActivityEnum {
 
 #define MCONST_ARCHIVEDIRPERM   0755
 
+typedef enum MStmtType {
+  mstmtPrepared,
+  mstmtDirect
+} MStmtType;
+
+typedef union mstmt_union {
+  struct mstmt_sqlite3_t *SQLite3;
+  struct mstmt_odbc_t    *ODBC;
+  struct mpstmt_odbc_t   *PODBC;
+  struct mdstmt_odbc_t   *DODBC;
+} mstmt_union;
+
+typedef struct mstmt_t {
+  mstmt_union StmtUnion;
+  MDBTypeEnum DBType;
+  MStmtType StmtType;
+} mstmt_t;
+
 typedef struct mdb_t {
 
   union {
@@ -14285,6 +14503,19 @@ typedef struct mdb_t {
   mbool_t WriteVCInitialized;
   mbool_t WriteRequestsInitialized;
   mbool_t InsertCPInitialized;
+
+  /* statements of MDBWrite*() and MDBInsertCP(), bound to their static buffers */
+
+  mstmt_t WriteNodesStmt;
+  mstmt_t DeleteNodeStmt;
+  mstmt_t WriteJobsStmt;
+  mstmt_t DeleteJobStmt;
+  mstmt_t DeleteRequestsStmt;
+  mstmt_t WriteRsvStmt;
+  mstmt_t WriteTriggerStmt;
+  mstmt_t WriteVCStmt;
+  mstmt_t WriteRequestsStmt;
+  mstmt_t InsertCPStmt;
 } mdb_t;
 
 /*Moab logged events struct */
@@ -15512,6 +15743,7 @@ typedef struct msched_t {
 
   struct mdb_t  MDB;
   enum MDBTypeEnum ReqMDBType;   /* database type requested by client configuration */
+  mbool_t DBWALMode;             /* (config) put SQLite databases in write-ahead-log mode */
   int  DBIterationRetries;       /* number of retries this iteration */
 
   char        *WebServicesURL;        /* URL to Web Services */
@@ -15546,6 +15778,9 @@ typedef struct msched_t {
   int         TPSize;           /* (config) size of thread pool. TPSize <= 0
                                    means do not allocate a thread pool */
 
+  int         NodeSelectThreads; /* (config) threads used to evaluate the feasible
+                                    node list in MNodeSelectIdleTasks() (1 = serial) */
+
   mbool_t DontCancelInteractiveHJobs; /* Determines if interactive jobs will
                                          be canceled or not if can't run -
                                          default = true */
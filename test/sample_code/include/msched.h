@@ -49,9 +49,11 @@
 #define MSCHED_ENVRECOVERYVAR                    "MOABRECOVERYACTION"
 #define MSCHED_ENVHOMEVAR                        "MOABHOMEDIR"
 #define MSCHED_ENVLOGSTDERRVAR                   "MOABLOGSTDERR"
+#define MSCHED_ENVLOGASYNCVAR                    "MOABASYNCLOG"
 #define MSCHED_ENVPARVAR                         "MOABPARTITION"
 #define MSCHED_ENVSMPVAR                         "MOABSMP"
 #define MSCHED_ENVTESTVAR                        "MOABTEST"
+#define MSCHED_ENVTPAFFINITYVAR                  "MOABTPAFFINITY"
 #define MSCHED_ENVCKTESTVAR                      "MOABCKTEST"
 #define MSCHED_ENVSIMTESTVAR                     "MOABSIMTEST"
 #define MSCHED_ENVDSTESTVAR                      "MOABDSTEST"
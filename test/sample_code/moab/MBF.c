@@ -16,14 +16,6 @@
 #include "moab-const.h"
  
 
-/* local prototypes */
-
-int __MBFStoreClusterState(enum MNodeStateEnum *);
-int __MBFRestoreClusterState(enum MNodeStateEnum *);
-int __MBFReserveNodes(mnl_t *);
-int __MBFReleaseNodes(enum MNodeStateEnum *,mnl_t *);
-
-
 
 /**
  * Perform preemption-based backfill scheduling.
@@ -318,6 +310,8 @@ int MBFFirstFit(
 
   mbitmap_t     BM;
   mbitmap_t     OptimizedBF;
+
+  marenamark_t  Mark;
   
   const char *FName = "MBFFirstFit";
 
@@ -373,7 +367,11 @@ int MBFFirstFit(
 
   ChunkingActive = FALSE;
 
-  MNLInit(&tmpNL);
+  /* per-job scratch node lists are drawn from the per-iteration arena */
+
+  MUArenaMark(&MSchedArena,&Mark);
+
+  MNLInitFromArena(&tmpNL,&MSchedArena);
 
   for (jindex = 0;BFQueue[jindex] != NULL;jindex++)
     {
@@ -594,7 +592,11 @@ int MBFFirstFit(
 
         long        StartTime = (long)MSched.Time;
 
-        MNLMultiInit(MNodeList);
+        marenamark_t JMark;
+
+        MUArenaMark(&MSchedArena,&JMark);
+
+        MNLMultiInitFromArena(MNodeList,&MSchedArena);
 
         MSched.BFNSDelayJobs = TRUE;
 
@@ -605,6 +607,8 @@ int MBFFirstFit(
           {
           MNLMultiFree(MNodeList);
 
+          MUArenaRelease(&MSchedArena,&JMark);
+
           continue;
           }
 
@@ -615,12 +619,16 @@ int MBFFirstFit(
           {
           MNLMultiFree(MNodeList);
 
+          MUArenaRelease(&MSchedArena,&JMark);
+
           continue;
           }
 
         MNLCopy(&J->Req[0]->NodeList,MNodeList[0]);
 
         MNLMultiFree(MNodeList);
+
+        MUArenaRelease(&MSchedArena,&JMark);
         }    /* END if (MJobAllocMNL() == FAILURE) */
  
       /* job is feasible */
@@ -774,6 +782,8 @@ int MBFFirstFit(
  
   MNLFree(&tmpNL);
 
+  MUArenaRelease(&MSchedArena,&Mark);
+
   MDB(2,fSCHED) MLog("INFO:     partition %s nodes/procs available after %s: %d/%d (%d jobs examined)\n",
     P->Name,
     FName,
@@ -788,75 +798,115 @@ int MBFFirstFit(
 
 
 /**
+ * Initialize a what-if snapshot of backfill window Base.
  *
+ * The snapshot shares Base and the live node state with the caller and
+ * with any other snapshot of the same window.  Nodes a trial reserves
+ * (MBFSnapReserve()) are only recorded in the snapshot, and a private
+ * copy of the window without them is made when it is next requested
+ * (MBFSnapGetNL()).  Neither Base nor any node is modified, so trials
+ * need no rollback and do not see each other's reservations.
  *
- * @param NSList
+ * @see MBFSnapFree()
+ * @see MBFGreedy() - parent
+ *
+ * @param S    (O)
+ * @param Base (I) [not modified, must outlive S]
  */
 
-int __MBFStoreClusterState(
- 
-  enum MNodeStateEnum *NSList)
- 
+int MBFSnapInit(
+
+  mbfsnap_t   *S,
+  const mnl_t *Base)
+
   {
-  int nindex;
+  if ((S == NULL) || (Base == NULL))
+    {
+    return(FAILURE);
+    }
 
-  mnode_t *N;
+  memset(S,0,sizeof(mbfsnap_t));
 
-  for (nindex = 0;nindex < MSched.M[mxoNode];nindex++)
+  S->Base = Base;
+
+  /* size the private copy for the whole window up front */
+
+  if ((MNLInit(&S->NL) == FAILURE) ||
+      (MNLSetNodeAtIndex(&S->NL,MAX(Base->Size,1),NULL) == FAILURE))
     {
-    N = MNode[nindex];
+    MNLFree(&S->NL);
+
+    return(FAILURE);
+    }
+
+  S->IsRsv = (char *)MUCalloc(MSched.M[mxoNode],sizeof(char));
+
+  if (S->IsRsv == NULL)
+    {
+    MNLFree(&S->NL);
+
+    return(FAILURE);
+    }
+
+  S->IsRsvSize = MSched.M[mxoNode];
 
-    if (N != NULL)    
-      NSList[nindex] = N->State;
-    else
-      NSList[nindex] = mnsNONE;
-    }  /* END for (nindex) */
- 
   return(SUCCESS);
-  }  /* END __MBFStoreClusterState() */
- 
- 
- 
- 
+  }  /* END MBFSnapInit() */
+
+
+
+
+
 /**
+ * Reserve the nodes in NL within snapshot S.
  *
+ * @see MBFSnapRelease()
  *
- * @param NSList
+ * @param S  (I) [modified]
+ * @param NL (I)
  */
 
-int __MBFRestoreClusterState(
- 
-  enum MNodeStateEnum *NSList)
- 
+int MBFSnapReserve(
+
+  mbfsnap_t   *S,
+  const mnl_t *NL)
+
   {
   int nindex;
 
   mnode_t *N;
 
-  for (nindex = 0;nindex < MSched.M[mxoNode];nindex++)
+  for (nindex = 0;MNLGetNodeAtIndex(NL,nindex,&N) == SUCCESS;nindex++)
     {
-    N = MNode[nindex];
+    if ((N->Index < 0) || (N->Index >= S->IsRsvSize) || (S->IsRsv[N->Index] == TRUE))
+      continue;
+
+    S->IsRsv[N->Index] = TRUE;
 
-    if (N != NULL)
-      N->State = NSList[nindex];
+    S->RsvCount++;
+
+    S->NLIsValid = FALSE;
     }  /* END for (nindex) */
- 
+
   return(SUCCESS);
-  }  /* END __MBFRestoreClusterState() */ 
+  }  /* END MBFSnapReserve() */
+
+
 
 
 
- 
 /**
+ * Release the nodes in NL reserved by MBFSnapReserve().
  *
- *
- * @param NL
+ * @param S  (I) [modified]
+ * @param NL (I)
  */
 
-int __MBFReserveNodes(
- 
-  mnl_t *NL)
- 
+int MBFSnapRelease(
+
+  mbfsnap_t   *S,
+  const mnl_t *NL)
+
   {
   int nindex;
 
@@ -864,40 +914,110 @@ int __MBFReserveNodes(
 
   for (nindex = 0;MNLGetNodeAtIndex(NL,nindex,&N) == SUCCESS;nindex++)
     {
-    N->State = mnsReserved;
+    if ((N->Index < 0) || (N->Index >= S->IsRsvSize) || (S->IsRsv[N->Index] == FALSE))
+      continue;
+
+    S->IsRsv[N->Index] = FALSE;
+
+    S->RsvCount--;
+
+    S->NLIsValid = FALSE;
     }  /* END for (nindex) */
- 
+
   return(SUCCESS);
-  }  /* END __MBFReserveNodes() */
- 
- 
- 
- 
- 
+  }  /* END MBFSnapRelease() */
+
+
+
+
+
 /**
+ * Return the backfill window as seen by snapshot S, i.e. its base window
+ * less the nodes reserved in S, in base window order.
  *
+ * NOTE:  returns the shared base window itself while nothing is reserved,
+ *        otherwise the private copy is rebuilt once per reservation change.
  *
- * @param NSList
- * @param NL
+ * @param S (I) [modified]
  */
 
-int __MBFReleaseNodes(
- 
-  enum MNodeStateEnum   *NSList,
-  mnl_t *NL)
- 
+const mnl_t *MBFSnapGetNL(
+
+  mbfsnap_t *S)
+
   {
-  int nindex = 0;
+  const mnalloc_old_t *B;
+
+  int nindex;
+  int sindex;
 
   mnode_t *N;
 
-  for (nindex = 0;MNLGetNodeAtIndex(NL,nindex,&N) == SUCCESS;nindex++)
+  if (S->RsvCount == 0)
+    {
+    return(S->Base);
+    }
+
+  if (S->NLIsValid == TRUE)
+    {
+    return(&S->NL);
+    }
+
+  /* NL was sized for all of Base by MBFSnapInit() */
+
+  B = S->Base->Array;
+
+  sindex = 0;
+
+  for (nindex = 0;nindex < S->Base->Size;nindex++)
     {
-    N->State = NSList[N->Index];
+    if ((N = B[nindex].N) == NULL)
+      break;
+
+    if ((N->Index >= 0) && (N->Index < S->IsRsvSize) && (S->IsRsv[N->Index] == TRUE))
+      continue;
+
+    S->NL.Array[sindex++] = B[nindex];
     }  /* END for (nindex) */
- 
+
+  S->NL.Array[sindex].N  = NULL;
+  S->NL.Array[sindex].TC = 0;
+
+  S->NLIsValid = TRUE;
+
+  return(&S->NL);
+  }  /* END MBFSnapGetNL() */
+
+
+
+
+
+/**
+ * Free the memory held by snapshot S (the base window is not touched).
+ *
+ * @param S (I) [freed]
+ */
+
+int MBFSnapFree(
+
+  mbfsnap_t *S)
+
+  {
+  if (S == NULL)
+    {
+    return(FAILURE);
+    }
+
+  MNLFree(&S->NL);
+
+  MUFree(&S->IsRsv);
+
+  S->IsRsvSize = 0;
+  S->RsvCount  = 0;
+  S->NLIsValid = FALSE;
+
   return(SUCCESS);
-  }  /* END __MBFReleaseNodes() */
+  }  /* END MBFSnapFree() */
 
 
 
@@ -1908,7 +2028,7 @@ int MBFGreedy(
   mnl_t    NodeList;
   mnl_t    tmpNL;
 
-  enum MNodeStateEnum *NSList = NULL;
+  mbfsnap_t    Snap;
 
   static int   ReservationMisses = 0;
 
@@ -1952,8 +2072,13 @@ int MBFGreedy(
 
   SPC = 0;
 
-  NSList = (enum MNodeStateEnum *)MUCalloc(1,sizeof(enum MNodeStateEnum) * MSched.M[mxoNode]);
-  __MBFStoreClusterState(NSList);
+  /* trial schedules reserve nodes in a snapshot of the window, live node
+     state is left alone until the best schedule is launched */
+
+  if (MBFSnapInit(&Snap,BFNodeList) == FAILURE)
+    {
+    return(FAILURE);
+    }
 
   MDB(4,fSCHED) MLog("INFO:     attempting greedy backfill w/%d procs, %ld time\n",
     BFProcCount,
@@ -1985,7 +2110,7 @@ int MBFGreedy(
 
   if (MNodeMapInit(&NodeMap) == FAILURE)
     {
-    MUFree((char **)&NSList);
+    MBFSnapFree(&Snap);
 
     return(FAILURE);
     }
@@ -2008,13 +2133,11 @@ int MBFGreedy(
         (void *)BestList[0],
         (void *)BestList[1]);
   
-      __MBFRestoreClusterState(NSList);
- 
       MNLMultiFree(MNodeList);
       MNLFree(&NodeList);
       MNLFree(&tmpNL);
 
-      MUFree((char **)&NSList);
+      MBFSnapFree(&Snap);
       MUFree(&NodeMap);
 
       return(FAILURE);
@@ -2184,7 +2307,7 @@ int MBFGreedy(
             J,
             J->Req[0],
             P,
-            BFNodeList,
+            MBFSnapGetNL(&Snap),
             &tmpNL,
             NULL,
             NULL,
@@ -2251,7 +2374,7 @@ int MBFGreedy(
 
       MJobGetNL(J,&NodeList);
 
-      __MBFReserveNodes(&NodeList);
+      MBFSnapReserve(&Snap,&NodeList);
 
       MDB(6,fSCHED) MLog("INFO:     reservation added for Job[%03d] '%s'\n",
         sindex,
@@ -2367,13 +2490,13 @@ int MBFGreedy(
 
       MJobGetNL(J,&NodeList);
 
-      __MBFReleaseNodes(NSList,&NodeList);
+      MBFSnapRelease(&Snap,&NodeList);
       }    /* END else if (sindex == 0) */
 
     StartIndex = BFIndex[sindex] + 1;
     }   /* END  while(scount++ < GP->BFMaxSchedules) */
 
-  __MBFRestoreClusterState(NSList);
+  MBFSnapFree(&Snap);
 
   if (BestValue == 0)
     {
@@ -2385,7 +2508,6 @@ int MBFGreedy(
     MNLFree(&NodeList);
     MNLFree(&tmpNL);
 
-    MUFree((char **)&NSList);
     MUFree(&NodeMap);
 
     return(SUCCESS);
@@ -2564,7 +2686,6 @@ int MBFGreedy(
   MNLFree(&NodeList);
   MNLFree(&tmpNL);
   MUFree(&NodeMap);
-  MUFree((char **)&NSList);
 
   MDB(2,fSCHED) MLog("INFO:     partition %s nodes/procs available after %s: %d/%d\n",
     P->Name,
@@ -19,17 +19,77 @@
 using namespace std;
 
 /**
- *    the BM attribute is an array of unsigned chars, which grows depending on
- *    the bit to be set/unset.  
- *    the Size attribute is the number of chars in the BM array
+ *    bits are stored in mulong words (bit N is word N / MBM_WORDBITS).  up to
+ *    MBM_INLINEWORDS words live inside the object itself so the common small
+ *    flag sets never touch the heap, larger maps spill to a calloc'd array.
+ *    the Size attribute is the number of words in use.
+ *
+ *    NOTE: an all-zero mbitmap_t is a valid empty map (structs holding
+ *          bitmaps are routinely memset()).
  */
 
-#define MDEF_BMSIZE 128
+#define MBM_WORDBITS    (sizeof(mulong) * 8)
 
 /* isolation macros */
 
-#define OFFSET(bit)     ((bit) >> 3)
-#define OFFSETBIT(bit)  (1 << ((bit) % 8))
+#define WORD(bit)       ((bit) / MBM_WORDBITS)
+#define WORDBIT(bit)    ((mulong)1 << ((bit) % MBM_WORDBITS))
+
+#define MBMISINLINE(M)  ((M)->Size <= MBM_INLINEWORDS)
+#define MBMWORDS(M)     (MBMISINLINE(M) ? (M)->Data.Inline : (M)->Data.Heap)
+
+
+/**
+ * Make sure BM holds at least Words words, new words are cleared.
+ *
+ * @param BM    (I/O)
+ * @param Words (I)
+ */
+
+int __bmgrow(
+
+  mbitmap_t    *BM,
+  unsigned int  Words)
+
+  {
+  mulong *tmp;
+
+  if (Words <= BM->Size)
+    return(SUCCESS);
+
+  if (Words <= MBM_INLINEWORDS)
+    {
+    memset(BM->Data.Inline + BM->Size,0,(Words - BM->Size) * sizeof(mulong));
+    }
+  else if (MBMISINLINE(BM))
+    {
+    /* spill inline words to the heap */
+
+    tmp = (mulong *)calloc(Words,sizeof(mulong));
+
+    if (tmp == NULL)
+      return(FAILURE);
+
+    memcpy(tmp,BM->Data.Inline,BM->Size * sizeof(mulong));
+
+    BM->Data.Heap = tmp;
+    }
+  else
+    {
+    tmp = (mulong *)realloc(BM->Data.Heap,Words * sizeof(mulong));
+
+    if (tmp == NULL)
+      return(FAILURE);
+
+    memset(tmp + BM->Size,0,(Words - BM->Size) * sizeof(mulong));
+
+    BM->Data.Heap = tmp;
+    }
+
+  BM->Size = Words;
+
+  return(SUCCESS);
+  }  /* END __bmgrow() */
 
 
 /* Object methods */
@@ -39,16 +99,13 @@ using namespace std;
 mbitmap_t::mbitmap_t()
   {
   this->Size = 0;
-  this->BM = NULL;
+  memset(&this->Data,0,sizeof(this->Data));
   } /* END mbitmap_t */
 
 /* destructor */
 mbitmap_t::~mbitmap_t()
   {
-  if (BM != NULL)
-    free(BM);
-  BM = NULL;
-  Size = 0;
+  clear();
   } /* END ~mbitmap_t */
 
 
@@ -57,26 +114,47 @@ mbitmap_t::~mbitmap_t()
 /* assignment operator */
 mbitmap_t & mbitmap_t::operator= (const mbitmap_t &rhs) 
   {
-  /* Clear the Dest object */
-  clear();
-
   /* check for NULL rhs - yeah, moab does that */
   if (NULL == &rhs)
+    {
+    clear();
+
     return(*this);
+    }
 
   /* check for self reference */
   if (this == &rhs)
     return(*this);
-    
-  /* if RHS has data, copy it to the Dest */
-  if ((rhs.BM != NULL) && (rhs.Size > 0 ))
+
+  if (MBMISINLINE(&rhs))
     {
+    clear();
+
+    Data = rhs.Data;
     Size = rhs.Size;
-    
-    BM = (unsigned char *) calloc(1,Size);
+    }
+  else
+    {
+    /* reuse our heap array when it is already the right size */
+
+    if (Size != rhs.Size)
+      {
+      mulong *tmp = (mulong *)malloc(rhs.Size * sizeof(mulong));
 
-    /* Copy the existing BM from RHS to Dest */
-    std::copy(rhs.BM, rhs.BM + rhs.Size, BM);
+      if (tmp == NULL)
+        {
+        clear();
+
+        return(*this);
+        }
+
+      clear();
+
+      Data.Heap = tmp;
+      Size = rhs.Size;
+      }
+
+    memcpy(Data.Heap,rhs.Data.Heap,Size * sizeof(mulong));
     }
 
   return *this;
@@ -84,20 +162,31 @@ mbitmap_t & mbitmap_t::operator= (const mbitmap_t &rhs)
 
 /* Copy constructor */
 mbitmap_t::mbitmap_t(const mbitmap_t& rhs) 
-        : BM( (unsigned char *) calloc(1,rhs.Size)), Size(rhs.Size)
+        : Size(rhs.Size)
   {
-  std::copy(rhs.BM, rhs.BM + rhs.Size, BM);
+  if (MBMISINLINE(&rhs))
+    {
+    Data = rhs.Data;
+    }
+  else
+    {
+    Data.Heap = (mulong *)malloc(Size * sizeof(mulong));
+
+    if (Data.Heap == NULL)
+      Size = 0;
+    else
+      memcpy(Data.Heap,rhs.Data.Heap,Size * sizeof(mulong));
+    }
   }  /* END mbitmap_t copy constructor */
 
 /* bmclear method */
 void mbitmap_t::clear(void)
   {
-  if (BM == NULL)
-    return;
+  if (!MBMISINLINE(this))
+    free(Data.Heap);
 
-  free(BM);
+  memset(&Data,0,sizeof(Data));
 
-  BM = NULL;
   Size = 0;
   }  /* END clear() */
 
@@ -113,20 +202,17 @@ std::string mbitmap_t::ToString(void)
   {
   string        retString("<empty>");
 
-  if ((0 == Size) || (NULL == BM))    /* if no bits, then it is empty */
+  if (0 == Size)    /* if no bits, then it is empty */
     return retString;
 
   retString = "";      /* Init to NULL string */
 
-  /* Calc the number of bits contained in this BM, based on Size bytes of BM */
-  int   bitCount = Size * 8;
+  /* Calc the number of bits contained in this BM, based on Size words of BM */
+  int   bitCount = Size * MBM_WORDBITS;
 
   /* iterate over the bitmap, "toString" each bit */
   for (int bit = 0; bit < bitCount; bit++)
     {
-    unsigned int Offset = OFFSET(bit);
-    unsigned int OffsetBit = OFFSETBIT(bit);
-
     /* Check for a spacer ('_') is needed now in the sequence */
     if ((bit > 0) && ((bit % 8) == 0))
       {
@@ -134,7 +220,7 @@ std::string mbitmap_t::ToString(void)
       }
 
     /* Determine if bit SET or ZERO */
-    if (((*(BM + Offset)) & OffsetBit) != 0)
+    if ((MBMWORDS(this)[WORD(bit)] & WORDBIT(bit)) != 0)
       {
         retString += "1";
       }
@@ -310,12 +396,15 @@ void bmcopy(
   const mbitmap_t *SrcFlagBM)
 
   {
-  if (DstFlagBM != NULL)
-    DstFlagBM->clear();
-
+  if (DstFlagBM == NULL)
+    return;
 
   if (SrcFlagBM == NULL)
+    {
+    DstFlagBM->clear();
+
     return;
+    }
 
   /* Use the assignment operator override to do this */
 
@@ -385,10 +474,7 @@ void bmsetbool(
 /**
  * Report TRUE if bitmap has no values set.
  *
- * NOTE:  broken!  does not check last entry in array!
- *
  * @param Map (I)
- * @param Size (I) [in bits] size of bitmap
  */
 
 mbool_t bmisclear(
@@ -396,16 +482,20 @@ mbool_t bmisclear(
   const mbitmap_t *Map)
 
   {
+  const mulong *W;
+
   unsigned int index;
 
   if ((Map == NULL) || (Map->Size == 0))
     return(TRUE);
-    
+
+  W = MBMWORDS(Map);
+
   for (index = 0;index < Map->Size;index++)
     {
-    if (Map->BM[index] != '\0')
+    if (W[index] != 0)
       return(FALSE);
-    } 
+    }
 
   return(TRUE);
   }  /* END bmisclear() */
@@ -427,12 +517,23 @@ void bmsetall(
   unsigned int   LastEnumOrMaxSize)  /* ie: MMAX_PAR or mjfLAST */
 
   {
+  mulong *W;
+
   unsigned int index;
 
-  for (index = 0;index < LastEnumOrMaxSize;index++)
-    {
-    bmset(FlagBM,index);
-    }
+  if ((FlagBM == NULL) || (LastEnumOrMaxSize == 0))
+    return;
+
+  if (__bmgrow(FlagBM,WORD(LastEnumOrMaxSize - 1) + 1) == FAILURE)
+    return;
+
+  W = MBMWORDS(FlagBM);
+
+  for (index = 0;index < WORD(LastEnumOrMaxSize);index++)
+    W[index] = ~(mulong)0;
+
+  if (LastEnumOrMaxSize % MBM_WORDBITS)
+    W[index] |= WORDBIT(LastEnumOrMaxSize) - 1;
 
   return;
   }  /* END bmsetall() */
@@ -457,14 +558,28 @@ mbool_t bmissetall(
   unsigned int     LastEnumOrMaxSize)  /* ie: MMAX_PAR or mjfLAST */
 
   {
+  const mulong *W;
+
   unsigned int index;
 
-  for (index = 0;index < LastEnumOrMaxSize;index++)
+  if (LastEnumOrMaxSize == 0)
+    return(TRUE);
+
+  if ((FlagBM == NULL) || (FlagBM->Size < WORD(LastEnumOrMaxSize - 1) + 1))
+    return(FALSE);
+
+  W = MBMWORDS(FlagBM);
+
+  for (index = 0;index < WORD(LastEnumOrMaxSize);index++)
     {
-    if (!bmisset(FlagBM,index))
+    if (W[index] != ~(mulong)0)
       return(FALSE);
     }
 
+  if ((LastEnumOrMaxSize % MBM_WORDBITS) &&
+     ((W[index] & (WORDBIT(LastEnumOrMaxSize) - 1)) != WORDBIT(LastEnumOrMaxSize) - 1))
+    return(FALSE);
+
   return(TRUE);
   }  /* END bmissetall() */
 
@@ -472,9 +587,10 @@ mbool_t bmissetall(
 /**
  * Return 0 if the BMs are equal.
  *
+ * NOTE: the shorter map is treated as zero-extended.
+ *
  * @param BM1
  * @param BM2
- * @param LastEnumOrMaxSize
  */
 
 int bmcompare(
@@ -483,7 +599,12 @@ int bmcompare(
   const mbitmap_t *BM2)
 
   {
-  unsigned int Max;
+  const mulong *W1;
+  const mulong *W2;
+
+  mulong Diff = 0;
+
+  unsigned int Min;
   unsigned int index;
 
   if ((BM1 == NULL) && (BM2 == NULL))
@@ -491,38 +612,26 @@ int bmcompare(
     return(0);
     }
 
-  if ((BM1 == NULL) && (BM2 != NULL))
+  if ((BM1 == NULL) || (BM2 == NULL))
     {
     return(1);
     }
 
-  if ((BM1 != NULL) && (BM2 == NULL))
-    {
-    return(1);
-    }
+  W1 = MBMWORDS(BM1);
+  W2 = MBMWORDS(BM2);
 
-  Max = MAX(BM1->Size,BM2->Size);
+  Min = MIN(BM1->Size,BM2->Size);
 
-  for (index = 0;index < Max;index++)
-    {
-    if ((index < BM1->Size) && (index < BM2->Size) &&
-        (BM1->BM[index] != BM2->BM[index]))
-      {
-      return(1);
-      }
+  for (index = 0;index < Min;index++)
+    Diff |= W1[index] ^ W2[index];
 
-    if ((index > BM1->Size) && (BM2->BM[index] != '\0'))
-      {
-      return(1);
-      }
+  for (index = Min;index < BM1->Size;index++)
+    Diff |= W1[index];
 
-    if ((index > BM2->Size) && (BM1->BM[index] != '\0'))
-      {
-      return(1);
-      }
-    } /* END for (index) */
+  for (index = Min;index < BM2->Size;index++)
+    Diff |= W2[index];
 
-  return(0);
+  return((Diff != 0) ? 1 : 0);
   }  /* END bmcompare() */
 
 
@@ -604,16 +713,12 @@ mbool_t bmisset(
   unsigned int      Bit)
 
   {
-  unsigned int Offset = OFFSET(Bit);
-  unsigned int OffsetBit = OFFSETBIT(Bit);
+  unsigned int Word = WORD(Bit);
 
-  if (FlagBM == NULL)
+  if ((FlagBM == NULL) || (Word >= FlagBM->Size))
     return(FALSE);
 
-  if (Offset >= FlagBM->Size)
-    return(FALSE);
-
-  if (((*(FlagBM->BM + Offset)) & OffsetBit) != 0)
+  if ((MBMWORDS(FlagBM)[Word] & WORDBIT(Bit)) != 0)
     return(TRUE);
 
   return(FALSE);
@@ -636,49 +741,16 @@ void bmset(
   unsigned int   Bit)
 
   {
+  unsigned int Word = WORD(Bit);
+
   if (FlagBM == NULL)
     return;
 
-  unsigned char *tmp;
-  unsigned int Offset = OFFSET(Bit);
-  unsigned int OffsetBit = OFFSETBIT(Bit);
-  unsigned int newSize = Offset + 1;
-
-  /* Check if the BM is currently empty: BM == NULL, then empty */
-  if (FlagBM->BM == NULL)
-    {
-    /* calloc the memory and check it BEFORE storing it */
-    tmp = (unsigned char *) calloc(1,newSize);
-    if (NULL == tmp)
-      return;
-
-    FlagBM->BM = tmp;
-    FlagBM->Size = newSize;
-    }
-  else if (Offset >= FlagBM->Size)
-    {
-    unsigned int index;
-
-    /* resize to larger buffer */
-
-    /* calloc the memory and check it BEFORE storing it */
-    tmp = (unsigned char *)realloc(FlagBM->BM,newSize);
-    if (NULL == tmp)
-      return;
-
-    FlagBM->BM = tmp;
-
-    /* Ensure the fresh bits are cleared first */
-    for (index = FlagBM->Size;index < newSize;index++)
-      {
-      FlagBM->BM[index] = 0;
-      }
-
-    FlagBM->Size = newSize;
-    }
+  if ((Word >= FlagBM->Size) && (__bmgrow(FlagBM,Word + 1) == FAILURE))
+    return;
 
   /* set the bit now */
-  *(FlagBM->BM + Offset) |= OffsetBit;
+  MBMWORDS(FlagBM)[Word] |= WORDBIT(Bit);
 
   }  /* END bmset() */
     
@@ -698,22 +770,22 @@ void bmunset(
   unsigned int   Bit)
 
   {
-  unsigned int Offset = OFFSET(Bit);
-  unsigned int OffsetBit = OFFSETBIT(Bit);
+  unsigned int Word = WORD(Bit);
 
-  if (Offset >= FlagBM->Size)
+  if ((FlagBM == NULL) || (Word >= FlagBM->Size))
     return;
 
-  (*(FlagBM->BM + Offset)) &= ~(OffsetBit);
+  MBMWORDS(FlagBM)[Word] &= ~WORDBIT(Bit);
   }  /* END bmunset() */
 
 
 /**
  * Logically OR Src and Dst maps with result in Dst.
  *
+ * NOTE: Dst only grows as far as the last non-zero word of Src.
+ *
  * @param DstFlagBM (I/O)
  * @param SrcFlagBM (I)
- * @param MapSize   (I)  Number of bits in bitmap
  */
 
 void bmor(
@@ -722,21 +794,31 @@ void bmor(
   const mbitmap_t *SrcFlagBM)
 
   {
-  unsigned int NumFlagBits;
+  const mulong *S;
+  mulong       *D;
+
+  unsigned int Words;
   unsigned int index;
 
-  if ((SrcFlagBM == NULL) || (DstFlagBM == NULL))
+  if ((SrcFlagBM == NULL) || (DstFlagBM == NULL) || (SrcFlagBM == DstFlagBM))
     {
     return;
     }
 
-  NumFlagBits = SrcFlagBM->Size * 8;
+  S = MBMWORDS(SrcFlagBM);
 
-  for (index = 0;index < NumFlagBits;index++)
-    {
-    if (bmisset(SrcFlagBM,index))
-      bmset(DstFlagBM,index);
-    }  /* END for (index) */
+  for (Words = SrcFlagBM->Size;(Words > 0) && (S[Words - 1] == 0);Words--);
+
+  if (Words == 0)
+    return;
+
+  if (__bmgrow(DstFlagBM,Words) == FAILURE)
+    return;
+
+  D = MBMWORDS(DstFlagBM);
+
+  for (index = 0;index < Words;index++)
+    D[index] |= S[index];
   }  /* END bmor() */
 
 
@@ -748,7 +830,6 @@ void bmor(
  *
  * @param DstFlagBM (I/O)
  * @param SrcFlagBM (I)
- * @param MapSize   (I)  Number of bits in bitmap
  */
 
 void bmand(
@@ -757,24 +838,29 @@ void bmand(
   const mbitmap_t *SrcFlagBM)
 
   {
-  unsigned int NumFlagBits;
+  const mulong *S;
+  mulong       *D;
+
+  unsigned int Min;
   unsigned int index;
 
-  if ((SrcFlagBM == NULL) || (DstFlagBM == NULL))
+  if ((SrcFlagBM == NULL) || (DstFlagBM == NULL) || (SrcFlagBM == DstFlagBM))
     {
     return;
     }
 
+  S = MBMWORDS(SrcFlagBM);
+  D = MBMWORDS(DstFlagBM);
 
-  NumFlagBits = SrcFlagBM->Size * 8;
+  Min = MIN(SrcFlagBM->Size,DstFlagBM->Size);
 
-  for (index = 0;index < NumFlagBits;index++)
-    {
-    if (bmisset(SrcFlagBM,index) && bmisset(DstFlagBM,index))
-      bmset(DstFlagBM,index);
-    else
-      bmunset(DstFlagBM,index);
-    }  /* END for (index) */
+  for (index = 0;index < Min;index++)
+    D[index] &= S[index];
+
+  /* bits past the end of Src are clear in Src */
+
+  for (index = Min;index < DstFlagBM->Size;index++)
+    D[index] = 0;
   }  /* END bmand() */
 
 
@@ -784,6 +870,9 @@ void bmand(
 /**
  * Logically NOT Dst map.
  *
+ * NOTE: historically this clears the first MapSize * 8 bits rather than
+ *       inverting them, callers rely on that.
+ *
  * @param DstFlagBM (I/O)
  * @param MapSize   (I)  Number of bits in bitmap
  */
@@ -794,6 +883,8 @@ void bmnot(
   unsigned int   MapSize)
 
   {
+  mulong *W;
+
   unsigned int NumFlagBits;
   unsigned int index;
 
@@ -804,11 +895,13 @@ void bmnot(
 
   NumFlagBits = MapSize * 8;
 
-  for (index = 0;index < NumFlagBits;index++)
-    {
-    if (bmisset(DstFlagBM,index))
-     bmunset(DstFlagBM,index);
-    }  /* END for (index) */
+  W = MBMWORDS(DstFlagBM);
+
+  for (index = 0;(index < DstFlagBM->Size) && (index < WORD(NumFlagBits));index++)
+    W[index] = 0;
+
+  if ((index < DstFlagBM->Size) && (index == WORD(NumFlagBits)))
+    W[index] &= ~(WORDBIT(NumFlagBits) - 1);
   }  /* END bmnot() */
 
 /* END MBitMaps.c */
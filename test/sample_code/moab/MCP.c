@@ -53,7 +53,9 @@ static const enum MStatAttrEnum DefCPStatAList[] = {
 /* GLOBALS */
 msubjournal_t MSubJournal;
 
-mhash_t MCPHashTable;
+mhash_t MCPHashTable;                   /* MCP.Buffer line index (see MCPBuildHashTable()) */
+
+static const char *MCPHashTableBuffer = NULL;  /* buffer MCPHashTable points into */
 
 /**
  * Create checkpoint records for all jobs in specified job list.
@@ -679,83 +681,84 @@ int MCPCreate(
 
 
 /**
- *  Build a hash table for each line in the checkpoint file for processing on 
- *  moab boot for increased speed.
+ * Index every line of a checkpoint buffer by its '<TYPE> <NAME> ' prefix
+ * (the key MCPGetLine() looks up) so objects can be restored without
+ * scanning the buffer.
+ *
+ * The index points into Buffer, which must stay loaded and unmodified while
+ * the index is in use.  If a key appears on more than one line the first
+ * line wins, as it would for a scan from the top of the buffer.
  *
- *  NOTE: Only used before iteration 1 since checkpoint file can be modified 
- *        after iteration 0. 
+ * @see MCPGetLine() - peer
  *
- * @param tmpPtr (I)  Pointer to a copy of the MCP.Buffer
+ * @param Buffer (I) checkpoint file contents (MCP.Buffer)
  */
 
 int MCPBuildHashTable(
 
-  char *tmpPtr)
+  const char *Buffer)  /* I */
 
   {
-  char  HashString[MMAX_LINE];
-  char  EndType[MMAX_LINE];
-  char  EndName[MMAX_LINE];
-  char  EndTime[MMAX_LINE];
+  char        HashString[MMAX_LINE];
 
-  static mbool_t MCPHashTableCreated = FALSE;
- 
-  if (tmpPtr == NULL)
-    {
-    return(FAILURE);
-    }
+  const char *ptr;
+  const char *tail;
 
-  if (MSched.Iteration > 0)
-    {
-    return(FAILURE);
-    }
+  int         len;
 
-  if (MCPHashTableCreated == TRUE)
+  if (Buffer == NULL)
     {
     return(FAILURE);
     }
- 
+
+  MUHTFree(&MCPHashTable,FALSE,NULL);
+
   MUHTCreate(&MCPHashTable,-1);
 
-  MCPHashTableCreated = TRUE;
+  MCPHashTableBuffer = Buffer;
 
-  while (tmpPtr != NULL)
+  /* FORMAT:  <TYPE> <NAME> <TIME> <DATA>\n (see MCPStoreObj()) */
+
+  for (ptr = Buffer;*ptr != '\0';ptr = tail + 1)
     {
-    EndType[0] = '\0';
-    EndName[0] = '\0';
-    EndTime[0] = '\0';
+    tail = ptr;
+
+    while ((*tail != '\0') && (*tail != ' ') && (*tail != '\n'))
+      tail++;
 
-    if ((sscanf(tmpPtr,"%s%s%s",EndType,EndName,EndTime) == 3) && (strtol(EndTime,NULL,10) > 0))
+    if (tail > ptr)
       {
-      char *cpyLoc;
+      while (*tail == ' ')
+        tail++;
 
-      cpyLoc = strstr(tmpPtr,EndTime);
+      while ((*tail != '\0') && (*tail != ' ') && (*tail != '\n'))
+        tail++;
 
-      if (cpyLoc != NULL)
+      len = tail - ptr + 1;
+
+      if ((*tail == ' ') && (len < (int)sizeof(HashString)))
         {
-        MUStrCpy(HashString,tmpPtr,(cpyLoc - tmpPtr) + 1);
+        memcpy(HashString,ptr,len);
+
+        HashString[len] = '\0';
 
-        if (!MUStrIsEmpty(HashString))
+        if (MUHTGet(&MCPHashTable,HashString,NULL,NULL) == FAILURE)
           {
           MUHTAdd(
             &MCPHashTable,
-            HashString,   /* I hash key */
-            tmpPtr,       /* I object pointer */
+            HashString,    /* I hash key */
+            (void *)ptr,   /* I start of line */
             NULL,
             NULL);
           }
         }
       }
 
-    /* Get pointer to the next record */
+    /* advance to the next record */
 
-    tmpPtr = strchr(tmpPtr,'\n');
-
-    if (tmpPtr != NULL)
-      {
-      tmpPtr++; /* advance beyond the line feed at the end of the last record */
-      }
-    }    /* END while (tmpPtr != NULL) */ 
+    if ((tail = strchr(tail,'\n')) == NULL)
+      break;
+    }    /* END for (ptr) */
 
   return(SUCCESS);
   }  /* END MCPBuildHashTable() */
@@ -764,6 +767,60 @@ int MCPBuildHashTable(
 
 
 
+/**
+ * Find the line holding the checkpoint record of the given object in
+ * MCP.Buffer.  The line is newline terminated, not NUL terminated.
+ *
+ * The buffer is indexed on first use (and again if MCP.Buffer is replaced),
+ * so each lookup costs one hash probe regardless of iteration or file size.
+ *
+ * @see MCPBuildHashTable() - child
+ * @see MCPRestore() - parent
+ *
+ * @param CKIndex (I)
+ * @param OName   (I)
+ * @param LineP   (O)
+ */
+
+int MCPGetLine(
+
+  enum MCkptTypeEnum  CKIndex, /* I */
+  const char         *OName,   /* I */
+  char              **LineP)   /* O */
+
+  {
+  char CPLineKey[MMAX_LINE];
+
+  if (LineP != NULL)
+    *LineP = NULL;
+
+  if ((OName == NULL) || (LineP == NULL) || (MCP.Buffer == NULL))
+    {
+    return(FAILURE);
+    }
+
+  if (MCPHashTableBuffer != MCP.Buffer)
+    {
+    MCPBuildHashTable(MCP.Buffer);
+
+    MDB(7,fCKPT) MLog("INFO:     checkpoint hash table created in iteration %d (%d records)\n",
+      MSched.Iteration,
+      MCPHashTable.NumItems);
+    }
+
+  /* key matches the line prefix written by MCPStoreObj() */
+
+  snprintf(CPLineKey,sizeof(CPLineKey),"%-9s %20s ",
+    MCPType[CKIndex],
+    OName);
+
+  return(MUHTGet(&MCPHashTable,CPLineKey,(void **)LineP,NULL));
+  }  /* END MCPGetLine() */
+
+
+
+
+
 /**
  * Restores checkpoint information to a given object
  *
@@ -796,12 +853,8 @@ int MCPRestore(
   char *tmp;
  
   mstring_t MLine(MMAX_BUFFER);;
-  char CPLineKey[MMAX_LINE];
   int LineLength;
 
-  static char *LastJobPtr = NULL;
-  static char *tmpMCPBuffer = NULL;
-
   const char *FName = "MCPRestore";
 
   mdb_t *MDBInfo;
@@ -833,27 +886,6 @@ int MCPRestore(
 
   if ((MCP.UseDatabase == FALSE) || (MDBInfo->DBType == mdbNONE))
     {
-    if ((MSched.Iteration > 0) && (tmpMCPBuffer != NULL))
-      {
-      /* After iterations -1 and 0, the checkpoint file may have been modified 
-         so the original hash table is stale.  We only use this hash table 
-         during iterations -1 and 0 to speed up boot time processing - after 
-         that free it. */
-
-      /* free the copy of the MCP buffer that the hash table is pointing at 
-         before we free the hash table */
-
-      MUFree(&tmpMCPBuffer);
-
-      MUHTFree(
-        &MCPHashTable,
-        FALSE,
-        NULL);
-
-      MDB(7,fCKPT) MLog("INFO:     checkpoint hash table freed in iteration %d\n",
-        MSched.Iteration);
-      }
-
     if (MCP.Buffer == NULL)
       { 
       if ((MCP.Buffer = MFULoadNoCache(MCP.CPFileName,1,&count,NULL,NULL,NULL)) == NULL)
@@ -868,91 +900,35 @@ int MCPRestore(
         }
    
       MCP.LastCPTime = MSched.Time;
-
-      /* must reset variables pointing to old checkpoint buffer */
-
-      LastJobPtr = NULL;
-
-      if ((MSched.Iteration < 1) && (tmpMCPBuffer == NULL))
-        {
-        /* Build a hash table for boot time processing (iterations -1 and 0) of the checkpoint file */
-        /* Note that this copy is freed just before we free the hash table */
-
-        MUStrDup(&tmpMCPBuffer,MCP.Buffer);
-
-        MCPBuildHashTable(tmpMCPBuffer);
-
-        MDB(7,fCKPT) MLog("INFO:     checkpoint hash table created in iteration %d\n",
-          MSched.Iteration);
-        }
       }
    
     /* NOTE:  CP version should be verified */
    
-    if (LastJobPtr == NULL)
-      LastJobPtr = MCP.Buffer;
-   
-    /* create a key to search for a checkpoint file line entry for the requested object */
+    /* MCP.Buffer is loaded once and never modified, so its line index stays
+       valid for every iteration (MCPGetLine() builds it on first use) */
 
-    sprintf(CPLineKey,"%-9s %20s ",
-      MCPType[CKIndex],
-      OName);
-
-    if (tmpMCPBuffer != NULL)
+    if (MCPGetLine(CKIndex,OName,&ptr) == FAILURE)
       {
-      /* At boot time use the fast hash table lookup instead of the much slower strstr() */
-
-      if (MUHTGet(&MCPHashTable,CPLineKey,(void **)&ptr,NULL) != SUCCESS)
-        {
-        /* no checkpoint entry for object */
-    
-        MDB(4,fCKPT) MLog("INFO:     no checkpoint entry for object '%s'\n",
-          CPLineKey); 
-   
-        if (Found != NULL)
-          *Found = FALSE;
-   
-        return(SUCCESS);
-        }
-      }
-    else
-      {
-      MDB(8,fCKPT) MLog("INFO:     checkpoint non hash table lookup '%s' in iteration %d\n",
-        CPLineKey,
-        MSched.Iteration);
-
-      if ((CKIndex == mcpJob) && 
-         ((ptr = strstr(LastJobPtr,CPLineKey)) != NULL))
-        {
-        /* NOTE: optimization depends on job checkpoint file being written
-                 in order of RM reporting */
+      /* no checkpoint entry for object */
    
-        /* job found */
+      MDB(4,fCKPT) MLog("INFO:     no checkpoint entry for object '%s:%s'\n",
+        MCPType[CKIndex],
+        OName);
    
-        if (MSched.M[mxoJob] > 10000)
-          LastJobPtr = ptr;
-        }
-      else if ((ptr = strstr(MCP.Buffer,CPLineKey)) == NULL)
-        {
-        /* no checkpoint entry for object */
-   
-        MDB(4,fCKPT) MLog("INFO:     no checkpoint entry for object '%s'\n",
-          CPLineKey);
-   
-        if (Found != NULL)
-          *Found = FALSE;
+      if (Found != NULL)
+        *Found = FALSE;
    
-        return(SUCCESS);
-        }
+      return(SUCCESS);
       }
      
-    /* We now have a pointer to a newline delimited line in either the MCP.Buffer or the tmpMCPBuffer */
+    /* We now have a pointer to a newline delimited line in MCP.Buffer */
     /* get the length of this line using the newline delimiter */
    
     if ((tmp = strchr(ptr,'\n')) == NULL)
       {
-      MDB(1,fCKPT) MLog("WARNING:  incorrectly formed checkpoint line corresponding to key '%s'\n",
-        CPLineKey);
+      MDB(1,fCKPT) MLog("WARNING:  incorrectly formed checkpoint line for object '%s:%s'\n",
+        MCPType[CKIndex],
+        OName);
 
       return(FAILURE);
       }
@@ -4094,6 +4070,62 @@ int MCPSubmitJournalAddEntry(
   return(SUCCESS);
   }  /* END MCPSubmitJournalAddEntry() */
 
+
+
+/**
+ * Removes the entry just written for J by MCPSubmitJournalAddEntry(), used
+ * when J could not be queued after all.
+ *
+ * NOTE: J's entry must be the last one in the journal (see 
+ *       MSysAddJobSubmitToQueue()).
+ *
+ * @param J (I)
+ */
+
+int MCPSubmitJournalDropEntry(
+
+  mjob_submit_t *J)
+
+  {
+  long EndOffset;
+
+  if (MCP.UseCPJournal == FALSE)
+    {
+    return(SUCCESS);
+    }
+
+  if ((J == NULL) || (MSubJournal.FP == NULL))
+    {
+    return(FAILURE);
+    }
+
+  MUMutexLock(&MSubJournal.Lock);
+
+  EndOffset = ftell(MSubJournal.FP);
+
+  if ((EndOffset < (long)J->JournalID) ||
+      (ftruncate(fileno(MSubJournal.FP),J->JournalID) != 0))
+    {
+    MUMutexUnlock(&MSubJournal.Lock);
+
+    MDB(0,fCKPT) MLog("ALERT:  cannot drop submit journal entry for job %d.  errno: %d (%s)\n",
+      J->ID,
+      errno,
+      strerror(errno));
+
+    return(FAILURE);
+    }
+
+  fseek(MSubJournal.FP,J->JournalID,SEEK_SET);
+
+  MSubJournal.JournalSize -= EndOffset - J->JournalID;
+  MSubJournal.OutstandingEntries--;
+
+  MUMutexUnlock(&MSubJournal.Lock);
+
+  return(SUCCESS);
+  }  /* END MCPSubmitJournalDropEntry() */
+
 #define MSUBMITJOURNAL_CLEARTIME 120
 /**
  *  This function will notify the submit journal
@@ -4320,7 +4352,20 @@ int MCPSubmitJournalLoad()
       MXMLAddE(tmpJE,SubmitTimeE);
       }
 
-    MSysAddJobSubmitToQueue(J,&J->ID,FALSE);
+    if (MSysAddJobSubmitToQueue(J,&J->ID,FALSE,NULL) == FAILURE)
+      {
+      /* queue is full - this thread is its consumer, drain it and retry */
+
+      MS3ProcessSubmitQueue();
+
+      if (MSysAddJobSubmitToQueue(J,&J->ID,FALSE,NULL) == FAILURE)
+        {
+        MDB(1,fCKPT) MLog("ALERT:    cannot queue journaled job submission %d\n",
+          J->ID);
+
+        MJobSubmitDestroy(&J);
+        }
+      }
     
     MUFree(&tmpLine);
     }  /* END while(1) */
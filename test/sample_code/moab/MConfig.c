@@ -2831,6 +2831,7 @@ int MCfgSetVal(
     case mcoFSMostSpecificLimit:
     case mcoAuthTimeout:
     case mcoThreadPoolSize:
+    case mcoNodeSelectThreads:
     case mcoGreenPoolEvalInterval:
     case mcoEnableHPAffinityScheduling:
     case mcoSocketLingerVal:
@@ -2856,6 +2857,7 @@ int MCfgSetVal(
     case mcoVMStorageNodeThreshold:
     case mcoShowMigratedJobsAsIdle:
     case mcoBGPreemption:
+    case mcoDBWALMode:
     case mcoGuaranteedPreemption:
     case mcoDisableRegExCaching:
     case mcoJobFailRetryCount:
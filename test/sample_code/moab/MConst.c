@@ -5488,6 +5488,7 @@ const mcfg_t MCfg[] = {
   { "CREDWEIGHT",               mcoCredWeight,                mdfString,  mxoPar,   NULL, FALSE, mcoNONE, NULL },
   { "CREDDISCOVERY",            mcoCredDiscovery,             mdfString,  mxoSched, NULL, FALSE, mcoNONE, NULL },
   { "DATASTAGEHOLDTYPE",        mcoDataStageHoldType,         mdfString,  mxoSched, NULL, FALSE, mcoNONE, (char **)MHoldType },
+  { "DBWALMODE",                mcoDBWALMode,                 mdfString,  mxoSched, NULL, FALSE, mcoNONE, (char **)MBoolString },
   { "DEADLINECAP",              mcoSDeadlineCap,              mdfInt,     mxoPar,   NULL, FALSE, mcoNONE, NULL },
   { "DEADLINEPOLICY",           mcoDeadlinePolicy,            mdfString,  mxoSched, NULL, FALSE, mcoNONE, NULL },
   { "DEADLINECAP",              mcoSDeadlineCap,              mdfInt,     mxoPar,   NULL, FALSE, mcoNONE, NULL },
@@ -5745,6 +5746,7 @@ const mcfg_t MCfg[] = {
   { "NODENAMECASEINSENSITIVE",  mcoNodeNameCaseInsensitive,   mdfString,  mxoSched, NULL, FALSE, mcoNONE, (char **)MBoolString },
   { "NODEPOLLFREQUENCY",        mcoNodePollFrequency,         mdfInt,     mxoSched, NULL, FALSE, mcoNONE, NULL },
   { "NODEPURGETIME",            mcoNodePurgeTime,             mdfString,  mxoSched, NULL, FALSE, mcoNONE, NULL },
+  { "NODESELECTTHREADS",        mcoNodeSelectThreads,         mdfInt,     mxoSched, NULL, FALSE, mcoNONE, NULL },
   { "NODESETATTRIBUTE",         mcoNodeSetAttribute,          mdfString,  mxoPar,   NULL, FALSE, mcoNONE, (char **)MResSetAttrType },
   { "NODESETDELAY",             mcoNodeSetDelay,              mdfString,  mxoPar,   NULL, FALSE, mcoNONE, NULL },
   { "NODESETFORCEMINALLOC",     mcoNodeSetForceMinAlloc,      mdfString,  mxoPar,   NULL, FALSE, mcoNONE, (char **)MBoolString },
@@ -69,6 +69,9 @@ const char *MDBTriggersBaseDelete                  = "DELETE FROM Triggers;";
 const char *MDBVCsBaseDelete                       = "DELETE FROM VCs;";
 const char *MDBRequestsBaseDelete                  = "DELETE FROM Requests;";
 const char *MDBNodesBaseDelete                     = "DELETE FROM Nodes;";
+const char *MDBDeleteJobByIDStmtText               = "DELETE FROM Jobs WHERE ID = ?;";
+const char *MDBDeleteRequestsByJobIDStmtText       = "DELETE FROM Requests WHERE JobID = ?;";
+const char *MDBDeleteNodeByIDStmtText              = "DELETE FROM Nodes WHERE ID = ?;";
 char  MDBSelectGeneralStatsStmtText[MMAX_BUFFER];
 char  MDBSelectGeneralStatsRangeStmtText[MMAX_BUFFER];
 char  MDBSelectNodeStatsStmtText[MMAX_BUFFER];
@@ -833,6 +836,114 @@ int MDBDeleteNodesStmt(
 
 
 
+
+/**
+ * Retrieve the statement to delete the job with a given ID from the Jobs table.
+ * Unlike the constraint-based deletes the statement text never changes, so
+ * it stays prepared; bind the job ID as its only parameter.
+ *
+ * @param   MDBInfo (I) the db info struct
+ * @param   MStmt   (O) the statement we'll execute later
+ * @param   EMsg    (O) any output error message
+ */
+
+int MDBDeleteJobByIDStmt(
+
+  mdb_t   *MDBInfo,
+  mstmt_t *MStmt,
+  char    *EMsg)
+
+  {
+  switch(MDBInfo->DBType)
+    {
+    case mdbSQLite3:
+      return(MSQLite3DeleteJobByIDStmt(MDBInfo->DBUnion.SQLite3,MStmt,EMsg));
+
+    case mdbODBC:
+      return(MODBCDeleteJobByIDStmt(MDBInfo->DBUnion.ODBC,MStmt,EMsg));
+
+    case mdbNONE:
+      return(SUCCESS);
+
+    default:
+      return(FAILURE);
+    }
+  }  /* END MDBDeleteJobByIDStmt() */
+
+
+
+
+/**
+ * Retrieve the statement to delete the requests of a given job from the Requests table.
+ * Unlike the constraint-based deletes the statement text never changes, so
+ * it stays prepared; bind the job ID as its only parameter.
+ *
+ * @param   MDBInfo (I) the db info struct
+ * @param   MStmt   (O) the statement we'll execute later
+ * @param   EMsg    (O) any output error message
+ */
+
+int MDBDeleteRequestsByJobIDStmt(
+
+  mdb_t   *MDBInfo,
+  mstmt_t *MStmt,
+  char    *EMsg)
+
+  {
+  switch(MDBInfo->DBType)
+    {
+    case mdbSQLite3:
+      return(MSQLite3DeleteRequestsByJobIDStmt(MDBInfo->DBUnion.SQLite3,MStmt,EMsg));
+
+    case mdbODBC:
+      return(MODBCDeleteRequestsByJobIDStmt(MDBInfo->DBUnion.ODBC,MStmt,EMsg));
+
+    case mdbNONE:
+      return(SUCCESS);
+
+    default:
+      return(FAILURE);
+    }
+  }  /* END MDBDeleteRequestsByJobIDStmt() */
+
+
+
+
+/**
+ * Retrieve the statement to delete the node with a given ID from the Nodes table.
+ * Unlike the constraint-based deletes the statement text never changes, so
+ * it stays prepared; bind the node ID as its only parameter.
+ *
+ * @param   MDBInfo (I) the db info struct
+ * @param   MStmt   (O) the statement we'll execute later
+ * @param   EMsg    (O) any output error message
+ */
+
+int MDBDeleteNodeByIDStmt(
+
+  mdb_t   *MDBInfo,
+  mstmt_t *MStmt,
+  char    *EMsg)
+
+  {
+  switch(MDBInfo->DBType)
+    {
+    case mdbSQLite3:
+      return(MSQLite3DeleteNodeByIDStmt(MDBInfo->DBUnion.SQLite3,MStmt,EMsg));
+
+    case mdbODBC:
+      return(MODBCDeleteNodeByIDStmt(MDBInfo->DBUnion.ODBC,MStmt,EMsg));
+
+    case mdbNONE:
+      return(SUCCESS);
+
+    default:
+      return(FAILURE);
+    }
+  }  /* END MDBDeleteNodeByIDStmt() */
+
+
+
 /**
  * delete reservations(s) from the Reservations table
  *
@@ -2187,6 +2298,41 @@ int MDBResetStmt(
 
 
 
+/**
+ * Declare that every parameter bound to MStmt points at storage that stays
+ * put for as long as the statement is in use (e.g. the static buffers of
+ * MDBWriteJobs()), so values need not be copied each time it is executed.
+ * The bound values must not change between MDBExecStmt() and MDBResetStmt().
+ *
+ * @param MStmt (I) [modified]
+ */
+
+int MDBSetStableParamStmt(
+
+  mstmt_t *MStmt) /* I (modified) */
+
+  {
+  switch(MStmt->DBType)
+    {
+    case mdbSQLite3:
+      return(MSQLite3SetStableParamStmt(MStmt->StmtUnion.SQLite3));
+      break;
+
+    case mdbODBC:
+
+      /* ODBC parameters are always bound by address */
+
+      return(SUCCESS);
+      break;
+
+    default:
+      return(FAILURE);
+    }
+  }  /* END MDBSetStableParamStmt() */
+
+
+
+
 /**
  *Allocate a direct statement using StmtText and store it in MStmt
  * @param MDBInfo  (I)
@@ -3273,7 +3419,7 @@ int MDBInsertCP(
   enum MStatusCodeEnum *SC)
 
   {
-  static mstmt_t MStmt;
+  mstmt_t *MStmt;
 
   static char  OTypeStatic[MMAX_LINE];
   static char  ONameStatic[MMAX_LINE];
@@ -3301,7 +3447,9 @@ int MDBInsertCP(
     return(FAILURE);
     }
 
-  if (MDBInsertCPStmt(MDBInfo,&MStmt,EMsg) == FAILURE)
+  MStmt = &MDBInfo->InsertCPStmt;
+
+  if (MDBInsertCPStmt(MDBInfo,MStmt,EMsg) == FAILURE)
     {
     return(FAILURE);
     }
@@ -3311,11 +3459,11 @@ int MDBInsertCP(
 
   if (MDBInfo->InsertCPInitialized == FALSE)
     {
-    MDBBindParamText(&MStmt,1,OTypeStatic,0);
-    MDBBindParamText(&MStmt,2,ONameStatic,0);
-    MDBBindParamInteger(&MStmt,3,(int *)&TStampStatic,0);
+    MDBBindParamText(MStmt,1,OTypeStatic,0);
+    MDBBindParamText(MStmt,2,ONameStatic,0);
+    MDBBindParamInteger(MStmt,3,(int *)&TStampStatic,0);
 
-    MDBBindParamText(&MStmt,4,DataStatic.c_str(),0);
+    MDBBindParamText(MStmt,4,DataStatic.c_str(),0);
 
     MDBInfo->InsertCPInitialized = TRUE;
     } /* END if (MDBInfo->InsertCPInitialized == FALSE) */
@@ -3332,7 +3480,7 @@ int MDBInsertCP(
   if (DataStaticPtr != NewDataStaticPtr)
     {
     /* Rebind the DataStatic because it's addressed changed */
-    MDBBindParamText(&MStmt,4,DataStatic.c_str(),0);
+    MDBBindParamText(MStmt,4,DataStatic.c_str(),0);
     }
 
   MUStrCpy(OTypeStatic,ObjectType,MMAX_LINE);
@@ -3341,8 +3489,8 @@ int MDBInsertCP(
 
   MDBDeleteCP(MDBInfo,ObjectType,ObjectName,0,NULL);
 
-  MDBExecStmt(&MStmt,SC);
-  MDBResetStmt(&MStmt);
+  MDBExecStmt(MStmt,SC);
+  MDBResetStmt(MStmt);
 
   return(SUCCESS);
   } /* END MDBInsertCP */ 
@@ -4593,6 +4741,10 @@ int MDBGetEventMessages(
 /**
  * Wrapper for writing database objects (operational, not events or statistics), includes retry logic.
  *
+ * The batch is written atomically: in a transaction of its own, or under a
+ * savepoint if the caller already has a transaction open (SQLite only).  A
+ * failed batch is rolled back without touching the caller's other writes.
+ *
  * NOTE: this routine is not threadsafe, it should only be called
  *       by the MOTransitionFromQueue() thread.
  *
@@ -4600,6 +4752,8 @@ int MDBGetEventMessages(
  * @param   O       (I) 
  * @param   OType   (I) 
  * @param   Msg     (O) any output error message
+ *
+ * @return FAILURE if the batch could not be written
  */
 
 int MDBWriteObjectsWithRetry(
@@ -4612,7 +4766,11 @@ int MDBWriteObjectsWithRetry(
   {
   enum MStatusCodeEnum SC;
 
+  int rc;
+
   mbool_t Retry;
+  mbool_t InTransaction = FALSE;  /* transaction opened by this routine */
+  mbool_t InSavepoint = FALSE;
 
   if ((MDBP == NULL) || (O == NULL))
     {
@@ -4626,6 +4784,16 @@ int MDBWriteObjectsWithRetry(
     return(SUCCESS);
     }
 
+  /* commit the whole batch at once rather than row by row */
+
+  if (MDBP->DBType != mdbNONE)
+    {
+    if (MDBInTransaction(MDBP) == FALSE)
+      InTransaction = (MDBBeginTransaction(MDBP,NULL) == SUCCESS);
+    else
+      InSavepoint = (MDBSetSavepoint(MDBP,NULL) == SUCCESS);
+    }
+
   do 
     {
     Retry = FALSE;
@@ -4634,12 +4802,12 @@ int MDBWriteObjectsWithRetry(
 
     switch (OType)
       {
-      case mxoNode: MDBWriteNodes(MDBP,(mtransnode_t **)O,NULL,&SC); break;
-      case mxoJob:  MDBWriteJobs(MDBP,(mtransjob_t **)O,NULL,&SC); break;
-      case mxoTrig: MDBWriteTrigger(MDBP,(mtranstrig_t **)O,NULL,&SC); break;
-      case mxoxVC:  MDBWriteVC(MDBP,(mtransvc_t **)O,NULL,&SC); break;
-      case mxoRsv:  MDBWriteRsv(MDBP,(mtransrsv_t **)O,NULL,&SC); break;
-      default: /* NO-OP */ break;
+      case mxoNode: rc = MDBWriteNodes(MDBP,(mtransnode_t **)O,NULL,&SC); break;
+      case mxoJob:  rc = MDBWriteJobs(MDBP,(mtransjob_t **)O,NULL,&SC); break;
+      case mxoTrig: rc = MDBWriteTrigger(MDBP,(mtranstrig_t **)O,NULL,&SC); break;
+      case mxoxVC:  rc = MDBWriteVC(MDBP,(mtransvc_t **)O,NULL,&SC); break;
+      case mxoRsv:  rc = MDBWriteRsv(MDBP,(mtransrsv_t **)O,NULL,&SC); break;
+      default: rc = SUCCESS; /* NO-OP */ break;
       }
 
     if (MDBShouldRetry(SC) == TRUE)
@@ -4653,9 +4821,34 @@ int MDBWriteObjectsWithRetry(
       MDBP->DBType = MSched.ReqMDBType;
 
       MSysInitDB(MDBP);
+
+      /* the new connection has no transaction, write the batch in one of its own */
+
+      InSavepoint = FALSE;
+
+      InTransaction = (MDBP->DBType != mdbNONE) && 
+                      (MDBBeginTransaction(MDBP,NULL) == SUCCESS);
       }
     } while (Retry == TRUE);
 
+  if (rc == FAILURE)
+    {
+    MDB(2,fSOCK) MLog("ALERT:    cannot write %s objects to database, batch discarded\n",
+      MXO[OType]);
+
+    if (InTransaction == TRUE)
+      MDBRollbackTransaction(MDBP,NULL,&SC);
+    else if (InSavepoint == TRUE)
+      MDBRollbackToSavepoint(MDBP,NULL);
+
+    return(FAILURE);
+    }
+
+  if (InTransaction == TRUE)
+    MDBEndTransaction(MDBP,NULL,&SC);
+  else if (InSavepoint == TRUE)
+    MDBReleaseSavepoint(MDBP,NULL);
+
   return(SUCCESS);
   }  /* END MDBWriteNodesWithRetry() */
 
@@ -4725,7 +4918,8 @@ int MDBWriteNodes(
   {
   int nindex;
 
-  static mstmt_t MStmt;
+  mstmt_t *MStmt;
+  mstmt_t *DeleteStmt;
   int     ParamIndex = 1;
 
   mbool_t DeleteFirst = TRUE;
@@ -4801,77 +4995,92 @@ int MDBWriteNodes(
 
   MDB(7,fSOCK) MLog("INFO:     writing nodes to database\n");
 
+  MStmt = &MDBInfo->WriteNodesStmt;
+  DeleteStmt = &MDBInfo->DeleteNodeStmt;
+
   if (MDBInfo->WriteNodesInitialized == FALSE)
     {
     MDB(7,fSOCK) MLog("INFO:     prepping node statement\n");
    
-    if (MDBInsertNodeStmt(MDBInfo,&MStmt,NULL) == FAILURE)
+    if (MDBInsertNodeStmt(MDBInfo,MStmt,NULL) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     error prepping node statement\n");
       return(FAILURE);
       }
     
-    MDBBindParamText(&MStmt,ParamIndex++,Name,0);
-    MDBBindParamText(&MStmt,ParamIndex++,State,0);
-    MDBBindParamText(&MStmt,ParamIndex++,OperatingSystem,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&ConfiguredProcessors,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&AvailableProcessors,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&ConfiguredMemory,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&AvailableMemory,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Architecture,0);
-    MDBBindParamText(&MStmt,ParamIndex++,AvailGRes,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ConfigGRes,0);
-    MDBBindParamText(&MStmt,ParamIndex++,AvailClasses,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ConfigClasses,0);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&ChargeRate,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&DynamicPriority,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&EnableProfiling,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Features,0);
-    MDBBindParamText(&MStmt,ParamIndex++,GMetric,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&HopCount,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,HypervisorType,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&IsDeleted,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&IsDynamic,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,JobList,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&LastUpdateTime,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&LoadAvg,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&MaxLoad,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&MaxJob,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&MaxJobPerUser,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&MaxProc,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&MaxProcPerUser,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,OldMessages,0);
-    MDBBindParamText(&MStmt,ParamIndex++,NetworkAddress,0);
-    MDBBindParamText(&MStmt,ParamIndex++,SubState,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Operations,0);
-    MDBBindParamText(&MStmt,ParamIndex++,OSList,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Owner,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ResOvercommitFactor,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Partition,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&PowerIsEnabled,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,PowerPolicy,0);
-    MDBBindParamText(&MStmt,ParamIndex++,PowerSelectState,0);
-    MDBBindParamText(&MStmt,ParamIndex++,PowerState,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&Priority,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,PriorityFunction,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&ProcessorSpeed,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,ProvisioningData,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&AvailableDisk,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&AvailableSwap,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&ConfiguredDisk,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&ConfiguredSwap,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&ReservationCount,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,ReservationList,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ResourceManagerList,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&Size,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&Speed,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&SpeedWeight,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&TotalNodeActiveTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&LastModifyTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&TotalTimeTracked,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&TotalNodeUpTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,&TaskCount,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,VMOSList,0);
+    MDBBindParamText(MStmt,ParamIndex++,Name,0);
+    MDBBindParamText(MStmt,ParamIndex++,State,0);
+    MDBBindParamText(MStmt,ParamIndex++,OperatingSystem,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&ConfiguredProcessors,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&AvailableProcessors,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&ConfiguredMemory,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&AvailableMemory,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Architecture,0);
+    MDBBindParamText(MStmt,ParamIndex++,AvailGRes,0);
+    MDBBindParamText(MStmt,ParamIndex++,ConfigGRes,0);
+    MDBBindParamText(MStmt,ParamIndex++,AvailClasses,0);
+    MDBBindParamText(MStmt,ParamIndex++,ConfigClasses,0);
+    MDBBindParamDouble(MStmt,ParamIndex++,&ChargeRate,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&DynamicPriority,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&EnableProfiling,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Features,0);
+    MDBBindParamText(MStmt,ParamIndex++,GMetric,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&HopCount,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,HypervisorType,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&IsDeleted,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&IsDynamic,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,JobList,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&LastUpdateTime,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&LoadAvg,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&MaxLoad,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&MaxJob,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&MaxJobPerUser,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&MaxProc,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&MaxProcPerUser,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,OldMessages,0);
+    MDBBindParamText(MStmt,ParamIndex++,NetworkAddress,0);
+    MDBBindParamText(MStmt,ParamIndex++,SubState,0);
+    MDBBindParamText(MStmt,ParamIndex++,Operations,0);
+    MDBBindParamText(MStmt,ParamIndex++,OSList,0);
+    MDBBindParamText(MStmt,ParamIndex++,Owner,0);
+    MDBBindParamText(MStmt,ParamIndex++,ResOvercommitFactor,0);
+    MDBBindParamText(MStmt,ParamIndex++,Partition,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&PowerIsEnabled,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,PowerPolicy,0);
+    MDBBindParamText(MStmt,ParamIndex++,PowerSelectState,0);
+    MDBBindParamText(MStmt,ParamIndex++,PowerState,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&Priority,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,PriorityFunction,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&ProcessorSpeed,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,ProvisioningData,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&AvailableDisk,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&AvailableSwap,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&ConfiguredDisk,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&ConfiguredSwap,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&ReservationCount,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,ReservationList,0);
+    MDBBindParamText(MStmt,ParamIndex++,ResourceManagerList,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,&Size,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&Speed,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&SpeedWeight,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&TotalNodeActiveTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&LastModifyTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&TotalTimeTracked,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&TotalNodeUpTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,&TaskCount,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,VMOSList,0);
+
+    MDBSetStableParamStmt(MStmt);
+
+    if (MDBDeleteNodeByIDStmt(MDBInfo,DeleteStmt,NULL) == FAILURE)
+      {
+      MDB(7,fSOCK) MLog("INFO:     error prepping node delete statement\n");
+      return(FAILURE);
+      }
+
+    MDBBindParamText(DeleteStmt,1,Name,0);
+
+    MDBSetStableParamStmt(DeleteStmt);
 
     MDBInfo->WriteNodesInitialized = TRUE;
     }
@@ -4884,27 +5093,28 @@ int MDBWriteNodes(
     if (MSched.Shutdown == TRUE)
       return(SUCCESS);
 
+    MUStrCpy(Name,(MUStrIsEmpty(N[nindex]->Name)) ? "\0" : N[nindex]->Name,sizeof(Name));
+
     if (DeleteFirst == TRUE)
       {
-      marray_t NConstraintList;
-      mnodeconstraint_t NConstraint;
-   
-      /* delete rsv from the database before we try to insert */
-   
-      MUArrayListCreate(&NConstraintList,sizeof(mnodeconstraint_t),1);
-    
-      NConstraint.AType = mnaNodeID;
-      MUStrCpy(NConstraint.AVal[0],N[nindex]->Name,sizeof(NConstraint.AVal[0]));
-      NConstraint.ACmp = mcmpEQ;
-    
-      MUArrayListAppend(&NConstraintList,(void *)&NConstraint);
-    
-      MDBDeleteNodes(MDBInfo,&NConstraintList,NULL);
-    
-      MUArrayListFree(&NConstraintList);
+      enum MStatusCodeEnum DeleteSC = mscNoError;
+
+      /* delete node from the database before we try to insert */
+
+      if (MDBExecStmt(DeleteStmt,&DeleteSC) == FAILURE)
+        {
+        MDB(7,fSOCK) MLog("INFO:     failure executing node delete statement\n");
+
+        MDBResetStmt(DeleteStmt);
+
+        *SC = DeleteSC;
+
+        return(FAILURE);
+        }
+
+      MDBResetStmt(DeleteStmt);
       }
 
-    MUStrCpy(Name,(MUStrIsEmpty(N[nindex]->Name)) ? "\0" : N[nindex]->Name,sizeof(Name));
     MUStrCpy(State,MNodeState[N[nindex]->State],sizeof(State));
     MUStrCpy(OperatingSystem,(MUStrIsEmpty(N[nindex]->OperatingSystem)) ? "\0" : N[nindex]->OperatingSystem,sizeof(OperatingSystem));
     MUStrCpy(Architecture,(MUStrIsEmpty(N[nindex]->Architecture)) ? "\0" : N[nindex]->Architecture,sizeof(Architecture));
@@ -4971,11 +5181,16 @@ int MDBWriteNodes(
     MDB(7,fTRANS) MLog("INFO:     writing node '%s' to database\n",
       Name);
 
-    if (MDBExecStmt(&MStmt,SC) == FAILURE)
+    if (MDBExecStmt(MStmt,SC) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     failure executing node statement\n");
+
+      MDBResetStmt(MStmt);
+
       return(FAILURE);
       }
+
+    MDBResetStmt(MStmt);
     }  /* END for (nindex) */
 
   return(SUCCESS);
@@ -5515,7 +5730,9 @@ int MDBWriteJobs(
   {
   mbool_t DeleteFirst = TRUE;
 
-  static mstmt_t MStmt;
+  mstmt_t *MStmt;
+  mstmt_t *DeleteJobStmt;
+  mstmt_t *DeleteReqStmt;
 
   static char Name[MMAX_LINE];
   static char SourceRMJobID[MMAX_LINE];
@@ -5604,81 +5821,100 @@ int MDBWriteJobs(
 
   MDB(7,fSOCK) MLog("INFO:     writing jobs to database\n");
 
+  MStmt = &MDBInfo->WriteJobsStmt;
+  DeleteJobStmt = &MDBInfo->DeleteJobStmt;
+  DeleteReqStmt = &MDBInfo->DeleteRequestsStmt;
+
   if (MDBInfo->WriteJobsInitialized == FALSE)
     {
     MDB(7,fSOCK) MLog("INFO:     prepping job statement\n");
 
-    if (MDBInsertJobStmt(MDBInfo,&MStmt,NULL) == FAILURE)
+    if (MDBInsertJobStmt(MDBInfo,MStmt,NULL) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     error prepping job statement\n");
       return(FAILURE);
       }
  
-    MDBBindParamText(&MStmt,ParamIndex++,Name,0);
-    MDBBindParamText(&MStmt,ParamIndex++,SourceRMJobID,0);
-    MDBBindParamText(&MStmt,ParamIndex++,DestinationRMJobID,0);
-    MDBBindParamText(&MStmt,ParamIndex++,GridJobID,0);
-    MDBBindParamText(&MStmt,ParamIndex++,AName,0);
-    MDBBindParamText(&MStmt,ParamIndex++,User,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Account,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Class,0);
-    MDBBindParamText(&MStmt,ParamIndex++,QOS,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Group,0);
-    MDBBindParamText(&MStmt,ParamIndex++,JobGroup,0);
-    MDBBindParamText(&MStmt,ParamIndex++,State,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ExpectedState,0);
-    MDBBindParamText(&MStmt,ParamIndex++,SubState,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&UserPriority,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&SystemPriority,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&Priority,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&RunPriority,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,PerPartitionPriority,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&SubmitTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&QueueTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&StartTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&CompletionTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&CompletionCode,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&UsedWalltime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&RequestedMinWalltime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&RequestedMaxWalltime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&CPULimit,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&SuspendTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&HoldTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&MaxProcessorCount,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&RequestedNodes,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,ActivePartition,0);
-    MDBBindParamText(&MStmt,ParamIndex++,SpecPAL,0);
-    MDBBindParamText(&MStmt,ParamIndex++,DestinationRM,0);
-    MDBBindParamText(&MStmt,ParamIndex++,SourceRM,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Flags,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&MinPreemptTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Dependencies,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RequestedHostList,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ExcludedHostList,0);
-    MDBBindParamText(&MStmt,ParamIndex++,MasterHost,0);
-    MDBBindParamText(&MStmt,ParamIndex++,GenericAttributes,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Holds,0);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&Cost,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Description,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Messages,0);
-    MDBBindParamText(&MStmt,ParamIndex++,NotificationAddress,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&StartCount,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&BypassCount,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,CommandFile,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Arguments,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RMSubmitLanguage,0);
-    MDBBindParamText(&MStmt,ParamIndex++,StdIn,0);
-    MDBBindParamText(&MStmt,ParamIndex++,StdOut,0);
-    MDBBindParamText(&MStmt,ParamIndex++,StdErr,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RMOutput,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RMError,0);
-    MDBBindParamText(&MStmt,ParamIndex++,InitialWorkingDirectory,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&UMask,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&RsvStartTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,BlockReason,0);
-    MDBBindParamText(&MStmt,ParamIndex++,BlockMsg,0);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&PSDedicated,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&PSUtilized,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Name,0);
+    MDBBindParamText(MStmt,ParamIndex++,SourceRMJobID,0);
+    MDBBindParamText(MStmt,ParamIndex++,DestinationRMJobID,0);
+    MDBBindParamText(MStmt,ParamIndex++,GridJobID,0);
+    MDBBindParamText(MStmt,ParamIndex++,AName,0);
+    MDBBindParamText(MStmt,ParamIndex++,User,0);
+    MDBBindParamText(MStmt,ParamIndex++,Account,0);
+    MDBBindParamText(MStmt,ParamIndex++,Class,0);
+    MDBBindParamText(MStmt,ParamIndex++,QOS,0);
+    MDBBindParamText(MStmt,ParamIndex++,Group,0);
+    MDBBindParamText(MStmt,ParamIndex++,JobGroup,0);
+    MDBBindParamText(MStmt,ParamIndex++,State,0);
+    MDBBindParamText(MStmt,ParamIndex++,ExpectedState,0);
+    MDBBindParamText(MStmt,ParamIndex++,SubState,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&UserPriority,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&SystemPriority,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&Priority,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&RunPriority,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,PerPartitionPriority,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&SubmitTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&QueueTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&StartTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&CompletionTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&CompletionCode,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&UsedWalltime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&RequestedMinWalltime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&RequestedMaxWalltime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&CPULimit,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&SuspendTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&HoldTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&MaxProcessorCount,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&RequestedNodes,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,ActivePartition,0);
+    MDBBindParamText(MStmt,ParamIndex++,SpecPAL,0);
+    MDBBindParamText(MStmt,ParamIndex++,DestinationRM,0);
+    MDBBindParamText(MStmt,ParamIndex++,SourceRM,0);
+    MDBBindParamText(MStmt,ParamIndex++,Flags,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&MinPreemptTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Dependencies,0);
+    MDBBindParamText(MStmt,ParamIndex++,RequestedHostList,0);
+    MDBBindParamText(MStmt,ParamIndex++,ExcludedHostList,0);
+    MDBBindParamText(MStmt,ParamIndex++,MasterHost,0);
+    MDBBindParamText(MStmt,ParamIndex++,GenericAttributes,0);
+    MDBBindParamText(MStmt,ParamIndex++,Holds,0);
+    MDBBindParamDouble(MStmt,ParamIndex++,&Cost,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Description,0);
+    MDBBindParamText(MStmt,ParamIndex++,Messages,0);
+    MDBBindParamText(MStmt,ParamIndex++,NotificationAddress,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&StartCount,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&BypassCount,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,CommandFile,0);
+    MDBBindParamText(MStmt,ParamIndex++,Arguments,0);
+    MDBBindParamText(MStmt,ParamIndex++,RMSubmitLanguage,0);
+    MDBBindParamText(MStmt,ParamIndex++,StdIn,0);
+    MDBBindParamText(MStmt,ParamIndex++,StdOut,0);
+    MDBBindParamText(MStmt,ParamIndex++,StdErr,0);
+    MDBBindParamText(MStmt,ParamIndex++,RMOutput,0);
+    MDBBindParamText(MStmt,ParamIndex++,RMError,0);
+    MDBBindParamText(MStmt,ParamIndex++,InitialWorkingDirectory,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&UMask,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&RsvStartTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,BlockReason,0);
+    MDBBindParamText(MStmt,ParamIndex++,BlockMsg,0);
+    MDBBindParamDouble(MStmt,ParamIndex++,&PSDedicated,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&PSUtilized,FALSE);
+
+    MDBSetStableParamStmt(MStmt);
+
+    if ((MDBDeleteJobByIDStmt(MDBInfo,DeleteJobStmt,NULL) == FAILURE) ||
+        (MDBDeleteRequestsByJobIDStmt(MDBInfo,DeleteReqStmt,NULL) == FAILURE))
+      {
+      MDB(7,fSOCK) MLog("INFO:     error prepping job delete statement\n");
+      return(FAILURE);
+      }
+
+    MDBBindParamText(DeleteJobStmt,1,Name,0);
+    MDBBindParamText(DeleteReqStmt,1,Name,0);
+
+    MDBSetStableParamStmt(DeleteJobStmt);
+    MDBSetStableParamStmt(DeleteReqStmt);
 
     MDBInfo->WriteJobsInitialized = TRUE;
     } /* END if (MDBInfo->WriteJobsInitialized == FALSE) */
@@ -5717,26 +5953,33 @@ int MDBWriteJobs(
       MUArrayListFree(&JConstraintList);
       }
 
+    MUStrCpy(Name,J[jindex]->Name,MMAX_LINE);
+
     if (DeleteFirst == TRUE)
       {
-      marray_t JConstraintList;
-      mjobconstraint_t JConstraint;
-   
-      MUArrayListCreate(&JConstraintList,sizeof(mjobconstraint_t),1);
-    
-      JConstraint.AType = mjaJobID;
-      MUStrCpy(JConstraint.AVal[0],J[jindex]->Name,sizeof(JConstraint.AVal[0]));
-      JConstraint.ACmp = mcmpEQ;
-    
-      MUArrayListAppend(&JConstraintList,(void *)&JConstraint);
-    
-      MDBDeleteJobs(MDBInfo,&JConstraintList,NULL);
-      MDBDeleteRequests(MDBInfo,&JConstraintList,NULL);
-    
-      MUArrayListFree(&JConstraintList);
+      enum MStatusCodeEnum DeleteSC = mscNoError;
+
+      int rc;
+
+      rc = MDBExecStmt(DeleteJobStmt,&DeleteSC);
+      MDBResetStmt(DeleteJobStmt);
+
+      if (rc == SUCCESS)
+        {
+        rc = MDBExecStmt(DeleteReqStmt,&DeleteSC);
+        MDBResetStmt(DeleteReqStmt);
+        }
+
+      if (rc == FAILURE)
+        {
+        MDB(7,fSOCK) MLog("INFO:     failure executing job delete statement\n");
+
+        *SC = DeleteSC;
+
+        return(FAILURE);
+        }
       }
 
-    MUStrCpy(Name,J[jindex]->Name,MMAX_LINE);
     MUStrCpy(SourceRMJobID,(!MUStrIsEmpty(J[jindex]->SourceRMJobID)) ? J[jindex]->SourceRMJobID : "\0",MMAX_LINE);
     MUStrCpy(DestinationRMJobID,(!MUStrIsEmpty(J[jindex]->DestinationRMJobID)) ? J[jindex]->DestinationRMJobID : "\0",MMAX_LINE);
     MUStrCpy(GridJobID,(!MUStrIsEmpty(J[jindex]->GridJobID)) ? J[jindex]->GridJobID : "\0",MMAX_LINE);
@@ -5813,13 +6056,21 @@ int MDBWriteJobs(
     MDB(7,fTRANS) MLog("INFO:     writing job '%s' to database\n",
       Name);
 
-    if (MDBExecStmt(&MStmt,SC) == FAILURE)
+    if (MDBExecStmt(MStmt,SC) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     failure executing job statement\n");
+
+      MDBResetStmt(MStmt);
+
       return(FAILURE);
       }
 
-    MDBWriteRequests(MDBInfo,J[jindex]->Requirements,Msg,SC);
+    MDBResetStmt(MStmt);
+
+    if (MDBWriteRequests(MDBInfo,J[jindex]->Requirements,Msg,SC) == FAILURE)
+      {
+      return(FAILURE);
+      }
     }  /* END for (jindex) */  /* write all the reqs via MDBWriteRequest */
 
   return(SUCCESS);
@@ -5850,7 +6101,7 @@ int MDBWriteRsv(
   {
   mbool_t DeleteFirst = TRUE;
 
-  static mstmt_t MStmt;
+  mstmt_t *MStmt;
 
   static char Name[MMAX_LINE];
   static char ACL[MMAX_LINE];
@@ -5916,68 +6167,72 @@ int MDBWriteRsv(
 
   MDB(7,fSOCK) MLog("INFO:     writing reservations to database\n");
 
+  MStmt = &MDBInfo->WriteRsvStmt;
+
   if (MDBInfo->WriteRsvInitialized == FALSE)
     {
     MDB(7,fSOCK) MLog("INFO:     prepping reservation statement\n");
 
-    if (MDBInsertRsvStmt(MDBInfo,&MStmt,NULL) == FAILURE)
+    if (MDBInsertRsvStmt(MDBInfo,MStmt,NULL) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     error prepping reservation statement\n");
       return(FAILURE);
       }
  
-    MDBBindParamText(&MStmt,ParamIndex++,Name,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ACL,0);
-    MDBBindParamText(&MStmt,ParamIndex++,AAccount,0);
-    MDBBindParamText(&MStmt,ParamIndex++,AGroup,0);
-    MDBBindParamText(&MStmt,ParamIndex++,AUser,0);
-    MDBBindParamText(&MStmt,ParamIndex++,AQOS,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&AllocNodeCount,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,AllocNodeList,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&AllocProcCount,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&AllocTaskCount,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,CL,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Comment,0);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&Cost,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&CTime,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&Duration,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&EndTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,ExcludeRsv,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&ExpireTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Flags,0);
-    MDBBindParamText(&MStmt,ParamIndex++,GlobalID,0);
-    MDBBindParamText(&MStmt,ParamIndex++,HostExp,0);
-    MDBBindParamText(&MStmt,ParamIndex++,History,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Label,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&LastChargeTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,LogLevel,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Messages,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Owner,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Partition,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Profile,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqArch,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqFeatureList,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqMemory,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqNodeCount,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqNodeList,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqOS,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqTaskCount,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqTPN,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Resources,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RsvAccessList,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RsvGroup,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RsvParent,0);
-    MDBBindParamText(&MStmt,ParamIndex++,SID,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&StartTime,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&StatCAPS,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&StatCIPS,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&StatTAPS,FALSE);
-    MDBBindParamDouble(&MStmt,ParamIndex++,&StatTIPS,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,SubType,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Trigger,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Type,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Variables,0);
-    MDBBindParamText(&MStmt,ParamIndex++,VMList,0);
+    MDBBindParamText(MStmt,ParamIndex++,Name,0);
+    MDBBindParamText(MStmt,ParamIndex++,ACL,0);
+    MDBBindParamText(MStmt,ParamIndex++,AAccount,0);
+    MDBBindParamText(MStmt,ParamIndex++,AGroup,0);
+    MDBBindParamText(MStmt,ParamIndex++,AUser,0);
+    MDBBindParamText(MStmt,ParamIndex++,AQOS,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&AllocNodeCount,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,AllocNodeList,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&AllocProcCount,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&AllocTaskCount,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,CL,0);
+    MDBBindParamText(MStmt,ParamIndex++,Comment,0);
+    MDBBindParamDouble(MStmt,ParamIndex++,&Cost,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&CTime,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&Duration,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&EndTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,ExcludeRsv,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&ExpireTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Flags,0);
+    MDBBindParamText(MStmt,ParamIndex++,GlobalID,0);
+    MDBBindParamText(MStmt,ParamIndex++,HostExp,0);
+    MDBBindParamText(MStmt,ParamIndex++,History,0);
+    MDBBindParamText(MStmt,ParamIndex++,Label,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&LastChargeTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,LogLevel,0);
+    MDBBindParamText(MStmt,ParamIndex++,Messages,0);
+    MDBBindParamText(MStmt,ParamIndex++,Owner,0);
+    MDBBindParamText(MStmt,ParamIndex++,Partition,0);
+    MDBBindParamText(MStmt,ParamIndex++,Profile,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqArch,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqFeatureList,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqMemory,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqNodeCount,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqNodeList,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqOS,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqTaskCount,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqTPN,0);
+    MDBBindParamText(MStmt,ParamIndex++,Resources,0);
+    MDBBindParamText(MStmt,ParamIndex++,RsvAccessList,0);
+    MDBBindParamText(MStmt,ParamIndex++,RsvGroup,0);
+    MDBBindParamText(MStmt,ParamIndex++,RsvParent,0);
+    MDBBindParamText(MStmt,ParamIndex++,SID,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&StartTime,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&StatCAPS,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&StatCIPS,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&StatTAPS,FALSE);
+    MDBBindParamDouble(MStmt,ParamIndex++,&StatTIPS,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,SubType,0);
+    MDBBindParamText(MStmt,ParamIndex++,Trigger,0);
+    MDBBindParamText(MStmt,ParamIndex++,Type,0);
+    MDBBindParamText(MStmt,ParamIndex++,Variables,0);
+    MDBBindParamText(MStmt,ParamIndex++,VMList,0);
+
+    MDBSetStableParamStmt(MStmt);
 
     MDBInfo->WriteRsvInitialized = TRUE;
     } /* END if (MDBInfo->WriteRsvInitialized == FALSE) */
@@ -6066,11 +6321,16 @@ int MDBWriteRsv(
     MDB(7,fTRANS) MLog("INFO:     writing reservation '%s' to database\n",
       Name);
 
-    if (MDBExecStmt(&MStmt,SC) == FAILURE)
+    if (MDBExecStmt(MStmt,SC) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     failure executing reservation statement\n");
+
+      MDBResetStmt(MStmt);
+
       return(FAILURE);
       }
+
+    MDBResetStmt(MStmt);
     }  /* END for (rindex) */  /* write all the reqs via MDBWriteRequest */
 
   return(SUCCESS);
@@ -6101,7 +6361,7 @@ int MDBWriteTrigger(
   {
   mbool_t DeleteFirst = TRUE;
 
-  static mstmt_t MStmt;
+  mstmt_t *MStmt;
 
   static char TrigID[MMAX_LINE];
   static char Name[MMAX_LINE];
@@ -6146,47 +6406,51 @@ int MDBWriteTrigger(
 
   MDB(7,fSOCK) MLog("INFO:     writing triggers to database\n");
 
+  MStmt = &MDBInfo->WriteTriggerStmt;
+
   if (MDBInfo->WriteTriggerInitialized == FALSE)
     {
     MDB(7,fSOCK) MLog("INFO:     prepping trigger statement\n");
 
-    if (MDBInsertTriggerStmt(MDBInfo,&MStmt,NULL) == FAILURE)
+    if (MDBInsertTriggerStmt(MDBInfo,MStmt,NULL) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     error prepping trigger statement\n");
       return(FAILURE);
       }
 
-    MDBBindParamText(&MStmt,ParamIndex++,TrigID,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Name,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ActionData,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ActionType,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&BlockTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Description,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&Disabled,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,EBuf,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&EventTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,EventType,0);
-    MDBBindParamText(&MStmt,ParamIndex++,FailOffset,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&FailureDetected,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Flags,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&IsComplete,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&IsInterval,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&LaunchTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Message,0);
-    MDBBindParamText(&MStmt,ParamIndex++,MultiFire,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ObjectID,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ObjectType,0);
-    MDBBindParamText(&MStmt,ParamIndex++,OBuf,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Offset,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Period,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&PID,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&RearmTime,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Requires,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Sets,0);
-    MDBBindParamText(&MStmt,ParamIndex++,State,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Threshold,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&Timeout,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,Unsets,0);
+    MDBBindParamText(MStmt,ParamIndex++,TrigID,0);
+    MDBBindParamText(MStmt,ParamIndex++,Name,0);
+    MDBBindParamText(MStmt,ParamIndex++,ActionData,0);
+    MDBBindParamText(MStmt,ParamIndex++,ActionType,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&BlockTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Description,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&Disabled,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,EBuf,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&EventTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,EventType,0);
+    MDBBindParamText(MStmt,ParamIndex++,FailOffset,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&FailureDetected,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Flags,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&IsComplete,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&IsInterval,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&LaunchTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Message,0);
+    MDBBindParamText(MStmt,ParamIndex++,MultiFire,0);
+    MDBBindParamText(MStmt,ParamIndex++,ObjectID,0);
+    MDBBindParamText(MStmt,ParamIndex++,ObjectType,0);
+    MDBBindParamText(MStmt,ParamIndex++,OBuf,0);
+    MDBBindParamText(MStmt,ParamIndex++,Offset,0);
+    MDBBindParamText(MStmt,ParamIndex++,Period,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&PID,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&RearmTime,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Requires,0);
+    MDBBindParamText(MStmt,ParamIndex++,Sets,0);
+    MDBBindParamText(MStmt,ParamIndex++,State,0);
+    MDBBindParamText(MStmt,ParamIndex++,Threshold,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&Timeout,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,Unsets,0);
+
+    MDBSetStableParamStmt(MStmt);
 
     MDBInfo->WriteTriggerInitialized = TRUE;
     } /* END if (MDBInfo->WriteTriggerInitialized == FALSE) */
@@ -6253,11 +6517,16 @@ int MDBWriteTrigger(
     MDB(7,fTRANS) MLog("INFO:     writing trigger '%s' to database\n",
       Name);
 
-    if (MDBExecStmt(&MStmt,SC) == FAILURE)
+    if (MDBExecStmt(MStmt,SC) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     failure executing trigger statement\n");
+
+      MDBResetStmt(MStmt);
+
       return(FAILURE);
       }
+
+    MDBResetStmt(MStmt);
     }  /* END for (tindex) */  /* write all the reqs via MDBWriteRequest */
 
   return(SUCCESS);
@@ -6288,7 +6557,7 @@ int MDBWriteVC(
   {
   mbool_t DeleteFirst = TRUE;
 
-  static mstmt_t MStmt;
+  mstmt_t *MStmt;
 
   static char Name[MMAX_LINE];
   static char Description[MMAX_LINE];
@@ -6310,25 +6579,29 @@ int MDBWriteVC(
 
   MDB(7,fSOCK) MLog("INFO:     writing VC's to database\n");
 
+  MStmt = &MDBInfo->WriteVCStmt;
+
   if (MDBInfo->WriteVCInitialized == FALSE)
     {
     MDB(7,fSOCK) MLog("INFO:     prepping VC statement\n");
 
-    if (MDBInsertVCStmt(MDBInfo,&MStmt,NULL) == FAILURE)
+    if (MDBInsertVCStmt(MDBInfo,MStmt,NULL) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     error prepping VC statement\n");
       return(FAILURE);
       }
 
-    MDBBindParamText(&MStmt,ParamIndex++,Name,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Description,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Jobs,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Nodes,0);
-    MDBBindParamText(&MStmt,ParamIndex++,VMs,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Rsvs,0);
-    MDBBindParamText(&MStmt,ParamIndex++,VCs,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Variables,0);
-    MDBBindParamText(&MStmt,ParamIndex++,Flags,0);
+    MDBBindParamText(MStmt,ParamIndex++,Name,0);
+    MDBBindParamText(MStmt,ParamIndex++,Description,0);
+    MDBBindParamText(MStmt,ParamIndex++,Jobs,0);
+    MDBBindParamText(MStmt,ParamIndex++,Nodes,0);
+    MDBBindParamText(MStmt,ParamIndex++,VMs,0);
+    MDBBindParamText(MStmt,ParamIndex++,Rsvs,0);
+    MDBBindParamText(MStmt,ParamIndex++,VCs,0);
+    MDBBindParamText(MStmt,ParamIndex++,Variables,0);
+    MDBBindParamText(MStmt,ParamIndex++,Flags,0);
+
+    MDBSetStableParamStmt(MStmt);
 
     MDBInfo->WriteVCInitialized = TRUE;
     }  /* END if (MDBInfo->WriteVCInitialized == FALSE) */
@@ -6376,11 +6649,16 @@ int MDBWriteVC(
     MDB(7,fTRANS) MLog("INFO:     writing VC '%s' to database\n",
       Name);
 
-    if (MDBExecStmt(&MStmt,SC) == FAILURE)
+    if (MDBExecStmt(MStmt,SC) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     failure executing VC statement\n");
+
+      MDBResetStmt(MStmt);
+
       return(FAILURE);
       }
+
+    MDBResetStmt(MStmt);
     }  /* END for (VCIndex = 0;VCIndex < MMAX_VC_DB_WRITE;VCIndex++) */
 
   return(SUCCESS);
@@ -6436,7 +6714,7 @@ int MDBWriteRequests(
   static int   SwapPerTask;                         
   static int   PartitionIndex;                      
   
-  static mstmt_t MStmt;
+  mstmt_t *MStmt;
 
   int rindex;
 
@@ -6449,43 +6727,47 @@ int MDBWriteRequests(
 
   MDB(7,fSOCK) MLog("INFO:     writing requests to database\n");
 
+  MStmt = &MDBInfo->WriteRequestsStmt;
+
   if (MDBInfo->WriteRequestsInitialized == FALSE)
     {
     MDB(7,fSOCK) MLog("INFO:     prepping request statement\n");
 
-    if (MDBInsertRequestStmt(MDBInfo,&MStmt,NULL) == FAILURE)
+    if (MDBInsertRequestStmt(MDBInfo,MStmt,NULL) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     error prepping request statement\n");
       return(FAILURE);
       }
    
-    MDBBindParamText(&MStmt,ParamIndex++,JobID,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&Index,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,AllocNodeList,0);
-    MDBBindParamText(&MStmt,ParamIndex++,AllocPartition,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&PartitionIndex,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,NodeAccessPolicy,0);
-    MDBBindParamText(&MStmt,ParamIndex++,PreferredFeatures,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RequestedApp,0);
-    MDBBindParamText(&MStmt,ParamIndex++,RequestedArch,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqOS,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqNodeSet,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ReqPartition,0);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&MinNodeCount,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&MinTaskCount,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&TaskCount,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&TaskCountPerNode,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&DiskPerTask,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&MemPerTask,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&ProcsPerTask,FALSE);
-    MDBBindParamInteger(&MStmt,ParamIndex++,(int *)&SwapPerTask,FALSE);
-    MDBBindParamText(&MStmt,ParamIndex++,NodeDisk,0);
-    MDBBindParamText(&MStmt,ParamIndex++,NodeFeatures,0);
-    MDBBindParamText(&MStmt,ParamIndex++,NodeMemory,0);
-    MDBBindParamText(&MStmt,ParamIndex++,NodeSwap,0);
-    MDBBindParamText(&MStmt,ParamIndex++,NodeProcs,0);
-    MDBBindParamText(&MStmt,ParamIndex++,GenericResources,0);
-    MDBBindParamText(&MStmt,ParamIndex++,ConfiguredGenericResources,0);
+    MDBBindParamText(MStmt,ParamIndex++,JobID,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&Index,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,AllocNodeList,0);
+    MDBBindParamText(MStmt,ParamIndex++,AllocPartition,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&PartitionIndex,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,NodeAccessPolicy,0);
+    MDBBindParamText(MStmt,ParamIndex++,PreferredFeatures,0);
+    MDBBindParamText(MStmt,ParamIndex++,RequestedApp,0);
+    MDBBindParamText(MStmt,ParamIndex++,RequestedArch,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqOS,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqNodeSet,0);
+    MDBBindParamText(MStmt,ParamIndex++,ReqPartition,0);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&MinNodeCount,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&MinTaskCount,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&TaskCount,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&TaskCountPerNode,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&DiskPerTask,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&MemPerTask,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&ProcsPerTask,FALSE);
+    MDBBindParamInteger(MStmt,ParamIndex++,(int *)&SwapPerTask,FALSE);
+    MDBBindParamText(MStmt,ParamIndex++,NodeDisk,0);
+    MDBBindParamText(MStmt,ParamIndex++,NodeFeatures,0);
+    MDBBindParamText(MStmt,ParamIndex++,NodeMemory,0);
+    MDBBindParamText(MStmt,ParamIndex++,NodeSwap,0);
+    MDBBindParamText(MStmt,ParamIndex++,NodeProcs,0);
+    MDBBindParamText(MStmt,ParamIndex++,GenericResources,0);
+    MDBBindParamText(MStmt,ParamIndex++,ConfiguredGenericResources,0);
+
+    MDBSetStableParamStmt(MStmt);
 
     MDBInfo->WriteRequestsInitialized = TRUE;
     }  /* END if (MDBInfo->WriteRequestsInitialized == FALSE) */
@@ -6536,11 +6818,16 @@ int MDBWriteRequests(
     MDB(7,fTRANS) MLog("INFO:     writing request '%s' to database\n",
       JobID);
 
-    if (MDBExecStmt(&MStmt,SC) == FAILURE)
+    if (MDBExecStmt(MStmt,SC) == FAILURE)
       {
       MDB(7,fSOCK) MLog("INFO:     failure executing request statement\n");
+
+      MDBResetStmt(MStmt);
+
       return(FAILURE);
       }
+
+    MDBResetStmt(MStmt);
     }  /* END for (rindex) */
 
   return(SUCCESS);
@@ -7276,6 +7563,186 @@ int MDBEndTransaction(
 
 
 
+/**
+ * Discard the open transaction of MDBInfo and return it to auto-commit.
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ * @param SC      (O)
+ *
+ * @return FAILURE if MDBInfo was not in a transaction or the rollback failed.
+ */
+
+int MDBRollbackTransaction(
+
+  mdb_t                *MDBInfo,
+  char                 *EMsg,
+  enum MStatusCodeEnum *SC)
+
+  {
+  int rc;
+  const char *FName = "MDBRollbackTransaction";
+
+  MDB(5,fSTRUCT) MLog("%s(MDBInfo,EMsg)\n",
+    FName);
+
+  if (!MDBInTransaction(MDBInfo))
+    return(FAILURE);
+
+  switch (MDBInfo->DBType)
+    {
+    case mdbSQLite3:
+
+      rc = MSQLite3RollbackTransaction(MDBInfo->DBUnion.SQLite3,EMsg);
+
+      break;
+
+    case mdbODBC:
+
+      rc = MODBCRollbackTransaction(MDBInfo->DBUnion.ODBC,EMsg,SC);
+
+      break;
+
+    default:
+
+      rc = FAILURE;
+      break;
+    }
+
+  return(rc);
+  } /* END MDBRollbackTransaction() */
+
+
+
+
+/**
+ * Open a savepoint inside the current transaction of MDBInfo so that a
+ * batch of writes can be undone with MDBRollbackToSavepoint() without
+ * discarding the rest of the transaction.  Only SQLite supports this.
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MDBSetSavepoint(
+
+  mdb_t *MDBInfo,
+  char  *EMsg)
+
+  {
+  int rc;
+
+  if (!MDBInTransaction(MDBInfo))
+    return(FAILURE);
+
+  switch (MDBInfo->DBType)
+    {
+    case mdbSQLite3:
+
+      rc = MSQLite3SetSavepoint(MDBInfo->DBUnion.SQLite3,EMsg);
+
+      break;
+
+    default:
+
+      /* NOTE:  savepoint syntax is not portable across ODBC back ends */
+
+      rc = FAILURE;
+      break;
+    }
+
+  return(rc);
+  } /* END MDBSetSavepoint() */
+
+
+
+
+/**
+ * Keep the writes made since MDBSetSavepoint() and drop the savepoint.
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MDBReleaseSavepoint(
+
+  mdb_t *MDBInfo,
+  char  *EMsg)
+
+  {
+  int rc;
+
+  if (!MDBInTransaction(MDBInfo))
+    return(FAILURE);
+
+  switch (MDBInfo->DBType)
+    {
+    case mdbSQLite3:
+
+      rc = MSQLite3ReleaseSavepoint(MDBInfo->DBUnion.SQLite3,EMsg);
+
+      break;
+
+    default:
+
+      /* NOTE:  savepoint syntax is not portable across ODBC back ends */
+
+      rc = FAILURE;
+      break;
+    }
+
+  return(rc);
+  } /* END MDBReleaseSavepoint() */
+
+
+
+
+/**
+ * Undo the writes made since MDBSetSavepoint() and drop the savepoint.
+ * The enclosing transaction stays open.
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MDBRollbackToSavepoint(
+
+  mdb_t *MDBInfo,
+  char  *EMsg)
+
+  {
+  int rc;
+
+  if (!MDBInTransaction(MDBInfo))
+    return(FAILURE);
+
+  switch (MDBInfo->DBType)
+    {
+    case mdbSQLite3:
+
+      rc = MSQLite3RollbackToSavepoint(MDBInfo->DBUnion.SQLite3,EMsg);
+
+      /* ROLLBACK TO leaves the savepoint open */
+
+      if (rc == SUCCESS)
+        rc = MSQLite3ReleaseSavepoint(MDBInfo->DBUnion.SQLite3,EMsg);
+
+      break;
+
+    default:
+
+      /* NOTE:  savepoint syntax is not portable across ODBC back ends */
+
+      rc = FAILURE;
+      break;
+    }
+
+  return(rc);
+  } /* END MDBRollbackToSavepoint() */
+
+
+
+
 /**
  *
  * @param MDBInfo (I)
@@ -78,6 +78,7 @@ mmutex_t                MDBHandleHashLock;
 
 mclass_t                MClass[MMAX_CLASS + 1];
 msched_t                MSched;
+marena_t                MSchedArena;          /* per-iteration scratch memory, reset by MSchedProcessJobs() */
 mckpt_t                 MCP;
 mpar_t                  MPar[MMAX_PAR + 1];  /* Give one slot more for boundary */
 int                     MParSize = sizeof(MPar);
@@ -34,13 +34,548 @@ int MUGenHash(
   }  /* END MUGenHash() */
 
 
+
+
+/* NOTE:  the table is open-addressed with linear probing and robin hood
+ *        placement--an item that is further from its home slot than the item
+ *        currently occupying a slot takes that slot.  Items are therefore
+ *        kept sorted by home slot within each run, which bounds lookups by
+ *        LongestChain and allows removal by shifting the run back one slot
+ *        (no tombstones).
+ *
+ *        When the table gets too full a table twice the size is allocated
+ *        and the old items are migrated MDEF_HASHREHASHSTEP slots at a time
+ *        on each add/remove, so no single add pays for a full rehash.  While
+ *        the migration is in progress lookups consult both tables.
+ *
+ *        Pointers returned by MUHTIterate() for Name point into the table and
+ *        are only valid until the table is next modified. */
+
+#define MHTSLOTNAME(S) (((S)->LongName != NULL) ? (S)->LongName : (S)->ShortName)
+
+
+
+
+/**
+ * Allocate a zeroed slot array with MHASHSIZE(HashSize) slots.
+ *
+ * @param HashSize (I)
+ */
+
+mhashslot_t *__MUHTAllocSlots(
+
+  int HashSize)  /* I */
+
+  {
+  /* NOTE:  zeroed memory is a valid empty slot (mbitmap_t has no data) */
+
+  return((mhashslot_t *)MUCalloc(1,MHASHSIZE(HashSize) * sizeof(mhashslot_t)));
+  }  /* END __MUHTAllocSlots() */
+
+
+
+
+/**
+ * Mark a slot empty without releasing anything it points to.
+ *
+ * @param S (I) [modified]
+ */
+
+void __MUHTClearSlot(
+
+  mhashslot_t *S)
+
+  {
+  S->Used     = FALSE;
+  S->Dist     = 0;
+  S->Hash     = 0;
+  S->LongName = NULL;
+  S->Ptr      = NULL;
+
+  S->ShortName[0] = '\0';
+
+  bmclear(&S->BM);
+
+  return;
+  }  /* END __MUHTClearSlot() */
+
+
+
+
+/**
+ * Move the item in Src to Dst (ownership of the key, object and BM 
+ * transfers to Dst) and mark Src empty.
+ *
+ * NOTE:  Dst must not hold an item.
+ *
+ * @param Dst (O)
+ * @param Src (I) [modified]
+ */
+
+void __MUHTMoveSlot(
+
+  mhashslot_t *Dst,
+  mhashslot_t *Src)
+
+  {
+  Dst->Used     = Src->Used;
+  Dst->Dist     = Src->Dist;
+  Dst->Hash     = Src->Hash;
+  Dst->LongName = Src->LongName;
+  Dst->Ptr      = Src->Ptr;
+
+  memcpy(Dst->ShortName,Src->ShortName,sizeof(Dst->ShortName));
+
+  Dst->BM = Src->BM;
+
+  __MUHTClearSlot(Src);
+
+  return;
+  }  /* END __MUHTMoveSlot() */
+
+
+
+
+/**
+ * Release the key, BM and (optionally) object held by a slot and mark the
+ * slot empty.
+ *
+ * @param S (I) [modified]
+ * @param Fn (I) [optional]
+ */
+
+void __MUHTFreeSlot(
+
+  mhashslot_t *S,
+  int        (*Fn)(void **))
+
+  {
+  if (S->LongName != NULL)
+    MUFree(&S->LongName);
+
+  if ((S->Ptr != NULL) && (Fn != NULL))
+    (*Fn)(&S->Ptr);
+
+  __MUHTClearSlot(S);
+
+  return;
+  }  /* END __MUHTFreeSlot() */
+
+
+
+
+/**
+ * Release every slot of a slot array (the array itself is not freed).
+ *
+ * @param Table (I) [modified]
+ * @param HashSize (I)
+ * @param Fn (I) [optional]
+ */
+
+void __MUHTFreeSlots(
+
+  mhashslot_t *Table,
+  int          HashSize,
+  int        (*Fn)(void **))
+
+  {
+  unsigned int sindex;
+
+  if (Table == NULL)
+    return;
+
+  for (sindex = 0;sindex < MHASHSIZE(HashSize);sindex++)
+    {
+    if (Table[sindex].Used == TRUE)
+      __MUHTFreeSlot(&Table[sindex],Fn);
+    }
+
+  return;
+  }  /* END __MUHTFreeSlots() */
+
+
+
+
+/**
+ * Locate Name in a slot array.
+ *
+ * NOTE:  OldTable has holes where items were migrated or removed, so empty
+ *        slots do not end the probe there (IsSparse == TRUE).  The probe is
+ *        always bounded by the table's longest chain.
+ *
+ * @param Table (I)
+ * @param HashSize (I)
+ * @param LongestChain (I)
+ * @param IsSparse (I)
+ * @param Hash (I)
+ * @param Name (I)
+ *
+ * @return index of the slot holding Name or -1 if not found
+ */
+
+int __MUHTFindSlot(
+
+  const mhashslot_t *Table,
+  int                HashSize,
+  int                LongestChain,
+  mbool_t            IsSparse,
+  uint32_t           Hash,
+  const char        *Name)
+
+  {
+  uint32_t Mask;
+  uint32_t sindex;
+  unsigned int Dist;
+
+  const mhashslot_t *S;
+
+  if (Table == NULL)
+    {
+    return(-1);
+    }
+
+  Mask = MHASHMASK(HashSize);
+
+  sindex = Hash & Mask;
+
+  for (Dist = 0;Dist <= (unsigned int)LongestChain;Dist++)
+    {
+    S = &Table[sindex];
+
+    if (S->Used == FALSE)
+      {
+      if (IsSparse == FALSE)
+        break;
+      }
+    else
+      {
+      /* robin hood: an item closer to home than our probe means Name is absent */
+
+      if (S->Dist < Dist)
+        break;
+
+      if ((S->Hash == Hash) && !strcmp(MHTSLOTNAME(S),Name))
+        {
+        return((int)sindex);
+        }
+      }
+
+    sindex = (sindex + 1) & Mask;
+    }  /* END for (Dist) */
+
+  return(-1);
+  }  /* END __MUHTFindSlot() */
+
+
+
+
+/**
+ * Open up the slot where an item with the given hash belongs in HT->Table,
+ * shifting the rest of the run forward one slot.  The returned slot is
+ * zeroed except for Used, Dist and Hash.
+ *
+ * NOTE:  caller must guarantee HT->Table has at least one free slot.
+ *
+ * @param HT (I) [modified]
+ * @param Hash (I)
+ *
+ * @return index of the opened slot
+ */
+
+int __MUHTMakeRoom(
+
+  mhash_t  *HT,
+  uint32_t  Hash)
+
+  {
+  uint32_t Mask;
+  uint32_t sindex;
+  uint32_t eindex;
+  uint32_t pindex;
+  unsigned int Dist;
+
+  mhashslot_t *S;
+
+  Mask = MHASHMASK(HT->HashSize);
+
+  sindex = Hash & Mask;
+
+  if (HT->Table[sindex].Used == TRUE)
+    {
+    /* bucket/hash collision detected! */
+
+    HT->NumCollisions++;
+    }
+
+  /* find the first slot that is empty or holds an item closer to home */
+
+  for (Dist = 0;;Dist++)
+    {
+    S = &HT->Table[sindex];
+
+    if ((S->Used == FALSE) || (S->Dist < Dist))
+      break;
+
+    sindex = (sindex + 1) & Mask;
+    }
+
+  if (S->Used == TRUE)
+    {
+    /* shift the remainder of the run up to the next empty slot forward */
+
+    eindex = sindex;
+
+    while (HT->Table[eindex].Used == TRUE)
+      {
+      eindex = (eindex + 1) & Mask;
+      }
+
+    while (eindex != sindex)
+      {
+      pindex = (eindex - 1) & Mask;
+
+      __MUHTMoveSlot(&HT->Table[eindex],&HT->Table[pindex]);
+
+      HT->Table[eindex].Dist++;
+
+      HT->LongestChain = MAX(HT->LongestChain,(int)HT->Table[eindex].Dist);
+
+      eindex = pindex;
+      }
+    }    /* END if (S->Used == TRUE) */
+
+  __MUHTClearSlot(S);
+
+  S->Used = TRUE;
+  S->Dist = Dist;
+  S->Hash = Hash;
+
+  HT->LongestChain = MAX(HT->LongestChain,(int)Dist);
+
+  return((int)sindex);
+  }  /* END __MUHTMakeRoom() */
+
+
+
+
+/**
+ * Remove the item in HT->Table[SIndex], shifting the remainder of its run
+ * back one slot.
+ *
+ * @param HT (I) [modified]
+ * @param SIndex (I)
+ * @param Fn (I) [optional]
+ */
+
+void __MUHTRemoveSlot(
+
+  mhash_t  *HT,
+  int       SIndex,
+  int     (*Fn)(void **))
+
+  {
+  uint32_t Mask;
+  uint32_t sindex;
+  uint32_t nindex;
+
+  Mask = MHASHMASK(HT->HashSize);
+
+  sindex = (uint32_t)SIndex;
+
+  __MUHTFreeSlot(&HT->Table[sindex],Fn);
+
+  for (;;)
+    {
+    nindex = (sindex + 1) & Mask;
+
+    if ((HT->Table[nindex].Used == FALSE) || (HT->Table[nindex].Dist == 0))
+      break;
+
+    __MUHTMoveSlot(&HT->Table[sindex],&HT->Table[nindex]);
+
+    HT->Table[sindex].Dist--;
+
+    sindex = nindex;
+    }
+
+  return;
+  }  /* END __MUHTRemoveSlot() */
+
+
+
+
+/**
+ * Migrate up to Count slots from HT->OldTable into HT->Table.  Frees
+ * OldTable once it has been fully migrated.
+ *
+ * @param HT (I) [modified]
+ * @param Count (I) [-1 = migrate everything]
+ */
+
+int __MUHTRehashStep(
+
+  mhash_t *HT,
+  int      Count)
+
+  {
+  int sindex;
+  int OldSize;
+
+  unsigned int Dist;
+
+  mhashslot_t *S;
+
+  if (HT->OldTable == NULL)
+    {
+    return(SUCCESS);
+    }
+
+  OldSize = (int)MHASHSIZE(HT->OldHashSize);
+
+  while ((HT->RehashIndex < (unsigned int)OldSize) && (Count != 0))
+    {
+    S = &HT->OldTable[HT->RehashIndex++];
+
+    if (Count > 0)
+      Count--;
+
+    if (S->Used == FALSE)
+      continue;
+
+    sindex = __MUHTMakeRoom(HT,S->Hash);
+
+    /* move key, object and BM as-is (ownership transfers to the new slot) */
+
+    Dist = HT->Table[sindex].Dist;
+
+    __MUHTMoveSlot(&HT->Table[sindex],S);
+
+    HT->Table[sindex].Dist = Dist;
+
+    HT->OldNumItems--;
+    }
+
+  if ((HT->RehashIndex >= (unsigned int)OldSize) || (HT->OldNumItems <= 0))
+    {
+    MUFree((char **)&HT->OldTable);
+
+    HT->OldHashSize = 0;
+    HT->OldNumItems = 0;
+    HT->OldLongestChain = 0;
+    HT->RehashIndex = 0;
+    }
+
+  return(SUCCESS);
+  }  /* END __MUHTRehashStep() */
+
+
+
+
+/**
+ * Make sure HT->Table has room for one more item, starting an incremental
+ * rehash into a table twice the size if it is over MDEF_HASHMAXLOAD.
+ *
+ * @param HT (I) [modified]
+ */
+
+int __MUHTReserve(
+
+  mhash_t *HT)
+
+  {
+  mhashslot_t *NewTable;
+
+  int InTable = HT->NumItems - HT->OldNumItems;
+
+  if ((InTable + 1) * 100 <= (int)MHASHSIZE(HT->HashSize) * MDEF_HASHMAXLOAD)
+    {
+    return(SUCCESS);
+    }
+
+  /* previous migration must be complete before the next one starts */
+
+  __MUHTRehashStep(HT,-1);
+
+  InTable = HT->NumItems - HT->OldNumItems;
+
+  NewTable = __MUHTAllocSlots(HT->HashSize + 1);  /* makes table 2x larger */
+
+  if (NewTable == NULL)
+    {
+    /* keep going in the current table as long as there is a free slot */
+
+    if (InTable + 1 < (int)MHASHSIZE(HT->HashSize))
+      return(SUCCESS);
+
+    return(FAILURE);
+    }
+
+  HT->OldTable        = HT->Table;
+  HT->OldHashSize     = HT->HashSize;
+  HT->OldNumItems     = HT->NumItems;
+  HT->OldLongestChain = HT->LongestChain;
+  HT->RehashIndex     = 0;
+
+  HT->Table = NewTable;
+  HT->HashSize++;
+  HT->LongestChain = 0;
+
+  return(SUCCESS);
+  }  /* END __MUHTReserve() */
+
+
+
+
+/**
+ * Locate Name in either table of HT.
+ *
+ * @param HT (I)
+ * @param Name (I)
+ * @param Hash (I)
+ *
+ * @return the slot holding Name or NULL if not found
+ */
+
+mhashslot_t *__MUHTLookup(
+
+  const mhash_t *HT,
+  const char    *Name,
+  uint32_t       Hash)
+
+  {
+  int sindex;
+
+  sindex = __MUHTFindSlot(HT->Table,HT->HashSize,HT->LongestChain,FALSE,Hash,Name);
+
+  if (sindex >= 0)
+    {
+    return(&HT->Table[sindex]);
+    }
+
+  if (HT->OldTable != NULL)
+    {
+    sindex = __MUHTFindSlot(HT->OldTable,HT->OldHashSize,HT->OldLongestChain,TRUE,Hash,Name);
+
+    if (sindex >= 0)
+      {
+      return(&HT->OldTable[sindex]);
+      }
+    }
+
+  return(NULL);
+  }  /* END __MUHTLookup() */
+
+
+
+
+
 /**
  * Creates a hashtable by allocating its memory and creating a hash table array
- * based on HT->HashSize. This function will NOT free an already full 
- * hashtable -- make sure you call MUHTFree() on a hash table before trying to 
+ * based on HT->HashSize. This function will NOT free an already full
+ * hashtable -- make sure you call MUHTFree() on a hash table before trying to
  * "re-create" it.
  *
- * NOTE: You don't have to call MUHTCreate() on a mhash_t structure -- you 
+ * NOTE: You don't have to call MUHTCreate() on a mhash_t structure -- you
  * can use it immediately with MUHTAdd() and it will be automatically created.
  *
  * @param HT (I)
@@ -66,10 +601,10 @@ int MUHTCreate(
   else
     HT->HashSize = MDEF_HASHTABLESIZE;
 
-  /* Allocate memory, verify we got it 
-   * Pointer size * the size of hashtable size (which is a shift factor on a 1)
+  /* Allocate memory, verify we got it
+   * slot size * the size of hashtable size (which is a shift factor on a 1)
    */
-  HT->Table = (mln_t **)MUCalloc(1,MHASHSIZE(HT->HashSize) * sizeof(mln_t *));
+  HT->Table = __MUHTAllocSlots(HT->HashSize);
   if (NULL == HT->Table)
     {
     HT->HashSize = 0;
@@ -122,9 +657,6 @@ int MUHTFree(
   int   (*Fn)(void **))  /* I (optional) */
 
   {
-  int hindex;
-  int MaxSize;
-
   if (HT == NULL)
     {
     return(FAILURE);
@@ -135,23 +667,7 @@ int MUHTFree(
     return(SUCCESS);
     }
 
-  HT->NumCollisions = 0;
-  HT->NumItems = 0;
-  HT->LongestChain = 0;
-
-  MaxSize = MHASHSIZE(HT->HashSize);
-
-  /* Scan list for items in the table */
-  for (hindex = 0;hindex < MaxSize;hindex++)
-    {
-    if (HT->Table[hindex] != NULL)
-      {
-      if (FreeObjects == TRUE)
-        MULLFree(&HT->Table[hindex],Fn);
-      else
-        MULLFree(&HT->Table[hindex],NULL);
-      }
-    }
+  MUHTClear(HT,FreeObjects,Fn);
 
   MUFree((char **)&HT->Table);
   HT->HashSize = 0;
@@ -176,9 +692,6 @@ int MUHTClear(
   int   (*Fn)(void **))  /* I (optional) */
 
   {
-  int hindex;
-  int MaxSize;
-
   if (HT == NULL)
     {
     return(FAILURE);
@@ -189,23 +702,27 @@ int MUHTClear(
     return(SUCCESS);
     }
 
-  HT->NumCollisions = 0;
-  HT->NumItems = 0;
-  HT->LongestChain = 0;
+  if (FreeObjects != TRUE)
+    Fn = NULL;
 
-  MaxSize = MHASHSIZE(HT->HashSize);
+  __MUHTFreeSlots(HT->Table,HT->HashSize,Fn);
 
-  for (hindex = 0;hindex < MaxSize;hindex++)
+  if (HT->OldTable != NULL)
     {
-    if (HT->Table[hindex] != NULL)
-      {
-      if (FreeObjects == TRUE)
-        MULLFree(&HT->Table[hindex],Fn);
-      else
-        MULLFree(&HT->Table[hindex],NULL);
-      }
+    __MUHTFreeSlots(HT->OldTable,HT->OldHashSize,Fn);
+
+    MUFree((char **)&HT->OldTable);
     }
 
+  HT->NumCollisions = 0;
+  HT->NumItems = 0;
+  HT->LongestChain = 0;
+
+  HT->OldHashSize = 0;
+  HT->OldNumItems = 0;
+  HT->OldLongestChain = 0;
+  HT->RehashIndex = 0;
+
   return(SUCCESS);
   }  /* MUHTClear() */
 
@@ -217,10 +734,8 @@ int MUHTClear(
  * extra function or work is needed.
  *
  * NOTE: if you are passing in objects that you want to be freed when
- *   they are removed from the table, you should pass in Fn.  This is
- *   also used when growing the table, so if you don't pass it in the
- *   add, you may get a memory leak (if you are passing in a char *,
- *   for example).
+ *   they are overridden, you should pass in Fn (if you are passing in
+ *   a char *, for example).
  *
  * @param HT (I)
  * @param Name (I)
@@ -239,10 +754,11 @@ int MUHTAdd(
   int       (*Fn)(void **)) /* I (optional) */
 
   {
-  int Hash = 0;
-  int Bucket = 0;
-  int OldLSize = 0;
-  mln_t *LLPtr;
+  uint32_t Hash;
+  int      sindex;
+  size_t   NameLen;
+
+  mhashslot_t *S;
 
   if ((HT == NULL) || (Name == NULL))
     {
@@ -259,73 +775,69 @@ int MUHTAdd(
       }
     }
 
-  /* rehash if longest chain grows too large! */
-
-  if (HT->LongestChain >= MDEF_HASHCHAINMAX)
-    {
-    mhash_t NewHash;
-    mhashiter_t HTIter;
-    char *VarName;
-    void *VarVal;
-    mbitmap_t VarBM;
-
-    /* need to grow table and rehash */
+  /* The best hash table sizes are powers of 2.  There is no need to do
+   * mod a prime (mod is sooo slow!).  If you need less than 32 bits,
+   * use a bitmask.  For example, if you need only 10 bits, do
+   *   h = (h & MHASHMASK(10));
+   *   In which case, the hash table should have MHASHSIZE(10) elements. */
 
-    MUHTCreate(&NewHash,HT->HashSize+1);  /* makes table 2x larger */
+  Hash = (uint32_t)MUGenHash(Name);
 
-    MUHTIterInit(&HTIter);
+  if ((S = __MUHTLookup(HT,Name,Hash)) != NULL)
+    {
+    /* existing item--replace payload (same semantics as MULLAdd()) */
 
-    while (MUHTIterate(HT,&VarName,&VarVal,&VarBM,&HTIter) == SUCCESS)
+    if (S->Ptr == NULL)
       {
-      MUHTAdd(&NewHash,VarName,VarVal,&VarBM,Fn);
+      S->Ptr = Object;
       }
+    else if ((Object != NULL) && (Object != S->Ptr))
+      {
+      if (Fn != NULL)
+        (*Fn)(&S->Ptr);
 
-    /* free old table */
+      S->Ptr = Object;
+      }
 
-    MUHTFree(HT,FALSE,Fn);
+    if (BM != NULL)
+      bmcopy(&S->BM,BM);
 
-    /* copy over new table */
+    return(SUCCESS);
+    }
 
-    memcpy(HT,&NewHash,sizeof(mhash_t));
-    memset(&NewHash,0x0,sizeof(mhash_t));
+  if (__MUHTReserve(HT) == FAILURE)
+    {
+    return(FAILURE);
     }
 
-  /* The best hash table sizes are powers of 2.  There is no need to do
-   * mod a prime (mod is sooo slow!).  If you need less than 32 bits,
-   * use a bitmask.  For example, if you need only 10 bits, do
-   *   h = (h & MHASHMASK(10));
-   *   In which case, the hash table should have MHASHSIZE(10) elements. */
+  sindex = __MUHTMakeRoom(HT,Hash);
 
-  Hash = MUGenHash(Name);
+  S = &HT->Table[sindex];
 
-  Bucket = (Hash & MHASHMASK(HT->HashSize));
+  NameLen = strlen(Name);
 
-  if (HT->Table[Bucket] == NULL)
+  if (NameLen < sizeof(S->ShortName))
     {
-    MULLCreate(&HT->Table[Bucket]);
+    memcpy(S->ShortName,Name,NameLen + 1);
     }
+  else if (MUStrDup(&S->LongName,Name) == FAILURE)
+    {
+    __MUHTRemoveSlot(HT,sindex,NULL);
 
-  OldLSize = HT->Table[Bucket]->ListSize;
+    return(FAILURE);
+    }
 
-  MULLAdd(&HT->Table[Bucket],Name,Object,&LLPtr,Fn);
+  S->Ptr = Object;
 
   if (BM != NULL)
-    LLPtr->BM = *BM;
+    bmcopy(&S->BM,BM);
 
-  if (OldLSize < HT->Table[Bucket]->ListSize)
-    {
-    if (OldLSize > 0)
-      {
-      /* bucket/hash collision detected! */
+  HT->NumItems++;  /* mark that we've added an item */
 
-      HT->NumCollisions++;
-      }
+  /* migrate after the add so Name cannot be moved out from under us */
 
-    HT->NumItems++;  /* mark that we've added an item */
-    }
+  __MUHTRehashStep(HT,MDEF_HASHREHASHSTEP);
 
-  HT->LongestChain = MAX(HT->Table[Bucket]->ListSize,HT->LongestChain);
-    
   return(SUCCESS);
   }  /* END MUHTAdd() */
 
@@ -342,7 +854,7 @@ int MUHTAdd(
  * NOTE: Performs a DEEP copy and strdups VarVal
  *
  * NOTE: only works on J->TVariables (ie data is null terminated string)
- * 
+ *
  * @param Dst (O)
  * @param Src (I)
  */
@@ -388,7 +900,7 @@ int MUHTCopy(
  */
 
 int MUHTAddCI(
- 
+
   mhash_t     *HT,
   const char  *Name,
   void        *Object,
@@ -466,8 +978,8 @@ int MUHTRemove(
   int        (*Fn)(void **))
 
   {
-  int Hash = 0;
-  int Bucket = 0;
+  uint32_t Hash;
+  int      sindex;
 
   if ((HT == NULL) ||
       (HT->Table == NULL) ||
@@ -476,31 +988,36 @@ int MUHTRemove(
     return(FAILURE);
     }
 
-  Hash = MUGenHash(Name);
+  Hash = (uint32_t)MUGenHash(Name);
 
-  Bucket = (Hash & MHASHMASK(HT->HashSize));
+  sindex = __MUHTFindSlot(HT->Table,HT->HashSize,HT->LongestChain,FALSE,Hash,Name);
 
-  if (HT->Table[Bucket] == NULL)
+  if (sindex >= 0)
     {
-    return(FAILURE);
+    __MUHTRemoveSlot(HT,sindex,Fn);
     }
   else
     {
-    int OldLSize;
+    sindex = __MUHTFindSlot(HT->OldTable,HT->OldHashSize,HT->OldLongestChain,TRUE,Hash,Name);
 
-    OldLSize = HT->Table[Bucket]->ListSize;
-
-    if (MULLRemove(&HT->Table[Bucket],Name,Fn) == SUCCESS)
-      {
-      if ((HT->Table[Bucket] == NULL) || (OldLSize > HT->Table[Bucket]->ListSize))
-        HT->NumItems--;
-      }
-    else
+    if (sindex < 0)
       {
       return(FAILURE);
       }
+
+    /* OldTable is probed sparsely--leave a hole */
+
+    __MUHTFreeSlot(&HT->OldTable[sindex],Fn);
+
+    HT->OldNumItems--;
     }
 
+  HT->NumItems--;
+
+  /* migrate after the remove (Name may point into the table) */
+
+  __MUHTRehashStep(HT,MDEF_HASHREHASHSTEP);
+
   return(SUCCESS);
   }  /* END MUHTRemove() */
 
@@ -520,8 +1037,8 @@ int MUHTRemove(
 
 int MUHTRemoveCI(
 
-  mhash_t     *HT,           
-  const char  *Name,        
+  mhash_t     *HT,
+  const char  *Name,
   int        (*Fn)(void **))
 
   {
@@ -565,7 +1082,7 @@ int MUHTRemoveInt(
 
 
 /**
- * Return an object in the hashtable for the given Name (which is a string 
+ * Return an object in the hashtable for the given Name (which is a string
  * and is acting as the key).
  *
  * @see MUHTGetInt() - peer
@@ -585,10 +1102,7 @@ int MUHTGet(
   mbitmap_t  *BM)     /* O (optional) */
 
   {
-  int Hash = 0;
-  int Bucket = 0;
-  mln_t *LLPtr;
-  int rc;
+  mhashslot_t *S;
 
   if (Object != NULL)
     *Object = NULL;
@@ -603,27 +1117,20 @@ int MUHTGet(
     return(FAILURE);
     }
 
-  Hash = MUGenHash(Name);
-
-  Bucket = (Hash & MHASHMASK(HT->HashSize));
-
-  if (HT->Table[Bucket] == NULL)
-    {
-    return(FAILURE);
-    }
+  /* NOTE:  lookups never migrate slots so concurrent readers are safe */
 
-  rc = MULLCheckCS(HT->Table[Bucket],Name,&LLPtr);
+  S = __MUHTLookup(HT,Name,(uint32_t)MUGenHash(Name));
 
-  if (rc == FAILURE)
+  if (S == NULL)
     {
     return(FAILURE);
     }
 
   if (Object != NULL)
-    *Object = LLPtr->Ptr;
+    *Object = S->Ptr;
 
   if (BM != NULL)
-    bmcopy(BM,&LLPtr->BM);
+    bmcopy(BM,&S->BM);
 
   return(SUCCESS);
   }  /* END MUHTGet() */
@@ -643,9 +1150,9 @@ int MUHTGet(
  * @param BM (O) [optional]
  * @return FAILURE if the given key is not in the hashtable.
  */
- 
+
 int MUHTGetCI(
- 
+
   mhash_t    *HT,     /* I */
   char const *Name,   /* I */
   void      **Object, /* O (optional) */
@@ -737,6 +1244,9 @@ int MUHTIterInit(
  * WARNING: Make sure Iter object is initialized with MUHTIterInit() before
  * calling this function.
  *
+ * WARNING: Do not add to or remove from HT while iterating over it (collect
+ * the keys and remove them afterwards).
+ *
  * @param HT (I)
  * @param Name (O) optional
  * @param Object (O) optional
@@ -753,7 +1263,9 @@ int MUHTIterate(
   mhashiter_t     *Iter)
 
   {
-  mln_t *tmpLL;
+  mhashslot_t *S;
+
+  unsigned int OldSize;
 
   if (Name != NULL)
     *Name = NULL;
@@ -774,45 +1286,33 @@ int MUHTIterate(
     return(FAILURE);
     }
 
-  /* find the next full bucket if we are not already in one */
+  /* OldTable (if a rehash is in progress) is visited first, then Table */
 
-  if (Iter->LLNode == NULL)
-    {
-    while (Iter->Bucket < MHASHSIZE(HT->HashSize))
-      {
-      if (HT->Table[Iter->Bucket] == NULL)
-        {
-        Iter->Bucket++;
-
-        continue;
-        }
+  OldSize = (HT->OldTable != NULL) ? MHASHSIZE(HT->OldHashSize) : 0;
 
-      Iter->LLNode = HT->Table[Iter->Bucket];
-      Iter->Bucket++;
-
-      break;
-      }
-    }
+  while (Iter->Bucket < OldSize + MHASHSIZE(HT->HashSize))
+    {
+    if (Iter->Bucket < OldSize)
+      S = &HT->OldTable[Iter->Bucket];
+    else
+      S = &HT->Table[Iter->Bucket - OldSize];
 
-  /* find the next item in the bucket, if we are already in a valid bucket */
+    Iter->Bucket++;
 
-  while (Iter->LLNode != NULL)
-    {
-    tmpLL = Iter->LLNode;
+    if (S->Used == FALSE)
+      continue;
 
     if (Name != NULL)
-      *Name = tmpLL->Name;
+      *Name = MHTSLOTNAME(S);
 
     if (Object != NULL)
-      *Object = tmpLL->Ptr;
+      *Object = S->Ptr;
 
     if (BM != NULL)
-      *BM = tmpLL->BM;
-
-    Iter->LLNode = tmpLL->Next;
+      *BM = S->BM;
 
     return(SUCCESS);
-    }  /* END while (Iter->LLNode != NULL) */
+    }  /* END while (Iter->Bucket < ...) */
 
   return(FAILURE);
   }  /* END MUHTIterate() */
@@ -24,164 +24,36 @@
 
 
 /**
- * Calculate job start priority.
+ * Load the job-independent priority weights and caps for a partition.
  *
- * @see MJobGetRunPriority()
- * @see MJobGetBackfillPriority()
+ * Weights come from F, falling back to GF where F does not set them, and
+ * sub-components disabled in MPar[0] get a weight of 0.
  *
- * @param J (I) [optional]
- * @param P (I)
- * @param Priority (O)
- * @param Mode (I) [mpdJob, mpdFooter, or mpdHeader]
- * @param RE (O)
- * @param String (O)
- * @param DFormat (O)
- * @param ShowJobName (I)
+ * @see MJobCalcStartPriority()
+ * @see __MJobPrioAdjustWeights() - applies per-job weight adjustments
+ *
+ * @param F (I)
+ * @param GF (I)
+ * @param CWeight (O) [mpcLAST]
+ * @param SWeight (O) [mpsLAST]
+ * @param CCap (O) [mpcLAST]
+ * @param SCap (O) [mpsLAST]
+ * @param MinWCLimit (O)
  */
 
-int MJobCalcStartPriority(
+static int __MJobPrioGetWeights(
 
-  mjob_t                *J,
-  const mpar_t          *P,
-  double                *Priority,
-  enum MPrioDisplayEnum  Mode,
-  mxml_t               **RE,
-  mstring_t             *String,
-  enum MFormatModeEnum   DFormat,
-  mbool_t                ShowJobName)
+  const mfsc_t  *F,
+  const mfsc_t  *GF,
+  long          *CWeight,
+  long          *SWeight,
+  long          *CCap,
+  long          *SCap,
+  unsigned long *MinWCLimit)
 
   {
-  double        Prio;
-  double        APrio;
-
-  double        XFactor;
-
-  double        FSTargetUsage;
-
-  enum MFSTargetEnum FSTargetMode;
-
-  char          CHeader[mpcLAST][MMAX_NAME];    
-  char          CWLine[mpcLAST][MMAX_NAME];    
-  char          CFooter[mpcLAST][MMAX_NAME];  
-  char          CLine[mpcLAST][MMAX_NAME];
-
-  char          tmpHeader[MMAX_NAME];
-  char          tmpCWLine[MMAX_NAME];
-  char          tmpLine[MMAX_NAME];
-
-  double        CFactor[mpcLAST];  /* component factors */
-  double        SFactor[mpsLAST];  /* sub-component factors */
-
-  long          CWeight[mpcLAST];  /* component weights */
-  long          SWeight[mpsLAST];  /* sub-component weights */
-
-  static double TotalCFactor[mpcLAST];
-  static double TotalSFactor[mpsLAST];
-
-  double        CP[mpcLAST];       /* component percentages */
-  double        SP[mpsLAST];       /* sub-component percentages */
-
-  static double TotalPriority;
-
-  static int    SDisplay[mpsLAST];
-
-  const mfsc_t       *F;
-  mfsc_t       *GF;
-
-  mpar_t       *GP;
-
-  mreq_t       *RQ;
-
-  int           rqindex;
-  int           qindex;
-  int           index;
-
-  int           cindex;
-  int           sindex;
-
-  int           Target;
-  enum MFSTargetEnum TargetMod;
-
-  int           PC;
-
-  long          CCap[mpcLAST];
-  long          SCap[mpsLAST];
-
-  long          EffQDate;
-
-  long          tmpL;
-  char          tmpS[MMAX_NAME];
-
-  unsigned long MinWCLimit = 0;
-
-  mxml_t      *E = NULL;  /* set to avoid compiler warning */
-  mxml_t      *JE;
-  mxml_t      *CE;
-  mxml_t      *SE;
-
-  /* XML Format:  <data><job name="header"><prioc name="service" value="1000"><prios name="queuetime" value="1"></prios></prioc></job><job name="job13725" priority="93271"><prioc name="service"><priosub name="queuetime" value="100" metric="100 seconds"></priosub></prioc><prioc name="cred" value="10000"><prios name="user" value="100"></prios></prioc></job></data> */
-
-  const char *FName = "MJobCalcStartPriority";
-
-  MDB(6,fSCHED) MLog("%s(%s,%s,%s,%u,RE,String,%s)\n",
-    FName,
-    (J != NULL) ? J->Name : "NULL",
-    (P != NULL) ? P->Name : "NULL",
-    (Priority != NULL) ? "Priority" : "NULL",
-    Mode,
-    MFormatMode[DFormat]);
-
-  if (Priority != NULL)
-    *Priority = 0.0;
-
-  /* NOTE: routine used to diagnose priority */
-
-  GF = &MPar[0].FSC;
-
-  F  = (P != NULL) ? &P->FSC : GF;
-
-/*
-  F = GF;
-*/
-
-  GP = &MPar[0];
-
-  /* NOTE:  do not initialize Buffer */
-
-  if (DFormat == mfmXML)
-    {
-    if ((RE == NULL) && (Mode != mpdJob))
-      {
-      return(FAILURE);
-      }
-
-    if (RE != NULL)
-      {
-      if (*RE == NULL)
-        {
-        MXMLCreateE(RE,(char *)MSON[msonData]);
-        }
-
-      E = *RE;
-      }
-    }
-  else
-    {
-    if ((Mode != mpdJob) && (String == NULL))
-      {
-      return(FAILURE);
-      }
-
-    /* DON'T initialize String */
-    }
-
-  if ((Mode == mpdJob) && (J == NULL))
-    {
-    /* can't calculcate priority on NULL job */
+  int index;
 
-    return(FAILURE);
-    }
- 
   for (index = 1;index < mpcLAST;index++)
     {
     CWeight[index] = (F->PCW[index] != MCONST_PRIO_NOTSET) ? 
@@ -200,9 +72,6 @@ int MJobCalcStartPriority(
       CCap[index],
       F->PCC[index],
       GF->PCC[index]);
-
-    CFactor[index] = 0.0;
-    CP[index]      = 0.0;
     }  /* END for (index) */
  
   for (index = 0;index < mpsLAST;index++)
@@ -223,9 +92,6 @@ int MJobCalcStartPriority(
       SCap[index],
       F->PSC[index],
       GF->PSC[index]);
-
-    SFactor[index] = 0.0;
-    SP[index]      = 0.0;
     }  /* END for (index) */
 
   for (index = mpsCU;index <= mpsCC;index++)
@@ -240,707 +106,281 @@ int MJobCalcStartPriority(
       SWeight[index] = 0;
     }
 
-  /* apply credential based weight adjustments */
+  *MinWCLimit = (F->XFMinWCLimit != -1) ? F->XFMinWCLimit : GF->XFMinWCLimit;
 
-  if ((J != NULL) && (J->Credential.Q != NULL))
-    {
-    SWeight[mpsSQT] += J->Credential.Q->QTSWeight;
-    SWeight[mpsSXF] += J->Credential.Q->XFSWeight;
-    }
+  return(SUCCESS);
+  }  /* END __MJobPrioGetWeights() */
 
-  MinWCLimit = (F->XFMinWCLimit != -1) ? F->XFMinWCLimit : GF->XFMinWCLimit;
 
-  if (J != NULL)
-    {
-    if (J->Credential.A != NULL)
-      {
-      CWeight[mpcFS] += J->Credential.A->FSCWeight;
-      }
 
-    if (J->Credential.G != NULL)
-      {
-      CWeight[mpcFS] += J->Credential.G->FSCWeight;
-      }
 
-    if (J->Credential.Q != NULL)
-      {
-      CWeight[mpcFS] += J->Credential.Q->FSCWeight;
-      }
 
-    if (J->Credential.G != NULL)
-      {
-      if (J->Credential.G->ClassSWeight > 0)
-        SWeight[mpsCC] = J->Credential.G->ClassSWeight;
-      }
-    }    /* END if (J != NULL) */
+/**
+ * Apply credential based weight adjustments for J.
+ *
+ * @param J (I) [optional]
+ * @param CWeight (I/O) [mpcLAST]
+ * @param SWeight (I/O) [mpsLAST]
+ */
 
-  if (Mode == mpdHeader)
-    {
-    /* initialize summary values/create header */
+static int __MJobPrioAdjustWeights(
 
-    memset(TotalCFactor,0,sizeof(TotalCFactor));
-    memset(TotalSFactor,0,sizeof(TotalSFactor));      
-    memset(SDisplay,FALSE,sizeof(SDisplay));        
+  const mjob_t *J,
+  long         *CWeight,
+  long         *SWeight)
 
-    memset(CHeader,0,sizeof(CHeader));      
-    memset(CWLine,0,sizeof(CWLine));  
+  {
+  if (J == NULL)
+    {
+    return(SUCCESS);
+    }
 
-    TotalPriority = 0.0;
+  if (J->Credential.Q != NULL)
+    {
+    SWeight[mpsSQT] += J->Credential.Q->QTSWeight;
+    SWeight[mpsSXF] += J->Credential.Q->XFSWeight;
+    }
 
-    if (DFormat == mfmXML)
-      {
-      JE = NULL;
+  if (J->Credential.A != NULL)
+    {
+    CWeight[mpcFS] += J->Credential.A->FSCWeight;
+    }
 
-      MXMLCreateE(&JE,"job");
-      MXMLSetAttr(JE,"name",(void **)"template",mdfString);
+  if (J->Credential.G != NULL)
+    {
+    CWeight[mpcFS] += J->Credential.G->FSCWeight;
+    }
 
-      MXMLAddE(E,JE);
+  if (J->Credential.Q != NULL)
+    {
+    CWeight[mpcFS] += J->Credential.Q->FSCWeight;
+    }
 
-      for (cindex = mpcServ;cindex <= mpcUsage;cindex++)
-        {
-        CE = NULL;
+  if (J->Credential.G != NULL)
+    {
+    if (J->Credential.G->ClassSWeight > 0)
+      SWeight[mpsCC] = J->Credential.G->ClassSWeight;
+    }
 
-        MXMLCreateE(&CE,MCONST_PRIOCOMPNAME);
-        MXMLSetAttr(CE,"name",(void **)MPrioCName[cindex],mdfString);
-        MXMLSetAttr(CE,"value",(void **)&CWeight[cindex],mdfLong);
+  return(SUCCESS);
+  }  /* END __MJobPrioAdjustWeights() */
 
-        MXMLAddE(JE,CE);
 
-        for (sindex = MPSCStart[cindex];sindex <= MPSCEnd[cindex];sindex++)
-          {
-          SE = NULL;
-  
-          MXMLCreateE(&SE,MCONST_PRIOSUBCOMPNAME);
-          MXMLSetAttr(SE,"name",(void **)MPrioSCName[sindex],mdfString);
-          MXMLSetAttr(SE,"value",(void **)&SWeight[sindex],mdfLong);
 
-          MXMLAddE(CE,SE);
-          }  /* END for (sindex) */
-        }    /* END for (cindex) */
-      }
-    else 
-      {
-      if (CWeight[mpcCred] != 0)
-        {
-        tmpHeader[0] = '\0';
-        tmpCWLine[0] = '\0';     
 
-        for (index = mpsCU;index <= mpsCC;index++)
-          {
-          if (SWeight[index] == 0)
-            continue;
 
-          if (tmpHeader[0] != '\0')
-            {
-            strcat(tmpHeader,":");
-            strcat(tmpCWLine,":");
-            }
+/**
+ * Determine the effective queue date and the xfactor of J.
+ *
+ * NOTE:  sets J->EffXFactor
+ *
+ * @param J (I/O)
+ * @param MinWCLimit (I)
+ * @param EffQDateP (O)
+ * @param XFactorP (O)
+ */
 
-          switch (index)
-            {
-            case mpsCU: strcat(tmpHeader," User"); break;
-            case mpsCG: strcat(tmpHeader,"Group"); break;        
-            case mpsCA: strcat(tmpHeader,"Accnt"); break;        
-            case mpsCC: strcat(tmpHeader,"Class"); break;        
-            case mpsCQ: strcat(tmpHeader,"  QOS"); break;        
-            }
+static int __MJobPrioGetXFactor(
 
-          sprintf(tmpCWLine,"%s%5ld",
-            tmpCWLine,
-            (long)SWeight[index]);
-          }  /* END for (index) */
+  mjob_t        *J,
+  unsigned long  MinWCLimit,
+  long          *EffQDateP,
+  double        *XFactorP)
 
-        if (tmpHeader[0] != '\0')
-          {
-          sprintf(CHeader[mpcCred],"  Cred(%s)",
-            tmpHeader);
+  {
+  long   EffQDate;
+  double XFactor;
 
-          sprintf(CWLine[mpcCred]," %5ld(%s)",
-            CWeight[mpcCred],
-            tmpCWLine);
-          }
-        }    /* END if (CWeight[mpcCred] != 0) */
+  if (J->SpecWCLimit[0] == 0)
+    {
+    MDB(0,fSCHED) MLog("ERROR:    job '%s' has no WCLimit specified\n",
+      J->Name);
+    }
 
-    if (CWeight[mpcFS] != 0)
-      {
-      tmpHeader[0] = '\0';
-      tmpCWLine[0] = '\0';
- 
-      for (index = MPSCStart[mpcFS];index <= MPSCEnd[mpcFS];index++)
-        {
-        if (SWeight[index] == 0)
-          continue;
+  if (J->EffQueueDuration >= 0)
+    {
+    EffQDate = MSched.Time - J->EffQueueDuration;
+    
+    MDB(7,fSCHED) MLog("INFO:    EffQDate is MSched.Time (%ld) - J->EffQueueDuration (%ld)\n",MSched.Time,J->EffQueueDuration); /* BRIAN - debug (2400) */
+    }
+  else if (bmisset(&MPar[0].Flags,mpfUseSystemQueueTime))
+    {
+    EffQDate = J->SystemQueueTime;
+    
+    MDB(7,fSCHED) MLog("INFO:    EffQDate is J->SystemQueueTime (%ld)\n",J->SystemQueueTime); /* BRIAN - debug (2400) */
+    }
+  else
+    {
+    EffQDate = J->SubmitTime;
+    
+    MDB(7,fSCHED) MLog("INFO:    EffQDate is J->SubmitTime (%ld)\n",J->SubmitTime); /* BRIAN - debug (2400) */
+    }
 
-        if (tmpHeader[0] != '\0')
-          {
-          strcat(tmpHeader,":");
-          strcat(tmpCWLine,":");
-          }
+  MDB(7,fSCHED) MLog("INFO:    EffQDate is min of MSched.Time (%ld) and EffQDate (%ld)\n",MSched.Time,EffQDate); /* BRIAN - debug (2400) */
+  EffQDate = MIN((long)MSched.Time,EffQDate);
 
-        switch (index)
-          {
-          case mpsFU:    strcat(tmpHeader," User"); break;
-          case mpsFG:    strcat(tmpHeader,"Group"); break;
-          case mpsFA:    strcat(tmpHeader,"Accnt"); break;
-          case mpsFC:    strcat(tmpHeader,"Class"); break;
-          case mpsFQ:    strcat(tmpHeader,"  QOS"); break;
-          case mpsGFU:   strcat(tmpHeader,"GUser"); break;
-          case mpsGFG:   strcat(tmpHeader," GGrp"); break;
-          case mpsGFA:   strcat(tmpHeader,"GAcct"); break;
-          case mpsFUWCA: strcat(tmpHeader,"  WCA"); break;
-          case mpsFJPU:  strcat(tmpHeader,"  JPU"); break;
-          case mpsFJRPU: strcat(tmpHeader," JRPU"); break;
-          case mpsFPPU:  strcat(tmpHeader,"  PPU"); break;
-          case mpsFPSPU: strcat(tmpHeader," PSPU"); break;
-          }  /* END switch (index) */
- 
-        sprintf(tmpCWLine,"%s%5ld",
-          tmpCWLine,
-          SWeight[index]);
-        }  /* END for (index) */
- 
-      if (tmpHeader[0] != '\0')
-        {
-        sprintf(CHeader[mpcFS],"    FS(%s)",
-          tmpHeader);
- 
-        sprintf(CWLine[mpcFS]," %5ld(%s)",
-          CWeight[mpcFS],
-          tmpCWLine);
-        }
-      }    /* END if (CWeight[mpcFS] != 0) */
+  MDB(7,fSCHED) MLog("INFO:    MSched.Time = %ld\n EffQDate = %ld\n (MSched.Time - EffQDate) = %ld\n J->SpecWCLimit = %ld\n (MSched.Time - EffQDate) + J->SpecWClimit) = %ld\n MinWCLimit = %ld\n Result = %ld\n", /* BRIAN - debug (2400) */
+      MSched.Time,
+      EffQDate,
+      MSched.Time - EffQDate,
+      J->SpecWCLimit[0],
+      (MSched.Time - EffQDate) + J->SpecWCLimit[0],
+      MinWCLimit,
+      (((MSched.Time - EffQDate) + J->SpecWCLimit[0])/(MAX(1,MAX(MinWCLimit,J->SpecWCLimit[0])))));
 
-    if (CWeight[mpcAttr] != 0)
-      {
-      tmpHeader[0] = '\0';
-      tmpCWLine[0] = '\0';
+  XFactor = (double)(((unsigned long)(MSched.Time - EffQDate) + J->SpecWCLimit[0])) / 
+    MAX(1,MAX(MinWCLimit,J->SpecWCLimit[0]));
 
-      for (index = MPSCStart[mpcAttr];index <= MPSCEnd[mpcAttr];index++)
-        {
-        /* handle job attr based priority weights */
+  J->EffXFactor = XFactor;
 
-        switch (index)
-          {
-          case mpsAAttr:
-          case mpsAGRes:
-          case mpsAJobID:
-          case mpsAJobName:
-          case mpsAState:
-        
-            if (SWeight[index] != 0)
-              {
-              SDisplay[index] = TRUE;
-              }
+  MDB(7,fSCHED) MLog("INFO:   XFactor = %f\n",XFactor); /* BRIAN - debug (2400) */
 
-            break;
+  *EffQDateP = EffQDate;
+  *XFactorP  = XFactor;
 
-          default:
+  return(SUCCESS);
+  }  /* END __MJobPrioGetXFactor() */
 
-            /* NO-OP */
 
-            break;
-          }  /* END switch (index) */
 
-        if ((SWeight[index] == 0) && (SDisplay[index] == FALSE))
-          continue;
 
-        if (tmpHeader[0] != '\0')
-          {
-          strcat(tmpHeader,":");
-          strcat(tmpCWLine,":");
-          }
 
-        switch (index)
-          {
-          case mpsAAttr:    strcat(tmpHeader," Attr"); break;
-          case mpsAGRes:    strcat(tmpHeader," GRes"); break;
-          case mpsAJobID:   strcat(tmpHeader,"  JID"); break;
-          case mpsAJobName: strcat(tmpHeader," Name"); break;
-          case mpsAState:   strcat(tmpHeader,"State"); break;
-          }
+/**
+ * Calculate the credential component of J's start priority.
+ *
+ * @param J (I)
+ * @param SWeight (I) [mpsLAST]
+ * @param SCap (I) [mpsLAST]
+ * @param SFactor (O) [mpsLAST]
+ * @param CFactor (O) [mpcLAST]
+ */
 
-        sprintf(tmpCWLine,"%s%5ld",
-          tmpCWLine,
-          SWeight[index]);
-        }  /* END for (index) */
+static int __MJobPrioGetCredFactor(
 
-      if (tmpHeader[0] != '\0')
-        {
-        sprintf(CHeader[mpcAttr],"  Attr(%s)",
-          tmpHeader);
+  const mjob_t *J,
+  const long   *SWeight,
+  const long   *SCap,
+  double       *SFactor,
+  double       *CFactor)
 
-        sprintf(CWLine[mpcAttr]," %5ld(%s)",
-          CWeight[mpcAttr],
-          tmpCWLine);
-        }    /* END for (index) */
-      }      /* END if (CWeight[mpcAttr] != 0) */
+  {
+  int index;
 
-    if (CWeight[mpcServ] != 0)
-      {
-      tmpHeader[0] = '\0';
-      tmpCWLine[0] = '\0';
+  if ((J->Credential.U != NULL) && (J->Credential.U->F.Priority != 0))       
+    SFactor[mpsCU] = J->Credential.U->F.Priority;
+  else if (MSched.DefaultU != NULL)
+    SFactor[mpsCU] = MSched.DefaultU->F.Priority;
 
-      for (index = MPSCStart[mpcServ];index <= MPSCEnd[mpcServ];index++)
-        {
-        /* handle QOS based service priority weights */
+  if ((J->Credential.G != NULL) && (J->Credential.G->F.Priority != 0))          
+    SFactor[mpsCG] = J->Credential.G->F.Priority;
+  else if (MSched.DefaultG != NULL)
+    SFactor[mpsCG] = MSched.DefaultG->F.Priority;
 
-        switch (index)
-          {
-          case mpsSQT:
+  if ((J->Credential.A != NULL) && (J->Credential.A->F.Priority != 0))     
+    SFactor[mpsCA] = J->Credential.A->F.Priority; 
+  else if (MSched.DefaultA != NULL)
+    SFactor[mpsCA] = MSched.DefaultA->F.Priority;         
+    
+  if ((J->Credential.Q != NULL) && (J->Credential.Q->F.Priority != 0))
+    SFactor[mpsCQ] = J->Credential.Q->F.Priority;
+  else if (MSched.DefaultQ != NULL)
+    SFactor[mpsCQ] = MSched.DefaultQ->F.Priority;
 
-            if (SWeight[mpsSQT] != 0)
-              {
-              SDisplay[mpsSQT] = TRUE;
-              }
-            else
-              {
-              for (qindex = 1;qindex < MMAX_QOS;qindex++)
-                {
-                if (MQOS[qindex].QTSWeight > 0)
-                  {
-                  SDisplay[mpsSQT] = TRUE;  
+  if ((J->Credential.C != NULL) && (J->Credential.C->F.Priority != 0))
+    SFactor[mpsCC] = J->Credential.C->F.Priority;
+  else if (MSched.DefaultC != NULL)
+    SFactor[mpsCC] = MSched.DefaultC->F.Priority;
  
-                  break;
-                  }
-                }
-              }
+  CFactor[mpcCred] = 0;
 
-            break;
+  for (index = MPSCStart[mpcCred];index <= MPSCEnd[mpcCred];index++)
+    {
+    SFactor[index] = (SCap[index] > 0) ? 
+      MIN(SFactor[index],SCap[index]) : 
+      SFactor[index];
 
-          case mpsSXF:
- 
-            if (SWeight[mpsSXF] != 0)
-              {
-              SDisplay[mpsSXF] = TRUE;
-              }
-            else
-              {
-              for (qindex = 1;qindex < MMAX_QOS;qindex++)
-                {
-                if (MQOS[qindex].XFSWeight > 0)
-                  {
-                  SDisplay[mpsSXF] = TRUE;
- 
-                  break;
-                  }
-                }    /* END for (qindex) */
-              }
- 
-            break;
-          }  /* END switch (index) */
+    SFactor[index] = (SCap[index] > 0) ?
+      MAX(SFactor[index],-SCap[index]) :
+      SFactor[index];
 
-        if ((SWeight[index] == 0) && (SDisplay[index] == FALSE))
-          continue;
- 
-        if (tmpHeader[0] != '\0')
-          {
-          strcat(tmpHeader,":");
-          strcat(tmpCWLine,":");
-          }
- 
-        switch (index)
-          {
-          case mpsSQT:         strcat(tmpHeader,"QTime"); break;
-          case mpsSXF:         strcat(tmpHeader,"XFctr"); break;
-          case mpsSDeadline:   strcat(tmpHeader,"DLine"); break;
-          case mpsSSPV:        strcat(tmpHeader,"SPVio"); break;
-          case mpsSUPrio:      strcat(tmpHeader,"UPrio"); break;
-          case mpsSBP:         strcat(tmpHeader,"Bypas"); break;
-          case mpsSStartCount: strcat(tmpHeader,"Start"); break;
-          }
- 
-        sprintf(tmpCWLine,"%s%5ld",
-          tmpCWLine,
-          SWeight[index]);
-        }  /* END for (index) */
- 
-      if (tmpHeader[0] != '\0')
-        {
-        sprintf(CHeader[mpcServ],"  Serv(%s)",
-          tmpHeader);
- 
-        sprintf(CWLine[mpcServ]," %5ld(%s)",
-          CWeight[mpcServ],
-          tmpCWLine);
-        }
-      }    /* END if (CWeight[mpcServ] != 0) */
+    CFactor[mpcCred] += SWeight[index] * SFactor[index];
+    }  /* END for (index) */
 
-    if (CWeight[mpcTarg] != 0)
-      {
-      tmpHeader[0] = '\0';
-      tmpCWLine[0] = '\0';
- 
-      for (index = mpsTQT;index <= mpsTXF;index++)
-        {
-        if (SWeight[index] == 0)
-          continue;
- 
-        if (tmpHeader[0] != '\0')
-          {
-          strcat(tmpHeader,":");
-          strcat(tmpCWLine,":");
-          }
- 
-        switch (index)
-          {
-          case mpsTQT: strcat(tmpHeader,"QTime"); break;
-          case mpsTXF: strcat(tmpHeader,"XFctr"); break;
-          }
- 
-        sprintf(tmpCWLine,"%s%5ld",
-          tmpCWLine,
-          SWeight[index]);
-        }  /* END for (index) */
- 
-      if (tmpHeader[0] != '\0')
-        {
-        sprintf(CHeader[mpcTarg],"  Targ(%s)",
-          tmpHeader);
- 
-        sprintf(CWLine[mpcTarg]," %5ld(%s)",
-          CWeight[mpcTarg],
-          tmpCWLine);
-        }
-      }    /* END if (CWeight[mpcTarg] != 0) */
+  return(SUCCESS);
+  }  /* END __MJobPrioGetCredFactor() */
 
-    if (CWeight[mpcRes] != 0)
-      {
-      tmpHeader[0] = '\0';
-      tmpCWLine[0] = '\0';
- 
-      for (index = mpsRNode;index <= mpsRWallTime;index++)
-        {
-        if (SWeight[index] == 0)
-          continue;
- 
-        if (tmpHeader[0] != '\0')
-          {
-          strcat(tmpHeader,":");
-          strcat(tmpCWLine,":");
-          }
- 
-        switch (index)
-          {
-          case mpsRNode:     strcat(tmpHeader," Node"); break;
-          case mpsRProc:     strcat(tmpHeader," Proc"); break;
-          case mpsRMem:      strcat(tmpHeader,"  Mem"); break;
-          case mpsRSwap:     strcat(tmpHeader," Swap"); break;
-          case mpsRDisk:     strcat(tmpHeader," Disk"); break;
-          case mpsRPS:       strcat(tmpHeader,"   PS"); break;  
-          case mpsRPE:       strcat(tmpHeader,"   PE"); break;  
-          case mpsRWallTime: strcat(tmpHeader,"WTime"); break;  
-          }
- 
-        sprintf(tmpCWLine,"%s%5ld",
-          tmpCWLine,
-          SWeight[index]);
-        }  /* END for (index) */
- 
-      if (tmpHeader[0] != '\0')
-        {
-        sprintf(CHeader[mpcRes],"   Res(%s)",
-          tmpHeader);
- 
-        sprintf(CWLine[mpcRes]," %5ld(%s)",
-          CWeight[mpcRes],
-          tmpCWLine);
-        }
-      }    /* END if (CWeight[mpcRes] != 0) */
 
-    if (CWeight[mpcUsage] != 0)
-      {
-      tmpHeader[0] = '\0';
-      tmpCWLine[0] = '\0';
- 
-      for (index = mpsUCons;index <= mpsUExeTime;index++)
-        {
-        if (SWeight[index] == 0)
-          continue;
- 
-        if (tmpHeader[0] != '\0')
-          {
-          strcat(tmpHeader,":");
-          strcat(tmpCWLine,":");
-          }
- 
-        switch (index)
-          {
-          case mpsUCons:     strcat(tmpHeader,"Cons "); break;
-          case mpsURem:      strcat(tmpHeader,"Rem  "); break;
-          case mpsUPerC:     strcat(tmpHeader,"PerC "); break;
-          case mpsUExeTime:  strcat(tmpHeader,"ExeT "); break;
-          }
- 
-        sprintf(tmpCWLine,"%s%5ld",
-          tmpCWLine,
-          SWeight[index]);
-        }  /* END for (index) */
- 
-      if (tmpHeader[0] != '\0')
-        {
-        sprintf(CHeader[mpcUsage],"   Res(%s)",
-          tmpHeader);
- 
-        sprintf(CWLine[mpcUsage]," %5ld(%s)",
-          CWeight[mpcUsage],
-          tmpCWLine);
-        }
-      }    /* END if (CWeight[mpcUsage] != 0) */
 
-      MStringAppendF(String,"%-20s %10s%c %*s%*s%*s%*s%*s%*s%*s\n",
-        "Job",
-        "PRIORITY",
-        '*',
-        (int)strlen(CHeader[mpcCred]),
-        CHeader[mpcCred],
-        (int)strlen(CHeader[mpcFS]),
-        CHeader[mpcFS],
-        (int)strlen(CHeader[mpcAttr]),
-        CHeader[mpcAttr],
-        (int)strlen(CHeader[mpcServ]),
-        CHeader[mpcServ],
-        (int)strlen(CHeader[mpcTarg]),
-        CHeader[mpcTarg],
-        (int)strlen(CHeader[mpcRes]),
-        CHeader[mpcRes],
-        (int)strlen(CHeader[mpcUsage]),
-        CHeader[mpcUsage]);
 
-      MStringAppendF(String,"%20s %10s%c %*s%*s%*s%*s%*s%*s%*s\n",
-        "Weights",
-        "--------",
-        ' ',
-        (int)strlen(CWLine[mpcCred]),
-        CWLine[mpcCred],
-        (int)strlen(CWLine[mpcFS]),
-        CWLine[mpcFS],
-        (int)strlen(CWLine[mpcAttr]),
-        CWLine[mpcAttr],
-        (int)strlen(CWLine[mpcServ]),
-        CWLine[mpcServ],
-        (int)strlen(CWLine[mpcTarg]),
-        CWLine[mpcTarg],
-        (int)strlen(CWLine[mpcRes]),
-        CWLine[mpcRes],
-        (int)strlen(CWLine[mpcUsage]),
-        CWLine[mpcUsage]);
 
-      MStringAppendF(String,"\n");
-      }  /* END else (DFormat == mfmXML) */
+/**
+ * Calculate the fairshare component (target utilization delta) of J's
+ * start priority.
+ *
+ * NOTE:  sets/clears mjfFSViolation on J
+ *
+ * @param J (I/O)
+ * @param P (I) [optional]
+ * @param GF (I)
+ * @param GP (I)
+ * @param SWeight (I) [mpsLAST]
+ * @param SCap (I) [mpsLAST]
+ * @param SFactor (O) [mpsLAST]
+ * @param CFactor (O) [mpcLAST]
+ */
 
-    MDB(5,fUI) MLog("INFO:     %s header created\n",
-      FName);
+static int __MJobPrioGetFSFactor(
 
-    return(SUCCESS);
-    }  /* END if (Mode == mpdHeader) */
+  mjob_t       *J,
+  const mpar_t *P,
+  const mfsc_t *GF,
+  const mpar_t *GP,
+  const long   *SWeight,
+  const long   *SCap,
+  double       *SFactor,
+  double       *CFactor)
 
-  if (Mode == mpdFooter)
+  {
+  double FSTargetUsage;
+
+  enum MFSTargetEnum FSTargetMode;
+
+  int index;
+
+  CFactor[mpcFS] = 0;
+
+  bmunset(&J->SpecFlags,mjfFSViolation);
+  bmunset(&J->Flags,mjfFSViolation);
+
+  if ((GF->FSPolicy != mfspNONE) && 
+     ((GP->F.FSUsage[0] + GP->F.FSFactor) > 0.0))
     {
-    /* display priority footer */
+    mfs_t *CFS = NULL;
+    mfs_t *DFS;
 
-    memset(CFooter,'\0',sizeof(CFooter));  
+    double FSFactor;
 
-    for (cindex = mpcServ;cindex <= mpcUsage;cindex++)
+    DFS = NULL;
+
+    for (index = MPSCStart[mpcFS];index <= MPSCEnd[mpcFS];index++)
       {
-      if (CWeight[cindex] != 0)
+      switch (index)
         {
-        tmpLine[0] = '\0';
- 
-        for (sindex = MPSCStart[cindex];sindex <= MPSCEnd[cindex];sindex++)
-          {
-          if ((SWeight[sindex] == 0) && (SDisplay[sindex] != TRUE))
-            continue;
+        case mpsFU:
+        case mpsGFU:
 
-          if (DFormat != mfmXML)
-            { 
-            if (tmpLine[0] != '\0')
-              {
-              strcat(tmpLine,":");
-              }
+          CFS = (J->Credential.U != NULL) ? &J->Credential.U->F : NULL;
+          DFS = (MSched.DefaultU != NULL) ? &MSched.DefaultU->F : NULL;
 
-            sprintf(tmpS,"%3.1f",
-              (TotalPriority != 0.0) ?
-                ABS(((double)TotalSFactor[sindex] * SWeight[sindex] * CWeight[cindex] * 100.0 / TotalPriority)) :
-                0.0);
+          break;
 
-            sprintf(tmpLine,"%s%5.5s",
-              tmpLine,
-              tmpS);
-            }  /* END if (DFormat != mfmXML) */
-          }    /* END for (sindex) */
+        case mpsFG:
+        case mpsGFG:
 
-        if (DFormat != mfmXML)
-          { 
-          if (tmpLine[0] != '\0')
-            {
-            sprintf(tmpS,"%3.1f",
-              (TotalPriority != 0.0) ?
-                ABS(((double)TotalCFactor[cindex] * CWeight[cindex] * 100.0 / TotalPriority)) :
-                0.0);
- 
-            sprintf(CFooter[cindex]," %5.5s(%s)",
-              tmpS,
-              tmpLine);
-            }
-          }  /* END if (DFormat != mfmXML) */
-        }    /* END if (CWeight[cindex] != 0) */
-      }      /* END for (cindex) */
+          CFS = (J->Credential.G != NULL) ? &J->Credential.G->F : NULL;
+          DFS = (MSched.DefaultG != NULL) ? &MSched.DefaultG->F : NULL;
 
-    if (DFormat != mfmXML)
-      {
-      MStringAppendF(String,"\n");
-
-      MStringAppendF(String,"%-20s %10s%c %*s%*s%*s%*s%*s%*s%*s\n",
-        "Percent Contribution",
-        "--------",
-        ' ',
-        (int)strlen(CFooter[mpcCred]),
-        CFooter[mpcCred],
-        (int)strlen(CFooter[mpcFS]),
-        CFooter[mpcFS],
-        (int)strlen(CFooter[mpcAttr]),
-        CFooter[mpcAttr],
-        (int)strlen(CFooter[mpcServ]),
-        CFooter[mpcServ],
-        (int)strlen(CFooter[mpcTarg]),
-        CFooter[mpcTarg],
-        (int)strlen(CFooter[mpcRes]),
-        CFooter[mpcRes],
-        (int)strlen(CFooter[mpcUsage]),
-        CFooter[mpcUsage]);
-
-      MStringAppendF(String,"\n");
-
-      MStringAppendF(String,"* indicates absolute/relative system prio set on job\n");
-      }  /* END if (DFormat != mfmXML) */
-
-    return(SUCCESS);
-    }  /* END if (Mode == mpdFooter) */
-
-  /* calculate global values */
-
-  if (J->SpecWCLimit[0] == 0)
-    {
-    MDB(0,fSCHED) MLog("ERROR:    job '%s' has no WCLimit specified\n",
-      J->Name);
-    }
-
-  if (J->EffQueueDuration >= 0)
-    {
-    EffQDate = MSched.Time - J->EffQueueDuration;
-    
-    MDB(7,fSCHED) MLog("INFO:    EffQDate is MSched.Time (%ld) - J->EffQueueDuration (%ld)\n",MSched.Time,J->EffQueueDuration); /* BRIAN - debug (2400) */
-    }
-  else if (bmisset(&MPar[0].Flags,mpfUseSystemQueueTime))
-    {
-    EffQDate = J->SystemQueueTime;
-    
-    MDB(7,fSCHED) MLog("INFO:    EffQDate is J->SystemQueueTime (%ld)\n",J->SystemQueueTime); /* BRIAN - debug (2400) */
-    }
-  else
-    {
-    EffQDate = J->SubmitTime;
-    
-    MDB(7,fSCHED) MLog("INFO:    EffQDate is J->SubmitTime (%ld)\n",J->SubmitTime); /* BRIAN - debug (2400) */
-    }
-
-  MDB(7,fSCHED) MLog("INFO:    EffQDate is min of MSched.Time (%ld) and EffQDate (%ld)\n",MSched.Time,EffQDate); /* BRIAN - debug (2400) */
-  EffQDate = MIN((long)MSched.Time,EffQDate);
-
-  MDB(7,fSCHED) MLog("INFO:    MSched.Time = %ld\n EffQDate = %ld\n (MSched.Time - EffQDate) = %ld\n J->SpecWCLimit = %ld\n (MSched.Time - EffQDate) + J->SpecWClimit) = %ld\n MinWCLimit = %ld\n Result = %ld\n", /* BRIAN - debug (2400) */
-      MSched.Time,
-      EffQDate,
-      MSched.Time - EffQDate,
-      J->SpecWCLimit[0],
-      (MSched.Time - EffQDate) + J->SpecWCLimit[0],
-      MinWCLimit,
-      (((MSched.Time - EffQDate) + J->SpecWCLimit[0])/(MAX(1,MAX(MinWCLimit,J->SpecWCLimit[0])))));
-
-  XFactor = (double)(((unsigned long)(MSched.Time - EffQDate) + J->SpecWCLimit[0])) / 
-    MAX(1,MAX(MinWCLimit,J->SpecWCLimit[0]));
-
-  J->EffXFactor = XFactor;
-
-  MDB(7,fSCHED) MLog("INFO:   XFactor = %f\n",XFactor); /* BRIAN - debug (2400) */
-
-  /* calculate cred factor */
-
-  if ((J->Credential.U != NULL) && (J->Credential.U->F.Priority != 0))       
-    SFactor[mpsCU] = J->Credential.U->F.Priority;
-  else if (MSched.DefaultU != NULL)
-    SFactor[mpsCU] = MSched.DefaultU->F.Priority;
-
-  if ((J->Credential.G != NULL) && (J->Credential.G->F.Priority != 0))          
-    SFactor[mpsCG] = J->Credential.G->F.Priority;
-  else if (MSched.DefaultG != NULL)
-    SFactor[mpsCG] = MSched.DefaultG->F.Priority;
-
-  if ((J->Credential.A != NULL) && (J->Credential.A->F.Priority != 0))     
-    SFactor[mpsCA] = J->Credential.A->F.Priority; 
-  else if (MSched.DefaultA != NULL)
-    SFactor[mpsCA] = MSched.DefaultA->F.Priority;         
-    
-  if ((J->Credential.Q != NULL) && (J->Credential.Q->F.Priority != 0))
-    SFactor[mpsCQ] = J->Credential.Q->F.Priority;
-  else if (MSched.DefaultQ != NULL)
-    SFactor[mpsCQ] = MSched.DefaultQ->F.Priority;
-
-  if ((J->Credential.C != NULL) && (J->Credential.C->F.Priority != 0))
-    SFactor[mpsCC] = J->Credential.C->F.Priority;
-  else if (MSched.DefaultC != NULL)
-    SFactor[mpsCC] = MSched.DefaultC->F.Priority;
- 
-  CFactor[mpcCred] = 0;
-
-  for (index = MPSCStart[mpcCred];index <= MPSCEnd[mpcCred];index++)
-    {
-    SFactor[index] = (SCap[index] > 0) ? 
-      MIN(SFactor[index],SCap[index]) : 
-      SFactor[index];
-
-    SFactor[index] = (SCap[index] > 0) ?
-      MAX(SFactor[index],-SCap[index]) :
-      SFactor[index];
-
-    CFactor[mpcCred] += SWeight[index] * SFactor[index];
-    }  /* END for (index) */
- 
-  /* calculate FS factor (target utilization delta) */
-
-  CFactor[mpcFS] = 0;
-
-  bmunset(&J->SpecFlags,mjfFSViolation);
-  bmunset(&J->Flags,mjfFSViolation);
-
-  if ((GF->FSPolicy != mfspNONE) && 
-     ((GP->F.FSUsage[0] + GP->F.FSFactor) > 0.0))
-    {
-    mfs_t *CFS = NULL;
-    mfs_t *DFS;
-
-    double FSFactor;
-
-    DFS = NULL;
-
-    for (index = MPSCStart[mpcFS];index <= MPSCEnd[mpcFS];index++)
-      {
-      switch (index)
-        {
-        case mpsFU:
-        case mpsGFU:
-
-          CFS = (J->Credential.U != NULL) ? &J->Credential.U->F : NULL;
-          DFS = (MSched.DefaultU != NULL) ? &MSched.DefaultU->F : NULL;
-
-          break;
-
-        case mpsFG:
-        case mpsGFG:
-
-          CFS = (J->Credential.G != NULL) ? &J->Credential.G->F : NULL;
-          DFS = (MSched.DefaultG != NULL) ? &MSched.DefaultG->F : NULL;
-
-          break;
+          break;
 
         case mpsFA:
         case mpsGFA:
@@ -1411,12 +851,48 @@ int MJobCalcStartPriority(
       }  /* END for (index) */
     }    /* END if ((GF->FSPolicy != mfspNONE) && ...) */
 
-  /* calculate attr component */
+  return(SUCCESS);
+  }  /* END __MJobPrioGetFSFactor() */
+
+
+
+
+
+/**
+ * Calculate the attribute component of J's start priority.
+ *
+ * Unweighted subfactors never contribute to the component (RT7407), so with
+ * Lazy set they are not evaluated at all (only diagnostics need them).
+ *
+ * @param J (I)
+ * @param SWeight (I) [mpsLAST]
+ * @param SCap (I) [mpsLAST]
+ * @param Lazy (I)
+ * @param SFactor (O) [mpsLAST]
+ * @param CFactor (O) [mpcLAST]
+ */
+
+static int __MJobPrioGetAttrFactor(
+
+  mjob_t     *J,
+  const long *SWeight,
+  const long *SCap,
+  mbool_t     Lazy,
+  double     *SFactor,
+  double     *CFactor)
+
+  {
+  long tmpL;
+
+  int  index;
 
   CFactor[mpcAttr] = 0;
 
   for (index = MPSCStart[mpcAttr];index <= MPSCEnd[mpcAttr];index++)
     {
+    if ((Lazy == TRUE) && (SWeight[index] == 0))
+      continue;
+
     switch (index)
       {
       case mpsAAttr:
@@ -1478,82 +954,988 @@ int MJobCalcStartPriority(
 
         MJPrioFGetPrio(MSched.JPrioF,J,mjpatState,&tmpL);
 
-        SFactor[index] = (double)tmpL;
+        SFactor[index] = (double)tmpL;
+
+        break;
+
+      default:
+
+        /* NO-OP */
+
+        break;
+      }  /* END switch (index) */
+
+    MDB(8,fSTRUCT) MLog("INFO:     SFactor[%d] = %.2f\n",
+      index,
+      SFactor[index]);
+    }    /* END for (index) */
+
+  for (index = MPSCStart[mpcAttr];index <= MPSCEnd[mpcAttr];index++)
+    {
+    SFactor[index] = (SCap[index] > 0) ?
+      MIN(SFactor[index],SCap[index]) :
+      SFactor[index];
+
+    MDB(8,fSTRUCT) MLog("INFO:     SFactor[%d] = %.2f (MIN(SFactor[index],SCap[index]:%ld) if SCap[index] > 0)\n",
+      index,
+      SFactor[index],
+      SCap[index]);
+
+    SFactor[index] = (SCap[index] > 0) ?
+      MAX(SFactor[index],-SCap[index]) :
+      SFactor[index];
+
+    MDB(8,fSTRUCT) MLog("INFO:     SFactor[%d] = %.2f (MAX(SFactor[index],-SCap[index]:%ld) if SCap[index] > 0)\n",
+      index,
+      SFactor[index],
+      -SCap[index]);
+
+    if (SWeight[index] != 0)
+      {
+      /* there are problems with AName with a name like "3E71486D-AD3E-DF11-AFF8-001617C3B6E2.root",
+         This results in SFactor[index] = inf.  "inf" * 0 = nan. (RT7407) */
+
+      CFactor[mpcAttr] += SWeight[index] * SFactor[index];
+      }
+
+    MDB(8,fSTRUCT) MLog("INFO:     CFactor[mcpAttr] = %.2f (SWeight[%d]:%ld * SFactor[%d]:%.2f)\n",
+      CFactor[mpcAttr],
+      index,
+      SWeight[index],
+      index,
+      SFactor[index]);
+
+    }  /* END for (index) */
+
+  return(SUCCESS);
+  }  /* END __MJobPrioGetAttrFactor() */
+
+
+
+
+
+/**
+ * Load the raw service subfactors (queue time, xfactor, deadline, ...) of J.
+ *
+ * @param J (I)
+ * @param EffQDate (I)
+ * @param XFactor (I)
+ * @param SFactor (O) [mpsLAST]
+ */
+
+static int __MJobPrioGetServiceInput(
+
+  const mjob_t *J,
+  long          EffQDate,
+  double        XFactor,
+  double       *SFactor)
+
+  {
+  /* queue time factor (in minutes) */
+ 
+  SFactor[mpsSQT] = (double)((MSched.Time - EffQDate) / MCONST_MINUTELEN);
+
+  SFactor[mpsSXF] = (double)XFactor;
+
+  if ((J->CMaxDate > 0) && (J->CMaxDate < MMAX_TIME))
+    {
+    /* deadline factor value, ranges from 0.0 to 1.0 
+         1.0 indicates deadline is reached/surpassed */
+
+    SFactor[mpsSDeadline] = (double)(1.0 / (1 + MAX(0,(long)J->CMaxDate - (long)MSched.Time)));
+    }
+
+  SFactor[mpsSSPV] = bmisset(&J->Flags,mjfSPViolation) ? 1.0 : 0.0;
+
+  SFactor[mpsSUPrio] = (double)J->UPriority;
+
+  SFactor[mpsSBP] = (double)J->BypassCount;       
+
+  SFactor[mpsSStartCount] = (double)J->StartCount;
+
+  return(SUCCESS);
+  }  /* END __MJobPrioGetServiceInput() */
+
+
+
+
+
+/**
+ * Calculate the resource component of J's start priority.
+ *
+ * @param J (I)
+ * @param P (I) [optional]
+ * @param GP (I)
+ * @param SWeight (I) [mpsLAST]
+ * @param SCap (I) [mpsLAST]
+ * @param SFactor (O) [mpsLAST]
+ * @param CFactor (O) [mpcLAST]
+ */
+
+static int __MJobPrioGetResFactor(
+
+  const mjob_t *J,
+  const mpar_t *P,
+  const mpar_t *GP,
+  const long   *SWeight,
+  const long   *SCap,
+  double       *SFactor,
+  double       *CFactor)
+
+  {
+  const mreq_t *RQ;
+
+  int rqindex;
+  int sindex;
+
+  int Target;
+  enum MFSTargetEnum TargetMod;
+
+  int PC;
+
+  Target = 0;
+  TargetMod = mfstNONE;
+
+  if (P != NULL)
+    {
+    Target = P->PriorityTargetProcCount;
+    TargetMod = P->PTProcCountTargetMode;
+    }
+
+  if (Target == 0)
+    {
+    Target = GP->PriorityTargetProcCount;
+    TargetMod = GP->PTProcCountTargetMode;
+    }
+  
+  for (rqindex = 0;J->Req[rqindex] != NULL;rqindex++)
+    {
+    RQ = J->Req[rqindex];
+
+    SFactor[mpsRNode]    += RQ->NodeCount;
+
+    if (Target == 0)
+      {
+      SFactor[mpsRProc]  += RQ->TaskCount * RQ->DRes.Procs;
+      } 
+
+    SFactor[mpsRMem ]    += RQ->TaskCount * RQ->DRes.Mem ;    
+    SFactor[mpsRSwap]    += RQ->TaskCount * RQ->DRes.Swap;    
+    SFactor[mpsRDisk]    += RQ->TaskCount * RQ->DRes.Disk;  
+    SFactor[mpsRPS  ]    += RQ->TaskCount * RQ->DRes.Procs * J->WCLimit; 
+    }  /* END for (rqindex) */
+
+  if (Target != 0)
+    {
+    PC = J->TotalProcCount;
+
+    switch (TargetMod)
+      {
+      case mfstFloor:
+
+        SFactor[mpsRProc]  += MIN(0,PC - Target);
+
+        break;
+
+      case mfstCeiling:
+
+        SFactor[mpsRProc]  += MIN(0,Target - PC);
+
+        break;
+
+      default:
+
+        SFactor[mpsRProc]  -= abs(Target - PC);
+
+        break;
+      }  /* END switch (TargetMod) */
+    }
+
+  Target = 0;
+  TargetMod = mfstNONE;
+
+  if (P != NULL)
+    {
+    Target = P->PriorityTargetDuration;
+    TargetMod = P->PTDurationTargetMode;
+    }
+
+  if (Target == 0)
+    {
+    Target = GP->PriorityTargetDuration;
+    TargetMod = GP->PTDurationTargetMode;
+    }
+
+  if (Target != 0)
+    {
+    switch (TargetMod)
+      {
+      case mfstFloor:
+
+        SFactor[mpsRWallTime]  += MIN(0,J->WCLimit - Target);
+
+        break;
+
+      case mfstCeiling:
+
+        SFactor[mpsRWallTime]  += MIN(0,Target - J->WCLimit);
+
+        break;
+
+      default:
+
+        SFactor[mpsRWallTime]  -= abs(Target - (long)J->WCLimit);
+
+        break;
+      }  /* END switch (TargetMod) */
+    }
+  else
+    {
+    SFactor[mpsRWallTime] = J->WCLimit;
+    }
+      
+  MJobGetPE(J,GP,&SFactor[mpsRPE]);
+ 
+  CFactor[mpcRes] = 0;
+
+  /* NOTE:  resource subfactors are only capped from above */
+
+  for (sindex = MPSCStart[mpcRes];sindex <= MPSCEnd[mpcRes];sindex++)
+    { 
+    SFactor[sindex] = (SCap[sindex] > 0) ? 
+      MIN(SFactor[sindex],SCap[sindex]) : 
+      SFactor[sindex];
+
+    CFactor[mpcRes] += SWeight[sindex] * SFactor[sindex];
+    }  /* END for (sindex) */
+
+  return(SUCCESS);
+  }  /* END __MJobPrioGetResFactor() */
+
+
+
+
+
+/**
+ * Calculate job start priority.
+ *
+ * @see MJobGetRunPriority()
+ * @see MJobGetBackfillPriority()
+ *
+ * @param J (I) [optional]
+ * @param P (I)
+ * @param Priority (O)
+ * @param Mode (I) [mpdJob, mpdFooter, or mpdHeader]
+ * @param RE (O)
+ * @param String (O)
+ * @param DFormat (O)
+ * @param ShowJobName (I)
+ */
+
+int MJobCalcStartPriority(
+
+  mjob_t                *J,
+  const mpar_t          *P,
+  double                *Priority,
+  enum MPrioDisplayEnum  Mode,
+  mxml_t               **RE,
+  mstring_t             *String,
+  enum MFormatModeEnum   DFormat,
+  mbool_t                ShowJobName)
+
+  {
+  double        Prio;
+  double        APrio;
+
+  double        XFactor;
+
+  char          CHeader[mpcLAST][MMAX_NAME];    
+  char          CWLine[mpcLAST][MMAX_NAME];    
+  char          CFooter[mpcLAST][MMAX_NAME];  
+  char          CLine[mpcLAST][MMAX_NAME];
+
+  char          tmpHeader[MMAX_NAME];
+  char          tmpCWLine[MMAX_NAME];
+  char          tmpLine[MMAX_NAME];
+
+  double        CFactor[mpcLAST];  /* component factors */
+  double        SFactor[mpsLAST];  /* sub-component factors */
+
+  long          CWeight[mpcLAST];  /* component weights */
+  long          SWeight[mpsLAST];  /* sub-component weights */
+
+  static double TotalCFactor[mpcLAST];
+  static double TotalSFactor[mpsLAST];
+
+  double        CP[mpcLAST];       /* component percentages */
+  double        SP[mpsLAST];       /* sub-component percentages */
+
+  static double TotalPriority;
+
+  static int    SDisplay[mpsLAST];
+
+  const mfsc_t       *F;
+  mfsc_t       *GF;
+
+  mpar_t       *GP;
+
+  int           qindex;
+  int           index;
+
+  int           cindex;
+  int           sindex;
+
+  long          CCap[mpcLAST];
+  long          SCap[mpsLAST];
+
+  long          EffQDate;
+
+  char          tmpS[MMAX_NAME];
+
+  unsigned long MinWCLimit = 0;
+
+  mxml_t      *E = NULL;  /* set to avoid compiler warning */
+  mxml_t      *JE;
+  mxml_t      *CE;
+  mxml_t      *SE;
+
+  /* XML Format:  <data><job name="header"><prioc name="service" value="1000"><prios name="queuetime" value="1"></prios></prioc></job><job name="job13725" priority="93271"><prioc name="service"><priosub name="queuetime" value="100" metric="100 seconds"></priosub></prioc><prioc name="cred" value="10000"><prios name="user" value="100"></prios></prioc></job></data> */
+
+  const char *FName = "MJobCalcStartPriority";
+
+  MDB(6,fSCHED) MLog("%s(%s,%s,%s,%u,RE,String,%s)\n",
+    FName,
+    (J != NULL) ? J->Name : "NULL",
+    (P != NULL) ? P->Name : "NULL",
+    (Priority != NULL) ? "Priority" : "NULL",
+    Mode,
+    MFormatMode[DFormat]);
+
+  if (Priority != NULL)
+    *Priority = 0.0;
+
+  /* NOTE: routine used to diagnose priority */
+
+  GF = &MPar[0].FSC;
+
+  F  = (P != NULL) ? &P->FSC : GF;
+
+/*
+  F = GF;
+*/
+
+  GP = &MPar[0];
+
+  /* NOTE:  do not initialize Buffer */
+
+  if (DFormat == mfmXML)
+    {
+    if ((RE == NULL) && (Mode != mpdJob))
+      {
+      return(FAILURE);
+      }
+
+    if (RE != NULL)
+      {
+      if (*RE == NULL)
+        {
+        MXMLCreateE(RE,(char *)MSON[msonData]);
+        }
+
+      E = *RE;
+      }
+    }
+  else
+    {
+    if ((Mode != mpdJob) && (String == NULL))
+      {
+      return(FAILURE);
+      }
+
+    /* DON'T initialize String */
+    }
+
+  if ((Mode == mpdJob) && (J == NULL))
+    {
+    /* can't calculcate priority on NULL job */
+
+    return(FAILURE);
+    }
+ 
+  __MJobPrioGetWeights(F,GF,CWeight,SWeight,CCap,SCap,&MinWCLimit);
+
+  for (index = 1;index < mpcLAST;index++)
+    {
+    CFactor[index] = 0.0;
+    CP[index]      = 0.0;
+    }
+ 
+  for (index = 0;index < mpsLAST;index++)
+    {
+    SFactor[index] = 0.0;
+    SP[index]      = 0.0;
+    }
+
+  /* apply credential based weight adjustments */
+
+  __MJobPrioAdjustWeights(J,CWeight,SWeight);
+
+  if (Mode == mpdHeader)
+    {
+    /* initialize summary values/create header */
+
+    memset(TotalCFactor,0,sizeof(TotalCFactor));
+    memset(TotalSFactor,0,sizeof(TotalSFactor));      
+    memset(SDisplay,FALSE,sizeof(SDisplay));        
+
+    memset(CHeader,0,sizeof(CHeader));      
+    memset(CWLine,0,sizeof(CWLine));  
+
+    TotalPriority = 0.0;
+
+    if (DFormat == mfmXML)
+      {
+      JE = NULL;
+
+      MXMLCreateE(&JE,"job");
+      MXMLSetAttr(JE,"name",(void **)"template",mdfString);
+
+      MXMLAddE(E,JE);
+
+      for (cindex = mpcServ;cindex <= mpcUsage;cindex++)
+        {
+        CE = NULL;
+
+        MXMLCreateE(&CE,MCONST_PRIOCOMPNAME);
+        MXMLSetAttr(CE,"name",(void **)MPrioCName[cindex],mdfString);
+        MXMLSetAttr(CE,"value",(void **)&CWeight[cindex],mdfLong);
+
+        MXMLAddE(JE,CE);
+
+        for (sindex = MPSCStart[cindex];sindex <= MPSCEnd[cindex];sindex++)
+          {
+          SE = NULL;
+  
+          MXMLCreateE(&SE,MCONST_PRIOSUBCOMPNAME);
+          MXMLSetAttr(SE,"name",(void **)MPrioSCName[sindex],mdfString);
+          MXMLSetAttr(SE,"value",(void **)&SWeight[sindex],mdfLong);
+
+          MXMLAddE(CE,SE);
+          }  /* END for (sindex) */
+        }    /* END for (cindex) */
+      }
+    else 
+      {
+      if (CWeight[mpcCred] != 0)
+        {
+        tmpHeader[0] = '\0';
+        tmpCWLine[0] = '\0';     
+
+        for (index = mpsCU;index <= mpsCC;index++)
+          {
+          if (SWeight[index] == 0)
+            continue;
+
+          if (tmpHeader[0] != '\0')
+            {
+            strcat(tmpHeader,":");
+            strcat(tmpCWLine,":");
+            }
+
+          switch (index)
+            {
+            case mpsCU: strcat(tmpHeader," User"); break;
+            case mpsCG: strcat(tmpHeader,"Group"); break;        
+            case mpsCA: strcat(tmpHeader,"Accnt"); break;        
+            case mpsCC: strcat(tmpHeader,"Class"); break;        
+            case mpsCQ: strcat(tmpHeader,"  QOS"); break;        
+            }
+
+          sprintf(tmpCWLine,"%s%5ld",
+            tmpCWLine,
+            (long)SWeight[index]);
+          }  /* END for (index) */
+
+        if (tmpHeader[0] != '\0')
+          {
+          sprintf(CHeader[mpcCred],"  Cred(%s)",
+            tmpHeader);
+
+          sprintf(CWLine[mpcCred]," %5ld(%s)",
+            CWeight[mpcCred],
+            tmpCWLine);
+          }
+        }    /* END if (CWeight[mpcCred] != 0) */
+
+    if (CWeight[mpcFS] != 0)
+      {
+      tmpHeader[0] = '\0';
+      tmpCWLine[0] = '\0';
+ 
+      for (index = MPSCStart[mpcFS];index <= MPSCEnd[mpcFS];index++)
+        {
+        if (SWeight[index] == 0)
+          continue;
+
+        if (tmpHeader[0] != '\0')
+          {
+          strcat(tmpHeader,":");
+          strcat(tmpCWLine,":");
+          }
+
+        switch (index)
+          {
+          case mpsFU:    strcat(tmpHeader," User"); break;
+          case mpsFG:    strcat(tmpHeader,"Group"); break;
+          case mpsFA:    strcat(tmpHeader,"Accnt"); break;
+          case mpsFC:    strcat(tmpHeader,"Class"); break;
+          case mpsFQ:    strcat(tmpHeader,"  QOS"); break;
+          case mpsGFU:   strcat(tmpHeader,"GUser"); break;
+          case mpsGFG:   strcat(tmpHeader," GGrp"); break;
+          case mpsGFA:   strcat(tmpHeader,"GAcct"); break;
+          case mpsFUWCA: strcat(tmpHeader,"  WCA"); break;
+          case mpsFJPU:  strcat(tmpHeader,"  JPU"); break;
+          case mpsFJRPU: strcat(tmpHeader," JRPU"); break;
+          case mpsFPPU:  strcat(tmpHeader,"  PPU"); break;
+          case mpsFPSPU: strcat(tmpHeader," PSPU"); break;
+          }  /* END switch (index) */
+ 
+        sprintf(tmpCWLine,"%s%5ld",
+          tmpCWLine,
+          SWeight[index]);
+        }  /* END for (index) */
+ 
+      if (tmpHeader[0] != '\0')
+        {
+        sprintf(CHeader[mpcFS],"    FS(%s)",
+          tmpHeader);
+ 
+        sprintf(CWLine[mpcFS]," %5ld(%s)",
+          CWeight[mpcFS],
+          tmpCWLine);
+        }
+      }    /* END if (CWeight[mpcFS] != 0) */
+
+    if (CWeight[mpcAttr] != 0)
+      {
+      tmpHeader[0] = '\0';
+      tmpCWLine[0] = '\0';
+
+      for (index = MPSCStart[mpcAttr];index <= MPSCEnd[mpcAttr];index++)
+        {
+        /* handle job attr based priority weights */
+
+        switch (index)
+          {
+          case mpsAAttr:
+          case mpsAGRes:
+          case mpsAJobID:
+          case mpsAJobName:
+          case mpsAState:
+        
+            if (SWeight[index] != 0)
+              {
+              SDisplay[index] = TRUE;
+              }
+
+            break;
+
+          default:
+
+            /* NO-OP */
+
+            break;
+          }  /* END switch (index) */
+
+        if ((SWeight[index] == 0) && (SDisplay[index] == FALSE))
+          continue;
+
+        if (tmpHeader[0] != '\0')
+          {
+          strcat(tmpHeader,":");
+          strcat(tmpCWLine,":");
+          }
+
+        switch (index)
+          {
+          case mpsAAttr:    strcat(tmpHeader," Attr"); break;
+          case mpsAGRes:    strcat(tmpHeader," GRes"); break;
+          case mpsAJobID:   strcat(tmpHeader,"  JID"); break;
+          case mpsAJobName: strcat(tmpHeader," Name"); break;
+          case mpsAState:   strcat(tmpHeader,"State"); break;
+          }
+
+        sprintf(tmpCWLine,"%s%5ld",
+          tmpCWLine,
+          SWeight[index]);
+        }  /* END for (index) */
+
+      if (tmpHeader[0] != '\0')
+        {
+        sprintf(CHeader[mpcAttr],"  Attr(%s)",
+          tmpHeader);
+
+        sprintf(CWLine[mpcAttr]," %5ld(%s)",
+          CWeight[mpcAttr],
+          tmpCWLine);
+        }    /* END for (index) */
+      }      /* END if (CWeight[mpcAttr] != 0) */
+
+    if (CWeight[mpcServ] != 0)
+      {
+      tmpHeader[0] = '\0';
+      tmpCWLine[0] = '\0';
+
+      for (index = MPSCStart[mpcServ];index <= MPSCEnd[mpcServ];index++)
+        {
+        /* handle QOS based service priority weights */
+
+        switch (index)
+          {
+          case mpsSQT:
+
+            if (SWeight[mpsSQT] != 0)
+              {
+              SDisplay[mpsSQT] = TRUE;
+              }
+            else
+              {
+              for (qindex = 1;qindex < MMAX_QOS;qindex++)
+                {
+                if (MQOS[qindex].QTSWeight > 0)
+                  {
+                  SDisplay[mpsSQT] = TRUE;  
+ 
+                  break;
+                  }
+                }
+              }
+
+            break;
+
+          case mpsSXF:
+ 
+            if (SWeight[mpsSXF] != 0)
+              {
+              SDisplay[mpsSXF] = TRUE;
+              }
+            else
+              {
+              for (qindex = 1;qindex < MMAX_QOS;qindex++)
+                {
+                if (MQOS[qindex].XFSWeight > 0)
+                  {
+                  SDisplay[mpsSXF] = TRUE;
+ 
+                  break;
+                  }
+                }    /* END for (qindex) */
+              }
+ 
+            break;
+          }  /* END switch (index) */
+
+        if ((SWeight[index] == 0) && (SDisplay[index] == FALSE))
+          continue;
+ 
+        if (tmpHeader[0] != '\0')
+          {
+          strcat(tmpHeader,":");
+          strcat(tmpCWLine,":");
+          }
+ 
+        switch (index)
+          {
+          case mpsSQT:         strcat(tmpHeader,"QTime"); break;
+          case mpsSXF:         strcat(tmpHeader,"XFctr"); break;
+          case mpsSDeadline:   strcat(tmpHeader,"DLine"); break;
+          case mpsSSPV:        strcat(tmpHeader,"SPVio"); break;
+          case mpsSUPrio:      strcat(tmpHeader,"UPrio"); break;
+          case mpsSBP:         strcat(tmpHeader,"Bypas"); break;
+          case mpsSStartCount: strcat(tmpHeader,"Start"); break;
+          }
+ 
+        sprintf(tmpCWLine,"%s%5ld",
+          tmpCWLine,
+          SWeight[index]);
+        }  /* END for (index) */
+ 
+      if (tmpHeader[0] != '\0')
+        {
+        sprintf(CHeader[mpcServ],"  Serv(%s)",
+          tmpHeader);
+ 
+        sprintf(CWLine[mpcServ]," %5ld(%s)",
+          CWeight[mpcServ],
+          tmpCWLine);
+        }
+      }    /* END if (CWeight[mpcServ] != 0) */
+
+    if (CWeight[mpcTarg] != 0)
+      {
+      tmpHeader[0] = '\0';
+      tmpCWLine[0] = '\0';
+ 
+      for (index = mpsTQT;index <= mpsTXF;index++)
+        {
+        if (SWeight[index] == 0)
+          continue;
+ 
+        if (tmpHeader[0] != '\0')
+          {
+          strcat(tmpHeader,":");
+          strcat(tmpCWLine,":");
+          }
+ 
+        switch (index)
+          {
+          case mpsTQT: strcat(tmpHeader,"QTime"); break;
+          case mpsTXF: strcat(tmpHeader,"XFctr"); break;
+          }
+ 
+        sprintf(tmpCWLine,"%s%5ld",
+          tmpCWLine,
+          SWeight[index]);
+        }  /* END for (index) */
+ 
+      if (tmpHeader[0] != '\0')
+        {
+        sprintf(CHeader[mpcTarg],"  Targ(%s)",
+          tmpHeader);
+ 
+        sprintf(CWLine[mpcTarg]," %5ld(%s)",
+          CWeight[mpcTarg],
+          tmpCWLine);
+        }
+      }    /* END if (CWeight[mpcTarg] != 0) */
+
+    if (CWeight[mpcRes] != 0)
+      {
+      tmpHeader[0] = '\0';
+      tmpCWLine[0] = '\0';
+ 
+      for (index = mpsRNode;index <= mpsRWallTime;index++)
+        {
+        if (SWeight[index] == 0)
+          continue;
+ 
+        if (tmpHeader[0] != '\0')
+          {
+          strcat(tmpHeader,":");
+          strcat(tmpCWLine,":");
+          }
+ 
+        switch (index)
+          {
+          case mpsRNode:     strcat(tmpHeader," Node"); break;
+          case mpsRProc:     strcat(tmpHeader," Proc"); break;
+          case mpsRMem:      strcat(tmpHeader,"  Mem"); break;
+          case mpsRSwap:     strcat(tmpHeader," Swap"); break;
+          case mpsRDisk:     strcat(tmpHeader," Disk"); break;
+          case mpsRPS:       strcat(tmpHeader,"   PS"); break;  
+          case mpsRPE:       strcat(tmpHeader,"   PE"); break;  
+          case mpsRWallTime: strcat(tmpHeader,"WTime"); break;  
+          }
+ 
+        sprintf(tmpCWLine,"%s%5ld",
+          tmpCWLine,
+          SWeight[index]);
+        }  /* END for (index) */
+ 
+      if (tmpHeader[0] != '\0')
+        {
+        sprintf(CHeader[mpcRes],"   Res(%s)",
+          tmpHeader);
+ 
+        sprintf(CWLine[mpcRes]," %5ld(%s)",
+          CWeight[mpcRes],
+          tmpCWLine);
+        }
+      }    /* END if (CWeight[mpcRes] != 0) */
+
+    if (CWeight[mpcUsage] != 0)
+      {
+      tmpHeader[0] = '\0';
+      tmpCWLine[0] = '\0';
+ 
+      for (index = mpsUCons;index <= mpsUExeTime;index++)
+        {
+        if (SWeight[index] == 0)
+          continue;
+ 
+        if (tmpHeader[0] != '\0')
+          {
+          strcat(tmpHeader,":");
+          strcat(tmpCWLine,":");
+          }
+ 
+        switch (index)
+          {
+          case mpsUCons:     strcat(tmpHeader,"Cons "); break;
+          case mpsURem:      strcat(tmpHeader,"Rem  "); break;
+          case mpsUPerC:     strcat(tmpHeader,"PerC "); break;
+          case mpsUExeTime:  strcat(tmpHeader,"ExeT "); break;
+          }
+ 
+        sprintf(tmpCWLine,"%s%5ld",
+          tmpCWLine,
+          SWeight[index]);
+        }  /* END for (index) */
+ 
+      if (tmpHeader[0] != '\0')
+        {
+        sprintf(CHeader[mpcUsage],"   Res(%s)",
+          tmpHeader);
+ 
+        sprintf(CWLine[mpcUsage]," %5ld(%s)",
+          CWeight[mpcUsage],
+          tmpCWLine);
+        }
+      }    /* END if (CWeight[mpcUsage] != 0) */
+
+      MStringAppendF(String,"%-20s %10s%c %*s%*s%*s%*s%*s%*s%*s\n",
+        "Job",
+        "PRIORITY",
+        '*',
+        (int)strlen(CHeader[mpcCred]),
+        CHeader[mpcCred],
+        (int)strlen(CHeader[mpcFS]),
+        CHeader[mpcFS],
+        (int)strlen(CHeader[mpcAttr]),
+        CHeader[mpcAttr],
+        (int)strlen(CHeader[mpcServ]),
+        CHeader[mpcServ],
+        (int)strlen(CHeader[mpcTarg]),
+        CHeader[mpcTarg],
+        (int)strlen(CHeader[mpcRes]),
+        CHeader[mpcRes],
+        (int)strlen(CHeader[mpcUsage]),
+        CHeader[mpcUsage]);
+
+      MStringAppendF(String,"%20s %10s%c %*s%*s%*s%*s%*s%*s%*s\n",
+        "Weights",
+        "--------",
+        ' ',
+        (int)strlen(CWLine[mpcCred]),
+        CWLine[mpcCred],
+        (int)strlen(CWLine[mpcFS]),
+        CWLine[mpcFS],
+        (int)strlen(CWLine[mpcAttr]),
+        CWLine[mpcAttr],
+        (int)strlen(CWLine[mpcServ]),
+        CWLine[mpcServ],
+        (int)strlen(CWLine[mpcTarg]),
+        CWLine[mpcTarg],
+        (int)strlen(CWLine[mpcRes]),
+        CWLine[mpcRes],
+        (int)strlen(CWLine[mpcUsage]),
+        CWLine[mpcUsage]);
+
+      MStringAppendF(String,"\n");
+      }  /* END else (DFormat == mfmXML) */
 
-        break;
+    MDB(5,fUI) MLog("INFO:     %s header created\n",
+      FName);
 
-      default:
+    return(SUCCESS);
+    }  /* END if (Mode == mpdHeader) */
 
-        /* NO-OP */
+  if (Mode == mpdFooter)
+    {
+    /* display priority footer */
 
-        break;
-      }  /* END switch (index) */
+    memset(CFooter,'\0',sizeof(CFooter));  
 
-    MDB(8,fSTRUCT) MLog("INFO:     SFactor[%d] = %.2f\n",
-      index,
-      SFactor[index]);
-    }    /* END for (index) */
+    for (cindex = mpcServ;cindex <= mpcUsage;cindex++)
+      {
+      if (CWeight[cindex] != 0)
+        {
+        tmpLine[0] = '\0';
+ 
+        for (sindex = MPSCStart[cindex];sindex <= MPSCEnd[cindex];sindex++)
+          {
+          if ((SWeight[sindex] == 0) && (SDisplay[sindex] != TRUE))
+            continue;
 
-  for (index = MPSCStart[mpcAttr];index <= MPSCEnd[mpcAttr];index++)
-    {
-    SFactor[index] = (SCap[index] > 0) ?
-      MIN(SFactor[index],SCap[index]) :
-      SFactor[index];
+          if (DFormat != mfmXML)
+            { 
+            if (tmpLine[0] != '\0')
+              {
+              strcat(tmpLine,":");
+              }
 
-    MDB(8,fSTRUCT) MLog("INFO:     SFactor[%d] = %.2f (MIN(SFactor[index],SCap[index]:%ld) if SCap[index] > 0)\n",
-      index,
-      SFactor[index],
-      SCap[index]);
+            sprintf(tmpS,"%3.1f",
+              (TotalPriority != 0.0) ?
+                ABS(((double)TotalSFactor[sindex] * SWeight[sindex] * CWeight[cindex] * 100.0 / TotalPriority)) :
+                0.0);
 
-    SFactor[index] = (SCap[index] > 0) ?
-      MAX(SFactor[index],-SCap[index]) :
-      SFactor[index];
+            sprintf(tmpLine,"%s%5.5s",
+              tmpLine,
+              tmpS);
+            }  /* END if (DFormat != mfmXML) */
+          }    /* END for (sindex) */
 
-    MDB(8,fSTRUCT) MLog("INFO:     SFactor[%d] = %.2f (MAX(SFactor[index],-SCap[index]:%ld) if SCap[index] > 0)\n",
-      index,
-      SFactor[index],
-      -SCap[index]);
+        if (DFormat != mfmXML)
+          { 
+          if (tmpLine[0] != '\0')
+            {
+            sprintf(tmpS,"%3.1f",
+              (TotalPriority != 0.0) ?
+                ABS(((double)TotalCFactor[cindex] * CWeight[cindex] * 100.0 / TotalPriority)) :
+                0.0);
+ 
+            sprintf(CFooter[cindex]," %5.5s(%s)",
+              tmpS,
+              tmpLine);
+            }
+          }  /* END if (DFormat != mfmXML) */
+        }    /* END if (CWeight[cindex] != 0) */
+      }      /* END for (cindex) */
 
-    if (SWeight[index] != 0)
+    if (DFormat != mfmXML)
       {
-      /* there are problems with AName with a name like "3E71486D-AD3E-DF11-AFF8-001617C3B6E2.root",
-         This results in SFactor[index] = inf.  "inf" * 0 = nan. (RT7407) */
-
-      CFactor[mpcAttr] += SWeight[index] * SFactor[index];
-      }
+      MStringAppendF(String,"\n");
 
-    MDB(8,fSTRUCT) MLog("INFO:     CFactor[mcpAttr] = %.2f (SWeight[%d]:%ld * SFactor[%d]:%.2f)\n",
-      CFactor[mpcAttr],
-      index,
-      SWeight[index],
-      index,
-      SFactor[index]);
+      MStringAppendF(String,"%-20s %10s%c %*s%*s%*s%*s%*s%*s%*s\n",
+        "Percent Contribution",
+        "--------",
+        ' ',
+        (int)strlen(CFooter[mpcCred]),
+        CFooter[mpcCred],
+        (int)strlen(CFooter[mpcFS]),
+        CFooter[mpcFS],
+        (int)strlen(CFooter[mpcAttr]),
+        CFooter[mpcAttr],
+        (int)strlen(CFooter[mpcServ]),
+        CFooter[mpcServ],
+        (int)strlen(CFooter[mpcTarg]),
+        CFooter[mpcTarg],
+        (int)strlen(CFooter[mpcRes]),
+        CFooter[mpcRes],
+        (int)strlen(CFooter[mpcUsage]),
+        CFooter[mpcUsage]);
 
-    }  /* END for (index) */
+      MStringAppendF(String,"\n");
 
-  /* calculate service component */
+      MStringAppendF(String,"* indicates absolute/relative system prio set on job\n");
+      }  /* END if (DFormat != mfmXML) */
 
-  /* queue time factor (in minutes) */
- 
-  SFactor[mpsSQT] = (double)((MSched.Time - EffQDate) / MCONST_MINUTELEN);
+    return(SUCCESS);
+    }  /* END if (Mode == mpdFooter) */
 
-  SFactor[mpsSXF] = (double)XFactor;
+  /* calculate global values */
 
-  if ((J->CMaxDate > 0) && (J->CMaxDate < MMAX_TIME))
-    {
-    /* deadline factor value, ranges from 0.0 to 1.0 
-         1.0 indicates deadline is reached/surpassed */
+  __MJobPrioGetXFactor(J,MinWCLimit,&EffQDate,&XFactor);
 
-    SFactor[mpsSDeadline] = (double)(1.0 / (1 + MAX(0,(long)J->CMaxDate - (long)MSched.Time)));
-    }
+  __MJobPrioGetCredFactor(J,SWeight,SCap,SFactor,CFactor);
 
-  SFactor[mpsSSPV] = bmisset(&J->Flags,mjfSPViolation) ? 1.0 : 0.0;
+  __MJobPrioGetFSFactor(J,P,GF,GP,SWeight,SCap,SFactor,CFactor);
 
-  SFactor[mpsSUPrio] = (double)J->UPriority;
+  __MJobPrioGetAttrFactor(J,SWeight,SCap,FALSE,SFactor,CFactor);
 
-  SFactor[mpsSBP] = (double)J->BypassCount;       
+  /* calculate service component */
 
-  SFactor[mpsSStartCount] = (double)J->StartCount;
+  __MJobPrioGetServiceInput(J,EffQDate,XFactor,SFactor);
 
   CFactor[mpcServ] = 0;
 
@@ -1578,178 +1960,62 @@ int MJobCalcStartPriority(
       MAX(SFactor[index],-SCap[index]) :
       SFactor[index];
 
-    CFactor[mpcServ] += SWeight[index] * SFactor[index];
-  
-    MDB(7,fSCHED) MLog("INFO:    CFactor[mpcServ] (%f) += SWeight[%d] (%ld) * SFactor[%d] (%f)\n", /* BRIAN - debug (2400) */
-        CFactor[mpcServ],
-        index,
-        SWeight[index],
-        index,
-        SFactor[index]);
-
-    }  /* END for (index) */
-
-  MDB(7,fSCHED) MLog("INFO:    CFactor = %f\n",CFactor[mpcServ]); /* BRIAN - debug (2400) */
-
-  /* calculate target component */
-
-  /* target QT subcomponent */
-
-  if (J->Credential.Q != NULL)
-    { 
-    if (J->Credential.Q->QTTarget > 0)
-      {
-      /* give exponentially increasing priority as we approach target qtime */
-
-      /* Equation:  (1,000)^( QTCurrent / QTTarget )                  */ 
-
-      SFactor[mpsTQT] =
-        (double)pow(1000,((double)MIN(1.0,(double)J->EffQueueDuration / (double)J->Credential.Q->QTTarget)));
-      }
-
-    /* target XF subcomponent */
-
-    if (J->Credential.Q->XFTarget > 0.0)
-      {
-      /* give exponentially increasing priority as we approach target xfactor */
-      /* Equation:  (XFTarget - XFCurrent)^(-2)                               */
-
-      SFactor[mpsTXF] = 
-        (double)pow((MAX(.0001,J->Credential.Q->XFTarget - XFactor)),-2.0);
-      }
-    }
-
-  SFactor[mpsTQT] = (SCap[mpsTQT] > 0) ? 
-    MIN(SFactor[mpsTQT],SCap[mpsTQT]) : 
-    SFactor[mpsTQT];
-
-  SFactor[mpsTXF] = (SCap[mpsTXF] > 0) ? 
-    MIN(SFactor[mpsTXF],SCap[mpsTXF]) : 
-    SFactor[mpsTXF];
-
-  CFactor[mpcTarg] =
-    SWeight[mpsTQT] * SFactor[mpsTQT] +
-    SWeight[mpsTXF] * SFactor[mpsTXF];
-
-  /* determine resource factor */
-
-  Target = 0;
-  TargetMod = mfstNONE;
-
-  if (P != NULL)
-    {
-    Target = P->PriorityTargetProcCount;
-    TargetMod = P->PTProcCountTargetMode;
-    }
-
-  if (Target == 0)
-    {
-    Target = GP->PriorityTargetProcCount;
-    TargetMod = GP->PTProcCountTargetMode;
-    }
-  
-  for (rqindex = 0;J->Req[rqindex] != NULL;rqindex++)
-    {
-    RQ = J->Req[rqindex];
-
-    SFactor[mpsRNode]    += RQ->NodeCount;
-
-    if (Target == 0)
-      {
-      SFactor[mpsRProc]  += RQ->TaskCount * RQ->DRes.Procs;
-      } 
-
-    SFactor[mpsRMem ]    += RQ->TaskCount * RQ->DRes.Mem ;    
-    SFactor[mpsRSwap]    += RQ->TaskCount * RQ->DRes.Swap;    
-    SFactor[mpsRDisk]    += RQ->TaskCount * RQ->DRes.Disk;  
-    SFactor[mpsRPS  ]    += RQ->TaskCount * RQ->DRes.Procs * J->WCLimit; 
-    }  /* END for (rqindex) */
-
-  if (Target != 0)
-    {
-    PC = J->TotalProcCount;
-
-    switch (TargetMod)
-      {
-      case mfstFloor:
-
-        SFactor[mpsRProc]  += MIN(0,PC - Target);
-
-        break;
-
-      case mfstCeiling:
-
-        SFactor[mpsRProc]  += MIN(0,Target - PC);
-
-        break;
-
-      default:
-
-        SFactor[mpsRProc]  -= abs(Target - PC);
+    CFactor[mpcServ] += SWeight[index] * SFactor[index];
+  
+    MDB(7,fSCHED) MLog("INFO:    CFactor[mpcServ] (%f) += SWeight[%d] (%ld) * SFactor[%d] (%f)\n", /* BRIAN - debug (2400) */
+        CFactor[mpcServ],
+        index,
+        SWeight[index],
+        index,
+        SFactor[index]);
 
-        break;
-      }  /* END switch (TargetMod) */
-    }
+    }  /* END for (index) */
 
-  Target = 0;
-  TargetMod = mfstNONE;
+  MDB(7,fSCHED) MLog("INFO:    CFactor = %f\n",CFactor[mpcServ]); /* BRIAN - debug (2400) */
 
-  if (P != NULL)
-    {
-    Target = P->PriorityTargetDuration;
-    TargetMod = P->PTDurationTargetMode;
-    }
+  /* calculate target component */
 
-  if (Target == 0)
-    {
-    Target = GP->PriorityTargetDuration;
-    TargetMod = GP->PTDurationTargetMode;
-    }
+  /* target QT subcomponent */
 
-  if (Target != 0)
-    {
-    switch (TargetMod)
+  if (J->Credential.Q != NULL)
+    { 
+    if (J->Credential.Q->QTTarget > 0)
       {
-      case mfstFloor:
-
-        SFactor[mpsRWallTime]  += MIN(0,J->WCLimit - Target);
+      /* give exponentially increasing priority as we approach target qtime */
 
-        break;
+      /* Equation:  (1,000)^( QTCurrent / QTTarget )                  */ 
 
-      case mfstCeiling:
+      SFactor[mpsTQT] =
+        (double)pow(1000,((double)MIN(1.0,(double)J->EffQueueDuration / (double)J->Credential.Q->QTTarget)));
+      }
 
-        SFactor[mpsRWallTime]  += MIN(0,Target - J->WCLimit);
+    /* target XF subcomponent */
 
-        break;
+    if (J->Credential.Q->XFTarget > 0.0)
+      {
+      /* give exponentially increasing priority as we approach target xfactor */
+      /* Equation:  (XFTarget - XFCurrent)^(-2)                               */
 
-      default:
+      SFactor[mpsTXF] = 
+        (double)pow((MAX(.0001,J->Credential.Q->XFTarget - XFactor)),-2.0);
+      }
+    }
 
-        SFactor[mpsRWallTime]  -= abs(Target - (long)J->WCLimit);
+  SFactor[mpsTQT] = (SCap[mpsTQT] > 0) ? 
+    MIN(SFactor[mpsTQT],SCap[mpsTQT]) : 
+    SFactor[mpsTQT];
 
-        break;
-      }  /* END switch (TargetMod) */
-    }
-  else
-    {
-    SFactor[mpsRWallTime] = J->WCLimit;
-    }
-      
-  MJobGetPE(J,GP,&SFactor[mpsRPE]);
- 
-  CFactor[mpcRes] = 0;
+  SFactor[mpsTXF] = (SCap[mpsTXF] > 0) ? 
+    MIN(SFactor[mpsTXF],SCap[mpsTXF]) : 
+    SFactor[mpsTXF];
 
-  for (sindex = MPSCStart[mpcRes];sindex <= MPSCEnd[mpcRes];sindex++)
-    { 
-    SFactor[sindex] = (SCap[sindex] > 0) ? 
-      MIN(SFactor[sindex],SCap[sindex]) : 
-      SFactor[sindex];
+  CFactor[mpcTarg] =
+    SWeight[mpsTQT] * SFactor[mpsTQT] +
+    SWeight[mpsTXF] * SFactor[mpsTXF];
 
-    SFactor[index] = (SCap[index] > 0) ?
-      MAX(SFactor[index],-SCap[index]) :
-      SFactor[index];
+  /* determine resource factor */
 
-    CFactor[mpcRes] += SWeight[sindex] * SFactor[sindex];
-    }  /* END for (sindex) */
+  __MJobPrioGetResFactor(J,P,GP,SWeight,SCap,SFactor,CFactor);
 
   /* calculate usage factor */
 
@@ -2038,3 +2304,361 @@ int MJobCalcStartPriority(
   }  /* END MJobCalcStartPriority() */
 
 
+
+
+/**
+ * Calculate the start priority of each job in JList.
+ *
+ * Produces exactly the values MJobCalcStartPriority(J,P,&Prio,mpdJob,...)
+ * produces, but loads the partition weights once per call rather than once
+ * per job.  Per-job factors are gathered into one array per factor (SoA) so
+ * that capping and weighting the service, target and component factors runs
+ * as tight loops over all jobs.  Header/footer and XML/string diagnostics
+ * remain with MJobCalcStartPriority().
+ *
+ * NOTE:  like MJobCalcStartPriority(), sets J->EffXFactor and mjfFSViolation
+ *
+ * @see MJobCalcStartPriority()
+ * @see MQueuePrioritizeJobs() - parent
+ *
+ * @param JList (I) [modified]
+ * @param JCount (I)
+ * @param P (I) [optional]
+ * @param Priority (O) [JCount]
+ */
+
+int MJobCalcStartPriorityBatch(
+
+  mjob_t       **JList,
+  int            JCount,
+  const mpar_t  *P,
+  double        *Priority)
+
+  {
+  static double *Buf = NULL;
+  static int     BufSize = 0;
+
+  double *SCol[mpsTXF + 1];  /* service/target subfactors, one array per subfactor */
+  double *CCol[mpcLAST];     /* component factors, one array per component */
+
+  double *WSQT;              /* per-job SWeight[mpsSQT] */
+  double *WSXF;              /* per-job SWeight[mpsSXF] */
+  double *WFS;               /* per-job CWeight[mpcFS] */
+  double *QTDuration;        /* target subcomponent inputs */
+  double *QTTarget;
+  double *XFTarget;
+  double *XF;
+
+  double *SF;
+  double *CF;
+
+  double  CFactor[mpcLAST];
+  double  SFactor[mpsLAST];
+
+  double  W;
+
+  long    CWeight[mpcLAST];
+  long    SWeight[mpsLAST];
+  long    JCWeight[mpcLAST];
+  long    JSWeight[mpsLAST];
+  long    CCap[mpcLAST];
+  long    SCap[mpsLAST];
+
+  long    EffQDate;
+  double  XFactor;
+
+  unsigned long MinWCLimit = 0;
+
+  mbool_t ClipNeg;
+
+  const mfsc_t *F;
+  mfsc_t *GF;
+  mpar_t *GP;
+
+  mjob_t *J;
+
+  int     jindex;
+  int     index;
+  int     NCol;
+
+  const char *FName = "MJobCalcStartPriorityBatch";
+
+  MDB(6,fSCHED) MLog("%s(JList,%d,%s,Priority)\n",
+    FName,
+    JCount,
+    (P != NULL) ? P->Name : "NULL");
+
+  if ((JList == NULL) || (Priority == NULL))
+    {
+    return(FAILURE);
+    }
+
+  MDB(4,fSCHED)
+    {
+    /* per-job priority logging requested - use the scalar path */
+
+    for (jindex = 0;jindex < JCount;jindex++)
+      {
+      MJobCalcStartPriority(
+        JList[jindex],
+        P,
+        &Priority[jindex],
+        mpdJob,
+        NULL,
+        NULL,
+        mfmHuman,
+        FALSE);
+      }
+
+    return(SUCCESS);
+    }
+
+  if (JCount <= 0)
+    {
+    return(SUCCESS);
+    }
+
+  NCol = (mpsTXF - mpsSQT + 1) + (mpcUsage - mpcServ + 1) + 7;
+
+  if (JCount > BufSize)
+    {
+    MUFree((char **)&Buf);
+
+    BufSize = 0;
+
+    if ((Buf = (double *)MUCalloc(1,sizeof(double) * JCount * NCol)) == NULL)
+      {
+      return(FAILURE);
+      }
+
+    BufSize = JCount;
+    }
+
+  SF = Buf;
+
+  for (index = mpsSQT;index <= mpsTXF;index++)
+    {
+    SCol[index] = SF;
+
+    SF += JCount;
+    }
+
+  for (index = mpcServ;index <= mpcUsage;index++)
+    {
+    CCol[index] = SF;
+
+    SF += JCount;
+    }
+
+  WSQT       = SF;
+  WSXF       = WSQT + JCount;
+  WFS        = WSXF + JCount;
+  QTDuration = WFS + JCount;
+  QTTarget   = QTDuration + JCount;
+  XFTarget   = QTTarget + JCount;
+  XF         = XFTarget + JCount;
+
+  GF = &MPar[0].FSC;
+  F  = (P != NULL) ? &P->FSC : GF;
+  GP = &MPar[0];
+
+  __MJobPrioGetWeights(F,GF,CWeight,SWeight,CCap,SCap,&MinWCLimit);
+
+  /* gather per-job inputs (follows pointers, runs job by job) */
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    {
+    J = JList[jindex];
+
+    memcpy(JCWeight,CWeight,sizeof(JCWeight));
+    memcpy(JSWeight,SWeight,sizeof(JSWeight));
+
+    __MJobPrioAdjustWeights(J,JCWeight,JSWeight);
+
+    memset(CFactor,0,sizeof(CFactor));
+    memset(SFactor,0,sizeof(SFactor));
+
+    __MJobPrioGetXFactor(J,MinWCLimit,&EffQDate,&XFactor);
+
+    __MJobPrioGetCredFactor(J,JSWeight,SCap,SFactor,CFactor);
+
+    __MJobPrioGetFSFactor(J,P,GF,GP,JSWeight,SCap,SFactor,CFactor);
+
+    __MJobPrioGetAttrFactor(J,JSWeight,SCap,TRUE,SFactor,CFactor);
+
+    __MJobPrioGetServiceInput(J,EffQDate,XFactor,SFactor);
+
+    __MJobPrioGetResFactor(J,P,GP,JSWeight,SCap,SFactor,CFactor);
+
+    MJobGetRunPriority(J,(P != NULL) ? P->Index : 0,NULL,&CFactor[mpcUsage],NULL);
+
+    for (index = MPSCStart[mpcServ];index <= MPSCEnd[mpcServ];index++)
+      SCol[index][jindex] = SFactor[index];
+
+    WSQT[jindex] = (double)JSWeight[mpsSQT];
+    WSXF[jindex] = (double)JSWeight[mpsSXF];
+    WFS[jindex]  = (double)JCWeight[mpcFS];
+
+    QTDuration[jindex] = (double)J->EffQueueDuration;
+    XF[jindex]         = XFactor;
+
+    QTTarget[jindex] = ((J->Credential.Q != NULL) && (J->Credential.Q->QTTarget > 0)) ?
+      (double)J->Credential.Q->QTTarget : 0.0;
+
+    XFTarget[jindex] = (J->Credential.Q != NULL) ? J->Credential.Q->XFTarget : 0.0;
+
+    CCol[mpcServ][jindex]  = 0.0;
+    CCol[mpcCred][jindex]  = CFactor[mpcCred];
+    CCol[mpcAttr][jindex]  = CFactor[mpcAttr];
+    CCol[mpcFS][jindex]    = CFactor[mpcFS];
+    CCol[mpcRes][jindex]   = CFactor[mpcRes];
+    CCol[mpcUsage][jindex] = CFactor[mpcUsage];
+    }  /* END for (jindex) */
+
+  /* service component */
+
+  CF = CCol[mpcServ];
+
+  for (index = MPSCStart[mpcServ];index <= MPSCEnd[mpcServ];index++)
+    {
+    SF = SCol[index];
+
+    if (SCap[index] > 0)
+      {
+      for (jindex = 0;jindex < JCount;jindex++)
+        {
+        SF[jindex] = MIN(SF[jindex],SCap[index]);
+        SF[jindex] = MAX(SF[jindex],-SCap[index]);
+        }
+      }
+
+    if ((index == mpsSQT) || (index == mpsSXF))
+      {
+      /* weight includes per-job QoS adjustment */
+
+      const double *JW = (index == mpsSQT) ? WSQT : WSXF;
+
+      for (jindex = 0;jindex < JCount;jindex++)
+        CF[jindex] += JW[jindex] * SF[jindex];
+      }
+    else
+      {
+      W = (double)SWeight[index];
+
+      for (jindex = 0;jindex < JCount;jindex++)
+        CF[jindex] += W * SF[jindex];
+      }
+    }    /* END for (index) */
+
+  /* target component - see MJobCalcStartPriority() for the equations */
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    {
+    SCol[mpsTQT][jindex] = (QTTarget[jindex] > 0.0) ?
+      (double)pow(1000,((double)MIN(1.0,QTDuration[jindex] / QTTarget[jindex]))) :
+      0.0;
+
+    SCol[mpsTXF][jindex] = (XFTarget[jindex] > 0.0) ?
+      (double)pow((MAX(.0001,XFTarget[jindex] - XF[jindex])),-2.0) :
+      0.0;
+    }
+
+  for (index = mpsTQT;index <= mpsTXF;index++)
+    {
+    if (SCap[index] <= 0)
+      continue;
+
+    SF = SCol[index];
+
+    for (jindex = 0;jindex < JCount;jindex++)
+      SF[jindex] = MIN(SF[jindex],SCap[index]);
+    }
+
+  CF = CCol[mpcTarg];
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    {
+    CF[jindex] =
+      SWeight[mpsTQT] * SCol[mpsTQT][jindex] +
+      SWeight[mpsTXF] * SCol[mpsTXF][jindex];
+    }
+
+  /* weigh components */
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    Priority[jindex] = 0.0;
+
+  for (index = mpcServ;index <= mpcUsage;index++)
+    {
+    CF = CCol[index];
+
+    if (CCap[index] > 0)
+      {
+      for (jindex = 0;jindex < JCount;jindex++)
+        {
+        CF[jindex] = MIN(CF[jindex],CCap[index]);
+        CF[jindex] = MAX(CF[jindex],-CCap[index]);
+        }
+      }
+
+    /* NOTE:  store each weighted component before summing it so that, like
+             MJobCalcStartPriority()'s (which also feeds APrio), it is never
+             contracted into a fused multiply-add */
+
+    if (index == mpcFS)
+      {
+      /* weight includes per-job credential adjustment */
+
+      for (jindex = 0;jindex < JCount;jindex++)
+        {
+        CF[jindex] = WFS[jindex] * CF[jindex];
+
+        Priority[jindex] += CF[jindex];
+        }
+      }
+    else
+      {
+      W = (double)CWeight[index];
+
+      for (jindex = 0;jindex < JCount;jindex++)
+        {
+        CF[jindex] = W * CF[jindex];
+
+        Priority[jindex] += CF[jindex];
+        }
+      }
+    }    /* END for (index) */
+
+  /* clip prio at min value, cap job start priority */
+
+  ClipNeg = ((!bmisset(&GP->Flags,mpfRejectNegPrioJobs)) &&
+             (!bmisset(&GP->Flags,mpfEnableNegJobPriority))) ? TRUE : FALSE;
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    {
+    if ((ClipNeg == TRUE) && (Priority[jindex] < 1.0))
+      Priority[jindex] = 1.0;
+
+    if (Priority[jindex] > (double)MMAX_PRIO_VAL)
+      Priority[jindex] = (double)MMAX_PRIO_VAL;
+    }
+
+  /* incorporate system priority value */
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    {
+    J = JList[jindex];
+
+    if (J->SystemPrio > 0)
+      {
+      if (J->SystemPrio > MMAX_PRIO_VAL)
+        Priority[jindex] += (double)(J->SystemPrio - (MMAX_PRIO_VAL << 1));
+      else
+        Priority[jindex] = (double)(MMAX_PRIO_VAL + J->SystemPrio);
+      }
+    }
+
+  return(SUCCESS);
+  }  /* END MJobCalcStartPriorityBatch() */
+
+
@@ -13,8 +13,11 @@
  * int MLogInitialize(NewLogFile,NewMaxFileSize,Iteration) *
  * int MLogOpen(Iteration)                      *
  * int MLogRoll(Suffix,DoForce,Iteration,Depth) *
+ * int MLogAsyncStart()                         *
+ * int MLogFlush()                              *
  * char *MLogGetTime()                          *
  * void MLogLevelAdjust(signo)                  *
+ * int MLogUpdateFacilityMask()                 *
  *                                              */
 
 
@@ -120,6 +123,11 @@ int MLogInitialize(
     SigSet = 1;
     }
 
+  if ((getenv(MSCHED_ENVLOGASYNCVAR) != NULL) && (mlog.IsAsync == FALSE))
+    {
+    MLogAsyncStart();
+    }
+
   /* Initialize the memory portion of the mlog structure */
   mlog.MemoryTracker = MUMemoryInitialize();
 
@@ -249,6 +257,476 @@ int MLogOpen(
 
 
 
+/* asynchronous logging (see MLogAsyncStart()) */
+
+#ifdef MTHREADSAFE
+
+#include <sys/uio.h>
+
+#define MDEF_LOGRINGSIZE  (1 << 18) /* bytes in each thread's log ring (must be power of 2) */
+#define MMAX_LOGRING      32        /* threads which may hold a log ring at once */
+#define MDEF_LOGFLUSHMS   100       /* longest a line waits in a ring before it is written */
+#define MMAX_LOGIOV       64        /* iovec entries per writev() */
+
+/* single producer (owning thread) / single consumer (MLogMutex holder) ring */
+
+typedef struct mlogring_t {
+  volatile unsigned long Head;   /* bytes ever written by the owning thread */
+  volatile unsigned long Tail;   /* bytes ever drained to the log file */
+  volatile mbool_t       InUse;  /* ring is owned by a live thread */
+
+  char Buf[MDEF_LOGRINGSIZE];
+  } mlogring_t;
+
+mlogring_t     *MLogRing[MMAX_LOGRING];
+pthread_key_t   MLogRingKey;
+pthread_once_t  MLogRingKeyOnce = PTHREAD_ONCE_INIT;
+pthread_mutex_t MLogRingMutex = PTHREAD_MUTEX_INITIALIZER;   /* protects MLogRing[] assignment */
+pthread_mutex_t MLogWriterMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t  MLogWriterSignal = PTHREAD_COND_INITIALIZER; /* wakes the writer thread early */
+pthread_t       MLogWriterThread;
+volatile int    MLogAsyncProducers = 0;                      /* threads inside __MLogAsyncV() */
+
+
+
+/**
+ * Thread exit handler - release the thread's log ring for reuse.
+ *
+ * NOTE: the writer drains released rings before they are handed out again.
+ *
+ * @param Ring (I)
+ */
+
+void __MLogRingRelease(
+
+  void *Ring)
+
+  {
+  ((mlogring_t *)Ring)->InUse = FALSE;
+
+  return;
+  }  /* END __MLogRingRelease() */
+
+
+void __MLogRingKeyCreate(void)
+
+  {
+  pthread_key_create(&MLogRingKey,__MLogRingRelease);
+
+  return;
+  }  /* END __MLogRingKeyCreate() */
+
+
+
+
+/**
+ * Return the calling thread's log ring, attaching one on first use.
+ *
+ * @return NULL if all rings are taken (caller should log synchronously)
+ */
+
+mlogring_t *__MLogGetRing(void)
+
+  {
+  mlogring_t *R;
+
+  int rindex;
+
+  pthread_once(&MLogRingKeyOnce,__MLogRingKeyCreate);
+
+  if ((R = (mlogring_t *)pthread_getspecific(MLogRingKey)) != NULL)
+    {
+    return(R);
+    }
+
+  pthread_mutex_lock(&MLogRingMutex);
+
+  for (rindex = 0;rindex < MMAX_LOGRING;rindex++)
+    {
+    if (MLogRing[rindex] == NULL)
+      {
+      /* NOTE: use malloc() - MUCalloc() may log */
+
+      if ((MLogRing[rindex] = (mlogring_t *)calloc(1,sizeof(mlogring_t))) == NULL)
+        break;
+      }
+    else if ((MLogRing[rindex]->InUse == TRUE) ||
+             (MLogRing[rindex]->Head != MLogRing[rindex]->Tail))
+      {
+      /* owned, or released but not yet drained */
+
+      continue;
+      }
+
+    R = MLogRing[rindex];
+
+    R->InUse = TRUE;
+
+    break;
+    }  /* END for (rindex) */
+
+  pthread_mutex_unlock(&MLogRingMutex);
+
+  if (R != NULL)
+    pthread_setspecific(MLogRingKey,R);
+
+  return(R);
+  }  /* END __MLogGetRing() */
+
+
+
+
+/**
+ * Queue a formatted log line on the calling thread's ring.
+ *
+ * @param Header (I) [optional]
+ * @param Format (I)
+ * @param Args (I)
+ *
+ * @return FAILURE if line could not be queued (caller must write it synchronously)
+ */
+
+int __MLogAsyncPut(
+
+  const char *Header,
+  const char *Format,
+  va_list     Args)
+
+  {
+  mlogring_t *R;
+
+  char  Line[MMAX_LINE << 3];
+  int   HLen = 0;
+  int   Len;
+  int   Offset;
+  int   Chunk;
+
+  if ((R = __MLogGetRing()) == NULL)
+    {
+    return(FAILURE);
+    }
+
+  if (Header != NULL)
+    {
+    HLen = MIN((int)strlen(Header),(int)sizeof(Line) - 1);
+
+    memcpy(Line,Header,HLen);
+    }
+
+  Len = vsnprintf(Line + HLen,sizeof(Line) - HLen,Format,Args);
+
+  if ((Len < 0) || (Len >= (int)sizeof(Line) - HLen))
+    {
+    /* line too long for async path - flush what we queued so far to preserve order */
+
+    MLogFlush();
+
+    return(FAILURE);
+    }
+
+  Len += HLen;
+
+  if (MDEF_LOGRINGSIZE - (R->Head - R->Tail) < (unsigned long)Len)
+    {
+    /* ring full - writer is behind, drain it ourselves */
+
+    MLogFlush();
+
+    if (MDEF_LOGRINGSIZE - (R->Head - R->Tail) < (unsigned long)Len)
+      {
+      return(FAILURE);
+      }
+    }
+
+  Offset = (int)(R->Head & (MDEF_LOGRINGSIZE - 1));
+  Chunk  = MIN(Len,MDEF_LOGRINGSIZE - Offset);
+
+  memcpy(R->Buf + Offset,Line,Chunk);
+
+  if (Chunk < Len)
+    memcpy(R->Buf,Line + Chunk,Len - Chunk);
+
+  /* publish the line only after its bytes are in place */
+
+  __sync_synchronize();
+
+  R->Head += Len;
+
+  if (R->Head - R->Tail > (MDEF_LOGRINGSIZE >> 1))
+    pthread_cond_signal(&MLogWriterSignal);
+
+  return(SUCCESS);
+  }  /* END __MLogAsyncPut() */
+
+
+
+
+/**
+ * Queue a log line unless async logging is being shut down.
+ *
+ * @see __MLogAsyncPut()
+ *
+ * @param Header (I) [optional]
+ * @param Format (I)
+ * @param Args (I)
+ *
+ * @return FAILURE if line could not be queued (caller must write it synchronously)
+ */
+
+int __MLogAsyncV(
+
+  const char *Header,
+  const char *Format,
+  va_list     Args)
+
+  {
+  int rc;
+
+  /* register before re-checking IsAsync so MLogShutdown() can wait for us */
+
+  __sync_fetch_and_add(&MLogAsyncProducers,1);
+
+  if (mlog.IsAsync == FALSE)
+    {
+    __sync_fetch_and_sub(&MLogAsyncProducers,1);
+
+    return(FAILURE);
+    }
+
+  rc = __MLogAsyncPut(Header,Format,Args);
+
+  __sync_fetch_and_sub(&MLogAsyncProducers,1);
+
+  return(rc);
+  }  /* END __MLogAsyncV() */
+
+
+
+
+/**
+ * Log writer thread - drains all log rings every MDEF_LOGFLUSHMS or when
+ * a ring passes half full.
+ *
+ * @param Arg (I) [unused]
+ */
+
+void *__MLogWriter(
+
+  void *Arg)
+
+  {
+  struct timeval  Now;
+  struct timespec Deadline;
+
+  (void)Arg;
+
+  while (mlog.IsAsync == TRUE)
+    {
+    gettimeofday(&Now,NULL);
+
+    Deadline.tv_sec  = Now.tv_sec;
+    Deadline.tv_nsec = Now.tv_usec * 1000 + MDEF_LOGFLUSHMS * 1000000;
+
+    if (Deadline.tv_nsec >= 1000000000)
+      {
+      Deadline.tv_sec  += Deadline.tv_nsec / 1000000000;
+      Deadline.tv_nsec %= 1000000000;
+      }
+
+    pthread_mutex_lock(&MLogWriterMutex);
+
+    pthread_cond_timedwait(&MLogWriterSignal,&MLogWriterMutex,&Deadline);
+
+    pthread_mutex_unlock(&MLogWriterMutex);
+
+    MLogFlush();
+    }  /* END while (mlog.IsAsync == TRUE) */
+
+  return(NULL);
+  }  /* END __MLogWriter() */
+
+#endif /* MTHREADSAFE */
+
+
+
+
+/**
+ * Switch MLog(), MLogNH() and MLogNew() to asynchronous mode.
+ *
+ * Callers format lines into a per-thread ring buffer instead of writing to
+ * mlog.logfp under MLogMutex; a dedicated writer thread drains all rings
+ * with batched writev() calls.  Lines from one thread stay in order, lines
+ * from different threads are only ordered to within MDEF_LOGFLUSHMS.
+ *
+ * Enabled at startup via MSCHED_ENVLOGASYNCVAR.
+ *
+ * @see MLogFlush()
+ */
+
+int MLogAsyncStart(void)
+
+  {
+#ifdef MTHREADSAFE
+  pthread_attr_t Attr;
+
+  if (mlog.IsAsync == TRUE)
+    {
+    return(SUCCESS);
+    }
+
+  mlog.IsAsync = TRUE;
+
+  pthread_attr_init(&Attr);
+
+  if (pthread_create(&MLogWriterThread,&Attr,__MLogWriter,NULL) != 0)
+    {
+    mlog.IsAsync = FALSE;
+
+    pthread_attr_destroy(&Attr);
+
+    MDB(0,fCORE) MLog("ALERT:    cannot create log writer thread - logging synchronously\n");
+
+    return(FAILURE);
+    }
+
+  pthread_attr_destroy(&Attr);
+
+  return(SUCCESS);
+#else /* MTHREADSAFE */
+  return(FAILURE);
+#endif /* MTHREADSAFE */
+  }  /* END MLogAsyncStart() */
+
+
+
+
+/**
+ * Write all lines queued in the log rings to the logfile.
+ *
+ * NOTE: safe to call from any thread, no-op if logging is synchronous.
+ */
+
+int MLogFlush(void)
+
+  {
+#ifdef MTHREADSAFE
+  struct iovec IOV[MMAX_LOGIOV];
+
+  unsigned long Head[MMAX_LOGRING];
+
+  mlogring_t *R;
+
+  int rindex;
+  int first;
+  int icount;
+  int fd;
+  int Offset;
+  int Len;
+
+  ssize_t rc;
+
+  MUMutexLockSilent(&MLogMutex);
+
+  if ((mlog.logfp == NULL) || (mlog.State == mlsClosed))
+    {
+    MUMutexUnlockSilent(&MLogMutex);
+
+    return(SUCCESS);
+    }
+
+  /* push out anything written through stdio (MStat.eventfp, sync fallback) first */
+
+  fflush(mlog.logfp);
+
+  fd = fileno(mlog.logfp);
+
+  for (first = 0;first < MMAX_LOGRING;first += MMAX_LOGIOV >> 1)
+    {
+    icount = 0;
+
+    /* each ring contributes at most 2 segments (wrap) */
+
+    for (rindex = first;(rindex < MMAX_LOGRING) && (rindex < first + (MMAX_LOGIOV >> 1));rindex++)
+      {
+      if ((R = MLogRing[rindex]) == NULL)
+        {
+        Head[rindex] = 0;
+
+        continue;
+        }
+
+      Head[rindex] = R->Head;
+
+      __sync_synchronize();
+
+      if (Head[rindex] == R->Tail)
+        continue;
+
+      Offset = (int)(R->Tail & (MDEF_LOGRINGSIZE - 1));
+      Len    = (int)(Head[rindex] - R->Tail);
+
+      IOV[icount].iov_base = R->Buf + Offset;
+      IOV[icount].iov_len  = MIN(Len,MDEF_LOGRINGSIZE - Offset);
+
+      if ((int)IOV[icount].iov_len < Len)
+        {
+        icount++;
+
+        IOV[icount].iov_base = R->Buf;
+        IOV[icount].iov_len  = Len - IOV[icount - 1].iov_len;
+        }
+
+      icount++;
+      }  /* END for (rindex) */
+
+    /* write everything, resuming after partial writes */
+
+    rindex = 0;
+
+    while (rindex < icount)
+      {
+      rc = writev(fd,&IOV[rindex],icount - rindex);
+
+      if (rc < 0)
+        {
+        if (errno == EINTR)
+          continue;
+
+        /* cannot write - drop the batch rather than block logging forever */
+
+        break;
+        }
+
+      while ((rindex < icount) && (rc >= (ssize_t)IOV[rindex].iov_len))
+        {
+        rc -= IOV[rindex].iov_len;
+
+        rindex++;
+        }
+
+      if (rindex < icount)
+        {
+        IOV[rindex].iov_base = (char *)IOV[rindex].iov_base + rc;
+        IOV[rindex].iov_len -= rc;
+        }
+      }  /* END while (rindex < icount) */
+
+    /* release drained space to the producers */
+
+    __sync_synchronize();
+
+    for (rindex = first;(rindex < MMAX_LOGRING) && (rindex < first + (MMAX_LOGIOV >> 1));rindex++)
+      {
+      if ((MLogRing[rindex] != NULL) && (Head[rindex] != 0))
+        MLogRing[rindex]->Tail = Head[rindex];
+      }
+    }    /* END for (first) */
+
+  MUMutexUnlockSilent(&MLogMutex);
+#endif /* MTHREADSAFE */
+
+  return(SUCCESS);
+  }  /* END MLogFlush() */
 /**
  * Close logfile and clear log file handle.
  */
@@ -264,6 +742,10 @@ int MLogClose()
     return(SUCCESS);
     }
 
+  /* write out anything still queued for the old file */
+
+  MLogFlush();
+
   MUMutexLockSilent(&MLogMutex);
 
   mlog.State = mlsClosed;
@@ -288,6 +770,34 @@ int MLogClose()
 int MLogShutdown()
 
   {
+#ifdef MTHREADSAFE
+  if (mlog.IsAsync == TRUE)
+    {
+    /* stop accepting lines - later lines are written synchronously */
+
+    mlog.IsAsync = FALSE;
+
+    __sync_synchronize();
+
+    /* wait for producers already past the IsAsync check to finish queuing */
+
+    while (MLogAsyncProducers > 0)
+      sched_yield();
+
+    /* drain what was queued, then stop the writer */
+
+    MLogFlush();
+
+    pthread_mutex_lock(&MLogWriterMutex);
+
+    pthread_cond_signal(&MLogWriterSignal);
+
+    pthread_mutex_unlock(&MLogWriterMutex);
+
+    pthread_join(MLogWriterThread,NULL);
+    }
+#endif /* MTHREADSAFE */
+
   if (mlog.logfp != NULL)
     {
     MLogClose();
@@ -325,6 +835,38 @@ int MLog(
     return(SUCCESS);
     }
 
+#ifdef MTHREADSAFE
+  if (mlog.IsAsync == TRUE)
+    {
+    char Header[MMAX_NAME];
+    int  rc;
+
+#if defined(MLOGTHREADID)
+    snprintf(Header,sizeof(Header),"%s%s%u ",
+      (mlog.logfp != stderr) ? MLogGetTime() : "",
+      (mlog.logfp != stderr) ? " " : "",
+      (MUINT4)MUGetThreadID());
+#else /* MLOGTHREADID */
+    snprintf(Header,sizeof(Header),"%s%s",
+      (mlog.logfp != stderr) ? MLogGetTime() : "",
+      (mlog.logfp != stderr) ? " " : "");
+#endif /* MLOGTHREADID */
+
+    va_start(Args,Format);
+
+    rc = __MLogAsyncV(Header,Format,Args);
+
+    va_end(Args);
+
+    if (rc == SUCCESS)
+      {
+      return(SUCCESS);
+      }
+
+    /* fall through - write synchronously */
+    }
+#endif /* MTHREADSAFE */
+
   MUMutexLockSilent(&MLogMutex);
   
   if ((mlog.logfp != NULL) && (mlog.State != mlsClosed))
@@ -384,6 +926,24 @@ int MLogNH(
     return(SUCCESS);
     }
 
+#ifdef MTHREADSAFE
+  if (mlog.IsAsync == TRUE)
+    {
+    int rc;
+
+    va_start(Args,Format);
+
+    rc = __MLogAsyncV(NULL,Format,Args);
+
+    va_end(Args);
+
+    if (rc == SUCCESS)
+      {
+      return(SUCCESS);
+      }
+    }
+#endif /* MTHREADSAFE */
+
   MUMutexLockSilent(&MLogMutex);
 
   if ((mlog.logfp != NULL) && (mlog.State != mlsClosed))
@@ -576,48 +1136,174 @@ int MLogRoll(
   }  /* END MLogRoll() */
 
 
-char *MLogGetTimeNewFormat()
+/* per-second timestamp cache (see __MLogTimeCacheGet()) */
+
+typedef struct mlogtime_t {
+  volatile time_t  Second;         /* second Line[Index] was formatted for */
+  volatile int     Index;          /* Line[] readers should use */
+  volatile int     IsUpdating;     /* set while one thread reformats */
+  char             Line[2][MMAX_NAME];
+  } mlogtime_t;
+
+mlogtime_t MLogTime;
+mlogtime_t MLogTimeNewFormat;
+
+
+
+/**
+ * Format Now into Buf in the classic (MLogGetTime()) or new 
+ * (MLogGetTimeNewFormat()) log header format.
+ *
+ * @param Now (I)
+ * @param NewFormat (I)
+ * @param Buf (O) [minsize=MMAX_NAME]
+ */
+
+void __MLogFormatTime(
+
+  time_t   Now,
+  mbool_t  NewFormat,
+  char    *Buf)
 
   {
-  time_t        epoch_time = 0;
-  struct tm    *present_time;
-  static char   line[MMAX_LINE];
+  struct tm  tmpTM;
+  struct tm *present_time;
+
+  present_time = localtime_r(&Now,&tmpTM);
+
+  if (NewFormat == TRUE)
+    {
+    if (present_time != NULL)
+      {
+      snprintf(Buf,MMAX_NAME,"%4.4d-%2.2d-%2.2d %2.2d:%2.2d:%2.2d ",
+        present_time->tm_year + 1900,
+        present_time->tm_mon + 1,
+        present_time->tm_mday,
+        present_time->tm_hour,
+        present_time->tm_min,
+        present_time->tm_sec);
+      }
+    else
+      {
+      snprintf(Buf,MMAX_NAME,"%4.4d-%2.2d-%2.2d %2.2d:%2.2d:%2.2d ", 
+        0,0,0,0,0,0);
+      }
 
-  MUGetTime((mulong *)&epoch_time,mtmNONE,NULL);
+    return;
+    }  /* END if (NewFormat == TRUE) */
 
-  if ((present_time = localtime(&epoch_time)) != NULL)
+  if (present_time != NULL)
     {
-    sprintf(line,"%4.4d-%2.2d-%2.2d %2.2d:%2.2d:%2.2d ",
+#ifdef __MLOGYEAR
+    snprintf(Buf,MMAX_NAME,"%2.2d/%2.2d/%4.4d %2.2d:%2.2d:%2.2d ",
+      present_time->tm_mon + 1,
+      present_time->tm_mday,
       present_time->tm_year + 1900,
+      present_time->tm_hour,
+      present_time->tm_min,
+      present_time->tm_sec);
+#else /* __MLOGYEAR */
+    snprintf(Buf,MMAX_NAME,"%2.2d/%2.2d %2.2d:%2.2d:%2.2d ",
       present_time->tm_mon + 1,
       present_time->tm_mday,
       present_time->tm_hour,
       present_time->tm_min,
       present_time->tm_sec);
+#endif /* __MLOGYEAR */
     }
   else
     {
-    sprintf(line,"%4.4d-%2.2d-%2.2d %2.2d:%2.2d:%2.2d ", 
-      0,0,0,0,0,0);
+    snprintf(Buf,MMAX_NAME,"%2.2d/%2.2d %2.2d:%2.2d:%2.2d ", 
+      0,0,0,0,0);
     }
 
-  return(line);
-  }  /* END MLogGetTime() */
+  return;
+  }  /* END __MLogFormatTime() */
+
+
+
+
+/**
+ * Return the cached log timestamp for the current second, reformatting
+ * only when the second changes.
+ *
+ * NOTE: lock-free - the thread that wins IsUpdating formats into the
+ *       inactive buffer and then publishes it, all other threads keep 
+ *       reading the previous buffer (at most one second stale) meanwhile.
+ *
+ * @param C (I/O)
+ * @param NewFormat (I)
+ */
+
+char *__MLogTimeCacheGet(
+
+  mlogtime_t *C,
+  mbool_t     NewFormat)
 
+  {
+  time_t Now = 0;
+  int    Next;
+
+  MUGetTime((mulong *)&Now,mtmNONE,NULL);
+
+  if ((Now != C->Second) && 
+      (__sync_bool_compare_and_swap(&C->IsUpdating,0,1)))
+    {
+    Next = 1 - C->Index;
+
+    __MLogFormatTime(Now,NewFormat,C->Line[Next]);
+
+    __sync_synchronize();
+
+    C->Index  = Next;
+    C->Second = Now;
+
+    __sync_synchronize();
+
+    C->IsUpdating = 0;
+    }
+
+  while (C->Second == 0)
+    {
+    /* very first call raced with the initial format - wait for it */
+
+    __sync_synchronize();
+    }
 
+  return(C->Line[C->Index]);
+  }  /* END __MLogTimeCacheGet() */
 
 
 
 
+/**
+ * Report log header timestamp in the new log format.
+ *
+ * @see MLogNew()
+ */
+
+char *MLogGetTimeNewFormat()
+
+  {
+  return(__MLogTimeCacheGet(&MLogTimeNewFormat,TRUE));
+  }  /* END MLogGetTimeNewFormat() */
+
+
+
+
+
+/**
+ * Report log header timestamp.
+ *
+ * @see MLog()
+ */
+
 char *MLogGetTime()
 
   {
-  time_t        epoch_time = 0;
-  struct tm    *present_time;
+#ifdef MDEBUGLOG
   static char   line[MMAX_LINE];
-  static time_t now = 0;
 
-#ifdef MDEBUGLOG
   long milliseconds = 0;
 
   MUGetMS(NULL,&milliseconds);
@@ -628,39 +1314,7 @@ char *MLogGetTime()
   return(line);
 #endif /* MDEBUGLOG */
 
-  MUGetTime((mulong *)&epoch_time,mtmNONE,NULL);
-
-  if (epoch_time != now)
-    {
-    now = epoch_time;
-
-    if ((present_time = localtime(&epoch_time)) != NULL)
-      {
-#ifdef __MLOGYEAR
-      sprintf(line,"%2.2d/%2.2d/%4.4d %2.2d:%2.2d:%2.2d ",
-        present_time->tm_mon + 1,
-        present_time->tm_mday,
-        present_time->tm_year + 1900,
-        present_time->tm_hour,
-        present_time->tm_min,
-        present_time->tm_sec);
-#else /* __MLOGYEAR */
-      sprintf(line,"%2.2d/%2.2d %2.2d:%2.2d:%2.2d ",
-        present_time->tm_mon + 1,
-        present_time->tm_mday,
-        present_time->tm_hour,
-        present_time->tm_min,
-        present_time->tm_sec);
-#endif /* __MLOGYEAR */
-      }
-    else
-      {
-      sprintf(line,"%2.2d/%2.2d %2.2d:%2.2d:%2.2d ", 
-        0,0,0,0,0);
-      }
-    }    /* END if (epoch_time != now) */
-
-  return(line);
+  return(__MLogTimeCacheGet(&MLogTime,FALSE));
   }  /* END MLogGetTime() */
 
 
@@ -729,6 +1383,33 @@ void MLogLevelAdjust(
   }  /* END MLogLevelAdjust() */
 
 
+
+
+/**
+ * Rebuild mlog.FacilityMask (the single-word copy of mlog.FacilityBM 
+ * tested by MDB()/MDBE()/MDBO()).
+ *
+ * NOTE: must be called whenever mlog.FacilityBM is modified.
+ */
+
+int MLogUpdateFacilityMask()
+
+  {
+  unsigned long Mask = 0;
+  int           findex;
+
+  for (findex = 0;findex <= fALL;findex++)
+    {
+    if (bmisset(&mlog.FacilityBM,findex))
+      Mask |= (1UL << findex);
+    }
+
+  mlog.FacilityMask = Mask;
+
+  return(SUCCESS);
+  }  /* END MLogUpdateFacilityMask() */
+
+
 int MLogJob(
 
   enum MLogLevelEnum  Level,
@@ -781,6 +1462,46 @@ int MLogNew(
     return(SUCCESS);
     }
 
+#ifdef MTHREADSAFE
+  if (mlog.IsAsync == TRUE)
+    {
+    char    Header[MMAX_LINE];
+    va_list tmpArgs;
+    int     rc;
+
+    Header[0] = '\0';
+
+    if (mlog.logfp != stderr)
+      {
+      snprintf(Header,sizeof(Header),"%s %s %s %s %s/%d ",
+        MLogGetTimeNewFormat(),
+        MLogLevel[Level],
+        MXO[Category],
+        ID,
+        File,
+        Line);
+      }
+
+#if defined(MLOGTHREADID)
+    snprintf(Header + strlen(Header),sizeof(Header) - strlen(Header),"%u ",
+      (MUINT4)MUGetThreadID());
+#endif /* MLOGTHREADID */
+
+    /* Args may be needed again by the synchronous fallback */
+
+    va_copy(tmpArgs,Args);
+
+    rc = __MLogAsyncV(Header,Format,tmpArgs);
+
+    va_end(tmpArgs);
+
+    if (rc == SUCCESS)
+      {
+      return(SUCCESS);
+      }
+    }
+#endif /* MTHREADSAFE */
+
   MUMutexLockSilent(&MLogMutex);
   
   if ((mlog.logfp != NULL) && (mlog.State != mlsClosed))
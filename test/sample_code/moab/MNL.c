@@ -930,6 +930,45 @@ int MNLInit(
   }  /* END MNLMultiInit() */
 
 
+/**
+ * Initialize mnalloc structure with its array drawn from arena A.
+ *
+ * NOTE: list must not be used after A is reset (or after the MUArenaMark()
+ *       scope it was created in is released).  Free with MNLFree() as usual.
+ *
+ * @see MUArenaCalloc() - falls back to the heap if A cannot be used
+ *
+ * @param NL
+ * @param A
+ */
+
+int MNLInitFromArena(
+
+  mnl_t     *NL,
+  marena_t  *A)
+
+  {
+  if (NL == NULL)
+    return(FAILURE);
+
+  if (A == NULL)
+    return(MNLInit(NL));
+
+  memset(NL,0,sizeof(mnl_t));
+
+  NL->Array = (mnalloc_old_t *)MUArenaCalloc(A,MDEF_ARENANLSIZE,sizeof(mnalloc_old_t));
+
+  if (NL->Array == NULL)
+    return(FAILURE);
+
+  NL->Size       = MDEF_ARENANLSIZE;
+  NL->Arena      = A;
+  NL->ArenaDepth = A->Depth;
+
+  return(SUCCESS);
+  }  /* END MNLInitFromArena() */
+
+
 /**
  * Free mnalloc structure.
  *
@@ -944,9 +983,10 @@ int MNLFree(
   if (NL == NULL)
     return(FAILURE);
 
-  MUFree((char **)&NL->Array);
+  MUArenaFree(NL->Arena,(char **)&NL->Array);
 
-  NL->Size = 0;
+  NL->Size  = 0;
+  NL->Arena = NULL;
 
   return(SUCCESS);
   }  /* END MNLFree() */
@@ -984,6 +1024,42 @@ int MNLMultiInit(
   return(SUCCESS);
   }  /* END MNLMultiInit() */
 
+
+/**
+ * Initialize multi-mnalloc structure with lists drawn from arena A.
+ * 
+ * NOTE: Assumes array is size MMAX_REQ_PER_JOB.
+ *
+ * @see MNLInitFromArena()
+ *
+ * @param MNL
+ * @param A
+ */
+
+int MNLMultiInitFromArena(
+
+  mnl_t     **MNL,
+  marena_t   *A)
+
+  {
+  int index;
+
+  if (MNL == NULL)
+    return(FAILURE);
+
+  memset(MNL,0,sizeof(mnl_t *) * MMAX_REQ_PER_JOB);
+
+  for (index = 0;index < MMAX_REQ_PER_JOB;index++)
+    {
+    MNL[index] = (mnl_t *)MUArenaCalloc(A,1,sizeof(mnl_t));
+
+    if ((MNL[index] == NULL) || (MNLInitFromArena(MNL[index],A) == FAILURE))
+      return(FAILURE);
+    }  /* END for (index) */
+
+  return(SUCCESS);
+  }  /* END MNLMultiInitFromArena() */
+
 /**
  * Initialize multi-mnalloc structure.
  * 
@@ -1030,14 +1106,18 @@ int MNLMultiFree(
   {
   int index;
 
+  marena_t *A;
+
   if (MNL == NULL)
     return(FAILURE);
 
   for (index = 0;index < MMAX_REQ_PER_JOB;index++)
     {
+    A = (MNL[index] != NULL) ? MNL[index]->Arena : NULL;
+
     MNLFree(MNL[index]);
 
-    MUFree((char **)&MNL[index]);
+    MUArenaFree(A,(char **)&MNL[index]);
     }  /* END for (index) */
 
   memset(MNL,0,sizeof(mnl_t *) * MMAX_REQ_PER_JOB);
@@ -1062,14 +1142,18 @@ int MNLMultiFreeCount(
   {
   int index;
 
+  marena_t *A;
+
   if (MNL == NULL)
     return(FAILURE);
 
   for (index = 0;index < Count;index++)
     {
+    A = (MNL[index] != NULL) ? MNL[index]->Arena : NULL;
+
     MNLFree(MNL[index]);
 
-    MUFree((char **)&MNL[index]);
+    MUArenaFree(A,(char **)&MNL[index]);
     }  /* END for (index) */
 
   memset(MNL,0,sizeof(mnl_t *) * Count);
@@ -1110,6 +1194,28 @@ int __MNLGrow(
     {
     NL->Array = (mnalloc_old_t *)MUCalloc(NewSize,sizeof(mnalloc_old_t));
     }
+  else if (NL->Arena != NULL)
+    {
+    mnalloc_old_t *tmpArray;
+
+    /* arena memory cannot be realloc'd - copy into a new array, drawn from
+       the heap if a nested MUArenaMark() scope is open (it would be released
+       out from under this list) */
+
+    if (NL->Arena->Depth == NL->ArenaDepth)
+      tmpArray = (mnalloc_old_t *)MUArenaCalloc(NL->Arena,NewSize,sizeof(mnalloc_old_t));
+    else
+      tmpArray = (mnalloc_old_t *)MUArenaHeapCalloc(NL->Arena,NewSize,sizeof(mnalloc_old_t));
+
+    if (tmpArray == NULL)
+      return(FAILURE);
+
+    memcpy(tmpArray,NL->Array,NL->Size * sizeof(mnalloc_old_t));
+
+    MUArenaFree(NL->Arena,(char **)&NL->Array);
+
+    NL->Array = tmpArray;
+    }
   else
     {
     mnalloc_old_t *tmpArray;
@@ -142,7 +142,7 @@ int MNodeReserve(
   mrsv_t *R;
   mrsv_t *RProf = NULL;
 
-  mnl_t   NL = {0};
+  mnl_t   NL;
  
   mulong    EndTime;
 
@@ -153,6 +153,8 @@ int MNodeReserve(
     return(SUCCESS);
     }
 
+  memset(&NL,0,sizeof(NL));
+
   MNLInit(&NL);
 
   MNLSetNodeAtIndex(&NL,0,N);
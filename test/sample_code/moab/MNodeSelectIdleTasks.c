@@ -12,6 +12,10 @@
 #include "moab-const.h"  
 #include "moab-global.h"  
 
+#ifndef __NOMCOMMTHREAD
+#include <pthread.h>
+#endif /* !__NOMCOMMTHREAD */
+
 
 
 
@@ -24,6 +28,60 @@ typedef struct
   long     ATime;
   } _mpnodealloc_t;
 
+/* outcome of evaluating one FNL entry */
+
+typedef struct
+  {
+  mbool_t  IsSelected;   /* node goes on the idle node list */
+  char     Map;          /* NodeMap value (affinity or mnmUnavailable) */
+  int      TC;           /* MIN(node tasks,FNL tasks) */
+  int      ListTC;       /* TC rounded down to RQ->TasksPerNode */
+  long     ATime;
+  } _mpnodecheck_t;
+
+/* FNL slice evaluated by one thread, with that thread's counts */
+
+typedef struct
+  {
+  const mjob_t   *J;
+  const mreq_t   *RQ;
+  const mnl_t    *FNL;
+  int             StartIndex;
+  int             EndIndex;            /* exclusive */
+  _mpnodecheck_t *Result;              /* indexed by FNL index */
+
+  int             TC;                  /* tasks found */
+  int             NC;                  /* nodes selected */
+  int             RejCount[marLAST];   /* rejections by reason */
+  } _mpnodeslice_t;
+
+#ifndef __NOMCOMMTHREAD
+
+/* persistent worker threads for parallel FNL evaluation - the caller 
+   evaluates slice 0, worker <n> evaluates slice <n> */
+
+typedef struct
+  {
+  pthread_mutex_t Mutex;
+  pthread_cond_t  Start;       /* workers wait here for the next batch */
+  pthread_cond_t  Done;        /* caller waits here for Pending to reach 0 */
+  int             NumThreads;  /* workers created */
+  int             Batch;       /* incremented for each batch of slices */
+  int             Pending;     /* workers still busy with the current batch */
+  mbool_t         IsBusy;      /* a caller owns the workers */
+  int             SliceCount;
+  _mpnodeslice_t *Slice;
+  int             WorkerBatch[MMAX_NODESELECTTHREADS];  /* last batch seen by each worker */
+  } _mnodeselectpool_t;
+
+_mnodeselectpool_t MNodeSelectPool = { 
+  PTHREAD_MUTEX_INITIALIZER,
+  PTHREAD_COND_INITIALIZER,
+  PTHREAD_COND_INITIALIZER,
+  0, 0, 0, FALSE, 0, NULL, { 0 } };
+
+#endif /* !__NOMCOMMTHREAD */
+
 /* END private structures */
 
 /**
@@ -46,11 +104,324 @@ int __MNLATimeCompLToH(
 
 
 
+
+/**
+ * Evaluate FNL entries [S->StartIndex,S->EndIndex) against S->RQ, storing 
+ * each outcome in S->Result and counting tasks, nodes and rejections in S.
+ *
+ * NOTE: only touches S, its slice of S->Result and read-only job, node and
+ *       reservation state - safe to run concurrently on disjoint slices 
+ *       (see __MNodeSelectIdleTasksCanThread()).
+ *
+ * @param S (I/O)
+ */
+
+void __MNodeSelectIdleTasksCheckSlice(
+
+  _mpnodeslice_t *S)  /* I/O */
+
+  {
+  const mjob_t *J  = S->J;
+  const mreq_t *RQ = S->RQ;
+
+  _mpnodecheck_t *C;
+
+  mnode_t *N;
+
+  int      index;
+  int      tmpTC;
+
+  long     ATime;
+
+  char     NodeAffinity;
+
+  enum MAllocRejEnum RIndex;
+
+  S->TC = 0;
+  S->NC = 0;
+
+  memset(S->RejCount,0,sizeof(S->RejCount));
+
+  for (index = S->StartIndex;index < S->EndIndex;index++)
+    {
+    C = &S->Result[index];
+
+    C->IsSelected = FALSE;
+    C->Map        = mnmUnavailable;
+    C->TC         = 0;
+    C->ListTC     = 0;
+    C->ATime      = 0;
+
+    MNLGetNodeAtIndex(S->FNL,index,&N);
+
+    /* NOTE:  MReqCheckNRes does not check job hostlist */
+    /*        hostlist constraints must be enforced when creating FNL */
+
+    if (MReqCheckNRes(
+          J,
+          N,
+          RQ,
+          MSched.Time,
+          &tmpTC,       /* O */
+          1.0,
+/* NOTE: added in 04/07, removed 10/07 as it causes suspended jobs to require all feasible tasks
+         to be available in order to be resumed
+          (J->State == mjsSuspended) ? FNL[index].TC : 0,
+*/
+          0,
+          &RIndex,
+          &NodeAffinity,
+          &ATime,
+          FALSE,
+          FALSE,
+          NULL) == FAILURE)
+      {
+      /* record why job failed requirements check */
+
+      S->RejCount[RIndex]++;
+
+      if (tmpTC > 0)
+        S->TC += tmpTC;
+
+      continue;
+      }
+
+    if ((!MReqIsGlobalOnly(RQ)) &&
+        (bmisset(&J->Flags,mjfAdvRsv)) && (!bmisset(&J->IFlags,mjifNotAdvres)))
+      {
+      if ((NodeAffinity == mnmPositiveAffinity) ||
+          (NodeAffinity == mnmNeutralAffinity) ||
+          (NodeAffinity == mnmNegativeAffinity) ||
+          (NodeAffinity == mnmRequired))
+        {
+        MDB(7,fSCHED) MLog("INFO:     node '%s' added (reserved)\n",
+          N->Name);
+        }
+      else
+        {
+        MDB(7,fSCHED) MLog("INFO:     node '%s' rejected (not reserved)\n",
+          N->Name);
+
+        continue;
+        }
+      }
+
+    C->IsSelected = TRUE;
+    C->Map        = NodeAffinity;
+    C->TC         = MIN(tmpTC,MNLGetTCAtIndex(S->FNL,index));
+    C->ListTC     = C->TC;
+    C->ATime      = ATime;
+
+    if (RQ->TasksPerNode > 0)
+      C->ListTC -= C->ListTC % RQ->TasksPerNode;
+
+    S->TC += C->ListTC;
+    S->NC++;
+    }  /* END for (index) */
+
+  return;
+  }  /* END __MNodeSelectIdleTasksCheckSlice() */
+
+
+
+
+/**
+ * Report whether MReqCheckNRes() may be run for J on several nodes at once.
+ *
+ * MReqCheckNRes() and its children only write their locals and output
+ * arguments, except for two debugging aids:  MCResToString() (loglevel 7+
+ * messages in MJobGetSNRange()) returns a static buffer, and MUCalloc()/
+ * MUFree() update an unlocked table when memory tracking is enabled.
+ *
+ * @param J (I)
+ */
+
+mbool_t __MNodeSelectIdleTasksCanThread(
+
+  const mjob_t *J)  /* I */
+
+  {
+#ifdef __NOMCOMMTHREAD
+  return(FALSE);
+#else /* __NOMCOMMTHREAD */
+  if ((mlog.Threshold >= 7) ||
+      (J->LogLevel >= 7) ||
+      (mlog.MemoryTracker != NULL))
+    {
+    return(FALSE);
+    }
+
+  return(TRUE);
+#endif /* __NOMCOMMTHREAD */
+  }  /* END __MNodeSelectIdleTasksCanThread() */
+
+
+
+
+#ifndef __NOMCOMMTHREAD
+/**
+ * Worker thread - evaluate slice <Data> of each batch posted to
+ * MNodeSelectPool.
+ *
+ * @param Data (I) worker index (1 based)
+ */
+
+void *__MNodeSelectIdleTasksWorker(
+
+  void *Data)  /* I */
+
+  {
+  _mnodeselectpool_t *P = &MNodeSelectPool;
+  _mpnodeslice_t     *S;
+
+  int WIndex = (int)(long)Data;
+
+  pthread_mutex_lock(&P->Mutex);
+
+  for (;;)
+    {
+    while (P->Batch == P->WorkerBatch[WIndex])
+      {
+      pthread_cond_wait(&P->Start,&P->Mutex);
+      }
+
+    P->WorkerBatch[WIndex] = P->Batch;
+
+    S = (WIndex < P->SliceCount) ? &P->Slice[WIndex] : NULL;
+
+    pthread_mutex_unlock(&P->Mutex);
+
+    if (S != NULL)
+      __MNodeSelectIdleTasksCheckSlice(S);
+
+    pthread_mutex_lock(&P->Mutex);
+
+    if (--P->Pending == 0)
+      pthread_cond_signal(&P->Done);
+    }  /* END for (;;) */
+
+  /*NOTREACHED*/
+
+  return(NULL);
+  }  /* END __MNodeSelectIdleTasksWorker() */
+#endif /* !__NOMCOMMTHREAD */
+
+
+
+
+/**
+ * Evaluate Slice[0..SliceCount-1], slice 0 in the calling thread and the
+ * others on MNodeSelectPool workers (created on first use).
+ *
+ * NOTE: falls back to evaluating every slice in the calling thread if the
+ *       workers are in use by another caller or cannot be created.
+ *
+ * @param Slice      (I/O)
+ * @param SliceCount (I)
+ */
+
+int __MNodeSelectIdleTasksCheck(
+
+  _mpnodeslice_t *Slice,       /* I/O */
+  int             SliceCount)  /* I */
+
+  {
+  int sindex;
+  int Posted = 1;  /* slices handed to the workers (incl. slice 0) */
+
+#ifndef __NOMCOMMTHREAD
+  _mnodeselectpool_t *P = &MNodeSelectPool;
+
+  pthread_attr_t Attr;
+  pthread_t      Thread;
+
+  if (SliceCount > 1)
+    {
+    pthread_mutex_lock(&P->Mutex);
+
+    if (P->IsBusy == FALSE)
+      {
+      pthread_attr_init(&Attr);
+      pthread_attr_setdetachstate(&Attr,PTHREAD_CREATE_DETACHED);
+
+      while (P->NumThreads < SliceCount - 1)
+        {
+        P->WorkerBatch[P->NumThreads + 1] = P->Batch;
+
+        if (pthread_create(
+              &Thread,
+              &Attr,
+              __MNodeSelectIdleTasksWorker,
+              (void *)(long)(P->NumThreads + 1)) != 0)
+          {
+          MDB(2,fSCHED) MLog("WARNING:  cannot create node selection thread %d\n",
+            P->NumThreads + 1);
+
+          break;
+          }
+
+        P->NumThreads++;
+        }
+
+      pthread_attr_destroy(&Attr);
+
+      if (P->NumThreads > 0)
+        {
+        Posted = MIN(SliceCount,P->NumThreads + 1);
+
+        P->IsBusy     = TRUE;
+        P->Slice      = Slice;
+        P->SliceCount = Posted;
+        P->Pending    = P->NumThreads;
+
+        P->Batch++;
+
+        pthread_cond_broadcast(&P->Start);
+        }
+      }    /* END if (P->IsBusy == FALSE) */
+
+    pthread_mutex_unlock(&P->Mutex);
+    }      /* END if (SliceCount > 1) */
+#endif /* !__NOMCOMMTHREAD */
+
+  __MNodeSelectIdleTasksCheckSlice(&Slice[0]);
+
+  for (sindex = Posted;sindex < SliceCount;sindex++)
+    __MNodeSelectIdleTasksCheckSlice(&Slice[sindex]);
+
+#ifndef __NOMCOMMTHREAD
+  if (Posted > 1)
+    {
+    pthread_mutex_lock(&P->Mutex);
+
+    while (P->Pending > 0)
+      {
+      pthread_cond_wait(&P->Done,&P->Mutex);
+      }
+
+    P->IsBusy = FALSE;
+    P->Slice  = NULL;
+
+    pthread_mutex_unlock(&P->Mutex);
+    }
+#endif /* !__NOMCOMMTHREAD */
+
+  return(SUCCESS);
+  }  /* END __MNodeSelectIdleTasksCheck() */
+
+
+
 /**
  * Select nodes from specified feasible node list which are available for immediate use.
  *
+ * With NODESELECTTHREADS > 1 a large FNL is split into contiguous slices
+ * evaluated by several threads.  Each slice keeps its own task, node and
+ * rejection counts and per-node outcomes, which are merged in FNL order so
+ * the result is identical to a serial pass.
+ *
  * @see MJobSelectMNL() - parent - select tasks available for immediate use
  * @see MReqCheckNRes() - child
+ * @see __MNodeSelectIdleTasksCheck() - child - (parallel) FNL evaluation
  *
  * @param J         (I)
  * @param SRQ       (I) [optional]
@@ -82,24 +453,27 @@ int MNodeSelectIdleTasks(
   int     rqindex;
   int     nindex;
   int     index;
-
-  enum MAllocRejEnum RIndex;
-
-  char    NodeAffinity;
+  int     sindex;
+  int     rindex;
 
   int     TotalTC;
   int     TotalNC;
 
-  long    ATime;
-
   mnl_t  *NodeList;
 
   int     ANC[MMAX_REQ_PER_JOB];
   int     ATC[MMAX_REQ_PER_JOB];
 
   _mpnodealloc_t *MPN = NULL;
+  _mpnodecheck_t *NCheck = NULL;
+  _mpnodecheck_t *C;
 
-  int     tmpTC;
+  _mpnodeslice_t  Slice[MMAX_NODESELECTTHREADS];
+
+  int     NCount;
+  int     SliceCount;
+
+  marenamark_t Mark;
 
   mbool_t InadequateTasks = FALSE;
 
@@ -117,7 +491,7 @@ int MNodeSelectIdleTasks(
     *NodeCount = 0;
 
   if (RejCount != NULL)
-    memset(RejCount,0,sizeof(RejCount));
+    memset(RejCount,0,sizeof(RejCount[0]) * MMAX_REQ_PER_JOB);
 
   if ((J == NULL) || 
       (FNL == NULL) ||
@@ -129,7 +503,25 @@ int MNodeSelectIdleTasks(
   TotalTC = 0;
   TotalNC = 0;
 
-  MPN = (_mpnodealloc_t *)MUCalloc(1,sizeof(_mpnodealloc_t) * MSched.M[mxoNode]);
+  for (NCount = 0;MNLGetNodeAtIndex(FNL,NCount,NULL) == SUCCESS;NCount++);
+
+  /* each thread gets at least MMIN_NODESELECTTHREADNODES nodes */
+
+  SliceCount = MIN(MSched.NodeSelectThreads,NCount / MMIN_NODESELECTTHREADNODES);
+  SliceCount = MAX(1,MIN(SliceCount,MMAX_NODESELECTTHREADS));
+
+  if ((SliceCount > 1) && (__MNodeSelectIdleTasksCanThread(J) == FALSE))
+    SliceCount = 1;
+
+  /* scratch arrays are drawn from the per-iteration arena and discarded on
+     return - they are fully written before they are read and at most NCount
+     entries are ever used, so no clearing and no MSched.M[mxoNode] sizing */
+
+  MUArenaMark(&MSchedArena,&Mark);
+
+  MPN = (_mpnodealloc_t *)MUArenaMalloc(&MSchedArena,sizeof(_mpnodealloc_t) * MAX(1,NCount));
+
+  NCheck = (_mpnodecheck_t *)MUArenaMalloc(&MSchedArena,sizeof(_mpnodecheck_t) * MAX(1,NCount));
 
   for (rqindex = 0;J->Req[rqindex] != NULL;rqindex++)
     {
@@ -144,66 +536,44 @@ int MNodeSelectIdleTasks(
  
     ATC[rqindex] = 0;
     ANC[rqindex] = 0;
- 
-    for (index = 0;MNLGetNodeAtIndex(FNL,index,&N) == SUCCESS;index++)
+
+    /* evaluate every node, then merge the slices in FNL order */
+
+    for (sindex = 0;sindex < SliceCount;sindex++)
       {
-      /* NOTE:  MReqCheckNRes does not check job hostlist */
-      /*        hostlist constraints must be enforced when creating FNL */
-
-      if (MReqCheckNRes(
-            J,
-            N,
-            RQ,
-            MSched.Time,
-            &tmpTC,       /* O */
-            1.0,
-/* NOTE: added in 04/07, removed 10/07 as it causes suspended jobs to require all feasible tasks
-         to be available in order to be resumed
-            (J->State == mjsSuspended) ? FNL[index].TC : 0,
-*/
-            0,
-            &RIndex,
-            &NodeAffinity,
-            &ATime,
-            FALSE,
-            FALSE,
-            NULL) == FAILURE)
-        {
-        /* record why job failed requirements check */
+      Slice[sindex].J          = J;
+      Slice[sindex].RQ         = RQ;
+      Slice[sindex].FNL        = FNL;
+      Slice[sindex].StartIndex = (int)((long)NCount * sindex / SliceCount);
+      Slice[sindex].EndIndex   = (int)((long)NCount * (sindex + 1) / SliceCount);
+      Slice[sindex].Result     = NCheck;
+      }
+
+    __MNodeSelectIdleTasksCheck(Slice,SliceCount);
+
+    for (sindex = 0;sindex < SliceCount;sindex++)
+      {
+      ATC[rqindex] += Slice[sindex].TC;
+      ANC[rqindex] += Slice[sindex].NC;
+
+      if (RejCount == NULL)
+        continue;
+
+      for (rindex = 0;rindex < marLAST;rindex++)
+        RejCount[rqindex][rindex] += Slice[sindex].RejCount[rindex];
+      }
 
-        if (RejCount != NULL)
-          RejCount[rqindex][RIndex]++;
+    for (index = 0;index < NCount;index++)
+      {
+      C = &NCheck[index];
 
-        if (NodeMap != NULL) 
-          NodeMap[N->Index] = mnmUnavailable;
+      MNLGetNodeAtIndex(FNL,index,&N);
 
-        if (tmpTC > 0)
-          ATC[rqindex] += tmpTC;
+      if (NodeMap != NULL) 
+        NodeMap[N->Index] = C->Map;
 
+      if (C->IsSelected == FALSE)
         continue;
-        }
- 
-      if ((!MReqIsGlobalOnly(RQ)) &&
-          (bmisset(&J->Flags,mjfAdvRsv)) && (!bmisset(&J->IFlags,mjifNotAdvres)))
-        {
-        if ((NodeAffinity == mnmPositiveAffinity) ||
-            (NodeAffinity == mnmNeutralAffinity) ||
-            (NodeAffinity == mnmNegativeAffinity) ||
-            (NodeAffinity == mnmRequired))
-          {
-          MDB(7,fSCHED) MLog("INFO:     node '%s' added (reserved)\n",
-            N->Name);
-          }
-        else
-          {
-          MDB(7,fSCHED) MLog("INFO:     node '%s' rejected (not reserved)\n",
-            N->Name);
- 
-          NodeMap[N->Index] = mnmUnavailable;
- 
-          continue;
-          }
-        }
 
       if ((MPar[0].NAllocPolicy == mnalLastAvailable) ||
           (MPar[0].NAllocPolicy == mnalInReverseReportedOrder))
@@ -211,36 +581,17 @@ int MNodeSelectIdleTasks(
         /* NOTE:  sort jobs in min avail time first order */
       
         MPN[nindex].N     = N;
-        MPN[nindex].TC    = MIN(tmpTC,MNLGetTCAtIndex(FNL,index));
-        MPN[nindex].ATime = ATime;
-
-        MNLSetNodeAtIndex(NodeList,nindex,N);
-        MNLSetTCAtIndex(NodeList,nindex,MIN(tmpTC,MNLGetTCAtIndex(FNL,index)));
-        }
-      else
-        {
-        MNLSetNodeAtIndex(NodeList,nindex,N);
-        MNLSetTCAtIndex(NodeList,nindex,MIN(tmpTC,MNLGetTCAtIndex(FNL,index)));
-        }
- 
-      if (RQ->TasksPerNode > 0)
-        {
-        int tmpTC = MNLGetTCAtIndex(NodeList,nindex);
-
-        MNLSetTCAtIndex(NodeList,nindex,tmpTC - tmpTC % RQ->TasksPerNode);
+        MPN[nindex].TC    = C->TC;
+        MPN[nindex].ATime = C->ATime;
         }
- 
-      ATC[rqindex] += MNLGetTCAtIndex(NodeList,nindex);
 
-      ANC[rqindex]++;
- 
-      NodeMap[N->Index] = NodeAffinity;
+      MNLSetNodeAtIndex(NodeList,nindex,N);
+      MNLSetTCAtIndex(NodeList,nindex,C->ListTC);
  
-      MDB(6,fSCHED) MLog("INFO:     node[%d] %s added to task list (%d tasks : %d tasks total)\n",
+      MDB(6,fSCHED) MLog("INFO:     node[%d] %s added to task list (%d tasks)\n",
         nindex,
         N->Name,
-        MNLGetTCAtIndex(NodeList,nindex),
-        ATC[rqindex]);
+        C->ListTC);
  
       nindex++;
       }    /* END for (index)  */
@@ -304,7 +655,10 @@ int MNodeSelectIdleTasks(
   if (NodeCount != NULL)
     *NodeCount = TotalNC;
 
-  MUFree((char **)&MPN);
+  MUArenaFree(&MSchedArena,(char **)&NCheck);
+  MUArenaFree(&MSchedArena,(char **)&MPN);
+
+  MUArenaRelease(&MSchedArena,&Mark);
 
   if (InadequateTasks == TRUE)
     {
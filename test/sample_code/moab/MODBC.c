@@ -596,6 +596,87 @@ int MODBCDeleteNodesStmt(
 
 
 
+/**
+ * @see MDBDeleteJobByIDStmt()
+ * @param MDBInfo (I)
+ * @param MStmt   (O)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MODBCDeleteJobByIDStmt(
+
+  modbc_t *MDBInfo, /* I */
+  mstmt_t *MStmt,   /* O */
+  char    *EMsg)    /* O */
+
+  {
+  const char *StmtTextPtr = MDBDeleteJobByIDStmtText;
+
+  return(MODBCSetPreparedStmt(
+    MDBInfo,
+    MStmt,
+    &MDBInfo->DeleteJobByIDStmt,
+    StmtTextPtr,
+    EMsg));
+  } /* END MODBCDeleteJobByIDStmt() */
+
+
+
+
+/**
+ * @see MDBDeleteRequestsByJobIDStmt()
+ * @param MDBInfo (I)
+ * @param MStmt   (O)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MODBCDeleteRequestsByJobIDStmt(
+
+  modbc_t *MDBInfo, /* I */
+  mstmt_t *MStmt,   /* O */
+  char    *EMsg)    /* O */
+
+  {
+  const char *StmtTextPtr = MDBDeleteRequestsByJobIDStmtText;
+
+  return(MODBCSetPreparedStmt(
+    MDBInfo,
+    MStmt,
+    &MDBInfo->DeleteRequestsByJobIDStmt,
+    StmtTextPtr,
+    EMsg));
+  } /* END MODBCDeleteRequestsByJobIDStmt() */
+
+
+
+
+/**
+ * @see MDBDeleteNodeByIDStmt()
+ * @param MDBInfo (I)
+ * @param MStmt   (O)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MODBCDeleteNodeByIDStmt(
+
+  modbc_t *MDBInfo, /* I */
+  mstmt_t *MStmt,   /* O */
+  char    *EMsg)    /* O */
+
+  {
+  const char *StmtTextPtr = MDBDeleteNodeByIDStmtText;
+
+  return(MODBCSetPreparedStmt(
+    MDBInfo,
+    MStmt,
+    &MDBInfo->DeleteNodeByIDStmt,
+    StmtTextPtr,
+    EMsg));
+  } /* END MODBCDeleteNodeByIDStmt() */
+
+
+
+
 /**
  * Get statement for Selecting event descriptions
  * @see MDBSelectEventsMsgsStmt()
@@ -908,6 +989,12 @@ int MODBCFree(
   MDBInfo->DeleteRequestsStmt.super.IsInitialized = FALSE;
   MODBCFreeStmt(&MDBInfo->DeleteNodesStmt.super);
   MDBInfo->DeleteNodesStmt.super.IsInitialized = FALSE;
+  MODBCFreeStmt(&MDBInfo->DeleteJobByIDStmt.super);
+  MDBInfo->DeleteJobByIDStmt.super.IsInitialized = FALSE;
+  MODBCFreeStmt(&MDBInfo->DeleteRequestsByJobIDStmt.super);
+  MDBInfo->DeleteRequestsByJobIDStmt.super.IsInitialized = FALSE;
+  MODBCFreeStmt(&MDBInfo->DeleteNodeByIDStmt.super);
+  MDBInfo->DeleteNodeByIDStmt.super.IsInitialized = FALSE;
   MODBCFreeStmt(&MDBInfo->InsertJobStmt.super);
   MDBInfo->InsertJobStmt.super.IsInitialized = FALSE;
   MODBCFreeStmt(&MDBInfo->InsertRsvStmt.super);
@@ -2318,6 +2405,48 @@ int MODBCEndTransaction(
 
 
 
+/**
+ * @see MDBRollbackTransaction()
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ * @param SC      (O)
+ */
+
+int MODBCRollbackTransaction(
+
+  modbc_t              *MDBInfo,
+  char                 *EMsg,
+  enum MStatusCodeEnum *SC)
+
+  {
+  int rc;
+
+  rc = SQL_SUCCEEDED(SQLEndTran(SQL_HANDLE_DBC,MDBInfo->SQLHandle,SQL_ROLLBACK));
+
+  if (rc == FAILURE)
+    {
+    MODBCError(MDBInfo->SQLHandle,SQL_HANDLE_DBC,NULL,EMsg,SC);
+    return(FAILURE);
+    }
+
+  rc = SQL_SUCCEEDED(SQLSetConnectAttr(MDBInfo->SQLHandle,
+      SQL_ATTR_AUTOCOMMIT,
+      (SQLPOINTER)SQL_AUTOCOMMIT_ON,
+      SQL_IS_UINTEGER));
+
+  if (rc == FAILURE)
+    {
+    MODBCError(MDBInfo->SQLHandle,SQL_HANDLE_DBC,NULL,EMsg,SC);
+    return(FAILURE);
+    }
+
+  return (SUCCESS);
+  } /* END MODBCRollbackTransaction() */
+
+
+
+
 /**
  * @see MDBInTransaction()
  *
@@ -2506,6 +2635,45 @@ int MODBCDeleteNodesStmt(
 
 
 
+int MODBCDeleteJobByIDStmt(
+
+  modbc_t *MDBInfo,
+  mstmt_t *MStmt,   /* O */
+  char    *EMsg)    /* O */
+
+  {
+  return(FAILURE);
+  }
+
+
+
+
+int MODBCDeleteRequestsByJobIDStmt(
+
+  modbc_t *MDBInfo,
+  mstmt_t *MStmt,   /* O */
+  char    *EMsg)    /* O */
+
+  {
+  return(FAILURE);
+  }
+
+
+
+
+int MODBCDeleteNodeByIDStmt(
+
+  modbc_t *MDBInfo,
+  mstmt_t *MStmt,   /* O */
+  char    *EMsg)    /* O */
+
+  {
+  return(FAILURE);
+  }
+
+
+
+
 int MODBCSelectEventsMsgsStmt(
 
   modbc_t *MDBInfo,
@@ -3269,6 +3437,19 @@ int MODBCEndTransaction(
 
 
 
+int MODBCRollbackTransaction(
+
+  modbc_t *MDBInfo,
+  char *EMsg,
+  enum MStatusCodeEnum *SC)
+
+  {
+  return(FAILURE);
+  } /* END MODBCRollbackTransaction() */
+
+
+
+
 mbool_t MODBCInTransaction(
 
     modbc_t *MDBInfo)
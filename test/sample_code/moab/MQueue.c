@@ -46,6 +46,373 @@ int __MQueueSortCmp(
 
 
 
+/* previous MQueuePrioritizeJobs() order of each prioritized list - one per
+   partition plus one for caller supplied queues (HaveQ) */
+
+#define MQUEUE_PRIOLISTS (MMAX_PAR + 2)
+
+typedef struct mqueueorder_t {
+  mjob_t **Job;    /* jobs in previous order (never dereferenced - may be stale) */
+  int      Count;
+  int      Size;
+  } mqueueorder_t;
+
+static mqueueorder_t MQueuePrioOrder[MQUEUE_PRIOLISTS];
+
+
+
+
+/**
+ * Compare jobs by start priority, breaking ties which MJobStartPrioComp()
+ * reports as equal on the job name (and on the job address as a last
+ * resort), so that any sort of the same jobs gives the same order.
+ *
+ * @see MJobStartPrioComp()
+ *
+ * @param A (I)
+ * @param B (I)
+ */
+
+int MQueueStartPrioComp(
+
+  mjob_t **A,  /* I */
+  mjob_t **B)  /* I */
+
+  {
+  int tmp;
+
+  if ((tmp = MJobStartPrioComp(A,B)) != 0)
+    return(tmp);
+
+  if ((tmp = strcmp((*A)->Name,(*B)->Name)) != 0)
+    return(tmp);
+
+  if (*A == *B)
+    return(0);
+
+  return((*A < *B) ? -1 : 1);
+  }  /* END MQueueStartPrioComp() */
+
+
+
+
+/**
+ * Reorder Q by each job's position in the previous order O of the same list.
+ * Jobs not in O (new jobs) follow in their current order.
+ *
+ * NOTE:  the result is only a hint for MQueueSortStartPrio(), any order of Q
+ *        sorts correctly
+ *
+ * @param Q (I/O)
+ * @param JCount (I)
+ * @param O (I)
+ */
+
+static int __MQueueOrderByPrevious(
+
+  mjob_t              **Q,
+  int                   JCount,
+  const mqueueorder_t  *O)
+
+  {
+  static mjob_t **Slot = NULL;
+  static int      SlotSize = 0;
+
+  static mjob_t **Rest = NULL;
+  static int      RestSize = 0;
+
+  /* open addressed map of job address -> 1-based position in O */
+
+  static mjob_t **HJob = NULL;
+  static int     *HRank = NULL;
+  static int      HSize = 0;
+
+  int jindex;
+  int rindex;
+  int RCount;
+  int hindex;
+  int Mask;
+
+  if ((O->Count == 0) || (JCount < 2))
+    {
+    return(SUCCESS);
+    }
+
+  if (O->Count > SlotSize)
+    {
+    MUFree((char **)&Slot);
+
+    SlotSize = 0;
+
+    if ((Slot = (mjob_t **)MUCalloc(O->Count,sizeof(mjob_t *))) == NULL)
+      {
+      return(FAILURE);
+      }
+
+    SlotSize = O->Count;
+    }
+
+  if (JCount > RestSize)
+    {
+    MUFree((char **)&Rest);
+
+    RestSize = 0;
+
+    if ((Rest = (mjob_t **)MUCalloc(JCount,sizeof(mjob_t *))) == NULL)
+      {
+      return(FAILURE);
+      }
+
+    RestSize = JCount;
+    }
+
+  if (O->Count * 2 > HSize)
+    {
+    MUFree((char **)&HJob);
+    MUFree((char **)&HRank);
+
+    for (HSize = 64;HSize < O->Count * 2;HSize <<= 1);
+
+    HJob  = (mjob_t **)MUCalloc(HSize,sizeof(mjob_t *));
+    HRank = (int *)MUCalloc(HSize,sizeof(int));
+
+    if ((HJob == NULL) || (HRank == NULL))
+      {
+      MUFree((char **)&HJob);
+      MUFree((char **)&HRank);
+
+      HSize = 0;
+
+      return(FAILURE);
+      }
+    }
+
+  Mask = HSize - 1;
+
+#define MQUEUE_PTRHASH(J) ((int)((((mulong)(J)) >> 4) * 2654435761UL) & Mask)
+
+  memset(HJob,0,sizeof(mjob_t *) * HSize);
+
+  for (rindex = 0;rindex < O->Count;rindex++)
+    {
+    for (hindex = MQUEUE_PTRHASH(O->Job[rindex]);HJob[hindex] != NULL;hindex = (hindex + 1) & Mask);
+
+    HJob[hindex]  = O->Job[rindex];
+    HRank[hindex] = rindex + 1;
+    }
+
+  RCount = 0;
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    {
+    rindex = -1;
+
+    for (hindex = MQUEUE_PTRHASH(Q[jindex]);HJob[hindex] != NULL;hindex = (hindex + 1) & Mask)
+      {
+      if (HJob[hindex] == Q[jindex])
+        {
+        rindex = HRank[hindex] - 1;
+
+        break;
+        }
+      }
+
+    if ((rindex >= 0) && (Slot[rindex] == NULL))
+      Slot[rindex] = Q[jindex];
+    else
+      Rest[RCount++] = Q[jindex];
+    }
+
+#undef MQUEUE_PTRHASH
+
+  jindex = 0;
+
+  for (rindex = 0;rindex < O->Count;rindex++)
+    {
+    if (Slot[rindex] == NULL)
+      continue;
+
+    Q[jindex++] = Slot[rindex];
+
+    Slot[rindex] = NULL;
+    }
+
+  memcpy(&Q[jindex],Rest,sizeof(mjob_t *) * RCount);
+
+  return(SUCCESS);
+  }  /* END __MQueueOrderByPrevious() */
+
+
+
+
+/**
+ * Record Q as the previous order O of its list.
+ *
+ * @param Q (I)
+ * @param JCount (I)
+ * @param O (I/O)
+ */
+
+static int __MQueueSaveOrder(
+
+  mjob_t        **Q,
+  int             JCount,
+  mqueueorder_t  *O)
+
+  {
+  if (JCount > O->Size)
+    {
+    MUFree((char **)&O->Job);
+
+    O->Count = 0;
+    O->Size  = 0;
+
+    if ((O->Job = (mjob_t **)MUCalloc(JCount,sizeof(mjob_t *))) == NULL)
+      {
+      return(FAILURE);
+      }
+
+    O->Size = JCount;
+    }
+
+  memcpy(O->Job,Q,sizeof(mjob_t *) * JCount);
+
+  O->Count = JCount;
+
+  return(SUCCESS);
+  }  /* END __MQueueSaveOrder() */
+
+
+
+
+/**
+ * Sort Q by start priority (MQueueStartPrioComp()), taking advantage of Q
+ * already being mostly in order.
+ *
+ * Q is split in one pass into an ordered subsequence and the jobs that break
+ * it (a job is set aside either when it sorts before its predecessor, or,
+ * if it fits after the job before its predecessor, the predecessor is set
+ * aside instead).  Only the jobs set aside are sorted, then both are merged.
+ * With k jobs out of place this costs about 2n + k log k comparisons instead
+ * of n log n, and gives the same order as qsort() with MQueueStartPrioComp().
+ *
+ * @see MQueuePrioritizeJobs() - parent
+ *
+ * @param Q (I/O)
+ * @param JCount (I)
+ */
+
+int MQueueSortStartPrio(
+
+  mjob_t **Q,
+  int      JCount)
+
+  {
+  static mjob_t **Moved = NULL;
+  static mjob_t **Tmp = NULL;
+  static int      BufSize = 0;
+
+  int jindex;
+  int OCount;   /* ordered jobs, kept in place at the front of Q */
+  int MCount;   /* jobs set aside */
+  int oindex;
+  int mindex;
+
+  if ((Q == NULL) || (JCount < 2))
+    {
+    return(SUCCESS);
+    }
+
+  if (JCount > BufSize)
+    {
+    MUFree((char **)&Moved);
+    MUFree((char **)&Tmp);
+
+    BufSize = 0;
+
+    Moved = (mjob_t **)MUCalloc(JCount,sizeof(mjob_t *));
+    Tmp   = (mjob_t **)MUCalloc(JCount,sizeof(mjob_t *));
+
+    if ((Moved == NULL) || (Tmp == NULL))
+      {
+      MUFree((char **)&Moved);
+      MUFree((char **)&Tmp);
+
+      qsort(
+        (void *)&Q[0],
+        JCount,
+        sizeof(Q[0]),
+        (int(*)(const void *,const void *))MQueueStartPrioComp);
+
+      return(SUCCESS);
+      }
+
+    BufSize = JCount;
+    }
+
+  OCount = 1;
+  MCount = 0;
+
+  for (jindex = 1;jindex < JCount;jindex++)
+    {
+    if (MQueueStartPrioComp(&Q[OCount - 1],&Q[jindex]) <= 0)
+      {
+      Q[OCount++] = Q[jindex];
+      }
+    else if ((OCount >= 2) && (MQueueStartPrioComp(&Q[OCount - 2],&Q[jindex]) <= 0))
+      {
+      /* predecessor is out of place */
+
+      Moved[MCount++] = Q[OCount - 1];
+
+      Q[OCount - 1] = Q[jindex];
+      }
+    else
+      {
+      Moved[MCount++] = Q[jindex];
+      }
+    }    /* END for (jindex) */
+
+  if (MCount == 0)
+    {
+    return(SUCCESS);
+    }
+
+  qsort(
+    (void *)&Moved[0],
+    MCount,
+    sizeof(Moved[0]),
+    (int(*)(const void *,const void *))MQueueStartPrioComp);
+
+  /* merge */
+
+  memcpy(Tmp,Q,sizeof(mjob_t *) * OCount);
+
+  oindex = 0;
+  mindex = 0;
+  jindex = 0;
+
+  while ((oindex < OCount) && (mindex < MCount))
+    {
+    if (MQueueStartPrioComp(&Tmp[oindex],&Moved[mindex]) <= 0)
+      Q[jindex++] = Tmp[oindex++];
+    else
+      Q[jindex++] = Moved[mindex++];
+    }
+
+  while (oindex < OCount)
+    Q[jindex++] = Tmp[oindex++];
+
+  while (mindex < MCount)
+    Q[jindex++] = Moved[mindex++];
+
+  return(SUCCESS);
+  }  /* END MQueueSortStartPrio() */
+
+
+
+
+
 /**
  * Calculate 'start' priority for either Q (if HaveQ) or ALL jobs.
  *
@@ -63,8 +430,12 @@ int MQueuePrioritizeJobs(
   const mpar_t  *P)
 
   {
+  static double *JPrio = NULL;
+  static int     JPrioSize = 0;
+
   double  tmpD;
   int     jindex;
+  int     JCount;
 
   long    MaxIdleStartPriority = 0;
 
@@ -74,6 +445,8 @@ int MQueuePrioritizeJobs(
 
   int pindex = (P == NULL) ? 0 : P->Index;
 
+  mqueueorder_t *O = &MQueuePrioOrder[(HaveQ == TRUE) ? MQUEUE_PRIOLISTS - 1 : pindex];
+
   MDB(7,fSCHED) MLog("%s(Q,JobIndex,%s)\n",
     FName,
     (P != NULL) ? P->Name : "NULL");
@@ -85,43 +458,14 @@ int MQueuePrioritizeJobs(
 
   if (HaveQ == TRUE)
     {
-    /* just prioritize Q, not ALL jobs */
+    /* just prioritize Q, not ALL jobs - count its entries */
 
-    for (jindex = 0;Q[jindex] != NULL;jindex++) 
-      { 
-      J = Q[jindex]; 
-
-      MJobCalcStartPriority(
-        J,
-        P,
-        &tmpD,
-        mpdJob,
-        NULL,
-        0,
-        mfmHuman,
-        FALSE);
- 
-      MJobSetStartPriority(
-        J,
-        pindex,
-        (long)tmpD);
-
-      if (MJOBISACTIVE(J))
-        {
-        int PIndex = 0;
-
-        if (J->Req[0] != NULL)
-          PIndex = J->Req[0]->PtIndex;
+    jindex = 0;
 
-        MJobGetRunPriority(J,PIndex,&tmpD,NULL,NULL);
- 
-        J->RunPriority = (long)tmpD;
-        }
-      else 
-        {
-        MaxIdleStartPriority = MAX(MaxIdleStartPriority,J->PStartPriority[pindex]);
-        } /* END else (MJOBISACTIVE(J)) */ 
-      } /* END for (jindex = 0;JobIndex[jindex] != -1;jindex++) */
+    while (Q[jindex] != NULL)
+      {
+      jindex++;
+      }
     } /* END if Q == NULL .... */
   else
     {
@@ -143,40 +487,55 @@ int MQueuePrioritizeJobs(
           continue;
         }
 
-      MJobCalcStartPriority(
-        J,
-        P,
-        &tmpD,
-        mpdJob,
-        NULL,
-        0,
-        mfmHuman,
-        FALSE);
-
-      MJobSetStartPriority(
-        J,
-        pindex,
-        (long)tmpD);
+      Q[jindex++] = J;
+      }
+    }  /* END for (J) */
 
-      if (MJOBISACTIVE(J) == TRUE)
-        {
-        int PIndex = 0;
+  JCount = jindex;
 
-        if (J->Req[0] != NULL)
-          PIndex = J->Req[0]->PtIndex;
+  if (JCount > JPrioSize)
+    {
+    MUFree((char **)&JPrio);
 
-        MJobGetRunPriority(J,PIndex,&tmpD,NULL,NULL);
+    JPrioSize = 0;
 
-        J->RunPriority = (long)tmpD;
-        }
-      else
-        {
-        MaxIdleStartPriority = MAX(MaxIdleStartPriority,J->PStartPriority[pindex]);
-        }
+    if ((JPrio = (double *)MUCalloc(1,sizeof(double) * JCount)) == NULL)
+      {
+      return(FAILURE);
+      }
 
-      Q[jindex++] = J;
+    JPrioSize = JCount;
+    }
+
+  /* calculate all start priorities in one pass */
+
+  MJobCalcStartPriorityBatch(Q,JCount,P,JPrio);
+
+  for (jindex = 0;jindex < JCount;jindex++) 
+    { 
+    J = Q[jindex]; 
+
+    MJobSetStartPriority(
+      J,
+      pindex,
+      (long)JPrio[jindex]);
+
+    if (MJOBISACTIVE(J) == TRUE)
+      {
+      int PIndex = 0;
+
+      if (J->Req[0] != NULL)
+        PIndex = J->Req[0]->PtIndex;
+
+      MJobGetRunPriority(J,PIndex,&tmpD,NULL,NULL);
+ 
+      J->RunPriority = (long)tmpD;
       }
-    }  /* END for (J) */
+    else 
+      {
+      MaxIdleStartPriority = MAX(MaxIdleStartPriority,J->PStartPriority[pindex]);
+      } /* END else (MJOBISACTIVE(J)) */ 
+    } /* END for (jindex) */
 
   if (jindex > 1)
     {      
@@ -189,11 +548,12 @@ int MQueuePrioritizeJobs(
        according to the specified partition (we do not need to use J->PStartPriority[pindex]
        since it will be the same value) */
 
-    qsort(
-      (void *)&Q[0],
-      jindex,
-      sizeof(Q[0]),
-      (int(*)(const void *,const void *))MJobStartPrioComp);
+    /* most jobs keep their place from one iteration to the next - start from
+       the previous order of this list and only sort the jobs that moved */
+
+    __MQueueOrderByPrevious(Q,jindex,O);
+
+    MQueueSortStartPrio(Q,jindex);
 
     MDB(7,fSCHED) MLog("INFO:    Job Table AFTER prioritization - partition (%s)\n",
       (P == NULL) ? "" : P->Name);
@@ -201,6 +561,8 @@ int MQueuePrioritizeJobs(
     MDB(7,fSCHED) __MQueuePrintQueueWithPriority(Q,jindex,7);
     }
 
+  __MQueueSaveOrder(Q,JCount,O);
+
   Q[jindex] = NULL;          
 
 #if !defined(__MALWAYSPREEMPT)
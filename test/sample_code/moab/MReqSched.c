@@ -105,8 +105,6 @@ int MReqCheckResourceMatch(
     {
     msmpnode_t *SN;
 
-    int OldLogLevel = mlog.Threshold;
-
     if ((SN = MSMPNodeFindByNode(N,FALSE)) != NULL)
       {
       if (MSMPJobIsWithinRLimits(J,SN) == FALSE)
@@ -121,14 +119,9 @@ int MReqCheckResourceMatch(
         if (Msg != NULL)
           strcpy(Msg,"request exceeds resources allowed on SMP");
           
-        mlog.Threshold =  OldLogLevel;
-
- 
         return(FAILURE);
         }
       }
-
-    mlog.Threshold =  OldLogLevel;
     }     /* END if (MSched.SharedMem == TRUE) */
 
   if (J != NULL)
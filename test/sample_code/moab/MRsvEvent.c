@@ -186,34 +186,49 @@ int MREAlloc(
 
 
 
+/**
+ * Add a copy of RE to the time-sorted event list REHead.
+ *
+ * The new event is linked in after the last event at or before RE->Time,
+ * which is where a stable MRESort() of the appended list would place it.
+ * Should the list not be sorted, the event is appended and the list sorted.
+ *
+ * @param REHead (I) [modified]
+ * @param RE (I)
+ */
+
 int MREAddSingleEvent(
 
   mre_t **REHead,
   mre_t  *RE)
 
   {
-  if (RE == NULL)
+  mre_t *ptr;
+  mre_t *prev;
+  mre_t *last;
+
+  mbool_t IsSorted = TRUE;
+
+  if ((REHead == NULL) || (RE == NULL))
     {
     return(FAILURE);
     }
 
-  mre_t *ptr;
-  mre_t *prev;
-
-  /* initial setup of pointers */
+  /* locate insertion point */
 
   prev = NULL;
+  last = NULL;
 
-  ptr = *REHead;
-
-  while (ptr != NULL)
+  for (ptr = *REHead;ptr != NULL;ptr = ptr->Next)
     {
-    prev = ptr;   /* Save a pointer to the current node, as we walk the list */
+    if ((last != NULL) && (last->Time > ptr->Time))
+      IsSorted = FALSE;
 
-    ptr = ptr->Next;
-    }  /* END while (ptr != NULL) */
+    if (ptr->Time <= RE->Time)
+      prev = ptr;
 
-  /* reached end of list so we are adding new element to linked list */
+    last = ptr;
+    }  /* END for (ptr) */
 
   /* Get a new control structure */
   if ((ptr = (mre_t *)MUCalloc(1,sizeof(mre_t))) == NULL)
@@ -226,26 +241,33 @@ int MREAddSingleEvent(
     return(FAILURE);
     }
 
-  /* Check if list has nodes or is empty, and adjust ptrs accordingly */
-  if (prev != NULL)
+  /* fill in the new control node */
+
+  MRECopyEvent(ptr,RE,TRUE);
+
+  if (IsSorted == FALSE)
+    {
+    last->Next = ptr;
+
+    *REHead = MRESort(*REHead);
+    }
+  else if (prev != NULL)
     {
+    ptr->Next = prev->Next;
+
     prev->Next = ptr;
     }
   else
     {
-    /* This case is generated by an empty RE table */
+    /* new earliest event or empty RE table */
+
+    ptr->Next = *REHead;
 
     *REHead = ptr;
     }
 
-  /* fill in the new control node */
-
-  MRECopyEvent(ptr,RE,TRUE);
-
-  *REHead = MRESort(*REHead);
-
   return(SUCCESS);
-  }  /* END MREInsertSingleEvent() */
+  }  /* END MREAddSingleEvent() */
  
 
 
@@ -682,7 +682,6 @@ mbool_t MSMPJobIsWithinRLimits(
   int MaxMemUsage  = 0;
 
   int usageIndex;
-  int OldLogLevel = mlog.Threshold;
 
   if ((J == NULL) || (SN == NULL))
     {
@@ -698,8 +697,6 @@ mbool_t MSMPJobIsWithinRLimits(
     MDB(1,fSCHED) MLog("ERROR:    couldn't find index into NodeSetList for node feature %s\n",
       MAList[meNFeature][SN->Feature]);
       
-    mlog.Threshold = OldLogLevel;
-
     return(FALSE);
     }
 
@@ -709,8 +706,6 @@ mbool_t MSMPJobIsWithinRLimits(
         J->Name,
         J->Credential.C->Name);
     
-    mlog.Threshold = OldLogLevel;
-
     return(TRUE);
     }
 
@@ -753,8 +748,6 @@ mbool_t MSMPJobIsWithinRLimits(
       }
     } /* END if (MSched.NodeUsagePolicy > 0.0) */
 
-  mlog.Threshold = OldLogLevel;
-
   return(TRUE);
   } /* END mbool_t MSMPJobIsWithinRLimits() */
 
@@ -33,7 +33,7 @@ struct mstmt_sqlite3_t {
   MSQLite3StmtState         State;
   mbool_t                   ParametersBound;
   int                       ParamCurIndex;
-
+  mbool_t                   StableParams; /* bound buffers outlive each execution, bind with SQLITE_STATIC */
 };
 
 struct msqlite3_t {
@@ -71,12 +71,19 @@ struct msqlite3_t {
   mstmt_sqlite3_t SelectNodesStmt;
   mstmt_sqlite3_t BeginTransactionStmt;
   mstmt_sqlite3_t EndTransactionStmt;
+  mstmt_sqlite3_t RollbackTransactionStmt;
+  mstmt_sqlite3_t SetSavepointStmt;
+  mstmt_sqlite3_t ReleaseSavepointStmt;
+  mstmt_sqlite3_t RollbackToSavepointStmt;
   mstmt_sqlite3_t DeleteJobsStmt;
   mstmt_sqlite3_t DeleteRsvsStmt;
   mstmt_sqlite3_t DeleteTriggersStmt;
   mstmt_sqlite3_t DeleteVCsStmt;
   mstmt_sqlite3_t DeleteNodesStmt;
   mstmt_sqlite3_t DeleteRequestsStmt;
+  mstmt_sqlite3_t DeleteJobByIDStmt;
+  mstmt_sqlite3_t DeleteRequestsByJobIDStmt;
+  mstmt_sqlite3_t DeleteNodeByIDStmt;
 };
 
 
@@ -94,6 +101,7 @@ static int BindParamsForExecution(
   {
   int index;
   int ArrIndex = MStmt->ParamCurIndex;
+  sqlite3_destructor_type Copy = (MStmt->StableParams == TRUE) ? SQLITE_STATIC : SQLITE_TRANSIENT;
   if (ArrIndex >= MStmt->ParamArraySize)
     return(ArrIndex == 0); /*we should succeed if there are no parameters to bind */
 
@@ -119,7 +127,7 @@ static int BindParamsForExecution(
         if (Param->Size > 0)
           val += (ArrIndex * Param->Size);
 
-        rc = sqlite3_bind_text(MStmt->Stmt,index,val,-1,SQLITE_TRANSIENT);
+        rc = sqlite3_bind_text(MStmt->Stmt,index,val,-1,Copy);
         break;
         }
 
@@ -142,7 +150,7 @@ static int BindParamsForExecution(
         if (Param->Size > 0)
           val += (ArrIndex * Param->Size);
 
-        rc = sqlite3_bind_blob(MStmt->Stmt,index,val,Param->Size,SQLITE_TRANSIENT);
+        rc = sqlite3_bind_blob(MStmt->Stmt,index,val,Param->Size,Copy);
         break;
         }
 
@@ -1280,6 +1288,56 @@ static int MSQLite3VerifyTableIntegrity(
 
 
 
+/**
+ * switch the database file behind MDBInfo to write-ahead logging (see
+ * DBWALMODE), so that readers on other handles do not block the transition
+ * thread's commits and a commit only has to reach the log
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+static int MSQLite3SetWALMode(
+
+  msqlite3_t *MDBInfo, /* I */
+  char       *EMsg)    /* O */
+
+  {
+  sqlite3_stmt *Stmt = NULL;
+  char const   *Mode = NULL;
+  mbool_t       IsWAL = FALSE;
+
+  /* journal_mode answers with the mode now in effect, which stays the old
+   * one if the file cannot be switched */
+
+  if ((sqlite3_prepare_v2(MDBInfo->DB,"PRAGMA journal_mode=WAL;",-1,&Stmt,NULL) == SQLITE_OK) &&
+      (sqlite3_step(Stmt) == SQLITE_ROW) &&
+      ((Mode = (char const *)sqlite3_column_text(Stmt,0)) != NULL) &&
+      (!strcasecmp(Mode,"wal")))
+    {
+    IsWAL = TRUE;
+    }
+
+  sqlite3_finalize(Stmt);
+
+  if (IsWAL == FALSE)
+    {
+    if (EMsg != NULL)
+      snprintf(EMsg,MMAX_LINE,"cannot switch SQLite3 database file %s to WAL mode",MDBInfo->DBFile);
+
+    return(FAILURE);
+    }
+
+  /* in WAL mode only checkpoints need to be synced to be durable */
+
+  sqlite3_exec(MDBInfo->DB,"PRAGMA synchronous=NORMAL;",NULL,NULL,NULL);
+
+  return(SUCCESS);
+  } /* END MSQLite3SetWALMode */
+
+
+
+
 /**
  * @see MDBConnect()
  *This function allocates a sqlite3 database handle. It assumes that if
@@ -1348,6 +1406,14 @@ int MSQLite3Connect(
 
       return(FAILURE);
       }
+    else if ((MSched.DBWALMode == TRUE) &&
+             (MSQLite3SetWALMode(MDBInfo,EMsg) == FAILURE))
+      {
+      /* not fatal, the default rollback journal still works */
+
+      MDB(1,fCONFIG) MLog("WARNING:  %s\n",
+        (EMsg != NULL) ? EMsg : "cannot switch SQLite3 database to WAL mode");
+      }
     }
   return(SUCCESS);
   } /* END MSQLite3Connect */ 
@@ -1437,6 +1503,28 @@ int MSQLite3Free(
   MSQLite3FreeStmt(&MDBInfo->SelectNodesStmt);
   MSQLite3FreeStmt(&MDBInfo->BeginTransactionStmt);
   MSQLite3FreeStmt(&MDBInfo->EndTransactionStmt);
+  MSQLite3FreeStmt(&MDBInfo->RollbackTransactionStmt);
+  MSQLite3FreeStmt(&MDBInfo->SetSavepointStmt);
+  MSQLite3FreeStmt(&MDBInfo->ReleaseSavepointStmt);
+  MSQLite3FreeStmt(&MDBInfo->RollbackToSavepointStmt);
+  MSQLite3FreeStmt(&MDBInfo->InsertJobStmt);
+  MSQLite3FreeStmt(&MDBInfo->InsertRsvStmt);
+  MSQLite3FreeStmt(&MDBInfo->InsertTriggerStmt);
+  MSQLite3FreeStmt(&MDBInfo->InsertVCStmt);
+  MSQLite3FreeStmt(&MDBInfo->InsertRequestStmt);
+  MSQLite3FreeStmt(&MDBInfo->InsertNodeStmt);
+  MSQLite3FreeStmt(&MDBInfo->SelectRsvsStmt);
+  MSQLite3FreeStmt(&MDBInfo->SelectTriggersStmt);
+  MSQLite3FreeStmt(&MDBInfo->SelectVCsStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteJobsStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteRsvsStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteTriggersStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteVCsStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteNodesStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteRequestsStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteJobByIDStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteRequestsByJobIDStmt);
+  MSQLite3FreeStmt(&MDBInfo->DeleteNodeByIDStmt);
 
   rc = sqlite3_close(MDBInfo->DB);
 
@@ -1635,6 +1723,33 @@ int MSQLite3SelectNodeStatsRangeStmt(
 
 
 
+/**
+ * internal method to drop the statement cached in MStmt when it was prepared
+ * from other text than StmtText. The Delete* statement texts are rebuilt with
+ * a new WHERE clause for every call, so the cached statement cannot be reused
+ * blindly.
+ * @param MStmt    (I) [modified]
+ * @param StmtText (I)
+ */
+
+static int ForgetChangedStmt(
+
+  mstmt_sqlite3_t *MStmt,    /* I (modified) */
+  char const      *StmtText) /* I */
+
+  {
+  if ((MStmt->Stmt == NULL) || !strcmp(sqlite3_sql(MStmt->Stmt),StmtText))
+    return(SUCCESS);
+
+  MSQLite3FreeStmt(MStmt);
+  memset(MStmt,0,sizeof(mstmt_sqlite3_t));
+
+  return(SUCCESS);
+  } /* END ForgetChangedStmt */ 
+
+
+
+
 /**
  * @see MDBDeleteJobsStmt()
  * @param MDBInfo (I)
@@ -1651,6 +1766,8 @@ int MSQLite3DeleteJobsStmt(
   {
   char *StmtTextPtr = MDBDeleteJobsStmtText;
 
+  ForgetChangedStmt(&MDBInfo->DeleteJobsStmt,StmtTextPtr);
+
   return(MSQLite3SetStmt(
     MDBInfo,
     MStmt,
@@ -1678,6 +1795,8 @@ int MSQLite3DeleteRsvsStmt(
   {
   char *StmtTextPtr = MDBDeleteRsvsStmtText;
 
+  ForgetChangedStmt(&MDBInfo->DeleteRsvsStmt,StmtTextPtr);
+
   return(MSQLite3SetStmt(
     MDBInfo,
     MStmt,
@@ -1705,6 +1824,8 @@ int MSQLite3DeleteTriggersStmt(
   {
   char *StmtTextPtr = MDBDeleteTriggersStmtText;
 
+  ForgetChangedStmt(&MDBInfo->DeleteTriggersStmt,StmtTextPtr);
+
   return(MSQLite3SetStmt(
     MDBInfo,
     MStmt,
@@ -1732,6 +1853,8 @@ int MSQLite3DeleteVCsStmt(
   {
   char *StmtTextPtr = MDBDeleteVCsStmtText;
 
+  ForgetChangedStmt(&MDBInfo->DeleteVCsStmt,StmtTextPtr);
+
   return(MSQLite3SetStmt(
     MDBInfo,
     MStmt,
@@ -1760,6 +1883,8 @@ int MSQLite3DeleteRequestsStmt(
   {
   char *StmtTextPtr = MDBDeleteRequestsStmtText;
 
+  ForgetChangedStmt(&MDBInfo->DeleteRequestsStmt,StmtTextPtr);
+
   return(MSQLite3SetStmt(
     MDBInfo,
     MStmt,
@@ -1787,6 +1912,8 @@ int MSQLite3DeleteNodesStmt(
   {
   char *StmtTextPtr = MDBDeleteNodesStmtText;
 
+  ForgetChangedStmt(&MDBInfo->DeleteNodesStmt,StmtTextPtr);
+
   return(MSQLite3SetStmt(
     MDBInfo,
     MStmt,
@@ -1798,6 +1925,105 @@ int MSQLite3DeleteNodesStmt(
 
 
 
+/**
+ * @see MDBDeleteJobByIDStmt()
+ * @param MDBInfo (I)
+ * @param MStmt   (O)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MSQLite3DeleteJobByIDStmt(
+
+  msqlite3_t *MDBInfo, /* I */
+  mstmt_t    *MStmt,   /* O */
+  char       *EMsg)    /* O */
+
+  {
+  const char *StmtTextPtr = MDBDeleteJobByIDStmtText;
+
+  return(MSQLite3SetStmt(
+    MDBInfo,
+    MStmt,
+    &MDBInfo->DeleteJobByIDStmt,
+    StmtTextPtr,
+    EMsg));
+  } /* END MSQLite3DeleteJobByIDStmt() */
+
+
+
+
+/**
+ * @see MDBDeleteRequestsByJobIDStmt()
+ * @param MDBInfo (I)
+ * @param MStmt   (O)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MSQLite3DeleteRequestsByJobIDStmt(
+
+  msqlite3_t *MDBInfo, /* I */
+  mstmt_t    *MStmt,   /* O */
+  char       *EMsg)    /* O */
+
+  {
+  const char *StmtTextPtr = MDBDeleteRequestsByJobIDStmtText;
+
+  return(MSQLite3SetStmt(
+    MDBInfo,
+    MStmt,
+    &MDBInfo->DeleteRequestsByJobIDStmt,
+    StmtTextPtr,
+    EMsg));
+  } /* END MSQLite3DeleteRequestsByJobIDStmt() */
+
+
+
+
+/**
+ * @see MDBDeleteNodeByIDStmt()
+ * @param MDBInfo (I)
+ * @param MStmt   (O)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MSQLite3DeleteNodeByIDStmt(
+
+  msqlite3_t *MDBInfo, /* I */
+  mstmt_t    *MStmt,   /* O */
+  char       *EMsg)    /* O */
+
+  {
+  const char *StmtTextPtr = MDBDeleteNodeByIDStmtText;
+
+  return(MSQLite3SetStmt(
+    MDBInfo,
+    MStmt,
+    &MDBInfo->DeleteNodeByIDStmt,
+    StmtTextPtr,
+    EMsg));
+  } /* END MSQLite3DeleteNodeByIDStmt() */
+
+
+
+
+/**
+ * @see MDBSetStableParamStmt()
+ * @param MStmt (I) [modified]
+ */
+
+int MSQLite3SetStableParamStmt(
+
+  mstmt_sqlite3_t *MStmt) /* I (modified) */
+
+  {
+  MStmt->StableParams = TRUE;
+
+  return(SUCCESS);
+  } /* END MSQLite3SetStableParamStmt() */
+
+
+
+
 
 /**
  * @see MDBDeleteCPStmt()
@@ -2019,6 +2245,138 @@ int MSQLite3EndTransaction(
 
 
 
+
+/**
+ * @see MDBRollbackTransaction()
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MSQLite3RollbackTransaction(
+
+  msqlite3_t *MDBInfo,
+  char *EMsg)
+
+  {
+  int rc;
+
+  PROP_FAIL(MSQLite3InitAllocatedStmt(MDBInfo,
+      &MDBInfo->RollbackTransactionStmt,
+      "ROLLBACK TRANSACTION",
+      EMsg));
+
+  rc = MSQLite3ExecStmt(&MDBInfo->RollbackTransactionStmt);
+
+  if (rc == FAILURE)
+    MSQLite3Error(MDBInfo,1,EMsg);
+
+  MSQLite3ResetStmt(&MDBInfo->RollbackTransactionStmt);
+
+  return (rc);
+  } /* END MSQLite3RollbackTransaction() */
+
+
+
+
+/**
+ * @see MDBSetSavepoint()
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MSQLite3SetSavepoint(
+
+  msqlite3_t *MDBInfo,
+  char *EMsg)
+
+  {
+  int rc;
+
+  PROP_FAIL(MSQLite3InitAllocatedStmt(MDBInfo,
+      &MDBInfo->SetSavepointStmt,
+      "SAVEPOINT MDBWriteBatch",
+      EMsg));
+
+  rc = MSQLite3ExecStmt(&MDBInfo->SetSavepointStmt);
+
+  if (rc == FAILURE)
+    MSQLite3Error(MDBInfo,1,EMsg);
+
+  MSQLite3ResetStmt(&MDBInfo->SetSavepointStmt);
+
+  return (rc);
+  } /* END MSQLite3SetSavepoint() */
+
+
+
+
+/**
+ * @see MDBReleaseSavepoint()
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MSQLite3ReleaseSavepoint(
+
+  msqlite3_t *MDBInfo,
+  char *EMsg)
+
+  {
+  int rc;
+
+  PROP_FAIL(MSQLite3InitAllocatedStmt(MDBInfo,
+      &MDBInfo->ReleaseSavepointStmt,
+      "RELEASE SAVEPOINT MDBWriteBatch",
+      EMsg));
+
+  rc = MSQLite3ExecStmt(&MDBInfo->ReleaseSavepointStmt);
+
+  if (rc == FAILURE)
+    MSQLite3Error(MDBInfo,1,EMsg);
+
+  MSQLite3ResetStmt(&MDBInfo->ReleaseSavepointStmt);
+
+  return (rc);
+  } /* END MSQLite3ReleaseSavepoint() */
+
+
+
+
+/**
+ * @see MDBRollbackToSavepoint()
+ *
+ * @param MDBInfo (I)
+ * @param EMsg    (O) optional,minsize=MMAX_LINE
+ */
+
+int MSQLite3RollbackToSavepoint(
+
+  msqlite3_t *MDBInfo,
+  char *EMsg)
+
+  {
+  int rc;
+
+  PROP_FAIL(MSQLite3InitAllocatedStmt(MDBInfo,
+      &MDBInfo->RollbackToSavepointStmt,
+      "ROLLBACK TO SAVEPOINT MDBWriteBatch",
+      EMsg));
+
+  rc = MSQLite3ExecStmt(&MDBInfo->RollbackToSavepointStmt);
+
+  if (rc == FAILURE)
+    MSQLite3Error(MDBInfo,1,EMsg);
+
+  MSQLite3ResetStmt(&MDBInfo->RollbackToSavepointStmt);
+
+  return (rc);
+  } /* END MSQLite3RollbackToSavepoint() */
+
+
+
 /**
  * @see MDBInTransaction()
  *
@@ -2852,6 +3210,56 @@ int MSQLite3DeleteNodesStmt(
 
 
 
+int MSQLite3DeleteJobByIDStmt(
+
+  msqlite3_t *MDBInfo,
+  mstmt_t    *MStmt,   /* O */
+  char       *EMsg)    /* O */
+
+  {
+  return(FAILURE);
+  }
+
+
+
+
+int MSQLite3DeleteRequestsByJobIDStmt(
+
+  msqlite3_t *MDBInfo,
+  mstmt_t    *MStmt,   /* O */
+  char       *EMsg)    /* O */
+
+  {
+  return(FAILURE);
+  }
+
+
+
+
+int MSQLite3DeleteNodeByIDStmt(
+
+  msqlite3_t *MDBInfo,
+  mstmt_t    *MStmt,   /* O */
+  char       *EMsg)    /* O */
+
+  {
+  return(FAILURE);
+  }
+
+
+
+
+int MSQLite3SetStableParamStmt(
+
+  mstmt_sqlite3_t *MStmt)
+
+  {
+  return(FAILURE);
+  }
+
+
+
+
 int MSQLite3SelectNodeStatsRangeStmt(
 
   msqlite3_t *MDBInfo,
@@ -3006,6 +3414,54 @@ int MSQLite3EndTransaction(
 
 
 
+int MSQLite3RollbackTransaction(
+
+  msqlite3_t *MDBInfo,
+    char *EMsg)
+
+  {
+  return(FAILURE);
+  } /* END MSQLite3RollbackTransaction() */
+
+
+
+
+int MSQLite3SetSavepoint(
+
+  msqlite3_t *MDBInfo,
+    char *EMsg)
+
+  {
+  return(FAILURE);
+  } /* END MSQLite3SetSavepoint() */
+
+
+
+
+int MSQLite3ReleaseSavepoint(
+
+  msqlite3_t *MDBInfo,
+    char *EMsg)
+
+  {
+  return(FAILURE);
+  } /* END MSQLite3ReleaseSavepoint() */
+
+
+
+
+int MSQLite3RollbackToSavepoint(
+
+  msqlite3_t *MDBInfo,
+    char *EMsg)
+
+  {
+  return(FAILURE);
+  } /* END MSQLite3RollbackToSavepoint() */
+
+
+
+
 void stub(){if(0){BindParamsForExecution(NULL);
 BaseResetStmt(NULL);MSQLite3Step(NULL);}}
 #endif
@@ -372,6 +372,8 @@ int MSchedSetDefaults(
 
   MSched.TPSize = MDEF_TP_HANDLER_THREADS;
 
+  MSched.NodeSelectThreads = MDEF_NODESELECTTHREADS;
+
   MSched.GuaranteedPreemption = TRUE;
   MSched.CheckSuspendedJobPriority = TRUE;
 
@@ -1295,6 +1295,14 @@ int MSchedOConfigShow(
       MBool[S->BGPreemption]);
     }
 
+  if ((S->DBWALMode != FALSE) ||
+      (VFlag || (PIndex == -1) || (PIndex == mcoDBWALMode)))
+    {
+    MStringAppendF(String,"%-30s  %s\n",
+      MParam[mcoDBWALMode],
+      MBool[S->DBWALMode]);
+    }
+
   if ((S->GuaranteedPreemption != FALSE) ||
       (VFlag || (PIndex == -1) || (PIndex == mcoGuaranteedPreemption)))
     {
@@ -1673,6 +1681,12 @@ int MSchedOConfigShow(
       S->DefaultN.MaxLoad);
     }
 
+  if (S->NodeSelectThreads > 1)
+    {
+    MStringAppendF(String,"%s \n",
+      MUShowInt(MParam[mcoNodeSelectThreads],S->NodeSelectThreads));
+    }
+
   if (S->TPSize > 0)
     {
     MStringAppendF(String,"%s \n",
@@ -713,6 +713,10 @@ int MSchedProcessJobs(
 
   MStat.IJobsStarted = 0;
 
+  /* discard last iteration's scratch memory */
+
+  MUArenaReset(&MSchedArena);
+
   GP = &MPar[0];
 
   if ((MSched.Iteration == 0) || (MSched.Reload == TRUE))
@@ -512,6 +512,14 @@ int MSchedProcessOConfig(
 
       break;
 
+    case mcoDBWALMode:
+
+      /* NOTE:  only applied when the database is (re)connected */
+
+      MSched.DBWALMode = MUBoolFromString(SVal,FALSE);
+
+      break;
+
     case mcoUseDatabase:
 
       {
@@ -2178,6 +2186,8 @@ int MSchedProcessOConfig(
 
       bmfromstring(SVal,MLogFacilityType,&mlog.FacilityBM,":,");
 
+      MLogUpdateFacilityMask();
+
       if (bmisset(&mlog.FacilityBM,fALL))
         {
         MStringSet(&Line,MLogFacilityType[fALL]);
@@ -4291,6 +4301,18 @@ int MSchedProcessOConfig(
 
       break;
 
+    case mcoNodeSelectThreads:
+
+#ifdef __NOMCOMMTHREAD
+      /* no parallel node selection if there are no threads */
+
+      S->NodeSelectThreads = 1;
+#else /* __NOMCOMMTHREAD */
+      S->NodeSelectThreads = MAX(1,MIN(IVal,MMAX_NODESELECTTHREADS));
+#endif /* __NOMCOMMTHREAD */
+
+      break;
+
     case mcoUMask:
 
       S->UMask = (int)strtol(SVal,NULL,0);  /* NOTE:  allow octal/decimal spec */
@@ -314,22 +314,14 @@ int MStatReadProfile(
     while ((ptr != NULL))
       {
       mstat_union *StatUnion;
-      if (StatIndex >= OutRange->Stats.ArraySize)
-        {
-        int NewByteSize;
-        int OldByteSize;
-
-        OldByteSize = MUArrayListByteSize(&OutRange->Stats);
-        rc = MUArrayListResize(&OutRange->Stats,OutRange->Stats.ArraySize * 2);
+      /* grows geometrically and zeroes the new elements */
 
-        if (rc == FAILURE)
-          {
-          snprintf(ErrBuf,ErrBufSize,"Out of memory");
-          return(FAILURE);
-          }
+      rc = MUArrayListReserve(&OutRange->Stats,StatIndex + 1);
 
-        NewByteSize = MUArrayListByteSize(&OutRange->Stats);
-        memset(OutRange->Stats.Array + OldByteSize,0,NewByteSize - OldByteSize);
+      if (rc == FAILURE)
+        {
+        snprintf(ErrBuf,ErrBufSize,"Out of memory");
+        return(FAILURE);
         }
 
       StatUnion = (mstat_union *)MUArrayListGet(&OutRange->Stats,StatIndex);
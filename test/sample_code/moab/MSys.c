@@ -2398,6 +2398,8 @@ int MSysLogInitialize(
 
   bmset(&mlog.FacilityBM,MDEF_LOGFACILITY);
 
+  MLogUpdateFacilityMask();
+
   LogPath[0] = '\0';
 
   /* handle command line based logging specification */
@@ -5989,28 +5991,6 @@ int MSysStartUpdateHALockThread()
 
 
 
-/**
- * Insert a job into the submit job queue, retreive back a unique ID.
- *
- * @param JE
- */
-
-int MSysAddJobSubmitToJournal(
-
-  mjob_submit_t *JE)
-
-  {
-  mstring_t JString(MMAX_LINE);
-
-  MXMLToMString(JE->JE,&JString,NULL,TRUE);
-
-  MCPSubmitJournalAddEntry(&JString,JE);
-
-  return(SUCCESS);
-  }  /* END MSysAddJobSubmitToJournal() */
-
-
-
 
 char *MSysShowBuildInfo(void)
 
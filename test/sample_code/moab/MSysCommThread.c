@@ -605,7 +605,23 @@ int MSysEnqueueSocket(
     MSched.HistMaxClientCount = MSUClientCount;
     }
 
-  MSysAddSocketToQueue(S);  /* handles locking for thread safety */
+  if (MSysAddSocketToQueue(S) == FAILURE)  /* handles locking for thread safety */
+    {
+    MUISAddData(S,"ERROR:    Moab transaction queue is full - try again later\n");
+
+    S->StatusCode = msfConnRejected;
+
+    MSUSendData(S,MSched.SocketWaitTime,TRUE,TRUE,NULL,NULL);
+
+    MSUFree(S);
+
+    MUFree((char **)&S);
+
+    if (EMsg != NULL)
+      strcpy(EMsg,"transaction queue full");
+
+    return(FAILURE);
+    }
 
   return(SUCCESS);
   }  /* END MSysEnqueueSocket() */
@@ -701,7 +717,6 @@ int MSysStartCommThread()
   pthread_atfork(NULL,NULL,MSysPostFork);
 
   /* Intialize the various mutexes in the system */
-  MSysSocketQueueMutexInit();
   MSysJobSubmitQueueMutexInit();
   MObjectQueueMutexInit();
   MWSQueueMutexInit();
@@ -12,6 +12,10 @@
 #include "moab-const.h"  
 #include "moab-global.h"  
 
+#ifndef MDISABLESQLITE
+#include "sqlite3.h"
+#endif /* !MDISABLESQLITE */
+
 
 
 
@@ -692,159 +696,4436 @@ int __MSysTestSpawn()
   }  /* END __MSysTestSpawn() */
 
 
+#define MTESTHTKEYS 2000
+
 /**
- * Perform internal unit testing.
+ * Return the mhash_t test key for index KIndex (every third key is too
+ * long to be stored inline).
  */
 
-int MSysDoTest()
- 
+static void __MSysTestHTKey(
+
+  int   KIndex,
+  char *Buf,
+  int   BufSize)
+
   {
-  char *tptr;
-  char *aptr;
-  char *ptr;
+  if (KIndex % 3 == 0)
+    snprintf(Buf,BufSize,"moab.%d.a.name.too.long.to.fit.inline",KIndex);
+  else
+    snprintf(Buf,BufSize,"moab.%d",KIndex);
 
-  int   aindex;
-  int   rc;
+  return;
+  }  /* END __MSysTestHTKey() */
 
-  char  tmpLine[MMAX_LINE];
 
-  const char *TName[] = {
-    NONE,
-    "COMPRESS",
-    "SCHED",
-    "XML",
-    "RANGEAND",
-    "RANGECOLLAPSE",
-    "RANGEMERGE",
-    "GETSNRANGE",
-    "NODEPRIO",
-    "SPAWN",
-    "WIKINODE",
-    "WIKIJOB",
-    "WIKICLUSTER",
-    "RMX",
-    "JOBNAME",
-    "JOBDIST",
-    "CHECKSUM",
-    "LLSUBMIT",
-    "LLQUERY",
-    "MAIL",
-    "PBSPARSE",
-    "PBSPARSE2",
-    "NODERANGE",
-    "BGRANGE",
-    "ODBCTEST",
-    "SQLITE3TEST",
-    "STRINGTEST",
-    "RMXTEST",
-    "STATCONVTEST",
-    "GEOTEST",
-    "DISATEST",
-    "MACADDRESS",
-    NULL };
+/**
+ * Verify that Get and Iterate on HT agree with Present[] and return the
+ * number of mismatches.
+ */
 
-  enum {
-    mirtNONE = 0,
-    mirtCompress,
-    mirtSched,
-    mirtXML,
-    mirtRLAND,
-    mirtJobSelectFRL,
-    mirtRLMerge,
-    mirtJobGetSNRange,
-    mirtNodePrio,
-    mirtSpawn,
-    mirtWikiNode,
-    mirtWikiJob,
-    mirtWikiCluster,
-    mirtRMExtension,
-    mirtJobName,
-    mirtJobDist,
-    mirtChecksum,
-    mirtLLSubmit,
-    mirtLLQuery,
-    mirtMail,
-    mirtPBSParse,
-    mirtPBSParse2,
-    mirtNodeRange,
-    mirtBGRange,
-    mirtODBCTest,
-    mirtSQLite3Test,
-    mirtStringTest,
-    mirtRMX,
-    mirtStatConvTest,
-    mirtGeoTest,
-    mirtDisaTest,
-    mirtMacAddress,
-    mirtLAST };
- 
-  if ((tptr = getenv(MSCHED_ENVTESTVAR)) == NULL)
+static int __MSysTestHTCheck(
+
+  mhash_t *HT,
+  mbool_t *Present,
+  int     *Value)
+
+  {
+  mhashiter_t Iter;
+
+  mbitmap_t BM;
+
+  char  tmpName[MMAX_NAME];
+  char *Name;
+  void *Object;
+
+  char  Seen[MTESTHTKEYS];
+
+  int   Failures = 0;
+  int   Count = 0;
+  int   Visited = 0;
+  int   kindex;
+
+  memset(Seen,0,sizeof(Seen));
+
+  for (kindex = 0;kindex < MTESTHTKEYS;kindex++)
     {
-    return(SUCCESS);
+    __MSysTestHTKey(kindex,tmpName,sizeof(tmpName));
+
+    if (Present[kindex] == TRUE)
+      {
+      Count++;
+
+      if ((MUHTGet(HT,tmpName,&Object,&BM) == FAILURE) ||
+          (Object != (void *)&Value[kindex]) ||
+          (bmisset(&BM,kindex % 8) == FALSE))
+        {
+        fprintf(stderr,"ERROR:    key '%s' not found or has the wrong payload\n",
+          tmpName);
+
+        Failures++;
+        }
+      }
+    else if (MUHTGet(HT,tmpName,NULL,NULL) == SUCCESS)
+      {
+      fprintf(stderr,"ERROR:    removed key '%s' still found\n",
+        tmpName);
+
+      Failures++;
+      }
+    }    /* END for (kindex) */
+
+  MUHTIterInit(&Iter);
+
+  while (MUHTIterate(HT,&Name,&Object,NULL,&Iter) == SUCCESS)
+    {
+    kindex = (int)strtol(Name + strlen("moab."),NULL,10);
+
+    Visited++;
+
+    if ((kindex < 0) || (kindex >= MTESTHTKEYS) || 
+        (Present[kindex] == FALSE) || (Seen[kindex] != 0) ||
+        (Object != (void *)&Value[kindex]))
+      {
+      fprintf(stderr,"ERROR:    iteration returned unexpected key '%s'\n",
+        Name);
+
+      Failures++;
+
+      continue;
+      }
+
+    Seen[kindex] = 1;
     }
 
-  MUStrCpy(tmpLine,tptr,sizeof(tmpLine));
+  if ((Visited != Count) || (HT->NumItems != Count))
+    {
+    fprintf(stderr,"ERROR:    %d keys present, iteration visited %d, NumItems is %d\n",
+      Count,
+      Visited,
+      HT->NumItems);
 
-  aindex = MUGetIndexCI(tmpLine,TName,TRUE,0);
+    Failures++;
+    }
 
-  aptr = NULL;
+  return(Failures);
+  }  /* END __MSysTestHTCheck() */
 
-  if ((ptr = strchr(tmpLine,':')) != NULL)
+
+/**
+ * Functional test of mhash_t: add, get, remove and iterate (checked after
+ * every operation) while incremental rehashes are in progress, including
+ * removal of items that have not yet been migrated out of OldTable.
+ */
+
+int __MSysTestHT()
+
+  {
+  mhash_t HT;
+
+  mbitmap_t BM;
+
+  mbool_t Present[MTESTHTKEYS];
+  int     Value[MTESTHTKEYS];
+
+  char    tmpName[MMAX_NAME];
+
+  mbool_t InRehash = FALSE;
+
+  int     Failures = 0;
+  int     Rehashes = 0;
+  int     OldRemoves = 0;
+  int     kindex;
+  int     sindex;
+
+  memset(&HT,0,sizeof(HT));
+  memset(Present,0,sizeof(Present));
+
+  for (kindex = 0;kindex < MTESTHTKEYS;kindex++)
     {
-    aptr = ptr + 1;
+    Value[kindex] = kindex;
+
+    __MSysTestHTKey(kindex,tmpName,sizeof(tmpName));
+
+    bmclear(&BM);
+    bmset(&BM,kindex % 8);
+
+    if (MUHTAdd(&HT,tmpName,(void *)&Value[kindex],&BM,NULL) == FAILURE)
+      {
+      fprintf(stderr,"ERROR:    cannot add key '%s'\n",
+        tmpName);
+
+      Failures++;
+      }
+
+    Present[kindex] = TRUE;
+
+    if (HT.OldTable == NULL)
+      {
+      InRehash = FALSE;
+
+      continue;
+      }
+
+    if (InRehash == FALSE)
+      Rehashes++;
+
+    InRehash = TRUE;
+
+    /* remove one item still waiting in OldTable and one already migrated */
+
+    for (sindex = (int)MHASHSIZE(HT.OldHashSize) - 1;sindex >= 0;sindex--)
+      {
+      if (HT.OldTable[sindex].Used == TRUE)
+        break;
+      }
+
+    if (sindex >= 0)
+      {
+      MUStrCpy(tmpName,
+        (HT.OldTable[sindex].LongName != NULL) ? HT.OldTable[sindex].LongName : HT.OldTable[sindex].ShortName,
+        sizeof(tmpName));
+
+      Present[(int)strtol(tmpName + strlen("moab."),NULL,10)] = FALSE;
+
+      if (MUHTRemove(&HT,tmpName,NULL) == FAILURE)
+        {
+        fprintf(stderr,"ERROR:    cannot remove OldTable key '%s'\n",
+          tmpName);
+
+        Failures++;
+        }
+
+      OldRemoves++;
+      }
+
+    if ((kindex % 2 == 0) && (Present[kindex / 2] == TRUE))
+      {
+      __MSysTestHTKey(kindex / 2,tmpName,sizeof(tmpName));
+
+      Present[kindex / 2] = FALSE;
+
+      if (MUHTRemove(&HT,tmpName,NULL) == FAILURE)
+        {
+        fprintf(stderr,"ERROR:    cannot remove key '%s'\n",
+          tmpName);
+
+        Failures++;
+        }
+      }
+
+    Failures += __MSysTestHTCheck(&HT,Present,Value);
+    }  /* END for (kindex) */
+
+  Failures += __MSysTestHTCheck(&HT,Present,Value);
+
+  /* remove everything that is left */
+
+  for (kindex = 0;kindex < MTESTHTKEYS;kindex++)
+    {
+    if (Present[kindex] == FALSE)
+      continue;
+
+    __MSysTestHTKey(kindex,tmpName,sizeof(tmpName));
+
+    Present[kindex] = FALSE;
+
+    if (MUHTRemove(&HT,tmpName,NULL) == FAILURE)
+      Failures++;
+
+    if (kindex % 97 == 0)
+      Failures += __MSysTestHTCheck(&HT,Present,Value);
     }
 
-  fprintf(stderr,"INFO:     running test %s, data='%s'\n",
-    TName[aindex],
-    (aptr != NULL) ? aptr : "");
+  Failures += __MSysTestHTCheck(&HT,Present,Value);
 
-  switch (aindex)
+  if ((Rehashes == 0) || (OldRemoves == 0))
     {
-    case mirtCompress:
+    fprintf(stderr,"ERROR:    no incremental rehash was exercised\n");
 
-      MUCompressTest();
+    Failures++;
+    }
 
-      break;
+  MUHTFree(&HT,FALSE,NULL);
 
-    case mirtXML:
+  fprintf(stdout,"mhash_t test %s (%d rehashes, %d OldTable removes, %d failures)\n",
+    (Failures == 0) ? "passed" : "FAILED",
+    Rehashes,
+    OldRemoves,
+    Failures);
 
-      __MSysTestXML(aptr);
+  exit((Failures == 0) ? 0 : 1);
 
-      break;
+  /*NOTREACHED*/
 
-    case mirtRLAND:
+  return(SUCCESS);
+  }  /* END __MSysTestHT() */
 
-      __MSysTestRLAND(); 
 
-      break;
+/* chained hash table of mln_t buckets, grown 2x whenever a chain reaches 
+   4 items--the layout mhash_t used before it was open addressed (used as a
+   reference by __MSysTestHTBench() only) */
 
-    case mirtGeoTest:
+typedef struct mtestchainht_t {
+  int     HashSize;
+  int     LongestChain;
+  mln_t **Table;
+  } mtestchainht_t;
 
-      __MSysTestGeo(aptr);
 
-      break;
+int __MSysTestChainHTAdd(
 
-    case mirtJobSelectFRL:
+  mtestchainht_t *HT,
+  const char     *Name,
+  void           *Object)
 
-      __MSysTestJobSelectFRL();
+  {
+  int Bucket;
 
-      break;
+  if (HT->Table == NULL)
+    {
+    HT->HashSize = 2;
+    HT->Table = (mln_t **)MUCalloc(1,MHASHSIZE(HT->HashSize) * sizeof(mln_t *));
+    }
 
-    case mirtRLMerge:
- 
-      __MSysTestRLMerge(); 
+  if (HT->LongestChain >= 4)
+    {
+    mtestchainht_t NewHT;
+    mln_t *tmpL;
+    unsigned int bindex;
 
-      break;
+    NewHT.HashSize = HT->HashSize + 1;
+    NewHT.LongestChain = 0;
+    NewHT.Table = (mln_t **)MUCalloc(1,MHASHSIZE(NewHT.HashSize) * sizeof(mln_t *));
 
-    case mirtJobGetSNRange:
+    for (bindex = 0;bindex < MHASHSIZE(HT->HashSize);bindex++)
+      {
+      for (tmpL = HT->Table[bindex];tmpL != NULL;tmpL = tmpL->Next)
+        __MSysTestChainHTAdd(&NewHT,tmpL->Name,tmpL->Ptr);
 
-      __MSysTestJobGetSNRange();
+      MULLFree(&HT->Table[bindex],NULL);
+      }
 
-      break;
+    MUFree((char **)&HT->Table);
 
-    case mirtMacAddress:
+    memcpy(HT,&NewHT,sizeof(NewHT));
+    }
 
-      __MSysTestMacAddress();
+  Bucket = MUGenHash(Name) & MHASHMASK(HT->HashSize);
+
+  MULLAdd(&HT->Table[Bucket],Name,Object,NULL,NULL);
+
+  HT->LongestChain = MAX(HT->LongestChain,HT->Table[Bucket]->ListSize);
+
+  return(SUCCESS);
+  }  /* END __MSysTestChainHTAdd() */
+
+
+int __MSysTestChainHTGet(
+
+  mtestchainht_t *HT,
+  const char     *Name,
+  void          **Object)
+
+  {
+  mln_t *tmpL;
+
+  if (MULLCheckCS(HT->Table[MUGenHash(Name) & MHASHMASK(HT->HashSize)],Name,&tmpL) == FAILURE)
+    {
+    return(FAILURE);
+    }
+
+  *Object = tmpL->Ptr;
+
+  return(SUCCESS);
+  }  /* END __MSysTestChainHTGet() */
+
+
+/**
+ * Time add/get/remove on mhash_t and on the chained reference table at
+ * 10k, 100k and 1M keys.
+ *
+ * @param MaxCount (I) [optional, largest key count, default 1M]
+ */
+
+int __MSysTestHTBench(
+
+  char *MaxCount)
+
+  {
+  mhash_t        HT;
+  mtestchainht_t CHT;
+
+  int   Count;
+  int   MCount;
+  int   kindex;
+  int   rindex;
+
+  void *Object;
+
+  char  tmpName[MMAX_NAME];
+
+  struct timeval Start;
+  struct timeval End;
+
+  double AddUS;
+  double GetUS;
+  double RemoveUS;
+
+  const int LookupRounds = 4;
+
+#define MTESTELAPSEDUS(S,E) (((E).tv_sec - (S).tv_sec) * 1000000.0 + ((E).tv_usec - (S).tv_usec))
+
+  MCount = ((MaxCount != NULL) && (MaxCount[0] != '\0')) ? (int)strtol(MaxCount,NULL,10) : 1000000;
+
+  fprintf(stdout,"%10s %-8s %10s %10s %10s  (ns per op)\n",
+    "keys",
+    "table",
+    "add",
+    "get",
+    "remove");
+
+  for (Count = 10000;Count <= MCount;Count *= 10)
+    {
+    /* open addressed mhash_t */
+
+    memset(&HT,0,sizeof(HT));
+
+    gettimeofday(&Start,NULL);
+
+    for (kindex = 0;kindex < Count;kindex++)
+      {
+      snprintf(tmpName,sizeof(tmpName),"moab.%d",kindex);
+
+      MUHTAdd(&HT,tmpName,(void *)&HT,NULL,NULL);
+      }
+
+    gettimeofday(&End,NULL);
+
+    AddUS = MTESTELAPSEDUS(Start,End);
+
+    gettimeofday(&Start,NULL);
+
+    for (rindex = 0;rindex < LookupRounds;rindex++)
+      {
+      for (kindex = 0;kindex < Count;kindex++)
+        {
+        snprintf(tmpName,sizeof(tmpName),"moab.%d",kindex);
+
+        MUHTGet(&HT,tmpName,&Object,NULL);
+        }
+      }
+
+    gettimeofday(&End,NULL);
+
+    GetUS = MTESTELAPSEDUS(Start,End) / LookupRounds;
+
+    gettimeofday(&Start,NULL);
+
+    for (kindex = 0;kindex < Count;kindex++)
+      {
+      snprintf(tmpName,sizeof(tmpName),"moab.%d",kindex);
+
+      MUHTRemove(&HT,tmpName,NULL);
+      }
+
+    gettimeofday(&End,NULL);
+
+    RemoveUS = MTESTELAPSEDUS(Start,End);
+
+    MUHTFree(&HT,FALSE,NULL);
+
+    fprintf(stdout,"%10d %-8s %10.1f %10.1f %10.1f\n",
+      Count,
+      "mhash_t",
+      AddUS * 1000.0 / Count,
+      GetUS * 1000.0 / Count,
+      RemoveUS * 1000.0 / Count);
+
+    /* chained reference */
+
+    memset(&CHT,0,sizeof(CHT));
+
+    gettimeofday(&Start,NULL);
+
+    for (kindex = 0;kindex < Count;kindex++)
+      {
+      snprintf(tmpName,sizeof(tmpName),"moab.%d",kindex);
+
+      __MSysTestChainHTAdd(&CHT,tmpName,(void *)&CHT);
+      }
+
+    gettimeofday(&End,NULL);
+
+    AddUS = MTESTELAPSEDUS(Start,End);
+
+    gettimeofday(&Start,NULL);
+
+    for (rindex = 0;rindex < LookupRounds;rindex++)
+      {
+      for (kindex = 0;kindex < Count;kindex++)
+        {
+        snprintf(tmpName,sizeof(tmpName),"moab.%d",kindex);
+
+        __MSysTestChainHTGet(&CHT,tmpName,&Object);
+        }
+      }
+
+    gettimeofday(&End,NULL);
+
+    GetUS = MTESTELAPSEDUS(Start,End) / LookupRounds;
+
+    gettimeofday(&Start,NULL);
+
+    for (kindex = 0;kindex < Count;kindex++)
+      {
+      snprintf(tmpName,sizeof(tmpName),"moab.%d",kindex);
+
+      MULLRemove(&CHT.Table[MUGenHash(tmpName) & MHASHMASK(CHT.HashSize)],tmpName,NULL);
+      }
+
+    gettimeofday(&End,NULL);
+
+    RemoveUS = MTESTELAPSEDUS(Start,End);
+
+    for (kindex = 0;kindex < (int)MHASHSIZE(CHT.HashSize);kindex++)
+      MULLFree(&CHT.Table[kindex],NULL);
+
+    MUFree((char **)&CHT.Table);
+
+    fprintf(stdout,"%10d %-8s %10.1f %10.1f %10.1f\n",
+      Count,
+      "chained",
+      AddUS * 1000.0 / Count,
+      GetUS * 1000.0 / Count,
+      RemoveUS * 1000.0 / Count);
+    }  /* END for (Count) */
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestHTBench() */
+
+
+
+
+#ifdef MTHREADSAFE
+
+void *__MSysTestLogBenchThread(
+
+  void *Count)
+
+  {
+  int mindex;
+
+  for (mindex = 0;mindex < *(int *)Count;mindex++)
+    {
+    MLog("INFO:     log benchmark message %d of %d (job %s, node %s)\n",
+      mindex,
+      *(int *)Count,
+      "Moab.12345",
+      "node001");
+    }
+
+  return(NULL);
+  }  /* END __MSysTestLogBenchThread() */
+
+#endif /* MTHREADSAFE */
+
+
+/**
+ * Report MLog() throughput (messages/second) with 1, 4 and 16 logging
+ * threads, synchronous vs asynchronous (MLogAsyncStart()).
+ *
+ * @param Count (I) [optional, messages per thread, default 100000]
+ */
+
+int __MSysTestLogBench(
+
+  char *Count)
+
+  {
+#ifdef MTHREADSAFE
+  pthread_t Thread[16];
+
+  const int ThreadCount[] = { 1, 4, 16, 0 };
+
+  int  MCount;
+  int  mode;
+  int  cindex;
+  int  tindex;
+
+  char LogPath[MMAX_PATH_LEN];
+
+  struct timeval Start;
+  struct timeval End;
+
+  double Elapsed;
+
+  MCount = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 100000;
+
+  snprintf(LogPath,sizeof(LogPath),"/tmp/moab.logbench.%d",
+    (int)getpid());
+
+  MLogInitialize(LogPath,-1,0);
+
+  fprintf(stdout,"%-6s %8s %14s\n",
+    "mode",
+    "threads",
+    "messages/sec");
+
+  for (mode = 0;mode < 2;mode++)
+    {
+    if (mode == 1)
+      MLogAsyncStart();
+
+    for (cindex = 0;ThreadCount[cindex] > 0;cindex++)
+      {
+      gettimeofday(&Start,NULL);
+
+      for (tindex = 0;tindex < ThreadCount[cindex];tindex++)
+        pthread_create(&Thread[tindex],NULL,__MSysTestLogBenchThread,(void *)&MCount);
+
+      for (tindex = 0;tindex < ThreadCount[cindex];tindex++)
+        pthread_join(Thread[tindex],NULL);
+
+      /* lines are not done until they are in the file */
+
+      MLogFlush();
+
+      fflush(mlog.logfp);
+
+      gettimeofday(&End,NULL);
+
+      Elapsed = (End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0;
+
+      fprintf(stdout,"%-6s %8d %14.0f\n",
+        (mode == 0) ? "sync" : "async",
+        ThreadCount[cindex],
+        (double)MCount * ThreadCount[cindex] / MAX(Elapsed,0.000001));
+      }  /* END for (cindex) */
+    }    /* END for (mode) */
+
+  MLogShutdown();
+
+  MFURemove(LogPath);
+
+  exit(0);
+#endif /* MTHREADSAFE */
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestLogBench() */
+
+
+
+
+/**
+ * Varargs wrapper so __MSysTestLogTimeBench() can drive MLogNew().
+ */
+
+int __MSysTestLogTimeNew(
+
+  const char *Format,
+  ...)
+
+  {
+  va_list Args;
+
+  va_start(Args,Format);
+
+  MLogNew(lINFO,mxoJob,(char *)"Moab.12345",__FILE__,__LINE__,(char *)Format,Args);
+
+  va_end(Args);
+
+  return(SUCCESS);
+  }  /* END __MSysTestLogTimeNew() */
+
+
+
+
+/**
+ * Report per-call cost (ns) of the log header timestamp - formatting the
+ * time for every line vs the per-second cache in MLogGetTime() and 
+ * MLogGetTimeNewFormat() - and per-line cost of MLog()/jlog-style 
+ * MLogNew() with a file-backed log.
+ *
+ * @param Count (I) [optional, calls per measurement, default 1000000]
+ */
+
+int __MSysTestLogTimeBench(
+
+  char *Count)
+
+  {
+  int    MCount;
+  int    mindex;
+  int    tindex;
+
+  char   LogPath[MMAX_PATH_LEN];
+  char   Line[MMAX_NAME];
+
+  time_t Now;
+
+  struct tm  tmpTM;
+  struct tm *present_time;
+
+  struct timeval Start;
+  struct timeval End;
+
+  double Elapsed;
+
+  volatile int Sink = 0;
+
+  const char *TestName[] = {
+    "uncached format",
+    "MLogGetTime",
+    "MLogGetTimeNewFormat",
+    "MLog line",
+    "MLogNew line",
+    NULL };
+
+  MCount = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 1000000;
+
+  snprintf(LogPath,sizeof(LogPath),"/tmp/moab.logtime.%d",
+    (int)getpid());
+
+  MLogInitialize(LogPath,-1,0);
+
+  fprintf(stdout,"%-22s %10s\n",
+    "test",
+    "ns/call");
+
+  for (tindex = 0;TestName[tindex] != NULL;tindex++)
+    {
+    gettimeofday(&Start,NULL);
+
+    for (mindex = 0;mindex < MCount;mindex++)
+      {
+      switch (tindex)
+        {
+        case 0:
+
+          /* what every log line paid before the cache */
+
+          Now = 0;
+
+          MUGetTime((mulong *)&Now,mtmNONE,NULL);
+
+          present_time = localtime_r(&Now,&tmpTM);
+
+          snprintf(Line,sizeof(Line),"%4.4d-%2.2d-%2.2d %2.2d:%2.2d:%2.2d ",
+            present_time->tm_year + 1900,
+            present_time->tm_mon + 1,
+            present_time->tm_mday,
+            present_time->tm_hour,
+            present_time->tm_min,
+            present_time->tm_sec);
+
+          Sink += Line[0];
+
+          break;
+
+        case 1:
+
+          Sink += MLogGetTime()[0];
+
+          break;
+
+        case 2:
+
+          Sink += MLogGetTimeNewFormat()[0];
+
+          break;
+
+        case 3:
+
+          MLog("INFO:     log timestamp benchmark message %d\n",
+            mindex);
+
+          break;
+
+        default:
+
+          __MSysTestLogTimeNew("INFO:     log timestamp benchmark message %d\n",
+            mindex);
+
+          break;
+        }  /* END switch (tindex) */
+      }    /* END for (mindex) */
+
+    fflush(mlog.logfp);
+
+    gettimeofday(&End,NULL);
+
+    Elapsed = (End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0;
+
+    fprintf(stdout,"%-22s %10.1f\n",
+      TestName[tindex],
+      Elapsed * 1000000000.0 / MAX(MCount,1));
+    }  /* END for (tindex) */
+
+  MLogShutdown();
+
+  MFURemove(LogPath);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestLogTimeBench() */
+
+
+
+
+/* MDB() as it was before MLOGMAXLEVEL/mlog.FacilityMask (MDBBENCH reference) */
+
+#define __MDBBENCHOLD(X,F) if ((mlog.Threshold >= (X)) && (bmisset(&mlog.FacilityBM,fALL) || bmisset(&mlog.FacilityBM,F)))
+
+/**
+ * Report the cost of a simulated scheduling iteration over Count jobs with
+ * LOGLEVEL 3 - each job passes the guard mix of a priority/idle-task/
+ * backfill pass (eight level 4-7 guards, optionally plus one level 3 
+ * message that is written) - using the bitmap-based guard vs MDB().  Build with -DMLOGMAXLEVEL=3 to see the
+ * compiled-out case.
+ *
+ * @param Count (I) [optional, jobs per iteration, default 50000]
+ */
+
+int __MSysTestMDBBench(
+
+  char *Count)
+
+  {
+  int    JCount;
+  int    jindex;
+  int    mode;
+  int    rindex;
+
+  char   LogPath[MMAX_PATH_LEN];
+
+  struct timeval Start;
+  struct timeval End;
+
+  double Elapsed;
+
+  volatile long Sink = 0;
+
+  JCount = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 50000;
+
+  snprintf(LogPath,sizeof(LogPath),"/tmp/moab.mdbbench.%d",
+    (int)getpid());
+
+  MLogInitialize(LogPath,-1,0);
+
+  mlog.Threshold = 3;
+
+  bmset(&mlog.FacilityBM,fALL);
+
+  MLogUpdateFacilityMask();
+
+  fprintf(stdout,"MLOGMAXLEVEL=%d  jobs=%d  loglevel=%d\n",
+    MLOGMAXLEVEL,
+    JCount,
+    mlog.Threshold);
+
+  fprintf(stdout,"%-10s %-12s %14s %14s\n",
+    "guard",
+    "level 3 line",
+    "ms/iteration",
+    "ns/job");
+
+  /* mode bit 0 - MDB() vs bitmap guard, mode bit 1 - also write the level 3 line */
+
+  for (mode = 0;mode < 4;mode++)
+    {
+    gettimeofday(&Start,NULL);
+
+    /* report the mean of 10 iterations */
+
+    for (rindex = 0;rindex < 10;rindex++)
+      {
+      for (jindex = 0;jindex < JCount;jindex++)
+        {
+        if ((mode & 1) == 0)
+          {
+          __MDBBENCHOLD(7,fSCHED) MLog("INFO:     job %d priority component %d\n",jindex,1);
+          __MDBBENCHOLD(7,fSCHED) MLog("INFO:     job %d priority component %d\n",jindex,2);
+          __MDBBENCHOLD(6,fSCHED) MLog("INFO:     job %d priority component %d\n",jindex,3);
+          __MDBBENCHOLD(6,fSTRUCT) MLog("INFO:     job %d node %d rejected\n",jindex,4);
+          __MDBBENCHOLD(5,fSCHED) MLog("INFO:     job %d idle tasks %d\n",jindex,5);
+          __MDBBENCHOLD(5,fSTRUCT) MLog("INFO:     job %d node %d rejected\n",jindex,6);
+          __MDBBENCHOLD(4,fSCHED) MLog("INFO:     job %d range %d\n",jindex,7);
+          __MDBBENCHOLD(4,fSCHED) MLog("INFO:     job %d range %d\n",jindex,8);
+
+          if (mode & 2)
+            {
+            __MDBBENCHOLD(3,fSCHED) MLog("INFO:     job %d considered for backfill\n",jindex);
+            }
+          }
+        else
+          {
+          MDB(7,fSCHED) MLog("INFO:     job %d priority component %d\n",jindex,1);
+          MDB(7,fSCHED) MLog("INFO:     job %d priority component %d\n",jindex,2);
+          MDB(6,fSCHED) MLog("INFO:     job %d priority component %d\n",jindex,3);
+          MDB(6,fSTRUCT) MLog("INFO:     job %d node %d rejected\n",jindex,4);
+          MDB(5,fSCHED) MLog("INFO:     job %d idle tasks %d\n",jindex,5);
+          MDB(5,fSTRUCT) MLog("INFO:     job %d node %d rejected\n",jindex,6);
+          MDB(4,fSCHED) MLog("INFO:     job %d range %d\n",jindex,7);
+          MDB(4,fSCHED) MLog("INFO:     job %d range %d\n",jindex,8);
+
+          if (mode & 2)
+            {
+            MDB(3,fSCHED) MLog("INFO:     job %d considered for backfill\n",jindex);
+            }
+          }
+
+        Sink += jindex;
+        }  /* END for (jindex) */
+      }    /* END for (rindex) */
+
+    fflush(mlog.logfp);
+
+    gettimeofday(&End,NULL);
+
+    Elapsed = (End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0;
+
+    fprintf(stdout,"%-10s %-12s %14.2f %14.1f\n",
+      (mode & 1) ? "MDB" : "bitmap",
+      (mode & 2) ? "written" : "none",
+      Elapsed * 1000.0 / 10,
+      Elapsed * 1000000000.0 / 10 / MAX(JCount,1));
+    }  /* END for (mode) */
+
+  MLogShutdown();
+
+  MFURemove(LogPath);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestMDBBench() */
+
+
+
+
+#ifdef MTHREADSAFE
+
+/* shared state for __MSysTestQueueBench() threads */
+
+typedef struct mtestqbench_t {
+  int                Mode;        /* 0 - mutex/mdllist, 1 - MPMC, 2 - MPMC batch dequeue */
+  int                Count;       /* items per producer */
+  volatile int       Remaining;   /* items not yet consumed */
+  mdllist_t         *L;
+  mmutex_t           Mutex;
+  mmpmcq_t          *Q;
+  } mtestqbench_t;
+
+
+void *__MSysTestQueueBenchProducer(
+
+  void *Arg)
+
+  {
+  mtestqbench_t *B = (mtestqbench_t *)Arg;
+
+  long index;
+
+  for (index = 1;index <= B->Count;index++)
+    {
+    if (B->Mode == 0)
+      {
+      /* the pattern MSysAddJobSubmitToQueue() used */
+
+      MUMutexLock(&B->Mutex);
+
+      MUDLListAppend(B->L,(void *)index);
+
+      MUMutexUnlock(&B->Mutex);
+      }
+    else
+      {
+      /* the pattern MSysAddSocketToQueue() uses */
+
+      MUMPMCQueueEnqueueWait(B->Q,(void *)index);
+      }
+    }
+
+  return(NULL);
+  }  /* END __MSysTestQueueBenchProducer() */
+
+
+void *__MSysTestQueueBenchConsumer(
+
+  void *Arg)
+
+  {
+  mtestqbench_t *B = (mtestqbench_t *)Arg;
+
+  void *Data[64];
+  int   count;
+
+  while (B->Remaining > 0)
+    {
+    count = 0;
+
+    if (B->Mode == 0)
+      {
+      /* the pattern MSysDequeueJobSubmit() used */
+
+      if (MUDLListSize(B->L) > 0)
+        {
+        MUMutexLock(&B->Mutex);
+
+        if (MUDLListSize(B->L) > 0)
+          {
+          Data[0] = MUDLListRemoveFirst(B->L);
+
+          count = 1;
+          }
+
+        MUMutexUnlock(&B->Mutex);
+        }
+      }
+    else if (B->Mode == 1)
+      {
+      count = (MUMPMCQueueDequeue(B->Q,&Data[0]) == SUCCESS) ? 1 : 0;
+      }
+    else
+      {
+      count = MUMPMCQueueDequeueBatch(B->Q,Data,64);
+      }
+
+    if (count > 0)
+      __sync_sub_and_fetch(&B->Remaining,count);
+    else
+      sched_yield();
+    }
+
+  return(NULL);
+  }  /* END __MSysTestQueueBenchConsumer() */
+
+#endif /* MTHREADSAFE */
+
+
+/**
+ * Report enqueue+dequeue throughput (items/second) of the submit/socket 
+ * queue - mutex protected mdllist_t vs MUMPMCQueue (single and batch 
+ * dequeue) - with 1, 4 and 16 producers (comm threads) against 1 and 4
+ * consumers.
+ *
+ * @param Count (I) [optional, items per producer, default 200000]
+ */
+
+int __MSysTestQueueBench(
+
+  char *Count)
+
+  {
+#ifdef MTHREADSAFE
+  pthread_t Thread[32];
+
+  mtestqbench_t B;
+
+  const int   ProducerCount[] = { 1, 4, 16, 0 };
+  const int   ConsumerCount[] = { 1, 4, 0 };
+  const char *ModeName[] = { "mutex", "mpmc", "mpmc-batch", NULL };
+
+  int pindex;
+  int cindex;
+  int tindex;
+  int tcount;
+
+  struct timeval Start;
+  struct timeval End;
+
+  double Elapsed;
+
+  B.Count = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 200000;
+
+  pthread_mutex_init(&B.Mutex,NULL);
+
+  fprintf(stdout,"%-11s %9s %9s %14s\n",
+    "queue",
+    "producers",
+    "consumers",
+    "items/sec");
+
+  for (B.Mode = 0;ModeName[B.Mode] != NULL;B.Mode++)
+    {
+    for (cindex = 0;ConsumerCount[cindex] > 0;cindex++)
+      {
+      for (pindex = 0;ProducerCount[pindex] > 0;pindex++)
+        {
+        B.L = MUDLListCreate();
+        B.Q = MUMPMCQueueCreate(MDEF_SOCKETQUEUESIZE);
+
+        B.Remaining = B.Count * ProducerCount[pindex];
+
+        tcount = 0;
+
+        gettimeofday(&Start,NULL);
+
+        for (tindex = 0;tindex < ConsumerCount[cindex];tindex++)
+          pthread_create(&Thread[tcount++],NULL,__MSysTestQueueBenchConsumer,(void *)&B);
+
+        for (tindex = 0;tindex < ProducerCount[pindex];tindex++)
+          pthread_create(&Thread[tcount++],NULL,__MSysTestQueueBenchProducer,(void *)&B);
+
+        for (tindex = 0;tindex < tcount;tindex++)
+          pthread_join(Thread[tindex],NULL);
+
+        gettimeofday(&End,NULL);
+
+        Elapsed = (End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0;
+
+        fprintf(stdout,"%-11s %9d %9d %14.0f\n",
+          ModeName[B.Mode],
+          ProducerCount[pindex],
+          ConsumerCount[cindex],
+          (double)B.Count * ProducerCount[pindex] / MAX(Elapsed,0.000001));
+
+        MUDLListFree(B.L);
+        MUMPMCQueueFree(B.Q);
+        }  /* END for (pindex) */
+      }    /* END for (cindex) */
+    }      /* END for (B.Mode) */
+
+  exit(0);
+#endif /* MTHREADSAFE */
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestQueueBench() */
+
+
+
+
+#ifndef __NOMCOMMTHREAD
+
+/* shared state for __MSysTestTPBench() threads */
+
+typedef struct mtesttpbench_t {
+  int           Count;       /* requests per submitter */
+  int           Work;        /* loop iterations per request */
+  int           BlockEvery;  /* every Nth request sleeps 1ms (0 - never) */
+  volatile int  Started;     /* requests started (picks the blocking ones) */
+  volatile int  Remaining;   /* requests not yet handled */
+  volatile int  NoDB;        /* requests run without a pool thread DB handle */
+  } mtesttpbench_t;
+
+
+void __MSysTestTPBenchRequest(
+
+  void *Arg)
+
+  {
+  mtesttpbench_t *B = (mtesttpbench_t *)Arg;
+
+  volatile int index;
+
+  for (index = 0;index < B->Work;index++);
+
+  if (MTPGetThreadDB() == NULL)
+    __sync_add_and_fetch(&B->NoDB,1);
+
+  if ((B->BlockEvery > 0) && (__sync_add_and_fetch(&B->Started,1) % B->BlockEvery == 0))
+    MUSleep(1000,FALSE);
+
+  __sync_sub_and_fetch(&B->Remaining,1);
+
+  return;
+  }  /* END __MSysTestTPBenchRequest() */
+
+
+void *__MSysTestTPBenchSubmitter(
+
+  void *Arg)
+
+  {
+  mtesttpbench_t *B = (mtesttpbench_t *)Arg;
+
+  int rindex;
+
+  for (rindex = 0;rindex < B->Count;rindex++)
+    MTPAddRequest(rindex,__MSysTestTPBenchRequest,Arg);
+
+  return(NULL);
+  }  /* END __MSysTestTPBenchSubmitter() */
+
+#endif /* !__NOMCOMMTHREAD */
+
+
+/**
+ * Report MTP thread pool throughput (requests/second) for 1 and 4
+ * submitting (comm) threads against a pool of MSched.TPSize (or 
+ * MDEF_TP_HANDLER_THREADS) workers, with uniform requests and with every
+ * 16th request blocking for 1ms (a slow client).  Also reports the pool
+ * counters (MTPGetStats()) for each run and checks that every request saw
+ * its thread's DB handle (MTPGetThreadDB()).  Set MOABTPAFFINITY to bind
+ * workers.
+ *
+ * @param Count (I) [optional, requests per submitter, default 200000]
+ */
+
+int __MSysTestTPBench(
+
+  char *Count)
+
+  {
+#ifndef __NOMCOMMTHREAD
+  pthread_t Thread[4];
+
+  mtesttpbench_t B;
+  mtpstats_t     Stats;
+  mtpstats_t     Prev;
+
+  const int SubmitterCount[] = { 1, 4, 0 };
+
+  int sindex;
+  int tindex;
+  int NumThreads;
+  int MCount;
+
+  struct timeval Start;
+  struct timeval End;
+
+  double Elapsed;
+
+  MCount = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 200000;
+
+  B.Work  = 200;
+  B.NoDB  = 0;
+
+  NumThreads = (MSched.TPSize > 0) ? MSched.TPSize : MDEF_TP_HANDLER_THREADS;
+
+  MTPCreateThreadPool(NumThreads);
+
+  MTPGetStats(&Prev);
+
+  /* maxwait/maxdepth are high-water marks since the pool was created */
+
+  fprintf(stdout,"%7s %10s %8s %14s %12s %12s %10s %10s\n",
+    "workers",
+    "submitters",
+    "load",
+    "requests/sec",
+    "avgwait(us)",
+    "maxwait(us)",
+    "maxdepth",
+    "steals");
+
+  for (B.BlockEvery = 0;B.BlockEvery <= 16;B.BlockEvery += 16)
+    {
+    /* blocking requests take 1ms each - keep the run short */
+
+    B.Count = (B.BlockEvery == 0) ? MCount : MAX(1,MCount / 100);
+
+    for (sindex = 0;SubmitterCount[sindex] > 0;sindex++)
+      {
+      B.Started   = 0;
+      B.Remaining = B.Count * SubmitterCount[sindex];
+
+      gettimeofday(&Start,NULL);
+
+      for (tindex = 0;tindex < SubmitterCount[sindex];tindex++)
+        pthread_create(&Thread[tindex],NULL,__MSysTestTPBenchSubmitter,(void *)&B);
+
+      for (tindex = 0;tindex < SubmitterCount[sindex];tindex++)
+        pthread_join(Thread[tindex],NULL);
+
+      while (B.Remaining > 0)
+        sched_yield();
+
+      gettimeofday(&End,NULL);
+
+      Elapsed = (End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0;
+
+      MTPGetStats(&Stats);
+
+      fprintf(stdout,"%7d %10d %8s %14.0f %12lu %12lu %10d %10lu\n",
+        Stats.NumThreads,
+        SubmitterCount[sindex],
+        (B.BlockEvery == 0) ? "uniform" : "blocking",
+        (double)B.Count * SubmitterCount[sindex] / MAX(Elapsed,0.000001),
+        (Stats.NumRequests > Prev.NumRequests) ? 
+          (Stats.TotalWaitUS - Prev.TotalWaitUS) / (Stats.NumRequests - Prev.NumRequests) : 0,
+        Stats.MaxWaitUS,
+        Stats.MaxQueueDepth,
+        Stats.NumSteals - Prev.NumSteals);
+
+      Prev = Stats;
+      }  /* END for (sindex) */
+    }    /* END for (B.BlockEvery) */
+
+  fprintf(stdout,"requests without a thread DB handle: %d\n",
+    B.NoDB);
+
+  MTPDestroyThreadPool();
+
+  exit(0);
+#endif /* !__NOMCOMMTHREAD */
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestTPBench() */
+
+
+
+
+/* one simulated scheduling iteration for __MSysTestArenaBench(), allocating
+   the way MBFFirstFit()/MNodeSelectIdleTasks() did before (A == NULL) or do
+   now (A != NULL) */
+
+void __MSysTestArenaBenchIteration(
+
+  marena_t *A,        /* I (optional) - NULL for plain MUCalloc()/MNLMultiInit() */
+  int       JobCount, /* I */
+  int       NodeCount)/* I */
+
+  {
+  static mnode_t N;
+
+  mnl_t  *MNodeList[MMAX_REQ_PER_JOB];
+  mnl_t   tmpNL;
+
+  char   *Scratch;
+
+  int     jindex;
+  int     nindex;
+
+  marenamark_t Mark;
+  marenamark_t JMark;
+
+  MUArenaMark(A,&Mark);
+
+  if (A != NULL)
+    MNLInitFromArena(&tmpNL,A);
+  else
+    MNLInit(&tmpNL);
+
+  for (jindex = 0;jindex < JobCount;jindex++)
+    {
+    /* MBFFirstFit() - feasible node list plus per-job node lists */
+
+    MUArenaMark(A,&JMark);
+
+    if (A != NULL)
+      MNLMultiInitFromArena(MNodeList,A);
+    else
+      MNLMultiInit(MNodeList);
+
+    for (nindex = 0;nindex < NodeCount;nindex++)
+      {
+      MNLSetNodeAtIndex(&tmpNL,nindex,&N);
+      MNLSetTCAtIndex(&tmpNL,nindex,1);
+      }
+
+    MNLTerminateAtIndex(&tmpNL,NodeCount);
+
+    /* MNodeSelectIdleTasks() - node sized scratch plus selected list */
+
+    if (A != NULL)
+      Scratch = (char *)MUArenaMalloc(A,NodeCount * 3 * sizeof(long));
+    else
+      Scratch = (char *)MUCalloc(1,MSched.M[mxoNode] * 3 * sizeof(long));
+
+    for (nindex = 0;nindex < NodeCount;nindex += 2)
+      {
+      MNLSetNodeAtIndex(MNodeList[0],nindex >> 1,&N);
+      MNLSetTCAtIndex(MNodeList[0],nindex >> 1,1);
+      }
+
+    MUArenaFree(A,&Scratch);
+
+    MNLMultiFree(MNodeList);
+
+    MUArenaRelease(A,&JMark);
+    }  /* END for (jindex) */
+
+  MNLFree(&tmpNL);
+
+  MUArenaRelease(A,&Mark);
+
+  return;
+  }  /* END __MSysTestArenaBenchIteration() */
+
+
+
+
+/**
+ * Compare simulated scheduling iterations using plain heap allocation with
+ * the same iterations drawing scratch memory from a per-iteration arena.
+ *
+ * @param Arg (I) [optional, <JOBCOUNT>[,<NODECOUNT>], default 2000,5000]
+ */
+
+int __MSysTestArenaBench(
+
+  char *Arg)
+
+  {
+  marena_t A;
+  marena_t Counter;
+
+  int JobCount  = 2000;
+  int NodeCount = 5000;
+  int Iterations = 5;
+  int iindex;
+
+  char *ptr;
+
+  struct timeval Start;
+  struct timeval End;
+
+  double HeapElapsed;
+  double ArenaElapsed;
+
+  if ((Arg != NULL) && (Arg[0] != '\0'))
+    {
+    JobCount = (int)strtol(Arg,&ptr,10);
+
+    if (*ptr == ',')
+      NodeCount = (int)strtol(ptr + 1,NULL,10);
+    }
+
+  memset(&A,0,sizeof(A));
+  memset(&Counter,0,sizeof(Counter));
+
+  /* an inactive arena passes every request to MUCalloc() and counts it */
+
+  __MSysTestArenaBenchIteration(&Counter,JobCount,NodeCount);
+
+  gettimeofday(&Start,NULL);
+
+  for (iindex = 0;iindex < Iterations;iindex++)
+    __MSysTestArenaBenchIteration(NULL,JobCount,NodeCount);
+
+  gettimeofday(&End,NULL);
+
+  HeapElapsed = (End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0;
+
+  gettimeofday(&Start,NULL);
+
+  for (iindex = 0;iindex < Iterations;iindex++)
+    {
+    MUArenaReset(&A);
+
+    __MSysTestArenaBenchIteration(&A,JobCount,NodeCount);
+    }
+
+  gettimeofday(&End,NULL);
+
+  ArenaElapsed = (End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0;
+
+  fprintf(stdout,"%d jobs x %d nodes, %d node scratch\n",
+    JobCount,
+    NodeCount,
+    MSched.M[mxoNode]);
+
+  fprintf(stdout,"heap:   %8.2f ms/iteration  %lu heap allocations/iteration\n",
+    HeapElapsed * 1000.0 / Iterations,
+    Counter.NumFallbacks);
+
+  fprintf(stdout,"arena:  %8.2f ms/iteration  %lu arena allocations/iteration  %lu blocks total  peak %lu KB\n",
+    ArenaElapsed * 1000.0 / Iterations,
+    A.NumAllocs / Iterations,
+    A.NumBlocks,
+    A.PeakBytes >> 10);
+
+  MUArenaDestroy(&A);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestArenaBench() */
+
+
+
+
+/**
+ * Time the hot mbitmap_t paths - flag tests on a job-flag sized map, copies
+ * of small and feature sized maps, and whole-map and/or/compare/isclear on
+ * feature sized (MMAX_ATTR) maps.
+ *
+ * @param Count (I) [optional, iterations, default 10000000]
+ */
+
+int __MSysTestBMBench(
+
+  char *Count)
+
+  {
+  mbitmap_t Flags;
+  mbitmap_t Feature;
+  mbitmap_t Feature2;
+  mbitmap_t Dst;
+
+  int       Iterations;
+  int       index;
+  int       Hits = 0;
+
+  struct timeval Start;
+  struct timeval End;
+
+  Iterations = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 10000000;
+
+  for (index = 0;index < mjifLAST;index += 3)
+    bmset(&Flags,index);
+
+  for (index = 0;index < MMAX_ATTR;index += 7)
+    bmset(&Feature,index);
+
+  bmcopy(&Feature2,&Feature);
+
+#define __MBMBENCH(Name,Expr)                                                 \
+  gettimeofday(&Start,NULL);                                                  \
+  for (index = 0;index < Iterations;index++)                                  \
+    { Expr; }                                                                 \
+  gettimeofday(&End,NULL);                                                    \
+  fprintf(stdout,"%-28s %8.2f ns/op\n",                                       \
+    Name,                                                                     \
+    ((End.tv_sec - Start.tv_sec) * 1000000.0 + (End.tv_usec - Start.tv_usec)) \
+      * 1000.0 / Iterations);
+
+  __MBMBENCH("bmisset (job flags)",Hits += bmisset(&Flags,index % mjifLAST))
+  __MBMBENCH("bmset/bmunset (job flags)",bmset(&Flags,index % mjifLAST); bmunset(&Flags,(index + 1) % mjifLAST))
+  __MBMBENCH("bmcopy (job flags)",bmcopy(&Dst,&Flags))
+  __MBMBENCH("copy constructor (job flags)",mbitmap_t tmpBM(Flags); Hits += bmisset(&tmpBM,1))
+  __MBMBENCH("bmcopy (features)",bmcopy(&Dst,&Feature))
+  __MBMBENCH("bmor (features)",bmor(&Dst,&Feature2))
+  __MBMBENCH("bmand (features)",bmand(&Dst,&Feature2))
+  __MBMBENCH("bmcompare (features)",Hits += bmcompare(&Dst,&Feature2))
+  __MBMBENCH("bmisclear (features)",Hits += bmisclear(&Feature))
+
+#undef __MBMBENCH
+
+  fprintf(stdout,"(%d)\n",
+    Hits);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestBMBench() */
+
+
+
+
+/**
+ * Time marray_t at scale: one-at-a-time, reserved and bulk appends, random
+ * removes followed by re-inserts into the freed slots (against the linear
+ * scan for an empty slot that a fixed-size empty table falls back to), and
+ * iteration with and without holes.
+ *
+ * @param Count (I) [optional, elements, default 1000000]
+ */
+
+int __MSysTestArrayBench(
+
+  char *Count)
+
+  {
+  marray_t A;
+
+  void   **Ptrs;
+  void   **tmpArray;
+  int     *RIndex;
+  int     *SIndex;
+
+  int      N;
+  int      NRemove;
+  int      NScan;
+  int      index;
+  int      sindex;
+
+  long     Sum = 0;
+
+  struct timeval Start;
+  struct timeval End;
+
+  N = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 1000000;
+
+  if (N < 10)
+    N = 10;
+
+  NRemove = N / 2;
+  NScan   = MIN(NRemove,10000);
+
+  Ptrs   = (void **)MUMalloc(sizeof(void *) * N);
+  RIndex = (int *)MUMalloc(sizeof(int) * N);
+  SIndex = (int *)MUMalloc(sizeof(int) * NScan);
+
+  /* any non-NULL, non-MEMPTYSLOT value will do */
+
+  for (index = 0;index < N;index++)
+    Ptrs[index] = (void *)((index + 2) * sizeof(void *));
+
+  /* distinct random indexes to remove (Fisher-Yates over [0,N)) */
+
+  for (index = 0;index < N;index++)
+    RIndex[index] = index;
+
+  srand(1);
+
+  for (index = N - 1;index > 0;index--)
+    {
+    int tmpI;
+
+    sindex = rand() % (index + 1);
+
+    tmpI = RIndex[index];
+    RIndex[index] = RIndex[sindex];
+    RIndex[sindex] = tmpI;
+    }
+
+#define __MARRAYBENCH(Name,Ops,Code)                                          \
+  gettimeofday(&Start,NULL);                                                  \
+  { Code; }                                                                   \
+  gettimeofday(&End,NULL);                                                    \
+  fprintf(stdout,"%-32s %8.2f ns/op\n",                                       \
+    Name,                                                                     \
+    ((End.tv_sec - Start.tv_sec) * 1000000.0 + (End.tv_usec - Start.tv_usec)) \
+      * 1000.0 / (Ops));
+
+  MUArrayListCreate(&A,sizeof(void *),0);
+
+  __MARRAYBENCH("append (one at a time)",N,
+    for (index = 0;index < N;index++)
+      MUArrayListAppendPtr(&A,Ptrs[index]))
+
+  MUArrayListFree(&A);
+  MUArrayListCreate(&A,sizeof(void *),0);
+
+  __MARRAYBENCH("append (after reserve)",N,
+    MUArrayListReserve(&A,N);
+    for (index = 0;index < N;index++)
+      MUArrayListAppendPtr(&A,Ptrs[index]))
+
+  MUArrayListFree(&A);
+  MUArrayListCreate(&A,sizeof(void *),0);
+
+  __MARRAYBENCH("append (bulk)",N,
+    MUArrayListAppendN(&A,Ptrs,N))
+
+  __MARRAYBENCH("iterate (dense)",N,
+    tmpArray = (void **)A.Array;
+    for (index = 0;index < A.NumItems;index++)
+      Sum += (long)tmpArray[index])
+
+  __MARRAYBENCH("remove (random, bulk)",NRemove,
+    MUArrayListRemoveN(&A,RIndex,NRemove,FALSE))
+
+  __MARRAYBENCH("iterate (half empty)",N,
+    tmpArray = (void **)A.Array;
+    for (index = 0;index < A.NumItems;index++)
+      {
+      if (tmpArray[index] != (void *)0x1)
+        Sum += (long)tmpArray[index];
+      })
+
+  /* reference: find each empty slot with a linear scan from the start and
+     fill it (the slots are emptied again afterwards) */
+
+  __MARRAYBENCH("re-insert (linear scan)",NScan,
+    tmpArray = (void **)A.Array;
+    for (index = 0;index < NScan;index++)
+      {
+      for (sindex = 0;sindex < A.NumItems;sindex++)
+        {
+        if (tmpArray[sindex] == (void *)0x1)
+          break;
+        }
+
+      tmpArray[sindex] = Ptrs[index];
+      SIndex[index] = sindex;
+      })
+
+  for (index = 0;index < NScan;index++)
+    tmpArray[SIndex[index]] = (void *)0x1;
+
+  __MARRAYBENCH("re-insert (free list)",NRemove,
+    for (index = 0;index < NRemove;index++)
+      MUArrayListInsertPtr(&A,Ptrs[index]))
+
+  MUArrayListRemoveN(&A,RIndex,NRemove,FALSE);
+
+  __MARRAYBENCH("compact",N,
+    MUArrayListCompact(&A))
+
+  __MARRAYBENCH("iterate (compacted)",N - NRemove,
+    tmpArray = (void **)A.Array;
+    for (index = 0;index < A.NumItems;index++)
+      Sum += (long)tmpArray[index])
+
+#undef __MARRAYBENCH
+
+  fprintf(stdout,"%d elements, %d removed, %d live (%ld)\n",
+    N,
+    NRemove,
+    A.NumItems - A.NumFree,
+    Sum);
+
+  MUArrayListFree(&A);
+  MUFree((char **)&Ptrs);
+  MUFree((char **)&RIndex);
+  MUFree((char **)&SIndex);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestArrayBench() */
+
+
+
+
+/**
+ * Time mln_t lists of growing size: MULLAdd() of new names, MULLCheck() of
+ * names in the list (and MULLCheckCS() of names that are not), the walk
+ * that lookups did before lists were indexed, and MULLIterate().
+ *
+ * @param Count (I) [optional, largest list, default 10000]
+ */
+
+int __MSysTestLLBench(
+
+  char *Count)
+
+  {
+  mln_t  *L;
+  mln_t  *ptr;
+
+  char  (*Names)[MMAX_NAME];
+
+  int     Max;
+  int     Size;
+  int     sindex;
+  int     Ops;
+  int     WalkOps;
+  int     index;
+  int     Hits = 0;
+
+  const char *Value;
+
+  const int Sizes[] = { 4, 16, 100, 1000, 10000, 100000, 1000000, 0 };
+
+  struct timeval Start;
+  struct timeval End;
+
+  Max = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 10000;
+
+  if (Max < 4)
+    Max = 4;
+
+  Names = (char (*)[MMAX_NAME])MUMalloc(sizeof(Names[0]) * Max * 2);
+
+  for (index = 0;index < Max * 2;index++)
+    snprintf(Names[index],sizeof(Names[0]),"JOBDEP_%d",index);
+
+#define __MLLBENCHUS ((End.tv_sec - Start.tv_sec) * 1000000.0 + (End.tv_usec - Start.tv_usec))
+
+  fprintf(stdout,"%8s %10s %10s %10s %10s %10s\n",
+    "items",
+    "add",
+    "check",
+    "miss",
+    "walk",
+    "iterate");
+
+  for (sindex = 0;(Sizes[sindex] > 0) && (Sizes[sindex] <= Max);sindex++)
+    {
+    double AddNS;
+    double CheckNS;
+    double MissNS;
+    double WalkNS;
+    double IterNS;
+
+    Size = Sizes[sindex];
+
+    Ops = 200000;
+    WalkOps = MAX(1000,MIN(Ops,20000000 / Size));
+
+    L = NULL;
+
+    gettimeofday(&Start,NULL);
+
+    for (index = 0;index < Size;index++)
+      MULLAdd(&L,Names[index],NULL,NULL,NULL);
+
+    gettimeofday(&End,NULL);
+
+    AddNS = __MLLBENCHUS * 1000.0 / Size;
+
+    gettimeofday(&Start,NULL);
+
+    for (index = 0;index < Ops;index++)
+      Hits += MULLCheck(L,Names[(index * 7919) % Size],NULL);
+
+    gettimeofday(&End,NULL);
+
+    CheckNS = __MLLBENCHUS * 1000.0 / Ops;
+
+    gettimeofday(&Start,NULL);
+
+    for (index = 0;index < Ops;index++)
+      Hits += MULLCheckCS(L,Names[Max + (index % Max)],NULL);
+
+    gettimeofday(&End,NULL);
+
+    MissNS = __MLLBENCHUS * 1000.0 / Ops;
+
+    /* reference: the strlen/strcasecmp walk MULLCheck() does on short lists */
+
+    gettimeofday(&Start,NULL);
+
+    for (index = 0;index < WalkOps;index++)
+      {
+      int ValueLen;
+
+      Value = Names[(index * 7919) % Size];
+      ValueLen = strlen(Value);
+
+      for (ptr = L;ptr != NULL;ptr = ptr->Next)
+        {
+        if ((ptr->NameLen == ValueLen) && !strcasecmp(Value,ptr->Name))
+          {
+          Hits++;
+
+          break;
+          }
+        }
+      }
+
+    gettimeofday(&End,NULL);
+
+    WalkNS = __MLLBENCHUS * 1000.0 / WalkOps;
+
+    gettimeofday(&Start,NULL);
+
+    for (index = 0;index < 100;index++)
+      {
+      ptr = NULL;
+
+      while (MULLIterate(L,&ptr) == SUCCESS)
+        Hits++;
+      }
+
+    gettimeofday(&End,NULL);
+
+    IterNS = __MLLBENCHUS * 1000.0 / (100.0 * Size);
+
+    fprintf(stdout,"%8d %8.1fns %8.1fns %8.1fns %8.1fns %8.1fns\n",
+      Size,
+      AddNS,
+      CheckNS,
+      MissNS,
+      WalkNS,
+      IterNS);
+
+    MULLFree(&L,NULL);
+    }  /* END for (Size) */
+
+#undef __MLLBENCHUS
+
+  fprintf(stdout,"(%d)\n",
+    Hits);
+
+  MUFree((char **)&Names);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestLLBench() */
+
+
+
+
+/**
+ * Build a synthetic resource manager payload of Count node (Type == mxoNode)
+ * or job elements for __MSysTestXMLBench().
+ *
+ * @param Type  (I)
+ * @param Count (I)
+ */
+
+char *__MSysTestXMLBenchDoc(
+
+  enum MXMLOTypeEnum Type,  /* I */
+  int                Count) /* I */
+
+  {
+  char *Doc;
+  char *ptr;
+
+  int   index;
+
+  const char *NState[] = { "Idle", "Busy", "Running", "Down", NULL };
+  const char *JState[] = { "Idle", "Running", "Hold", "Completed", NULL };
+
+  /* every element fits in MMAX_LINE */
+
+  if ((Doc = (char *)MUMalloc(Count * MMAX_LINE + MMAX_NAME)) == NULL)
+    return(NULL);
+
+  ptr = Doc + sprintf(Doc,"<?xml version=\"1.0\"?>\n<Data>");
+
+  for (index = 0;index < Count;index++)
+    {
+    if (Type == mxoNode)
+      {
+      ptr += sprintf(ptr,"<node NODEID=\"node%05d\" NODESTATE=\"%s\" OS=\"linux\" ARCH=\"x86_64\" RCPROC=\"32\" RAPROC=\"%d\" RCMEM=\"131072\" RAMEM=\"%d\" RCSWAP=\"8192\" RCDISK=\"1000000\" LOAD=\"%.2f\" SPEED=\"1.00\" PARTITION=\"base\" RM=\"base\" FEATURES=\"ib,fast,rack%d\" CLASSES=\"[batch 32][debug 32]\" LASTUPDATETIME=\"%ld\" MESSAGE=\"disk &lt; 90%% free &amp; ok\"><gres NAME=\"gpu\" CFG=\"2\" AVL=\"%d\"></gres><gres NAME=\"matlab\" CFG=\"4\" AVL=\"4\"></gres></node>\n",
+        index,
+        NState[index % 4],
+        index % 33,
+        (index * 7) % 131072,
+        (double)(index % 3200) / 100.0,
+        index / 40,
+        1300000000L + index,
+        index % 3);
+      }
+    else
+      {
+      ptr += sprintf(ptr,"<job JOBID=\"Moab.%d\" STATE=\"%s\" USER=\"user%d\" GROUP=\"grp%d\" ACCOUNT=\"acct%d\" CLASS=\"batch\" QOS=\"normal\" REQAWDURATION=\"3600\" SUBMITTIME=\"%ld\" STARTCOUNT=\"0\" PRIORITY=\"%d\" FLAGS=\"RESTARTABLE,BACKFILL\" IWD=\"/home/user%d/run\" ENV=\"PATH=/usr/bin~rs;HOME=/home/user%d~rs;\"><req REQID=\"0\" TCREQ=\"%d\" TPN=\"8\" RCPROC=\"1\" RCMEM=\"2048\" OPSYS=\"linux\" ALLOCNODELIST=\"node%05d:8\"></req><Variables><Variable name=\"run\">%d</Variable></Variables><Messages><message COUNT=\"1\" TYPE=\"info\">input &amp; output &lt;staged&gt;</message></Messages></job>\n",
+        index,
+        JState[index % 4],
+        index % 500,
+        index % 50,
+        index % 20,
+        1300000000L + index,
+        100000 - index,
+        index % 500,
+        index % 500,
+        (index % 16) + 1,
+        index % 10000,
+        index);
+      }
+    }    /* END for (index) */
+
+  strcpy(ptr,"</Data>");
+
+  return(Doc);
+  }  /* END __MSysTestXMLBenchDoc() */
+
+
+
+
+/**
+ * Returns TRUE if trees A and B hold the same names, values, attributes
+ * (in the same order) and children.
+ *
+ * @param A (I)
+ * @param B (I)
+ */
+
+mbool_t __MSysTestXMLBenchIsSame(
+
+  mxml_t *A, /* I */
+  mxml_t *B) /* I */
+
+  {
+  int index;
+
+#define __MXMLSTREQ(X,Y) ((((X) == NULL) && ((Y) == NULL)) || (((X) != NULL) && ((Y) != NULL) && !strcmp((X),(Y))))
+
+  if ((A == NULL) || (B == NULL))
+    return((A == B) ? TRUE : FALSE);
+
+  if (!__MXMLSTREQ(A->Name,B->Name) ||
+      !__MXMLSTREQ(A->Val,B->Val) ||
+      (A->ACount != B->ACount) ||
+      (A->CCount != B->CCount))
+    return(FALSE);
+
+  for (index = 0;index < A->ACount;index++)
+    {
+    if (!__MXMLSTREQ(A->AName[index],B->AName[index]) ||
+        !__MXMLSTREQ(A->AVal[index],B->AVal[index]))
+      return(FALSE);
+    }
+
+  for (index = 0;index < A->CCount;index++)
+    {
+    if (__MSysTestXMLBenchIsSame(A->C[index],B->C[index]) == FALSE)
+      return(FALSE);
+    }
+
+#undef __MXMLSTREQ
+
+  return(TRUE);
+  }  /* END __MSysTestXMLBenchIsSame() */
+
+
+
+
+/**
+ * Compare parse throughput of MXMLFromString() against the pull parser and
+ * the arena-backed tree builder on large node and job documents.
+ *
+ * @param Count (I) [optional, nodes/jobs per document, default 10000]
+ */
+
+int __MSysTestXMLBench(
+
+  char *Count)
+
+  {
+  marena_t   A;
+  mxmlpull_t P;
+
+  mxml_t    *E;
+  mxml_t    *HeapE;
+
+  mxmlview_t AName;
+  mxmlview_t AVal;
+
+  enum MXMLPullEventEnum Event;
+  enum MXMLOTypeEnum     Type;
+
+  char      *Doc;
+  char       tmpLine[MMAX_LINE];
+
+  int        N;
+  int        Iterations = 3;
+  int        iindex;
+  int        tindex;
+  int        Events = 0;
+  int        Attrs = 0;
+
+  double     MB;
+
+  struct timeval Start;
+  struct timeval End;
+
+  N = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 10000;
+
+  if (N < 1)
+    N = 1;
+
+  memset(&A,0,sizeof(A));
+
+  MUArenaReset(&A);
+
+#define __MXMLBENCH(Name,Code)                                                \
+  gettimeofday(&Start,NULL);                                                  \
+  for (iindex = 0;iindex < Iterations;iindex++)                               \
+    { Code; }                                                                 \
+  gettimeofday(&End,NULL);                                                    \
+  fprintf(stdout,"  %-34s %9.2f ms %9.1f MB/s\n",                             \
+    Name,                                                                     \
+    ((End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0) / Iterations, \
+    MB * Iterations / ((End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0));
+
+  for (tindex = 0;tindex < 2;tindex++)
+    {
+    Type = (tindex == 0) ? mxoNode : mxoJob;
+
+    if ((Doc = __MSysTestXMLBenchDoc(Type,N)) == NULL)
+      break;
+
+    MB = (double)strlen(Doc) / (1024.0 * 1024.0);
+
+    fprintf(stdout,"%d %ss, %.2f MB\n",
+      N,
+      MXO[Type],
+      MB);
+
+    __MXMLBENCH("MXMLFromString + MXMLDestroyE",
+      E = NULL;
+      MXMLFromString(&E,Doc,NULL,NULL);
+      MXMLDestroyE(&E))
+
+    __MXMLBENCH("MXMLFromStringArena + reset",
+      MUArenaReset(&A);
+      MXMLFromStringArena(&E,Doc,&A,NULL,NULL))
+
+    __MXMLBENCH("MXMLPullNext",
+      MXMLPullInit(&P,Doc,-1);
+      Events = 0;
+      while ((MXMLPullNext(&P,&Event) == SUCCESS) && (Event != mxpeEOF))
+        Events++)
+
+    __MXMLBENCH("MXMLPullNext + decoded attributes",
+      MXMLPullInit(&P,Doc,-1);
+      Attrs = 0;
+      while ((MXMLPullNext(&P,&Event) == SUCCESS) && (Event != mxpeEOF))
+        {
+        while (MXMLPullNextAttr(&P,&AName,&AVal) == SUCCESS)
+          {
+          MXMLViewDecode(&AVal,tmpLine,sizeof(tmpLine));
+          Attrs++;
+          }
+        })
+
+    /* both parsers must build the same tree */
+
+    HeapE = NULL;
+    MXMLFromString(&HeapE,Doc,NULL,NULL);
+
+    MUArenaReset(&A);
+    MXMLFromStringArena(&E,Doc,&A,NULL,NULL);
+
+    fprintf(stdout,"  %d events, %d attributes, arena peak %lu bytes, trees %s\n",
+      Events,
+      Attrs,
+      A.PeakBytes,
+      (__MSysTestXMLBenchIsSame(HeapE,E) == TRUE) ? "identical" : "DIFFER");
+
+    MXMLDestroyE(&HeapE);
+
+    MUFree(&Doc);
+    }  /* END for (tindex) */
+
+#undef __MXMLBENCH
+
+  MUArenaDestroy(&A);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestXMLBench() */
+
+
+
+
+/**
+ * Time MXMLToMString(), MXMLToString() and MXMLToXString() on a showq-scale
+ * job list and check that the output parses back to the same tree.
+ *
+ * @param Count (I) [optional, jobs in the list, default 10000]
+ */
+
+int __MSysTestXMLOutBench(
+
+  char *Count)
+
+  {
+  mxml_t    *E = NULL;
+  mxml_t    *RE;
+
+  mstring_t  MString(MMAX_LINE);
+
+  char      *Doc;
+  char      *Buf = NULL;
+
+  long       Size = 0;
+  int        BufSize = 0;
+
+  int        N;
+  int        Iterations = 3;
+  int        iindex;
+
+  double     MB;
+
+  struct timeval Start;
+  struct timeval End;
+
+  N = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 10000;
+
+  if (N < 1)
+    N = 1;
+
+  if ((Doc = __MSysTestXMLBenchDoc(mxoJob,N)) == NULL)
+    exit(1);
+
+  if (MXMLFromString(&E,Doc,NULL,NULL) == FAILURE)
+    exit(1);
+
+  MUFree(&Doc);
+
+  MXMLToStringSize(E,&Size);
+
+  MB = (double)Size / (1024.0 * 1024.0);
+
+  fprintf(stdout,"%d jobs, %.2f MB of XML\n",
+    N,
+    MB);
+
+#define __MXMLBENCH(Name,Code)                                                \
+  gettimeofday(&Start,NULL);                                                  \
+  for (iindex = 0;iindex < Iterations;iindex++)                               \
+    { Code; }                                                                 \
+  gettimeofday(&End,NULL);                                                    \
+  fprintf(stdout,"  %-34s %9.2f ms %9.1f MB/s\n",                             \
+    Name,                                                                     \
+    ((End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0) / Iterations, \
+    MB * Iterations / ((End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0));
+
+  __MXMLBENCH("MXMLToStringSize",
+    MXMLToStringSize(E,&Size))
+
+  __MXMLBENCH("MXMLToMString",
+    MString.clear();
+    MXMLToMString(E,&MString,NULL,TRUE))
+
+  Buf = (char *)MUMalloc(Size + 1);
+
+  __MXMLBENCH("MXMLToString (presized)",
+    MXMLToString(E,Buf,Size + 1,NULL,TRUE))
+
+  MUFree(&Buf);
+
+  __MXMLBENCH("MXMLToXString (reused buffer)",
+    MXMLToXString(E,&Buf,&BufSize,0,NULL,TRUE))
+
+  /* output must round trip */
+
+  RE = NULL;
+
+  MXMLFromString(&RE,MString.c_str(),NULL,NULL);
+
+  fprintf(stdout,"  %ld bytes, MString %s, buffers %s, round trip %s\n",
+    Size,
+    ((long)MString.length() == Size) ? "exact" : "WRONG SIZE",
+    ((Buf != NULL) && !strcmp(Buf,MString.c_str())) ? "identical" : "DIFFER",
+    (__MSysTestXMLBenchIsSame(E,RE) == TRUE) ? "identical" : "DIFFER");
+
+#undef __MXMLBENCH
+
+  MXMLDestroyE(&RE);
+  MXMLDestroyE(&E);
+
+  MUFree(&Buf);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestXMLOutBench() */
+
+
+
+
+/**
+ * Time checkpoint record lookup on a synthetic checkpoint file holding
+ * Count jobs (plus nodes and users): indexing the buffer, restoring every
+ * job through MCPGetLine(), and the strstr() scan lookups used to need.
+ *
+ * @param Count (I) [optional, jobs in the checkpoint file, default 100000]
+ */
+
+int __MSysTestCPBench(
+
+  char *Count)
+
+  {
+  char   *Buf;
+  char   *ptr;
+  char   *Line;
+  char   *SaveBuffer;
+
+  char    OName[MMAX_NAME];
+  char    CPLineKey[MMAX_LINE];
+
+  int     N;
+  int     NCount;
+  int     index;
+  int     Scans;
+  int     Found = 0;
+  int     Misses = 0;
+
+  double  BuildMS;
+  double  GetMS;
+  double  ScanMS;
+
+  struct timeval Start;
+  struct timeval End;
+
+  N = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 100000;
+
+  if (N < 1)
+    N = 1;
+
+  NCount = MAX(1,N / 10);
+
+  /* job records run to a few hundred bytes of XML */
+
+  if ((Buf = (char *)MUMalloc((N + NCount + 1000) * MMAX_LINE)) == NULL)
+    exit(1);
+
+  ptr = Buf;
+
+  ptr += sprintf(ptr,"%-9s %20s %9ld %s\n",
+    MCPType[mcpSched],
+    "Moab",
+    1300000000L,
+    "<sched></sched>");
+
+  for (index = 0;index < 1000;index++)
+    {
+    sprintf(OName,"user%d",index);
+
+    ptr += sprintf(ptr,"%-9s %20s %9ld <user FSUSAGE=\"%d\"></user>\n",
+      MCPType[mcpUser],
+      OName,
+      1300000000L,
+      index);
+    }
+
+  for (index = 0;index < NCount;index++)
+    {
+    sprintf(OName,"node%05d",index);
+
+    ptr += sprintf(ptr,"%-9s %20s %9ld <node NODESTATE=\"Idle\" POWER=\"On\" CFGCLASS=\"[batch 32]\"></node>\n",
+      MCPType[mcpNode],
+      OName,
+      1300000000L);
+    }
+
+  for (index = 0;index < N;index++)
+    {
+    sprintf(OName,"Moab.%d",index);
+
+    ptr += sprintf(ptr,"%-9s %20s %9ld <job><JOBID>Moab.%d</JOBID><SID>%d</SID><RMCount>1</RMCount><SubmitTime>%ld</SubmitTime><StartTime>%ld</StartTime><SysPrio>%d</SysPrio><Flags>RESTARTABLE,BACKFILL</Flags><Variables><Variable name=\"run\">%d</Variable></Variables><Messages><message COUNT=\"1\" TYPE=\"info\">staged</message></Messages></job>\n",
+      MCPType[mcpJob],
+      OName,
+      1300000000L,
+      index,
+      index % 30000,
+      1300000000L + index,
+      1300000000L + index + 60,
+      100000 - index,
+      index);
+    }
+
+  fprintf(stdout,"%d jobs, %d nodes, %.2f MB checkpoint\n",
+    N,
+    NCount,
+    (double)(ptr - Buf) / (1024.0 * 1024.0));
+
+  SaveBuffer = MCP.Buffer;
+
+  MCP.Buffer = Buf;
+
+  /* index the buffer */
+
+  gettimeofday(&Start,NULL);
+
+  MCPBuildHashTable(MCP.Buffer);
+
+  gettimeofday(&End,NULL);
+
+  BuildMS = (End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0;
+
+  /* restore every job in a scattered order, plus a miss for each */
+
+  gettimeofday(&Start,NULL);
+
+  for (index = 0;index < N;index++)
+    {
+    sprintf(OName,"Moab.%d",(int)((index * 7919L) % N));
+
+    if ((MCPGetLine(mcpJob,OName,&Line) == SUCCESS) &&
+        !strncmp(Line,MCPType[mcpJob],strlen(MCPType[mcpJob])))
+      Found++;
+
+    sprintf(OName,"Moab.%d",N + index);
+
+    if (MCPGetLine(mcpJob,OName,&Line) == FAILURE)
+      Misses++;
+    }
+
+  gettimeofday(&End,NULL);
+
+  GetMS = (End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0;
+
+  /* previous mid-run lookup: strstr() from the top of the buffer */
+
+  Scans = MIN(N,200);
+
+  srand(1);
+
+  gettimeofday(&Start,NULL);
+
+  for (index = 0;index < Scans;index++)
+    {
+    sprintf(OName,"Moab.%d",rand() % N);
+
+    sprintf(CPLineKey,"%-9s %20s ",
+      MCPType[mcpJob],
+      OName);
+
+    if (strstr(MCP.Buffer,CPLineKey) == NULL)
+      Misses = -1;
+    }
+
+  gettimeofday(&End,NULL);
+
+  ScanMS = (End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0;
+
+  fprintf(stdout,"  index build                  %9.2f ms\n",
+    BuildMS);
+
+  fprintf(stdout,"  MCPGetLine() hit + miss      %9.3f us/job, %9.2f ms for all jobs\n",
+    GetMS * 1000.0 / N,
+    GetMS);
+
+  fprintf(stdout,"  strstr() scan (old)          %9.3f us/job, %9.2f ms for all jobs (est)\n",
+    ScanMS * 1000.0 / Scans,
+    ScanMS / Scans * N);
+
+  fprintf(stdout,"  found %d/%d jobs, %s\n",
+    Found,
+    N,
+    (Misses == N) ? "no false hits" : "LOOKUP ERROR");
+
+  MCP.Buffer = SaveBuffer;
+
+  MUFree(&Buf);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestCPBench() */
+
+
+
+
+/**
+ * Time building the RE lists of a heavily reserved cluster: 32 nodes each
+ * carrying Count reservations (a mix of whole-node standing reservations
+ * and partial job reservations), and verify every list comes out sorted.
+ *
+ * @param Count (I) [optional, reservations per node, default 2000]
+ */
+
+int __MSysTestREBench(
+
+  char *Count)
+
+  {
+  mnode_t *N;
+  mnode_t *NList;
+  mrsv_t  *RList;
+
+  mcres_t  DRes;
+
+  int      NC = 32;
+  int      RC;
+
+  int      nindex;
+  int      rindex;
+  int      Events = 0;
+  int      Unsorted = 0;
+
+  long     RStart;
+  long     RDuration;
+
+  mre_t   *RE;
+
+  struct timeval Start;
+  struct timeval End;
+
+  RC = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 2000;
+
+  if (RC < 1)
+    RC = 1;
+
+  NList = (mnode_t *)MUCalloc(NC,sizeof(mnode_t));
+  RList = (mrsv_t *)MUCalloc(RC,sizeof(mrsv_t));
+
+  if ((NList == NULL) || (RList == NULL))
+    exit(1);
+
+  MCResInit(&DRes);
+
+  srand(1);
+
+  /* reserve the cluster - one week, job rsvs of up to 8 hours */
+
+  gettimeofday(&Start,NULL);
+
+  for (nindex = 0;nindex < NC;nindex++)
+    {
+    N = &NList[nindex];
+
+    sprintf(N->Name,"node%03d",nindex);
+
+    N->CRes.Procs = 32;
+    N->CRes.Mem   = 131072;
+
+    for (rindex = 0;rindex < RC;rindex++)
+      {
+      RStart = rand() % (7 * MCONST_DAYLEN);
+
+      if (rindex % 50 == 0)
+        {
+        /* standing rsv blocks the whole node for an hour */
+
+        RStart    -= RStart % MCONST_HOURLEN;
+        RDuration  = MCONST_HOURLEN;
+
+        DRes.Procs = -1;
+        DRes.Mem   = 0;
+        }
+      else
+        {
+        RDuration  = 60 + rand() % (8 * MCONST_HOURLEN);
+
+        DRes.Procs = 1 + rand() % 8;
+        DRes.Mem   = 1024 * (rand() % 16);
+        }
+
+      MREInsert(&N->RE,RStart,RStart + RDuration,&RList[rindex],&DRes,1);
+      }  /* END for (rindex) */
+    }    /* END for (nindex) */
+
+  gettimeofday(&End,NULL);
+
+  for (nindex = 0;nindex < NC;nindex++)
+    {
+    for (RE = NList[nindex].RE;RE != NULL;RE = RE->Next)
+      {
+      Events++;
+
+      if ((RE->Next != NULL) && (RE->Next->Time < RE->Time))
+        Unsorted++;
+      }
+    }
+
+  fprintf(stdout,"%d nodes, %d reservations/node, %d events\n",
+    NC,
+    RC,
+    Events);
+
+  fprintf(stdout,"  RE list build (MREInsert)    %9.2f ms, lists %s\n",
+    (End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0,
+    (Unsorted == 0) ? "sorted" : "NOT SORTED");
+
+  for (nindex = 0;nindex < NC;nindex++)
+    MREFree(&NList[nindex].RE);
+
+  MCResFree(&DRes);
+
+  MUFree((char **)&NList);
+  MUFree((char **)&RList);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestREBench() */
+
+
+
+
+/**
+ * Time start priority calculation for Count idle jobs, one job at a time
+ * (MJobCalcStartPriority()) and in one batch (MJobCalcStartPriorityBatch()),
+ * and verify both give bit-identical priorities.
+ *
+ * @param Count (I) [optional, number of jobs, default 100000]
+ */
+
+int __MSysTestPrioBench(
+
+  char *Count)
+
+  {
+  mjob_t  **JList;
+  mjob_t   *J;
+  mreq_t   *RList;
+
+  mgcred_t *UList;
+  mgcred_t *AList;
+  mqos_t   *QList;
+
+  mfsc_t   *F;
+
+  double   *Scalar;
+  double   *Batch;
+
+  int       JC;
+  int       UC = 500;
+  int       AC = 50;
+  int       QC = 8;
+
+  int       jindex;
+  int       rindex;
+  int       Mismatch = 0;
+
+  double    ScalarMS = 0.0;
+  double    BatchMS = 0.0;
+  double    MS;
+
+  struct timeval Start;
+  struct timeval End;
+
+#define __MPRIOBENCHMS ((End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0)
+
+  JC = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 100000;
+
+  if (JC < 1)
+    JC = 1;
+
+  JList  = (mjob_t **)MUCalloc(JC + 1,sizeof(mjob_t *));
+  RList  = (mreq_t *)MUCalloc(JC,sizeof(mreq_t));
+  UList  = (mgcred_t *)MUCalloc(UC,sizeof(mgcred_t));
+  AList  = (mgcred_t *)MUCalloc(AC,sizeof(mgcred_t));
+  QList  = (mqos_t *)MUCalloc(QC,sizeof(mqos_t));
+  Scalar = (double *)MUCalloc(JC,sizeof(double));
+  Batch  = (double *)MUCalloc(JC,sizeof(double));
+
+  if ((JList == NULL) || (RList == NULL) || (UList == NULL) || (AList == NULL) ||
+      (QList == NULL) || (Scalar == NULL) || (Batch == NULL))
+    {
+    exit(1);
+    }
+
+  if (MSched.Time == 0)
+    MSched.Time = time(NULL);
+
+  srand(1);
+
+  /* service, target, credential and resource weights */
+
+  F = &MPar[0].FSC;
+
+  F->PCW[mpcServ]  = 1;
+  F->PCW[mpcTarg]  = 1;
+  F->PCW[mpcCred]  = 1;
+  F->PCW[mpcAttr]  = 1;
+  F->PCW[mpcRes]   = 1;
+
+  F->PSW[mpsSQT]   = 1;
+  F->PSW[mpsSXF]   = 100;
+  F->PSW[mpsSBP]   = 10;
+  F->PSW[mpsTQT]   = 1;
+  F->PSW[mpsTXF]   = 1;
+  F->PSW[mpsCU]    = 10;
+  F->PSW[mpsCA]    = 10;
+  F->PSW[mpsCQ]    = 100;
+  F->PSW[mpsRProc] = 5;
+  F->PSW[mpsRMem]  = 1;
+
+  F->PSC[mpsSQT]   = 10000;
+  F->PCC[mpcRes]   = 50000;
+
+  F->PSCIsActive[mpsCU] = TRUE;
+  F->PSCIsActive[mpsCA] = TRUE;
+  F->PSCIsActive[mpsCQ] = TRUE;
+
+  for (rindex = 0;rindex < UC;rindex++)
+    UList[rindex].F.Priority = rand() % 100;
+
+  for (rindex = 0;rindex < AC;rindex++)
+    AList[rindex].F.Priority = rand() % 1000;
+
+  for (rindex = 0;rindex < QC;rindex++)
+    {
+    QList[rindex].F.Priority = rindex * 100;
+    QList[rindex].QTTarget   = (rindex % 2) ? MCONST_DAYLEN : 0;
+    QList[rindex].XFTarget   = (rindex % 3) ? 0.0 : 5.0;
+    QList[rindex].QTSWeight  = (rindex == 1) ? 10 : 0;
+    }
+
+  /* idle jobs */
+
+  for (jindex = 0;jindex < JC;jindex++)
+    {
+    J = (mjob_t *)MUCalloc(1,sizeof(mjob_t));
+
+    if (J == NULL)
+      exit(1);
+
+    JList[jindex] = J;
+
+    sprintf(J->Name,"%d",jindex + 1000);
+
+    J->State = mjsIdle;
+
+    J->Credential.U = &UList[rand() % UC];
+    J->Credential.A = &AList[rand() % AC];
+    J->Credential.Q = &QList[rand() % QC];
+
+    J->SubmitTime       = MSched.Time - rand() % (7 * MCONST_DAYLEN);
+    J->EffQueueDuration = MSched.Time - J->SubmitTime;
+    J->SpecWCLimit[0]   = 60 + rand() % MCONST_DAYLEN;
+    J->WCLimit          = J->SpecWCLimit[0];
+    J->BypassCount      = rand() % 10;
+
+    J->Req[0] = &RList[jindex];
+
+    J->Req[0]->TaskCount  = 1 + rand() % 64;
+    J->Req[0]->DRes.Procs = 1;
+    J->Req[0]->DRes.Mem   = 1024 * (rand() % 8);
+
+    J->TotalProcCount = J->Req[0]->TaskCount;
+    }  /* END for (jindex) */
+
+  fprintf(stdout,"%d idle jobs\n",
+    JC);
+
+  for (rindex = 0;rindex < 3;rindex++)
+    {
+    gettimeofday(&Start,NULL);
+
+    for (jindex = 0;jindex < JC;jindex++)
+      {
+      MJobCalcStartPriority(
+        JList[jindex],
+        &MPar[0],
+        &Scalar[jindex],
+        mpdJob,
+        NULL,
+        NULL,
+        mfmHuman,
+        FALSE);
+      }
+
+    gettimeofday(&End,NULL);
+
+    MS = __MPRIOBENCHMS;
+
+    ScalarMS = ((rindex == 0) || (MS < ScalarMS)) ? MS : ScalarMS;
+
+    gettimeofday(&Start,NULL);
+
+    MJobCalcStartPriorityBatch(JList,JC,&MPar[0],Batch);
+
+    gettimeofday(&End,NULL);
+
+    MS = __MPRIOBENCHMS;
+
+    BatchMS = ((rindex == 0) || (MS < BatchMS)) ? MS : BatchMS;
+    }  /* END for (rindex) */
+
+  for (jindex = 0;jindex < JC;jindex++)
+    {
+    if (memcmp(&Scalar[jindex],&Batch[jindex],sizeof(double)) != 0)
+      Mismatch++;
+    }
+
+  fprintf(stdout,"  scalar (MJobCalcStartPriority)     %9.2f ms  %7.3f us/job\n",
+    ScalarMS,
+    ScalarMS * 1000.0 / JC);
+
+  fprintf(stdout,"  batch (MJobCalcStartPriorityBatch) %9.2f ms  %7.3f us/job\n",
+    BatchMS,
+    BatchMS * 1000.0 / JC);
+
+  fprintf(stdout,"  %s\n",
+    (Mismatch == 0) ? "priorities match" : "PRIORITY MISMATCH");
+
+#undef __MPRIOBENCHMS
+
+  for (jindex = 0;jindex < JC;jindex++)
+    MUFree((char **)&JList[jindex]);
+
+  MUFree((char **)&JList);
+  MUFree((char **)&RList);
+  MUFree((char **)&UList);
+  MUFree((char **)&AList);
+  MUFree((char **)&QList);
+  MUFree((char **)&Scalar);
+  MUFree((char **)&Batch);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestPrioBench() */
+
+
+
+
+/**
+ * Free a job list created by __MSysTestPrioQBenchJobs().
+ *
+ * @param JList (I) [freed]
+ */
+
+static int __MSysTestPrioQBenchFree(
+
+  mjob_t **JList)
+
+  {
+  int jindex;
+
+  for (jindex = 0;JList[jindex] != NULL;jindex++)
+    {
+    MUFree((char **)&JList[jindex]->Req[0]);
+    MUFree((char **)&JList[jindex]);
+    }
+
+  MUFree((char **)&JList);
+
+  return(SUCCESS);
+  }  /* END __MSysTestPrioQBenchFree() */
+
+
+
+
+
+/**
+ * Configure service, target, credential and resource priority weights and
+ * create JC idle jobs with a spread of queue times, credentials and sizes,
+ * for the priority benchmarks.
+ *
+ * @see __MSysTestPrioQBenchFree()
+ *
+ * @param JC (I)
+ *
+ * @return NULL-terminated job list (alloc) or NULL
+ */
+
+static mjob_t **__MSysTestPrioQBenchJobs(
+
+  int JC)
+
+  {
+  static mgcred_t *UList = NULL;
+  static mgcred_t *AList = NULL;
+  static mqos_t   *QList = NULL;
+
+  mjob_t  **JList;
+  mjob_t   *J;
+
+  mfsc_t   *F;
+
+  int       UC = 500;
+  int       AC = 50;
+  int       QC = 8;
+
+  int       jindex;
+  int       rindex;
+
+  if (UList == NULL)
+    {
+    UList = (mgcred_t *)MUCalloc(UC,sizeof(mgcred_t));
+    AList = (mgcred_t *)MUCalloc(AC,sizeof(mgcred_t));
+    QList = (mqos_t *)MUCalloc(QC,sizeof(mqos_t));
+
+    if ((UList == NULL) || (AList == NULL) || (QList == NULL))
+      {
+      return(NULL);
+      }
+
+    for (rindex = 0;rindex < UC;rindex++)
+      UList[rindex].F.Priority = rand() % 100;
+
+    for (rindex = 0;rindex < AC;rindex++)
+      AList[rindex].F.Priority = rand() % 1000;
+
+    for (rindex = 0;rindex < QC;rindex++)
+      {
+      QList[rindex].F.Priority = rindex * 100;
+      QList[rindex].QTTarget   = (rindex % 2) ? MCONST_DAYLEN : 0;
+      QList[rindex].XFTarget   = (rindex % 3) ? 0.0 : 5.0;
+      QList[rindex].QTSWeight  = (rindex == 1) ? 10 : 0;
+      }
+    }    /* END if (UList == NULL) */
+
+  if ((JList = (mjob_t **)MUCalloc(JC + 1,sizeof(mjob_t *))) == NULL)
+    {
+    return(NULL);
+    }
+
+  if (MSched.Time == 0)
+    MSched.Time = time(NULL);
+
+  F = &MPar[0].FSC;
+
+  F->PCW[mpcServ]  = 1;
+  F->PCW[mpcTarg]  = 1;
+  F->PCW[mpcCred]  = 1;
+  F->PCW[mpcAttr]  = 1;
+  F->PCW[mpcRes]   = 1;
+
+  F->PSW[mpsSQT]   = 1;
+  F->PSW[mpsSXF]   = 100;
+  F->PSW[mpsSUPrio] = 1;
+  F->PSW[mpsSBP]   = 10;
+  F->PSW[mpsTQT]   = 1;
+  F->PSW[mpsTXF]   = 1;
+  F->PSW[mpsCU]    = 10;
+  F->PSW[mpsCA]    = 10;
+  F->PSW[mpsCQ]    = 100;
+  F->PSW[mpsRProc] = 5;
+  F->PSW[mpsRMem]  = 1;
+
+  F->PSC[mpsSQT]   = 10000;
+  F->PCC[mpcRes]   = 50000;
+
+  F->PSCIsActive[mpsCU] = TRUE;
+  F->PSCIsActive[mpsCA] = TRUE;
+  F->PSCIsActive[mpsCQ] = TRUE;
+
+  for (jindex = 0;jindex < JC;jindex++)
+    {
+    J = (mjob_t *)MUCalloc(1,sizeof(mjob_t));
+
+    if (J == NULL)
+      break;
+
+    JList[jindex] = J;
+
+    sprintf(J->Name,"%d",jindex + 1000);
+
+    J->State = mjsIdle;
+
+    J->Credential.U = &UList[rand() % UC];
+    J->Credential.A = &AList[rand() % AC];
+    J->Credential.Q = &QList[rand() % QC];
+
+    J->SubmitTime       = MSched.Time - rand() % (7 * MCONST_DAYLEN);
+    J->EffQueueDuration = MSched.Time - J->SubmitTime;
+    J->SpecWCLimit[0]   = 60 + rand() % MCONST_DAYLEN;
+    J->WCLimit          = J->SpecWCLimit[0];
+    J->BypassCount      = rand() % 10;
+
+    if ((J->Req[0] = (mreq_t *)MUCalloc(1,sizeof(mreq_t))) == NULL)
+      break;
+
+    J->Req[0]->TaskCount  = 1 + rand() % 64;
+    J->Req[0]->DRes.Procs = 1;
+    J->Req[0]->DRes.Mem   = 1024 * (rand() % 8);
+
+    J->TotalProcCount = J->Req[0]->TaskCount;
+    }  /* END for (jindex) */
+
+  if (jindex < JC)
+    {
+    __MSysTestPrioQBenchFree(JList);
+
+    return(NULL);
+    }
+
+  return(JList);
+  }  /* END __MSysTestPrioQBenchJobs() */
+
+
+
+
+/**
+ * Time re-prioritizing an idle queue over successive scheduling iterations,
+ * comparing a full qsort() of the queue with MQueueStartPrioComp() against
+ * MQueueSortStartPrio() starting from the previous iteration's order, and
+ * verify both give the same order.
+ *
+ * Each iteration advances the clock 30 seconds and changes the user priority
+ * of 1% of the jobs before re-scoring all jobs.
+ *
+ * @param Count (I) [optional, number of jobs, default 10000, 100000 and 500000]
+ */
+
+int __MSysTestPrioQBench(
+
+  char *Count)
+
+  {
+  mjob_t  **JList;
+  mjob_t  **Full;
+  mjob_t  **Prev;
+
+  double   *Prio;
+
+  int       Size[] = { 10000, 100000, 500000, 0 };
+
+  int       JC;
+  int       sindex;
+  int       iindex;
+  int       jindex;
+  int       Mismatch;
+
+  int       IterCount = 10;
+
+  double    ScoreMS;
+  double    FullMS;
+  double    IncrMS;
+
+  struct timeval Start;
+  struct timeval End;
+
+#define __MPRIOBENCHMS ((End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0)
+
+  if ((Count != NULL) && (Count[0] != '\0'))
+    {
+    Size[0] = MAX(2,(int)strtol(Count,NULL,10));
+    Size[1] = 0;
+    }
+
+  for (sindex = 0;Size[sindex] > 0;sindex++)
+    {
+    JC = Size[sindex];
+
+    srand(1);
+
+    JList = __MSysTestPrioQBenchJobs(JC);
+    Full  = (mjob_t **)MUCalloc(JC,sizeof(mjob_t *));
+    Prev  = (mjob_t **)MUCalloc(JC,sizeof(mjob_t *));
+    Prio  = (double *)MUCalloc(JC,sizeof(double));
+
+    if ((JList == NULL) || (Full == NULL) || (Prev == NULL) || (Prio == NULL))
+      {
+      exit(1);
+      }
+
+    /* initial order */
+
+    MJobCalcStartPriorityBatch(JList,JC,&MPar[0],Prio);
+
+    for (jindex = 0;jindex < JC;jindex++)
+      {
+      JList[jindex]->CurrentStartPriority = (long)Prio[jindex];
+
+      Prev[jindex] = JList[jindex];
+      }
+
+    qsort(
+      (void *)&Prev[0],
+      JC,
+      sizeof(Prev[0]),
+      (int(*)(const void *,const void *))MQueueStartPrioComp);
+
+    ScoreMS  = 0.0;
+    FullMS   = 0.0;
+    IncrMS   = 0.0;
+    Mismatch = 0;
+
+    for (iindex = 0;iindex < IterCount;iindex++)
+      {
+      MSched.Time += 30;
+
+      for (jindex = 0;jindex < JC / 100;jindex++)
+        JList[rand() % JC]->UPriority = rand() % 1000;
+
+      gettimeofday(&Start,NULL);
+
+      MJobCalcStartPriorityBatch(JList,JC,&MPar[0],Prio);
+
+      for (jindex = 0;jindex < JC;jindex++)
+        JList[jindex]->CurrentStartPriority = (long)Prio[jindex];
+
+      gettimeofday(&End,NULL);
+
+      ScoreMS += __MPRIOBENCHMS;
+
+      /* full sort from job table order */
+
+      memcpy(Full,JList,sizeof(mjob_t *) * JC);
+
+      gettimeofday(&Start,NULL);
+
+      qsort(
+        (void *)&Full[0],
+        JC,
+        sizeof(Full[0]),
+        (int(*)(const void *,const void *))MQueueStartPrioComp);
+
+      gettimeofday(&End,NULL);
+
+      FullMS += __MPRIOBENCHMS;
+
+      /* incremental sort from the previous order (what MQueuePrioritizeJobs()
+         restores from the previous order of the same list) */
+
+      gettimeofday(&Start,NULL);
+
+      MQueueSortStartPrio(Prev,JC);
+
+      gettimeofday(&End,NULL);
+
+      IncrMS += __MPRIOBENCHMS;
+
+      if (memcmp(Full,Prev,sizeof(mjob_t *) * JC) != 0)
+        Mismatch++;
+      }  /* END for (iindex) */
+
+    fprintf(stdout,"%d idle jobs, %d iterations\n",
+      JC,
+      IterCount);
+
+    fprintf(stdout,"  re-score (MJobCalcStartPriorityBatch)  %9.2f ms/iteration\n",
+      ScoreMS / IterCount);
+
+    fprintf(stdout,"  full sort (qsort)                      %9.2f ms/iteration\n",
+      FullMS / IterCount);
+
+    fprintf(stdout,"  incremental sort (MQueueSortStartPrio) %9.2f ms/iteration\n",
+      IncrMS / IterCount);
+
+    fprintf(stdout,"  %s\n",
+      (Mismatch == 0) ? "order matches" : "ORDER MISMATCH");
+
+    __MSysTestPrioQBenchFree(JList);
+
+    MUFree((char **)&Full);
+    MUFree((char **)&Prev);
+    MUFree((char **)&Prio);
+    }    /* END for (sindex) */
+
+#undef __MPRIOBENCHMS
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestPrioQBench() */
+
+
+
+
+
+/* one greedy backfill trial search for __MSysTestBFSnapBench() */
+
+typedef struct mtestbfsnap_t {
+  const mnl_t *Window;     /* backfill window */
+  const int   *Need;       /* nodes needed by each candidate job */
+  int          JC;         /* candidate jobs */
+  int          Offset;     /* first candidate (varies the search per strategy) */
+  int          Capacity;   /* nodes the schedule may use */
+  int          MaxSchedules;
+  mbool_t      UseSnap;    /* FALSE - reserve by changing live node state */
+
+  int          BestValue;  /* O */
+  unsigned long Checksum;  /* O - identifies the best schedule */
+  } mtestbfsnap_t;
+
+
+
+/**
+ * Pick the first Need idle nodes of W into NL, skipping nodes in a state
+ * other than idle the way MJobGetINL() does.
+ */
+
+static int __MSysTestBFSnapSelect(
+
+  const mnl_t *W,
+  int          Need,
+  mnl_t       *NL)
+
+  {
+  int nindex;
+  int sindex = 0;
+
+  mnode_t *N;
+
+  for (nindex = 0;MNLGetNodeAtIndex(W,nindex,&N) == SUCCESS;nindex++)
+    {
+    if (N->State != mnsIdle)
+      continue;
+
+    MNLSetNodeAtIndex(NL,sindex,N);
+    MNLSetTCAtIndex(NL,sindex,1);
+
+    if (++sindex >= Need)
+      break;
+    }
+
+  MNLTerminateAtIndex(NL,sindex);
+
+  return((sindex >= Need) ? SUCCESS : FAILURE);
+  }  /* END __MSysTestBFSnapSelect() */
+
+
+
+
+/**
+ * Run the MBFGreedy() search over B->Window, either saving, marking and
+ * restoring live node state (the way MBFGreedy() did before) or against
+ * an MBFSnapInit() snapshot.
+ *
+ * @param Arg (I/O) [mtestbfsnap_t *]
+ */
+
+static void *__MSysTestBFSnapTrial(
+
+  void *Arg)
+
+  {
+  mtestbfsnap_t *B = (mtestbfsnap_t *)Arg;
+
+  mbfsnap_t      Snap;
+
+  enum MNodeStateEnum *NSList = NULL;
+
+  mnl_t         *NL;
+  int           *List;
+
+  mnode_t       *N;
+
+  int            sindex = 0;
+  int            scount = 0;
+  int            jindex;
+  int            nindex;
+  int            index;
+  int            StartIndex = 0;
+  int            SPC = 0;
+  int            J;
+
+  unsigned long  Sum;
+
+  B->BestValue = 0;
+  B->Checksum  = 0;
+
+  NL   = (mnl_t *)MUCalloc(B->JC,sizeof(mnl_t));
+  List = (int *)MUCalloc(B->JC,sizeof(int));
+
+  if ((NL == NULL) || (List == NULL))
+    {
+    exit(1);
+    }
+
+  for (jindex = 0;jindex < B->JC;jindex++)
+    MNLInit(&NL[jindex]);
+
+  if (B->UseSnap == TRUE)
+    {
+    MBFSnapInit(&Snap,B->Window);
+    }
+  else
+    {
+    NSList = (enum MNodeStateEnum *)MUCalloc(1,sizeof(enum MNodeStateEnum) * MSched.M[mxoNode]);
+
+    for (nindex = 0;nindex < MSched.M[mxoNode];nindex++)
+      NSList[nindex] = (MNode[nindex] != NULL) ? MNode[nindex]->State : mnsNONE;
+    }
+
+  while (scount++ < B->MaxSchedules)
+    {
+    for (jindex = StartIndex;jindex < B->JC;jindex++)
+      {
+      J = (jindex + B->Offset) % B->JC;
+
+      if (SPC + B->Need[J] > B->Capacity)
+        continue;
+
+      if (__MSysTestBFSnapSelect(
+            (B->UseSnap == TRUE) ? MBFSnapGetNL(&Snap) : B->Window,
+            B->Need[J],
+            &NL[sindex]) == FAILURE)
+        continue;
+
+      if (B->UseSnap == TRUE)
+        {
+        MBFSnapReserve(&Snap,&NL[sindex]);
+        }
+      else
+        {
+        for (nindex = 0;MNLGetNodeAtIndex(&NL[sindex],nindex,&N) == SUCCESS;nindex++)
+          N->State = mnsReserved;
+        }
+
+      List[sindex++] = jindex;
+
+      SPC += B->Need[J];
+      }  /* END for (jindex) */
+
+    if (SPC > B->BestValue)
+      {
+      B->BestValue = SPC;
+
+      Sum = 0;
+
+      for (index = 0;index < sindex;index++)
+        {
+        for (nindex = 0;MNLGetNodeAtIndex(&NL[index],nindex,&N) == SUCCESS;nindex++)
+          Sum = Sum * 31 + N->Index;
+        }
+
+      B->Checksum = Sum;
+      }
+
+    if (sindex == 0)
+      break;
+
+    /* backtrack */
+
+    sindex--;
+
+    SPC -= B->Need[(List[sindex] + B->Offset) % B->JC];
+
+    if (B->UseSnap == TRUE)
+      {
+      MBFSnapRelease(&Snap,&NL[sindex]);
+      }
+    else
+      {
+      for (nindex = 0;MNLGetNodeAtIndex(&NL[sindex],nindex,&N) == SUCCESS;nindex++)
+        N->State = NSList[N->Index];
+      }
+
+    StartIndex = List[sindex] + 1;
+    }    /* END while (scount++ < B->MaxSchedules) */
+
+  if (B->UseSnap == TRUE)
+    {
+    MBFSnapFree(&Snap);
+    }
+  else
+    {
+    for (nindex = 0;nindex < MSched.M[mxoNode];nindex++)
+      {
+      if (MNode[nindex] != NULL)
+        MNode[nindex]->State = NSList[nindex];
+      }
+
+    MUFree((char **)&NSList);
+    }
+
+  for (jindex = 0;jindex < B->JC;jindex++)
+    MNLFree(&NL[jindex]);
+
+  MUFree((char **)&NL);
+  MUFree((char **)&List);
+
+  return(NULL);
+  }  /* END __MSysTestBFSnapTrial() */
+
+
+
+
+/**
+ * Time greedy backfill trial searches on a synthetic cluster, reserving
+ * nodes through live node state (the way MBFGreedy() did before) and
+ * through an MBFSnapInit() snapshot, then run several differently ordered
+ * searches (strategies) against snapshots of the same window serially and
+ * in parallel threads.  Verifies that all modes find the same schedules
+ * and that live node state is never changed by the snapshot searches.
+ *
+ * @param Count (I) [optional, node count, default 20000]
+ */
+
+int __MSysTestBFSnapBench(
+
+  char *Count)
+
+  {
+  mtestbfsnap_t B[4];
+
+  mnode_t *N;
+
+  mnl_t    Window;
+
+  int      Need[100];  /* MBFGreedy() considers up to 100 jobs */
+
+  int      NCount;
+  int      WCount = 0;
+  int      nindex;
+  int      jindex;
+  int      rindex;
+  int      tindex;
+  int      Changed = 0;
+  int      Mismatch = 0;
+
+  int      TC = 4;
+  int      RCount = 20;
+
+  unsigned long Checksum[4];
+
+  double   LiveMS;
+  double   SnapMS;
+  double   SerialMS;
+  double   ParallelMS;
+
+  struct timeval Start;
+  struct timeval End;
+
+  char     NName[MMAX_NAME];
+
+#ifndef __NOMCOMMTHREAD
+  pthread_t Thread[4];
+#endif /* !__NOMCOMMTHREAD */
+
+#define __MBFSNAPBENCHMS ((End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0)
+
+  NCount = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 20000;
+
+  NCount = MIN(NCount,MSched.M[mxoNode] - 1);
+
+  srand(1);
+
+  /* one node in 8 is idle and in the backfill window */
+
+  MNLInit(&Window);
+
+  for (nindex = 0;nindex < NCount;nindex++)
+    {
+    snprintf(NName,sizeof(NName),"bfsnap%05d",nindex);
+
+    if (MNodeAdd(NName,&N) == FAILURE)
+      break;
+
+    N->CRes.Procs = 1;
+    N->State      = ((nindex % 8) == 0) ? mnsIdle : mnsBusy;
+    N->EState     = N->State;
+
+    if (N->State == mnsIdle)
+      {
+      MNLSetNodeAtIndex(&Window,WCount,N);
+      MNLSetTCAtIndex(&Window,WCount,1);
+
+      WCount++;
+      }
+    }    /* END for (nindex) */
+
+  NCount = nindex;
+
+  MNLTerminateAtIndex(&Window,WCount);
+
+  for (jindex = 0;jindex < 100;jindex++)
+    Need[jindex] = 1 + rand() % 64;
+
+  for (tindex = 0;tindex < TC;tindex++)
+    {
+    B[tindex].Window       = &Window;
+    B[tindex].Need         = Need;
+    B[tindex].JC           = 100;
+    B[tindex].Offset       = tindex * 25;
+    B[tindex].Capacity     = WCount - 1;
+    B[tindex].MaxSchedules = 1000;
+    }
+
+  fprintf(stdout,"%d nodes, %d in backfill window, %d candidate jobs, %d schedules per search\n",
+    NCount,
+    WCount,
+    B[0].JC,
+    B[0].MaxSchedules);
+
+  /* one search, live node state vs snapshot */
+
+  LiveMS = 0.0;
+  SnapMS = 0.0;
+
+  for (rindex = 0;rindex < RCount;rindex++)
+    {
+    B[0].UseSnap = FALSE;
+
+    gettimeofday(&Start,NULL);
+
+    __MSysTestBFSnapTrial(&B[0]);
+
+    gettimeofday(&End,NULL);
+
+    LiveMS += __MBFSNAPBENCHMS;
+
+    Checksum[0] = B[0].Checksum;
+
+    B[0].UseSnap = TRUE;
+
+    gettimeofday(&Start,NULL);
+
+    __MSysTestBFSnapTrial(&B[0]);
+
+    gettimeofday(&End,NULL);
+
+    SnapMS += __MBFSNAPBENCHMS;
+
+    if (B[0].Checksum != Checksum[0])
+      Mismatch++;
+    }  /* END for (rindex) */
+
+  fprintf(stdout,"  live node state (store/reserve/restore) %9.3f ms/search\n",
+    LiveMS / RCount);
+
+  fprintf(stdout,"  snapshot (MBFSnap*)                     %9.3f ms/search\n",
+    SnapMS / RCount);
+
+  /* several strategies against snapshots of the same window */
+
+  SerialMS   = 0.0;
+  ParallelMS = 0.0;
+
+  for (rindex = 0;rindex < RCount;rindex++)
+    {
+    gettimeofday(&Start,NULL);
+
+    for (tindex = 0;tindex < TC;tindex++)
+      {
+      B[tindex].UseSnap = TRUE;
+
+      __MSysTestBFSnapTrial(&B[tindex]);
+
+      Checksum[tindex] = B[tindex].Checksum;
+      }
+
+    gettimeofday(&End,NULL);
+
+    SerialMS += __MBFSNAPBENCHMS;
+
+    gettimeofday(&Start,NULL);
+
+#ifndef __NOMCOMMTHREAD
+    for (tindex = 1;tindex < TC;tindex++)
+      pthread_create(&Thread[tindex],NULL,__MSysTestBFSnapTrial,(void *)&B[tindex]);
+
+    __MSysTestBFSnapTrial(&B[0]);
+
+    for (tindex = 1;tindex < TC;tindex++)
+      pthread_join(Thread[tindex],NULL);
+#else
+    for (tindex = 0;tindex < TC;tindex++)
+      __MSysTestBFSnapTrial(&B[tindex]);
+#endif /* !__NOMCOMMTHREAD */
+
+    gettimeofday(&End,NULL);
+
+    ParallelMS += __MBFSNAPBENCHMS;
+
+    for (tindex = 0;tindex < TC;tindex++)
+      {
+      if (B[tindex].Checksum != Checksum[tindex])
+        Mismatch++;
+      }
+    }    /* END for (rindex) */
+
+  fprintf(stdout,"  %d strategies, serial                   %9.3f ms\n",
+    TC,
+    SerialMS / RCount);
+
+  fprintf(stdout,"  %d strategies, %d threads               %9.3f ms\n",
+    TC,
+    TC,
+    ParallelMS / RCount);
+
+  for (nindex = 0;MNLGetNodeAtIndex(&Window,nindex,&N) == SUCCESS;nindex++)
+    {
+    if (N->State != mnsIdle)
+      Changed++;
+    }
+
+  fprintf(stdout,"  %s, %s\n",
+    (Mismatch == 0) ? "schedules match" : "SCHEDULE MISMATCH",
+    (Changed == 0) ? "node state unchanged" : "NODE STATE CHANGED");
+
+#undef __MBFSNAPBENCHMS
+
+  MNLFree(&Window);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestBFSnapBench() */
+
+
+
+
+#ifndef MDISABLESQLITE
+
+/**
+ * Create a scratch SQLite3 database for __MSysTestDBWriteBench() that 
+ * passes MSQLite3Connect()'s table check.  The Jobs and Requests columns
+ * are taken from the statements MDBWriteJobs() inserts with.
+ *
+ * @param DBFile (I)
+ */
+
+static int __MSysTestDBWriteBenchCreate(
+
+  char *DBFile)
+
+  {
+  const char *Table[] = {
+    "GeneralStats",
+    "GenericMetrics",
+    "Moab",
+    "NodeStats",
+    "NodeStatsGenericResources",
+    "ObjectType",
+    "mcheckpoint",
+    "Events",
+    NULL };
+
+  const char *Insert[] = {
+    MDBInsertJobStmtText,
+    MDBInsertRequestStmtText,
+    NULL };
+
+  const char *Head;
+  const char *Tail;
+
+  sqlite3 *DB;
+
+  char  SQL[MMAX_BUFFER];
+
+  int   tindex;
+  int   rc;
+
+  if (sqlite3_open(DBFile,&DB) != SQLITE_OK)
+    {
+    sqlite3_close(DB);
+
+    return(FAILURE);
+    }
+
+  rc = SQLITE_OK;
+
+  for (tindex = 0;(rc == SQLITE_OK) && (Table[tindex] != NULL);tindex++)
+    {
+    snprintf(SQL,sizeof(SQL),"CREATE TABLE %s (ID);",
+      Table[tindex]);
+
+    rc = sqlite3_exec(DB,SQL,NULL,NULL,NULL);
+    }
+
+  /* "INSERT INTO <Table> (<Columns>) VALUES (...);" */
+
+  for (tindex = 0;(rc == SQLITE_OK) && (Insert[tindex] != NULL);tindex++)
+    {
+    Head = strchr(Insert[tindex],'(');
+    Tail = strchr(Insert[tindex],')');
+
+    snprintf(SQL,sizeof(SQL),"CREATE TABLE %.*s%.*s);",
+      (int)(Head - Insert[tindex] - strlen("INSERT INTO ")),
+      Insert[tindex] + strlen("INSERT INTO "),
+      (int)(Tail - Head),
+      Head);
+
+    rc = sqlite3_exec(DB,SQL,NULL,NULL,NULL);
+    }
+
+  /* the per-row deletes look jobs and requests up by job id */
+
+  if (rc == SQLITE_OK)
+    {
+    rc = sqlite3_exec(DB,
+      "CREATE UNIQUE INDEX JobsByID ON Jobs (ID);"
+      "CREATE INDEX RequestsByJobID ON Requests (JobID);",
+      NULL,NULL,NULL);
+    }
+
+  sqlite3_close(DB);
+
+  return((rc == SQLITE_OK) ? SUCCESS : FAILURE);
+  }  /* END __MSysTestDBWriteBenchCreate() */
+
+
+
+
+/**
+ * Return the number of rows in Table of DBFile, -1 on error.
+ *
+ * @param DBFile (I)
+ * @param Table  (I)
+ */
+
+static int __MSysTestDBWriteBenchRows(
+
+  char       *DBFile,
+  const char *Table)
+
+  {
+  sqlite3      *DB;
+  sqlite3_stmt *Stmt = NULL;
+
+  char  SQL[MMAX_LINE];
+
+  int   Rows = -1;
+
+  if (sqlite3_open(DBFile,&DB) == SQLITE_OK)
+    {
+    snprintf(SQL,sizeof(SQL),"SELECT COUNT(*) FROM %s;",
+      Table);
+
+    if ((sqlite3_prepare_v2(DB,SQL,-1,&Stmt,NULL) == SQLITE_OK) &&
+        (sqlite3_step(Stmt) == SQLITE_ROW))
+      {
+      Rows = sqlite3_column_int(Stmt,0);
+      }
+
+    sqlite3_finalize(Stmt);
+    }
+
+  sqlite3_close(DB);
+
+  return(Rows);
+  }  /* END __MSysTestDBWriteBenchRows() */
+
+#endif /* !MDISABLESQLITE */
+
+
+
+
+/**
+ * Write Count job transitions (one req each) for 1000 distinct jobs to a
+ * scratch SQLite3 file in /tmp through MDBWriteJobs(), 500 transitions
+ * per scheduling iteration.  Compares committing every row (what the
+ * transition thread did before MDBWriteObjectsWithRetry() batched its
+ * writes) with one transaction per iteration, each with the rollback 
+ * journal and with DBWALMODE.  Row-by-row commits only write Count/100
+ * transitions, they sync the file several times per transition.
+ *
+ * @param Count (I) [optional, transitions, default 100000]
+ */
+
+int __MSysTestDBWriteBench(
+
+  char *Count)
+
+  {
+#ifndef MDISABLESQLITE
+  mdb_t MDB;
+
+  mtransjob_t  *J[1000];
+  mtransjob_t  *List[500 + 1];
+  mtransjob_t  *T;
+
+  enum MStatusCodeEnum SC;
+
+  int   TCount;
+  int   WCount;
+  int   jindex;
+  int   tindex;
+  int   mode;
+  int   BatchSize;
+  int   JRows;
+  int   RRows;
+
+  int   JCount = 1000;
+  int   ICount = 500;
+
+  char  DBFile[MMAX_PATH_LEN];
+  char  tmpPath[MMAX_PATH_LEN];
+  char  EMsg[MMAX_LINE];
+  char  tmpLine[MMAX_NAME];
+
+  double Elapsed;
+
+  struct timeval Start;
+  struct timeval End;
+
+  TCount = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 100000;
+
+  TCount = MAX(TCount,1);
+
+  snprintf(DBFile,sizeof(DBFile),"/tmp/moab.dbwritebench.%d.db",
+    (int)getpid());
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    {
+    MJobTransitionAllocate(&J[jindex]);
+
+    T = J[jindex];
+
+    snprintf(T->Name,sizeof(T->Name),"Moab.%d",
+      jindex + 1);
+
+    snprintf(tmpLine,sizeof(tmpLine),"user%02d",
+      jindex % 50);
+
+    MUStrDup(&T->User,tmpLine);
+    MUStrDup(&T->Group,"users");
+    MUStrDup(&T->Account,"research");
+    MUStrDup(&T->Class,"batch");
+    MUStrDup(&T->QOS,"normal");
+    MUStrDup(&T->SourceRMJobID,T->Name);
+
+    T->SubmitTime           = MSched.Time - jindex;
+    T->RequestedMaxWalltime = 3600;
+    T->MaxProcessorCount    = 1 + (jindex % 16);
+    T->RequestedNodes       = 1;
+
+    MReqTransitionAllocate(&T->Requirements[0]);
+
+    MUStrCpy(T->Requirements[0]->JobID,T->Name,sizeof(T->Requirements[0]->JobID));
+
+    T->Requirements[0]->TaskCount    = T->MaxProcessorCount;
+    T->Requirements[0]->MinNodeCount = 1;
+    T->Requirements[0]->ProcsPerTask = 1;
+    }  /* END for (jindex) */
+
+  bmset(&MSched.RealTimeDBObjects,mxoJob);
+
+  fprintf(stdout,"transitions=%d  jobs=%d  transitions/iteration=%d\n",
+    TCount,
+    JCount,
+    ICount);
+
+  fprintf(stdout,"%-8s %-10s %12s %12s %14s  %s\n",
+    "journal",
+    "commit",
+    "transitions",
+    "ms",
+    "transitions/s",
+    "rows");
+
+  /* mode bit 0 - DBWALMODE, mode bit 1 - one transaction per iteration */
+
+  for (mode = 0;mode < 4;mode++)
+    {
+    WCount = (mode & 2) ? TCount : MAX(TCount / 100,1);
+
+    MFURemove(DBFile);
+
+    if (__MSysTestDBWriteBenchCreate(DBFile) == FAILURE)
+      {
+      fprintf(stderr,"ERROR:    cannot create database '%s'\n",
+        DBFile);
+
+      exit(1);
+      }
+
+    MSched.DBWALMode = (mode & 1) ? TRUE : FALSE;
+
+    memset(&MDB,0,sizeof(MDB));
+
+    EMsg[0] = '\0';
+
+    if ((MSQLite3Initialize(&MDB,DBFile) == FAILURE) ||
+        (MDBConnect(&MDB,EMsg) == FAILURE))
+      {
+      fprintf(stderr,"ERROR:    cannot connect to database '%s' - %s\n",
+        DBFile,
+        EMsg);
+
+      exit(1);
+      }
+
+    gettimeofday(&Start,NULL);
+
+    for (tindex = 0;tindex < WCount;tindex += BatchSize)
+      {
+      BatchSize = MIN(ICount,WCount - tindex);
+
+      for (jindex = 0;jindex < BatchSize;jindex++)
+        {
+        T = J[(tindex + jindex) % JCount];
+
+        /* every pass over the jobs moves them to their next state */
+
+        T->State = ((tindex + jindex) / JCount % 2) ? mjsRunning : mjsIdle;
+        T->StartTime = (T->State == mjsRunning) ? MSched.Time : 0;
+
+        List[jindex] = T;
+        }
+
+      List[BatchSize] = NULL;
+
+      if (mode & 2)
+        MDBWriteObjectsWithRetry(&MDB,(void **)List,mxoJob,NULL);
+      else
+        MDBWriteJobs(&MDB,List,NULL,&SC);
+      }  /* END for (tindex) */
+
+    gettimeofday(&End,NULL);
+
+    MDBFree(&MDB);
+
+    Elapsed = (End.tv_sec - Start.tv_sec) * 1000.0 + (End.tv_usec - Start.tv_usec) / 1000.0;
+
+    JRows = __MSysTestDBWriteBenchRows(DBFile,"Jobs");
+    RRows = __MSysTestDBWriteBenchRows(DBFile,"Requests");
+
+    fprintf(stdout,"%-8s %-10s %12d %12.1f %14.0f  %s\n",
+      (mode & 1) ? "wal" : "delete",
+      (mode & 2) ? "iteration" : "row",
+      WCount,
+      Elapsed,
+      WCount * 1000.0 / MAX(Elapsed,0.001),
+      ((JRows == MIN(WCount,JCount)) && (RRows == JRows)) ? "ok" : "ROW COUNT MISMATCH");
+    }    /* END for (mode) */
+
+  MFURemove(DBFile);
+
+  snprintf(tmpPath,sizeof(tmpPath),"%s-wal",
+    DBFile);
+
+  MFURemove(tmpPath);
+
+  snprintf(tmpPath,sizeof(tmpPath),"%s-shm",
+    DBFile);
+
+  MFURemove(tmpPath);
+
+  for (jindex = 0;jindex < JCount;jindex++)
+    {
+    MJobTransitionFree((void **)&J[jindex]);
+    }
+#else /* !MDISABLESQLITE */
+  fprintf(stderr,"ERROR:    moab was not built with SQLite3\n");
+#endif /* !MDISABLESQLITE */
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestDBWriteBench() */
+
+
+
+
+/**
+ * Time MNodeSelectIdleTasks() over a synthetic cluster with serial and with
+ * parallel (NODESELECTTHREADS) feasibility evaluation, and verify that both
+ * produce the same node list, task/node counts, rejection counts and node
+ * map.  Nodes are a mix of idle, partially used, full, down and memory-short
+ * nodes so every MReqCheckNRes() outcome is exercised;  the second pass
+ * marks the job as a reservation so all nodes are rejected for affinity.
+ * Reports the best of 5 runs of each mode.
+ *
+ * @param Count (I) [optional, node count, default 50000]
+ */
+
+int __MSysTestNodeSelectBench(
+
+  char *Count)
+
+  {
+  mjob_t  *J = NULL;
+  mnode_t *N;
+
+  mnl_t    FNL;
+  mnl_t   *SMNL[MMAX_REQ_PER_JOB];
+  mnl_t   *PMNL[MMAX_REQ_PER_JOB];
+
+  char    *SMap;
+  char    *PMap;
+
+  int      SRej[MMAX_REQ_PER_JOB][marLAST];
+  int      PRej[MMAX_REQ_PER_JOB][marLAST];
+
+  int      NCount;
+  int      nindex;
+  int      pindex;
+  int      rindex;
+  int      STC;
+  int      SNC;
+  int      PTC;
+  int      PNC;
+  int      Threads;
+  int      Differs;
+
+  mnode_t *SN;
+  mnode_t *PN;
+
+  struct timeval Start;
+  struct timeval End;
+
+  double   Elapsed;
+  double   SBest;
+  double   PBest;
+
+  char     NName[MMAX_NAME];
+
+  const int Runs = 5;
+
+  NCount = ((Count != NULL) && (Count[0] != '\0')) ? (int)strtol(Count,NULL,10) : 50000;
+
+  NCount = MIN(NCount,MSched.M[mxoNode] - 1);
+
+  Threads = (MSched.NodeSelectThreads > 1) ? MSched.NodeSelectThreads : MMAX_NODESELECTTHREADS / 4;
+
+  MNLInit(&FNL);
+
+  for (nindex = 0;nindex < NCount;nindex++)
+    {
+    snprintf(NName,sizeof(NName),"bench%05d",nindex);
+
+    if (MNodeAdd(NName,&N) == FAILURE)
+      break;
+
+    N->State      = mnsIdle;
+    N->EState     = mnsIdle;
+    N->CRes.Procs = 8;
+    N->ARes.Procs = 8 - (nindex % 9);  /* full, partial and busy nodes */
+    N->CRes.Mem   = 4096;
+    N->ARes.Mem   = 4096;
+    N->PtIndex    = 1;
+
+    switch (nindex % 7)
+      {
+      case 3:
+
+        N->State  = mnsDown;
+        N->EState = mnsDown;
+
+        break;
+
+      case 5:
+
+        N->State  = mnsActive;
+        N->EState = mnsActive;
+
+        break;
+
+      case 6:
+
+        N->ARes.Mem = 256;
+
+        break;
+
+      default:
+
+        /* NO-OP */
+
+        break;
+      }  /* END switch (nindex % 7) */
+
+    N->DRes.Procs = N->CRes.Procs - N->ARes.Procs;
+    N->DRes.Mem   = N->CRes.Mem - N->ARes.Mem;
+
+    MNLSetNodeAtIndex(&FNL,nindex,N);
+    MNLSetTCAtIndex(&FNL,nindex,N->CRes.Procs);
+    }
+
+  NCount = nindex;
+
+  MNLTerminateAtIndex(&FNL,NCount);
+
+  MJobMakeTemp(&J);
+
+  J->Request.TC = NCount * 4;
+  J->Req[0]->TaskCount    = NCount * 4;
+  J->Req[0]->TasksPerNode = 2;
+  J->Req[0]->DRes.Mem     = 512;
+
+  SMap = (char *)MUCalloc(MSched.M[mxoNode],sizeof(char));
+  PMap = (char *)MUCalloc(MSched.M[mxoNode],sizeof(char));
+
+  MNLMultiInit(SMNL);
+  MNLMultiInit(PMNL);
+
+  fprintf(stdout,"%7s %8s %12s %8s %12s %8s %8s %10s\n",
+    "nodes",
+    "job",
+    "serial(ms)",
+    "threads",
+    "parallel(ms)",
+    "TC",
+    "NC",
+    "result");
+
+  for (pindex = 0;pindex < 2;pindex++)
+    {
+    if (pindex == 1)
+      bmset(&J->Flags,mjfAdvRsv);
+
+    SBest = -1.0;
+    PBest = -1.0;
+
+    for (rindex = 0;rindex < Runs * 2;rindex++)
+      {
+      /* alternate serial and parallel runs */
+
+      MSched.NodeSelectThreads = (rindex % 2) ? Threads : 1;
+
+      gettimeofday(&Start,NULL);
+
+      if (rindex % 2)
+        MNodeSelectIdleTasks(J,NULL,&FNL,PMNL,&PTC,&PNC,PMap,PRej);
+      else
+        MNodeSelectIdleTasks(J,NULL,&FNL,SMNL,&STC,&SNC,SMap,SRej);
+
+      gettimeofday(&End,NULL);
+
+      Elapsed = (End.tv_sec - Start.tv_sec) + (End.tv_usec - Start.tv_usec) / 1000000.0;
+
+      if (rindex % 2)
+        PBest = ((PBest < 0.0) || (Elapsed < PBest)) ? Elapsed : PBest;
+      else
+        SBest = ((SBest < 0.0) || (Elapsed < SBest)) ? Elapsed : SBest;
+      }  /* END for (rindex) */
+
+    /* compare the last serial and parallel selections */
+
+    Differs = ((STC != PTC) || (SNC != PNC));
+
+    for (nindex = 0;(Differs == FALSE) && (nindex < NCount);nindex++)
+      {
+      MNLGetNodeAtIndex(SMNL[0],nindex,&SN);
+      MNLGetNodeAtIndex(PMNL[0],nindex,&PN);
+
+      if ((SN != PN) ||
+          (MNLGetTCAtIndex(SMNL[0],nindex) != MNLGetTCAtIndex(PMNL[0],nindex)))
+        Differs = TRUE;
+
+      if (SN == NULL)
+        break;
+      }
+
+    for (rindex = 0;(Differs == FALSE) && (rindex < marLAST);rindex++)
+      {
+      if (SRej[0][rindex] != PRej[0][rindex])
+        Differs = TRUE;
+      }
+
+    if ((Differs == FALSE) && (memcmp(SMap,PMap,MSched.M[mxoNode]) != 0))
+      Differs = TRUE;
+
+    fprintf(stdout,"%7d %8s %12.3f %8d %12.3f %8d %8d %10s\n",
+      NCount,
+      (pindex == 0) ? "plain" : "advrsv",
+      SBest * 1000.0,
+      Threads,
+      PBest * 1000.0,
+      STC,
+      SNC,
+      (Differs == FALSE) ? "identical" : "DIFFERS");
+
+    fprintf(stdout,"  rejections:");
+
+    for (rindex = 0;rindex < marLAST;rindex++)
+      {
+      if (SRej[0][rindex] > 0)
+        fprintf(stdout," %s=%d",MAllocRejType[rindex],SRej[0][rindex]);
+      }
+
+    fprintf(stdout,"\n");
+    }    /* END for (pindex) */
+
+  MNLMultiFree(SMNL);
+  MNLMultiFree(PMNL);
+  MNLFree(&FNL);
+
+  MUFree(&SMap);
+  MUFree(&PMap);
+
+  MJobFreeTemp(&J);
+
+  exit(0);
+
+  /*NOTREACHED*/
+
+  return(SUCCESS);
+  }  /* END __MSysTestNodeSelectBench() */
+
+
+
+
+/**
+ * Perform internal unit testing.
+ */
+
+int MSysDoTest()
+ 
+  {
+  char *tptr;
+  char *aptr;
+  char *ptr;
+
+  int   aindex;
+  int   rc;
+
+  char  tmpLine[MMAX_LINE];
+
+  const char *TName[] = {
+    NONE,
+    "COMPRESS",
+    "SCHED",
+    "XML",
+    "RANGEAND",
+    "RANGECOLLAPSE",
+    "RANGEMERGE",
+    "GETSNRANGE",
+    "NODEPRIO",
+    "SPAWN",
+    "WIKINODE",
+    "WIKIJOB",
+    "WIKICLUSTER",
+    "RMX",
+    "JOBNAME",
+    "JOBDIST",
+    "CHECKSUM",
+    "LLSUBMIT",
+    "LLQUERY",
+    "MAIL",
+    "PBSPARSE",
+    "PBSPARSE2",
+    "NODERANGE",
+    "BGRANGE",
+    "ODBCTEST",
+    "SQLITE3TEST",
+    "STRINGTEST",
+    "RMXTEST",
+    "STATCONVTEST",
+    "GEOTEST",
+    "DISATEST",
+    "MACADDRESS",
+    "HTBENCH",
+    "HTTEST",
+    "LOGBENCH",
+    "LOGTIME",
+    "MDBBENCH",
+    "QUEUEBENCH",
+    "TPBENCH",
+    "ARENABENCH",
+    "BMBENCH",
+    "ARRAYBENCH",
+    "LLBENCH",
+    "XMLBENCH",
+    "XMLOUTBENCH",
+    "CPBENCH",
+    "REBENCH",
+    "PRIOBENCH",
+    "PRIOQBENCH",
+    "BFSNAPBENCH",
+    "DBWRITEBENCH",
+    "NODESELECTBENCH",
+    NULL };
+
+  enum {
+    mirtNONE = 0,
+    mirtCompress,
+    mirtSched,
+    mirtXML,
+    mirtRLAND,
+    mirtJobSelectFRL,
+    mirtRLMerge,
+    mirtJobGetSNRange,
+    mirtNodePrio,
+    mirtSpawn,
+    mirtWikiNode,
+    mirtWikiJob,
+    mirtWikiCluster,
+    mirtRMExtension,
+    mirtJobName,
+    mirtJobDist,
+    mirtChecksum,
+    mirtLLSubmit,
+    mirtLLQuery,
+    mirtMail,
+    mirtPBSParse,
+    mirtPBSParse2,
+    mirtNodeRange,
+    mirtBGRange,
+    mirtODBCTest,
+    mirtSQLite3Test,
+    mirtStringTest,
+    mirtRMX,
+    mirtStatConvTest,
+    mirtGeoTest,
+    mirtDisaTest,
+    mirtMacAddress,
+    mirtHTBench,
+    mirtHTTest,
+    mirtLogBench,
+    mirtLogTime,
+    mirtMDBBench,
+    mirtQueueBench,
+    mirtTPBench,
+    mirtArenaBench,
+    mirtBMBench,
+    mirtArrayBench,
+    mirtLLBench,
+    mirtXMLBench,
+    mirtXMLOutBench,
+    mirtCPBench,
+    mirtREBench,
+    mirtPrioBench,
+    mirtPrioQBench,
+    mirtBFSnapBench,
+    mirtDBWriteBench,
+    mirtNodeSelectBench,
+    mirtLAST };
+ 
+  if ((tptr = getenv(MSCHED_ENVTESTVAR)) == NULL)
+    {
+    return(SUCCESS);
+    }
+
+  MUStrCpy(tmpLine,tptr,sizeof(tmpLine));
+
+  aptr = NULL;
+
+  if ((ptr = strchr(tmpLine,':')) != NULL)
+    {
+    *ptr = '\0';
+
+    aptr = ptr + 1;
+    }
+
+  /* exact match - 'XML' must not shadow 'XMLBENCH' */
+
+  aindex = MUGetIndexCI(tmpLine,TName,FALSE,0);
+
+  fprintf(stderr,"INFO:     running test %s, data='%s'\n",
+    TName[aindex],
+    (aptr != NULL) ? aptr : "");
+
+  switch (aindex)
+    {
+    case mirtCompress:
+
+      MUCompressTest();
+
+      break;
+
+    case mirtXML:
+
+      __MSysTestXML(aptr);
+
+      break;
+
+    case mirtRLAND:
+
+      __MSysTestRLAND(); 
+
+      break;
+
+    case mirtGeoTest:
+
+      __MSysTestGeo(aptr);
+
+      break;
+
+    case mirtJobSelectFRL:
+
+      __MSysTestJobSelectFRL();
+
+      break;
+
+    case mirtRLMerge:
+ 
+      __MSysTestRLMerge(); 
+
+      break;
+
+    case mirtJobGetSNRange:
+
+      __MSysTestJobGetSNRange();
+
+      break;
+
+    case mirtMacAddress:
+
+      __MSysTestMacAddress();
+
+      break;
+
+    case mirtHTBench:
+
+      __MSysTestHTBench(aptr);
+
+      break;
+
+    case mirtHTTest:
+
+      __MSysTestHT();
+
+      break;
+
+    case mirtLogBench:
+
+      __MSysTestLogBench(aptr);
+
+      break;
+
+    case mirtLogTime:
+
+      __MSysTestLogTimeBench(aptr);
+
+      break;
+
+    case mirtMDBBench:
+
+      __MSysTestMDBBench(aptr);
+
+      break;
+
+    case mirtQueueBench:
+
+      __MSysTestQueueBench(aptr);
+
+      break;
+
+    case mirtTPBench:
+
+      __MSysTestTPBench(aptr);
+
+      break;
+
+    case mirtArenaBench:
+
+      __MSysTestArenaBench(aptr);
+
+      break;
+
+    case mirtBMBench:
+
+      __MSysTestBMBench(aptr);
+
+      break;
+
+    case mirtArrayBench:
+
+      __MSysTestArrayBench(aptr);
+
+      break;
+
+    case mirtLLBench:
+
+      __MSysTestLLBench(aptr);
+
+      break;
+
+    case mirtXMLBench:
+
+      __MSysTestXMLBench(aptr);
+
+      break;
+
+    case mirtXMLOutBench:
+
+      __MSysTestXMLOutBench(aptr);
+
+      break;
+
+    case mirtCPBench:
+
+      __MSysTestCPBench(aptr);
+
+      break;
+
+    case mirtREBench:
+
+      __MSysTestREBench(aptr);
+
+      break;
+
+    case mirtPrioBench:
+
+      __MSysTestPrioBench(aptr);
+
+      break;
+
+    case mirtPrioQBench:
+
+      __MSysTestPrioQBench(aptr);
+
+      break;
+
+    case mirtBFSnapBench:
+
+      __MSysTestBFSnapBench(aptr);
+
+      break;
+
+    case mirtDBWriteBench:
+
+      __MSysTestDBWriteBench(aptr);
+
+      break;
+
+    case mirtNodeSelectBench:
+
+      __MSysTestNodeSelectBench(aptr);
 
       break;
 
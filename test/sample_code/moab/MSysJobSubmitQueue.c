@@ -14,11 +14,12 @@
 
 
 
-/* Mutex to gate access to the MJobSumitQueue */
+/* Mutex to pair the internal RM job counter with the queue position so jobs
+   are queued in ID order (consumers do not take it - the queue is lock-free) */
 mmutex_t    MJobSubmitQueueMutex;
 
 /* Moab JobSubmitQueue */
-mdllist_t  *MJobSubmitQueue;
+mmpmcq_t   *MJobSubmitQueue;
 
 
 /**
@@ -27,7 +28,7 @@ mdllist_t  *MJobSubmitQueue;
 
 int MSysJobSubmitQueueCreate()
   {
-  MJobSubmitQueue = MUDLListCreate();
+  MJobSubmitQueue = MUMPMCQueueCreate(MDEF_JOBSUBMITQUEUESIZE);
   return(SUCCESS);
   }
 
@@ -37,7 +38,7 @@ int MSysJobSubmitQueueCreate()
 
 int MSysJobSubmitQueueFree()
   {
-  MUDLListFree(MJobSubmitQueue);
+  MUMPMCQueueFree(MJobSubmitQueue);
   return(SUCCESS);
   }
 
@@ -55,19 +56,31 @@ int MSysJobSubmitQueueMutexInit()
 /**
  * Insert a job into the submit job queue, retreive back a unique ID.
  *
+ * NOTE: does not wait for space - the scheduler thread may itself be the
+ *       caller (checkpoint journal replay) and is the queue's only consumer.
+ *
  * @param JE
  * @param ID
  * @param PopulateID - if TRUE then this routine will create a new ID and populate it to ID
  *                     if FALSE then this routine will leave ID alone and won't create a new ID
+ * @param Journal    - [optional] submit journal entry for JE, written with the new ID
+ *                     before JE is queued (requires PopulateID)
+ *
+ * @return FAILURE if the queue is full (the ID drawn for JE is not reused and
+ *         its journal entry is dropped)
  */
 
 int MSysAddJobSubmitToQueue(
 
   mjob_submit_t *JE,
   int           *ID,
-  mbool_t        PopulateID)
+  mbool_t        PopulateID,
+  mstring_t     *Journal)
 
   {
+  int JobID;
+  int rc;
+
   MDB(7,fSCHED)
     {
     mstring_t JString(MMAX_LINE);
@@ -77,28 +90,56 @@ int MSysAddJobSubmitToQueue(
     MLog("INFO:     Thread: %d, Enqueuing job with XML '%s'\n",MUGetThreadID(),JString.c_str());
     }
 
-  MUMutexLock(&MJobSubmitQueueMutex);
-
-  /* place S into queue */
+  /* place JE into queue - JE belongs to the scheduler thread once enqueued */
 
   MDB(7,fSOCK) MLog("INFO:     Thead: %d, job being enqueued\n",MUGetThreadID());
 
-  MUDLListAppend(MJobSubmitQueue,JE);
+  MSysTransactionCountAdjust(1);
 
   if (PopulateID == TRUE)
     {
-    *ID = MRMJobCounterIncrement(MSched.InternalRM);
+    /* assign the ID and take the queue slot together so queue order matches
+       ID order, and the ID is in place before JE is visible to the scheduler */
+
+    MUMutexLock(&MJobSubmitQueueMutex);
+
+    JobID = MRMJobCounterIncrement(MSched.InternalRM);
+
+    JE->ID = JobID;
+
+    /* journal JE while it still belongs to this thread - no other submit
+       can append to the journal until the mutex is released */
+
+    if (Journal != NULL)
+      MCPSubmitJournalAddEntry(Journal,JE);
+
+    rc = MUMPMCQueueEnqueue(MJobSubmitQueue,JE);
+
+    if ((rc == FAILURE) && (Journal != NULL))
+      MCPSubmitJournalDropEntry(JE);
+
+    MUMutexUnlock(&MJobSubmitQueueMutex);
+
+    if (rc == SUCCESS)
+      *ID = JobID;
+    }
+  else
+    {
+    JobID = JE->ID;
 
-    JE->ID = *ID;
+    rc = MUMPMCQueueEnqueue(MJobSubmitQueue,JE);
     }
 
-  MSched.TransactionCount++;
+  if (rc == FAILURE)
+    {
+    MSysTransactionCountAdjust(-1);
 
-  MSched.HistMaxTransactionCount = MAX(MSched.TransactionCount,MSched.HistMaxTransactionCount);
+    MDB(1,fSOCK) MLog("ALERT:    job submit queue is full - cannot enqueue job\n");
 
-  MUMutexUnlock(&MJobSubmitQueueMutex);
+    return(FAILURE);
+    }
 
-  MDB(7,fSOCK) MLog("INFO:     Thead: %d, job %d enqueued\n",MUGetThreadID(),*ID);
+  MDB(7,fSOCK) MLog("INFO:     Thead: %d, job %d enqueued\n",MUGetThreadID(),JobID);
 
   return(SUCCESS);
   }  /* END MSysAddJobSubmitToQueue() */
@@ -129,22 +170,53 @@ int MSysDequeueJobSubmit(
     return(FAILURE);
     }
 
-  if (MUDLListSize(MJobSubmitQueue) == 0)
+  if (MUMPMCQueueDequeue(MJobSubmitQueue,(void **)JS) == FAILURE)
     {
     /* queue is empty */
     
     return(FAILURE);
     }
 
-  MUMutexLock(&MJobSubmitQueueMutex);
+  MSysTransactionCountAdjust(-1);
 
-  *JS = (mjob_submit_t *)MUDLListRemoveFirst(MJobSubmitQueue);
+  return(SUCCESS);
+  }  /* END MSysDequeueJobSubmit() */
 
-  MSched.TransactionCount--;
 
-  MUMutexUnlock(&MJobSubmitQueueMutex);
 
-  return(SUCCESS);
-  }  /* END MSysDequeueJobSubmit() */
+
+
+/**
+ * Removes up to MaxCount jobs (in submit order) from the queue being shared
+ * by the communication and scheduling threads.
+ *
+ * @see MSysDequeueJobSubmit() - peer
+ *
+ * @param JSList   (O) [minsize=MaxCount]
+ * @param MaxCount (I)
+ *
+ * @return number of jobs removed (0 if the queue is empty)
+ */
+
+int MSysDequeueJobSubmitBatch(
+
+  mjob_submit_t **JSList,
+  int             MaxCount)
+
+  {
+  int count;
+
+  if (JSList == NULL)
+    {
+    return(0);
+    }
+
+  count = MUMPMCQueueDequeueBatch(MJobSubmitQueue,(void **)JSList,MaxCount);
+
+  if (count > 0)
+    MSysTransactionCountAdjust(-count);
+
+  return(count);
+  }  /* END MSysDequeueJobSubmitBatch() */
 
 /* END MSysJobSubmitQueue.c */
@@ -13,11 +13,8 @@
 #include "moab-global.h"  
 
 
-/* Mutex to gate  access to the Moab socket 'MSocketQueue' */
-mmutex_t     MSocketQueueMutex;
-
-/* Moab Socket Queue list */
-mdllist_t   *MSocketQueue;
+/* Moab Socket Queue */
+mmpmcq_t    *MSocketQueue;
 
 
 /**
@@ -26,7 +23,7 @@ mdllist_t   *MSocketQueue;
 
 int MSysSocketQueueCreate()
   {
-  MSocketQueue = MUDLListCreate();
+  MSocketQueue = MUMPMCQueueCreate(MDEF_SOCKETQUEUESIZE);
   return(SUCCESS);
   }
 
@@ -36,29 +33,51 @@ int MSysSocketQueueCreate()
 
 int MSysSocketQueueFree()
   {
-  MUDLListFree(MSocketQueue);
+  MUMPMCQueueFree(MSocketQueue);
   return(SUCCESS);
   }
 
 /**
- * initialize the mutex for the MSocketQueue
+ * Adjust MSched.TransactionCount (and the high-water mark) by Delta without
+ * taking a lock.
  *
+ * @param Delta (I)
  */
 
-int MSysSocketQueueMutexInit()
+int MSysTransactionCountAdjust(
+
+  int Delta)
+
   {
-  pthread_mutex_init(&MSocketQueueMutex,NULL);
+  int Count;
+  int HistMax;
+
+  Count = __sync_add_and_fetch(&MSched.TransactionCount,Delta);
+
+  HistMax = MSched.HistMaxTransactionCount;
+
+  while ((Count > HistMax) && 
+        (!__sync_bool_compare_and_swap(&MSched.HistMaxTransactionCount,HistMax,Count)))
+    {
+    HistMax = MSched.HistMaxTransactionCount;
+    }
+
   return(SUCCESS);
-  }
+  }  /* END MSysTransactionCountAdjust() */
+
+
 
 
 /**
  * Convienence function which adds the given socket, S, to the transaction
  * queue used between the communication and scheduling threads. This function
- * is thread safe, as it uses mutexes to lock the socket queue and
- * increases the transaction counters.
+ * is thread safe (lock-free) and increases the transaction counters.
+ *
+ * NOTE: blocks while the queue is full until the scheduler drains it.
  *
  * @param S (I)
+ *
+ * @return FAILURE if the queue is full and the caller cannot wait (non-threaded build)
  */
 
 int MSysAddSocketToQueue(
@@ -66,20 +85,22 @@ int MSysAddSocketToQueue(
   msocket_t *S)
 
   {
-  MUMutexLock(&MSocketQueueMutex);
-
   /* place S into queue */
 
   MDB(7,fSOCK) MLog("INFO:     socket '%d' being enqueued\n",
     S->sd);
 
-  MUDLListAppend(MSocketQueue,S);
+  MSysTransactionCountAdjust(1);
 
-  MSched.TransactionCount++;
+  if (MUMPMCQueueEnqueueWait(MSocketQueue,S) == FAILURE)
+    {
+    MSysTransactionCountAdjust(-1);
 
-  MSched.HistMaxTransactionCount = MAX(MSched.TransactionCount,MSched.HistMaxTransactionCount);
+    MDB(1,fSOCK) MLog("ALERT:    socket queue is full - cannot enqueue socket '%d'\n",
+      S->sd);
 
-  MUMutexUnlock(&MSocketQueueMutex);
+    return(FAILURE);
+    }
 
   return(SUCCESS);
   }  /* END MSysAddSocketToQueue() */
@@ -107,20 +128,14 @@ int MSysDequeueSocket(
     return(FAILURE);
     }
 
-  if (MUDLListSize(MSocketQueue) == 0)
+  if (MUMPMCQueueDequeue(MSocketQueue,(void **)S) == FAILURE)
     {
     /* queue is empty */
     
     return(FAILURE);
     }
 
-  MUMutexLock(&MSocketQueueMutex);
-
-  *S = (msocket_t *)MUDLListRemoveFirst(MSocketQueue);
-
-  MSched.TransactionCount--;
-
-  MUMutexUnlock(&MSocketQueueMutex);
+  MSysTransactionCountAdjust(-1);
 
   MUGetMS(NULL,(long *)&(*S)->ProcessTime);
 
@@ -130,6 +145,56 @@ int MSysDequeueSocket(
    
   return(SUCCESS);    
   }  /* END MSysDequeueSocket() */
+
+
+
+
+/**
+ * Removes up to MaxCount sockets (in arrival order) from the queue being 
+ * shared by the communication and scheduling threads.
+ *
+ * @see MSysDequeueSocket() - peer
+ *
+ * @param SList    (O) [minsize=MaxCount]
+ * @param MaxCount (I)
+ *
+ * @return number of sockets removed (0 if the queue is empty)
+ */
+
+int MSysDequeueSocketBatch(
+
+  msocket_t **SList,    /* O */
+  int         MaxCount) /* I */
+
+  {
+  int count;
+  int sindex;
+
+  if (SList == NULL)
+    {
+    return(0);
+    }
+
+  count = MUMPMCQueueDequeueBatch(MSocketQueue,(void **)SList,MaxCount);
+
+  if (count <= 0)
+    {
+    return(0);
+    }
+
+  MSysTransactionCountAdjust(-count);
+
+  for (sindex = 0;sindex < count;sindex++)
+    {
+    MUGetMS(NULL,(long *)&SList[sindex]->ProcessTime);
+
+    MDB(7,fSOCK) MLog("INFO:     socket %d being serviced after %lu milli-sec wait\n",
+      SList[sindex]->sd,
+      SList[sindex]->ProcessTime - SList[sindex]->CreateTime);
+    }
+
+  return(count);
+  }  /* END MSysDequeueSocketBatch() */
  
 
 /* END MSysSocketQueue.c */
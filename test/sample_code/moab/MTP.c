@@ -8,9 +8,13 @@
 
 /* Contains:                                    *
  *                                              *
- * int MTPCreateThreadPool()                    *
+ * int MTPAddRequest(RequestId,FunctionPtr,Data) *
+ * int MTPCreateThreadPool(NumThreads)          *
+ * void MTPDestroyThreadPool()                  *
+ * int MTPGetStats(Stats)                       *
+ * mdb_t *MTPGetThreadDB()                      *
  *                                              */
- 
+
 #include "moab.h"
 #include "moab-proto.h"
 #include "moab-global.h"
@@ -19,15 +23,20 @@
 typedef struct mtprequest_t mtprequest_t;
 #ifndef __NOMCOMMTHREAD
 #include <pthread.h>     /* pthread functions and data structures     */
+#ifdef __LINUX
+#include <sched.h>
+#endif /* __LINUX */
+
 
- 
 /* threadpool request data structure */
 
 struct mtprequest_t {
   int RequestId;                  /* id of request for debug */
-  mthread_handler_t FunctionPtr;  /* moab function to be called */  
+  long  QueueTimeUS;              /* time request was queued (microseconds) */
+  mthread_handler_t FunctionPtr;  /* moab function to be called */
   void *FunctionDataPtr;          /* pointer to data for the moab function */
-  struct mtprequest_t *Next;      /* pointer to next request, NULL if none. */
+  struct mtprequest_t *Next;      /* pointer to next (newer) request, NULL if none. */
+  struct mtprequest_t *Prev;      /* pointer to previous (older) request, NULL if none. */
 };
 
 /* info kept for each thread */
@@ -37,6 +46,29 @@ typedef struct mtpthreadinfo_t {
   pthread_t  ThreadHandle;          /* thread handle     */
   pthread_key_t      DBHandleKey;   /* thread-specific database handle thread key*/
   mdb_t              DBHandle;      /* thread-specific database handle */
+
+  /* per-worker request deque - owner takes the oldest request from the head,
+     idle workers steal the newest from the tail (the one that would wait
+     longest behind the others) */
+
+  pthread_mutex_t    Mutex;         /* guards the deque, IsIdle and WakeUp */
+  pthread_cond_t     Signal;        /* owner blocks here when it finds no work */
+  mtprequest_t      *Head;
+  mtprequest_t      *Tail;
+  volatile int       Depth;         /* requests in this deque */
+  volatile mbool_t   IsIdle;        /* owner is (about to be) blocked on Signal */
+  mbool_t            WakeUp;        /* work was queued behind a busy worker - look for it */
+
+  int                CPU;           /* cpu thread is bound to (-1 if none) */
+
+  /* counters (see MTPGetStats()) - MaxDepth is updated under Mutex, the 
+     rest only by the owning thread so no atomics are needed */
+
+  int                MaxDepth;
+  mulong             NumRequests;
+  mulong             NumSteals;
+  mulong             TotalWaitUS;
+  mulong             MaxWaitUS;
 } mtpthreadinfo_t;
 
 /* thread pool data */
@@ -45,30 +77,382 @@ typedef struct mtpthreadpool_t {
   mtpthreadinfo_t ThreadInfo[MMAX_TP_HANDLER_THREADS];
   int NumThreadsCreated;
 
-  /* Requests for a thread from the thread pool are kept in a linked list*/
-
-  mtprequest_t *RequestsHead;     /* head of linked list of requests. */
-  mtprequest_t *RequestsTail;     /* pointer to last request.         */
+  volatile int     NumIdle;     /* workers with IsIdle set */
+  volatile int     NumThieves;  /* idle workers woken to steal that have not looked yet */
+  volatile mbool_t Shutdown;
 } mtpthreadpool_t;
 
-/* For some reason the compiler does not like having these itmes in the mpthreadpool_t structure */
-
-pthread_mutex_t MTPRequestMutex = PTHREAD_MUTEX_INITIALIZER;   /* thread pool mutex */
-pthread_cond_t  MTPPendingRequestSignal = PTHREAD_COND_INITIALIZER; /* global condition variable, each thread in the pool blocks 
-                                                                       on this condition waiting for a request  */
-
 /* Global Thread Pool data */
 
 mtpthreadpool_t MTPThreadPool;
 mtpthreadpool_t *TP = &MTPThreadPool;
 
+/* key mapping a pool thread to its mtpthreadinfo_t (NULL in other threads) */
+
+pthread_key_t   MTPThreadInfoKey;
+pthread_once_t  MTPThreadInfoKeyOnce = PTHREAD_ONCE_INIT;
+
+
+
+
+/**
+ * Create MTPThreadInfoKey (once).
+ */
+
+void __MTPThreadInfoKeyCreate()
+
+  {
+  pthread_key_create(&MTPThreadInfoKey,NULL);
+
+  return;
+  } /* END __MTPThreadInfoKeyCreate() */
+
+
+
+
+/**
+ * Report the current time in microseconds.
+ */
+
+long __MTPGetTimeUS()
+
+  {
+  struct timeval tv;
+
+  gettimeofday(&tv,NULL);
+
+  return(tv.tv_sec * MDEF_USPERSECOND + tv.tv_usec);
+  } /* END __MTPGetTimeUS() */
+
+
+
+
+/**
+ * Append Request to the tail of TI's deque.
+ *
+ * NOTE: caller must hold TI->Mutex.
+ *
+ * @param TI      (I/O)
+ * @param Request (I)
+ */
+
+void __MTPPushTail(
+
+  mtpthreadinfo_t *TI,
+  mtprequest_t    *Request)
+
+  {
+  Request->Next = NULL;
+  Request->Prev = TI->Tail;
+
+  if (TI->Tail == NULL)
+    TI->Head = Request;
+  else
+    TI->Tail->Next = Request;
+
+  TI->Tail = Request;
+
+  TI->Depth++;
+
+  TI->MaxDepth = MAX(TI->MaxDepth,TI->Depth);
+
+  return;
+  } /* END __MTPPushTail() */
+
+
+
+
+/**
+ * Remove the oldest (FromHead == TRUE) or newest request from TI's deque.
+ *
+ * NOTE: caller must hold TI->Mutex.
+ *
+ * @param TI       (I/O)
+ * @param FromHead (I)
+ */
+
+mtprequest_t *__MTPPop(
+
+  mtpthreadinfo_t *TI,
+  mbool_t          FromHead)
+
+  {
+  mtprequest_t *Request;
+
+  if (FromHead == TRUE)
+    {
+    Request = TI->Head;
+
+    if (Request == NULL)
+      return(NULL);
+
+    TI->Head = Request->Next;
+
+    if (TI->Head == NULL)
+      TI->Tail = NULL;
+    else
+      TI->Head->Prev = NULL;
+    }
+  else
+    {
+    Request = TI->Tail;
+
+    if (Request == NULL)
+      return(NULL);
+
+    TI->Tail = Request->Prev;
+
+    if (TI->Tail == NULL)
+      TI->Head = NULL;
+    else
+      TI->Tail->Next = NULL;
+    }
+
+  TI->Depth--;
+
+  Request->Next = NULL;
+  Request->Prev = NULL;
+
+  return(Request);
+  } /* END __MTPPop() */
+
+
+
+
+/**
+ * Try to take work from another worker's deque - up to half of the first
+ * non-empty victim's backlog (newest first) is moved over so the thief
+ * does not have to come back for every request.
+ *
+ * @param ThreadId (I) id of the thief
+ *
+ * @return the oldest stolen request (the rest are placed on the thief's
+ *         deque), or NULL if every other deque is empty.
+ */
+
+mtprequest_t *__MTPSteal(
+
+  int ThreadId)
+
+  {
+  mtprequest_t    *Stolen[MDEF_TP_STEALBATCH];
+  mtpthreadinfo_t *Victim;
+  mtpthreadinfo_t *TI = &TP->ThreadInfo[ThreadId];
+
+  int tindex;
+  int vindex;
+  int sindex;
+  int count;
+
+  for (tindex = 1;tindex < TP->NumThreadsCreated;tindex++)
+    {
+    vindex = (ThreadId + tindex) % TP->NumThreadsCreated;
+
+    Victim = &TP->ThreadInfo[vindex];
+
+    if (Victim->Depth <= 0)
+      continue;
+
+    pthread_mutex_lock(&Victim->Mutex);
+
+    count = MIN((Victim->Depth + 1) / 2,MDEF_TP_STEALBATCH);
+
+    for (sindex = 0;sindex < count;sindex++)
+      Stolen[sindex] = __MTPPop(Victim,FALSE);
+
+    pthread_mutex_unlock(&Victim->Mutex);
+
+    if (count <= 0)
+      continue;
+
+    TI->NumSteals += count;
+
+    if (count > 1)
+      {
+      /* Stolen[] is newest first - keep the remainder in queue order */
+
+      pthread_mutex_lock(&TI->Mutex);
+
+      for (sindex = count - 2;sindex >= 0;sindex--)
+        __MTPPushTail(TI,Stolen[sindex]);
+
+      pthread_mutex_unlock(&TI->Mutex);
+      }
+
+    return(Stolen[count - 1]);
+    }  /* END for (tindex) */
+
+  return(NULL);
+  } /* END __MTPSteal() */
+
+
+
+
+/**
+ * Bind the calling pool thread to TI->CPU (if set).
+ *
+ * @param TI (I)
+ */
+
+int __MTPSetAffinity(
+
+  mtpthreadinfo_t *TI)
+
+  {
+#if defined(__LINUX) && defined(CPU_SET)
+  cpu_set_t CPUSet;
+
+  if (TI->CPU < 0)
+    {
+    return(SUCCESS);
+    }
+
+  CPU_ZERO(&CPUSet);
+  CPU_SET(TI->CPU,&CPUSet);
+
+  if (pthread_setaffinity_np(pthread_self(),sizeof(CPUSet),&CPUSet) != 0)
+    {
+    MDB(2,fCORE) MLog("WARNING:  cannot bind thread pool thread %d to cpu %d\n",
+      TI->ThreadId,
+      TI->CPU);
+
+    return(FAILURE);
+    }
+#endif /* __LINUX && CPU_SET */
+
+  return(SUCCESS);
+  } /* END __MTPSetAffinity() */
+
+
+
+
+/**
+ * Parse a cpu list (FORMAT:  <CPU>[-<CPU>][,<CPU>[-<CPU>]]...) into CPUList.
+ *
+ * @param String  (I)
+ * @param CPUList (O) [minsize=MMAX_TP_HANDLER_THREADS]
+ *
+ * @return number of cpus in CPUList
+ */
+
+int __MTPParseCPUList(
+
+  char *String,
+  int  *CPUList)
+
+  {
+  char *ptr = String;
+  char *tail;
+
+  int   First;
+  int   Last;
+  int   count = 0;
+
+  while ((ptr != NULL) && (*ptr != '\0') && (count < MMAX_TP_HANDLER_THREADS))
+    {
+    First = (int)strtol(ptr,&tail,10);
+
+    if (tail == ptr)
+      break;
+
+    Last = First;
+
+    if (*tail == '-')
+      {
+      ptr = tail + 1;
+
+      Last = (int)strtol(ptr,&tail,10);
+      }
+
+    for (;(First <= Last) && (count < MMAX_TP_HANDLER_THREADS);First++)
+      CPUList[count++] = First;
+
+    ptr = (*tail == ',') ? tail + 1 : NULL;
+    }
+
+  return(count);
+  } /* END __MTPParseCPUList() */
+
+
+
+
+/**
+ * Wake an idle worker so it steals the request just queued behind a busy
+ * worker.  At most one woken thief is outstanding - it takes up to half of
+ * the backlog and, once busy itself, the next request wakes another.
+ *
+ * NOTE: caller must not hold any worker's Mutex.
+ */
+
+void __MTPWakeThief()
+
+  {
+  mtpthreadinfo_t *TI;
+
+  int tindex;
+
+  /* pairs with the barrier in MTPGetRequest() - either the idle worker sees
+     the request when it scans for work or we see it idle here */
+
+  __sync_synchronize();
+
+  if ((TP->NumIdle <= 0) || (TP->NumThieves > 0))
+    {
+    return;
+    }
+
+  if (!__sync_bool_compare_and_swap(&TP->NumThieves,0,1))
+    {
+    /* another producer is waking one */
+
+    return;
+    }
+
+  for (tindex = 0;tindex < TP->NumThreadsCreated;tindex++)
+    {
+    TI = &TP->ThreadInfo[tindex];
+
+    if (TI->IsIdle == FALSE)
+      continue;
+
+    pthread_mutex_lock(&TI->Mutex);
+
+    if ((TI->IsIdle == TRUE) && (TI->WakeUp == FALSE))
+      {
+      TI->WakeUp = TRUE;
+
+      pthread_mutex_unlock(&TI->Mutex);
+
+      pthread_cond_signal(&TI->Signal);
+
+      return;
+      }
+
+    pthread_mutex_unlock(&TI->Mutex);
+    }  /* END for (tindex) */
+
+  /* every idle worker went back to work in the meantime */
+
+  __sync_fetch_and_sub(&TP->NumThieves,1);
+
+  return;
+  } /* END __MTPWakeThief() */
+
+
+
 
 /**
- * This function places a request on the pending request linked list
+ * This function places a request on a worker's pending request deque
  * for a thread to pick up and handle.
  *
+ * Requests queued from a pool thread stay on that thread's deque, others
+ * go to the first worker's.  If that worker is idle it is signalled, if it
+ * is busy an idle worker is woken to steal from the backlog - a woken
+ * worker takes up to half of it, so a burst reaches the pool in a few
+ * batches rather than one wake-up per request.
+ *
  * @param RequestId (I)  Optional parameter for logging
- * @param FunctionPtr (I) moab function 
+ * @param FunctionPtr (I) moab function
  * @param *Data (I)
  */
 
@@ -79,63 +463,113 @@ int MTPAddRequest(
   void *Data)
 
   {
-  mtprequest_t *NewRequest;      /* pointer to newly added request.     */
+  mtprequest_t    *NewRequest;      /* pointer to newly added request.     */
+  mtpthreadinfo_t *TI;
+
+  mbool_t IsIdle;
+
+  if ((TP->NumThreadsCreated <= 0) || (TP->Shutdown == TRUE))
+    {
+    return(FAILURE);
+    }
 
   /* create structure with new request */
 
   NewRequest = (mtprequest_t *)malloc(sizeof(mtprequest_t));
-  if (NewRequest == NULL) 
-    { 
-    /* TBD - add error handling here */
+
+  if (NewRequest == NULL)
+    {
+    MDB(1,fCORE) MLog("ALERT:    cannot allocate thread pool request %d\n",
+      RequestId);
+
+    return(FAILURE);
     }
 
   NewRequest->RequestId = RequestId;
-  NewRequest->Next = NULL;
   NewRequest->FunctionPtr = FunctionPtr;
   NewRequest->FunctionDataPtr = Data;
+  NewRequest->QueueTimeUS = __MTPGetTimeUS();
 
-  /* lock the mutex, to assure exclusive access to the request linked list */
+  /* select the worker */
 
-  pthread_mutex_lock(&MTPRequestMutex);
+  TI = (mtpthreadinfo_t *)pthread_getspecific(MTPThreadInfoKey);
 
-  /* add new request to the end of the list, updating list pointers as required */
+  if (TI == NULL)
+    TI = &TP->ThreadInfo[0];
 
-  if (TP->RequestsHead == NULL) 
-    { 
-    /* special case - list is empty */
+  /* lock only the selected worker's deque */
+
+  pthread_mutex_lock(&TI->Mutex);
+
+  __MTPPushTail(TI,NewRequest);
+
+  IsIdle = TI->IsIdle;
+
+  pthread_mutex_unlock(&TI->Mutex);
+
+  if (IsIdle == TRUE)
+    {
+    /* signal the worker - let it know that a new request is pending */
 
-    TP->RequestsHead = NewRequest;
-    TP->RequestsTail = NewRequest;
+    pthread_cond_signal(&TI->Signal);
     }
-  else 
+  else
     {
-    /* Add new request to the tail of the request list */
+    /* the worker will get to it after its current request - let an idle
+       worker steal it */
 
-    TP->RequestsTail->Next = NewRequest;
-    TP->RequestsTail = NewRequest;
+    __MTPWakeThief();
     }
 
-  /* unlock mutex */
+  return(SUCCESS);
+  } /* END MTPAddRequest() */
 
-  pthread_mutex_unlock(&MTPRequestMutex);
 
-  /* signal the condition variable - let the blocked threads know that a new request is pending */
 
-  pthread_cond_signal(&MTPPendingRequestSignal);
 
-  return(SUCCESS);
-  } /* END MTPAddRequest() */
+
+/**
+ * Set or clear TI->IsIdle, keeping TP->NumIdle in step.
+ *
+ * NOTE: only the owning thread changes its IsIdle, caller must hold TI->Mutex.
+ *
+ * @param TI     (I/O)
+ * @param IsIdle (I)
+ */
+
+void __MTPSetIdle(
+
+  mtpthreadinfo_t *TI,
+  mbool_t          IsIdle)
+
+  {
+  if (TI->IsIdle == IsIdle)
+    return;
+
+  TI->IsIdle = IsIdle;
+
+  if (IsIdle == TRUE)
+    __sync_fetch_and_add(&TP->NumIdle,1);
+  else
+    __sync_fetch_and_sub(&TP->NumIdle,1);
+
+  return;
+  } /* END __MTPSetIdle() */
 
 
 
 
 
 /**
- * This routine is called by a thread to get a request from the request queue.
+ * This routine is called by a thread to get a request - from its own deque
+ * first, then by stealing from the other workers, blocking if there is no
+ * work anywhere.
  *
  * Note that the returned request should be freed by the caller of this routine.
  *
- * @param ThreadId (I)   id of the thread handling the function (for debug) 
+ * @param ThreadId (I)   id of the thread handling the function
+ *
+ * @return NULL once the pool is shut down
  */
 
 mtprequest_t *MTPGetRequest(
@@ -143,52 +577,77 @@ mtprequest_t *MTPGetRequest(
   int ThreadId)
 
   {
-  mtprequest_t *Request = NULL;      /* pointer to request.                 */
-  int rc;
+  mtprequest_t    *Request = NULL;      /* pointer to request.                 */
+  mtpthreadinfo_t *TI = &TP->ThreadInfo[ThreadId];
 
-  if (TP->RequestsHead == NULL)
+  while (TP->Shutdown == FALSE)
     {
-    /* no pending requests so block waiting for a pending request signal and the mutex lock */
+    pthread_mutex_lock(&TI->Mutex);
 
-    rc = pthread_cond_wait(&MTPPendingRequestSignal,&MTPRequestMutex);
+    if (TI->WakeUp == TRUE)
+      {
+      /* we are the outstanding thief - let producers wake another once we
+         have looked (the decrement is a barrier before the scan below) */
 
-    if (rc != 0)
+      TI->WakeUp = FALSE;
+
+      __sync_fetch_and_sub(&TP->NumThieves,1);
+      }
+
+    Request = __MTPPop(TI,TRUE);
+
+    __MTPSetIdle(TI,(Request == NULL) ? TRUE : FALSE);
+
+    pthread_mutex_unlock(&TI->Mutex);
+
+    if (Request != NULL)
+      break;
+
+    /* pairs with the barrier in __MTPWakeThief() */
+
+    __sync_synchronize();
+
+    if ((Request = __MTPSteal(ThreadId)) != NULL)
       {
-      pthread_mutex_unlock(&MTPRequestMutex); /* just in case */
+      pthread_mutex_lock(&TI->Mutex);
 
-      return(NULL);
+      __MTPSetIdle(TI,FALSE);
+
+      pthread_mutex_unlock(&TI->Mutex);
+
+      break;
       }
-    }
-  else /* pending request - race the other threads to get it */
-    {
-    /* lock the mutex, to assure exclusive access to the list */
 
-    pthread_mutex_lock(&MTPRequestMutex);
-    }
+    /* no pending requests so block waiting for a pending request signal - 
+       re-check under the lock so neither a request queued on our deque nor
+       a wake-up to steal can be lost */
+
+    pthread_mutex_lock(&TI->Mutex);
 
-  /* We have the lock, check to see if there is still a pending request 
-   * or did another thread beat us to it. */
+    while ((TI->Head == NULL) && (TI->WakeUp == FALSE) && (TP->Shutdown == FALSE))
+      {
+      pthread_cond_wait(&TI->Signal,&TI->Mutex);
+      }
 
-  Request = TP->RequestsHead;
+    pthread_mutex_unlock(&TI->Mutex);
+    }  /* END while (TP->Shutdown == FALSE) */
 
-  if (Request != NULL) 
+  if (Request != NULL)
     {
-    /* Take this request off the list */
+    mulong Wait = (mulong)MAX(0,__MTPGetTimeUS() - Request->QueueTimeUS);
 
-    TP->RequestsHead = Request->Next;
+    TI->NumRequests++;
+    TI->TotalWaitUS += Wait;
+    TI->MaxWaitUS = MAX(TI->MaxWaitUS,Wait);
 
-    if (TP->RequestsHead == NULL) 
-      { 
-      /* this was the last request on the list */
+    if (TI->Depth > 0)
+      {
+      /* more work is waiting behind the request we are about to run */
 
-      TP->RequestsTail = NULL;
+      __MTPWakeThief();
       }
     }
 
-  /* unlock mutex */
-
-  pthread_mutex_unlock(&MTPRequestMutex);
-
   return(Request);
   } /* END MTPGetRequest() */
 
@@ -203,7 +662,7 @@ mtprequest_t *MTPGetRequest(
  * If the thread gets a request, call the request handler routine and
  * then free the request.
  *
- * @param Data (I) id of the thread (for debug) 
+ * @param Data (I) thread info (mtpthreadinfo_t *)
  */
 
 void *MTPHandleRequestsLoop(
@@ -215,20 +674,25 @@ void *MTPHandleRequestsLoop(
   mtpthreadinfo_t *TI = (mtpthreadinfo_t *)Data;
   int ThreadId = TI->ThreadId;
 
+  pthread_setspecific(MTPThreadInfoKey,TI);
+
+  __MTPSetAffinity(TI);
+
   MSysInitDB(&TI->DBHandle);
 
-  /* do forever.... */
+  pthread_setspecific(TI->DBHandleKey,&TI->DBHandle);
 
-  while (1) 
+  /* do until the pool is destroyed.... */
+
+  while (TP->Shutdown == FALSE)
     {
-    /* The MTPGetRequest() routine will block on the request queue mutex
-     * lock, or on a pthread_cond_wait() if no requests currently in the
-     * request queue */
+    /* The MTPGetRequest() routine will block on the worker's condition
+     * variable if no requests are available to this thread */
 
-    Request = MTPGetRequest(ThreadId); 
+    Request = MTPGetRequest(ThreadId);
 
-    if (Request != NULL) 
-      { 
+    if (Request != NULL)
+      {
       /* got a request - handle it and free it */
 
       if (Request->FunctionPtr != NULL)
@@ -236,7 +700,7 @@ void *MTPHandleRequestsLoop(
 
       free(Request);
       }
-    }   /* END while(1) */
+    }   /* END while (TP->Shutdown == FALSE) */
 
   return(NULL);
   } /* END MTPHandleRequestsLoop() */
@@ -248,6 +712,9 @@ void *MTPHandleRequestsLoop(
 /**
  * Create Thread Pool
  *
+ * NOTE: if MOABTPAFFINITY is set (FORMAT: <CPU>[-<CPU>][,...]) thread N is
+ *       bound to the N'th cpu in the list (wrapping).
+ *
  * @param NumThreads (I)
  */
 
@@ -258,43 +725,80 @@ int MTPCreateThreadPool(
   {
   int tindex;
   mtpthreadinfo_t *TI;
-  pthread_attr_t attr;
+
+  int   CPUList[MMAX_TP_HANDLER_THREADS];
+  int   CPUCount = 0;
+
+  char *ptr;
+
+  pthread_once(&MTPThreadInfoKeyOnce,__MTPThreadInfoKeyCreate);
+
+  NumThreads = MIN(NumThreads,MMAX_TP_HANDLER_THREADS);
+
+  if ((ptr = getenv(MSCHED_ENVTPAFFINITYVAR)) != NULL)
+    CPUCount = __MTPParseCPUList(ptr,CPUList);
 
   /* Initialize thread pool information */
 
-  TP->RequestsHead = NULL;
-  TP->RequestsTail = NULL;
   TP->NumThreadsCreated = 0;
+  TP->NumIdle = 0;
+  TP->NumThieves = 0;
+  TP->Shutdown = FALSE;
 
-  /* create the threads in the thread pool */
+  /* initialize every deque before any thread can steal from it */
+
+  for (tindex = 0;tindex < NumThreads;tindex++)
+    {
+    TI = &TP->ThreadInfo[tindex];
+
+    TI->ThreadId = tindex;
+    TI->Head = NULL;
+    TI->Tail = NULL;
+    TI->Depth = 0;
+    TI->IsIdle = FALSE;
+    TI->WakeUp = FALSE;
+    TI->CPU = (CPUCount > 0) ? CPUList[tindex % CPUCount] : -1;
+
+    TI->MaxDepth = 0;
+    TI->NumRequests = 0;
+    TI->NumSteals = 0;
+    TI->TotalWaitUS = 0;
+    TI->MaxWaitUS = 0;
+
+    pthread_key_create(&TI->DBHandleKey,NULL);
+    pthread_mutex_init(&TI->Mutex,NULL);
+    pthread_cond_init(&TI->Signal,NULL);
+    }
 
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr,PTHREAD_CREATE_DETACHED);
+  /* create the threads in the thread pool - joinable so that
+     MTPDestroyThreadPool() can wait for them before freeing the deques */
 
-  for (tindex = 0;tindex < NumThreads;tindex++) 
+  for (tindex = 0;tindex < NumThreads;tindex++)
     {
     int rc;
     TI = &TP->ThreadInfo[tindex];
-    TI->ThreadId = tindex;
+
+    /* NumThreadsCreated bounds stealing/selection - publish each thread's 
+       slot before it can be chosen */
+
+    TP->NumThreadsCreated++;
 
     /* create each thread */
 
-    rc = pthread_create(&TI->ThreadHandle,&attr,MTPHandleRequestsLoop,TI);
+    rc = pthread_create(&TI->ThreadHandle,NULL,MTPHandleRequestsLoop,TI);
 
     if (rc != 0)
       {
+      TP->NumThreadsCreated--;
+
       MLog("ERROR:    pthread_create number %d returned non-zero exit code %d\n",
         tindex+1,
         rc);
 
       return(FAILURE);
-      }    
-
-    TP->NumThreadsCreated++;
+      }
     }
 
-  pthread_attr_destroy(&attr);
-
   return(SUCCESS);
   }  /* END MTPCreateThreadPool() */
 
@@ -305,36 +809,138 @@ int MTPCreateThreadPool(
 /**
  * Destroy Thread Pool
  *
+ * Stop the workers (a request already running is allowed to finish), wait
+ * for them to exit, then free the requests nobody picked up.
  */
 
 void MTPDestroyThreadPool()
 
   {
-  mtprequest_t *Request;
+  mtprequest_t    *Request;
+  mtpthreadinfo_t *TI;
+
   int tindex;
 
-  /* cancel the threads */
+  TP->Shutdown = TRUE;
+
+  /* wake the idle threads - set under each worker's lock so a thread about
+     to block sees Shutdown */
 
-  for (tindex = 0;tindex < TP->NumThreadsCreated;tindex++) 
+  for (tindex = 0;tindex < TP->NumThreadsCreated;tindex++)
     {
-    pthread_cancel(TP->ThreadInfo[tindex].ThreadHandle);
+    TI = &TP->ThreadInfo[tindex];
+
+    pthread_mutex_lock(&TI->Mutex);
+
+    pthread_cond_broadcast(&TI->Signal);
+
+    pthread_mutex_unlock(&TI->Mutex);
     }
 
-  while (TP->RequestsHead != NULL)
+  for (tindex = 0;tindex < TP->NumThreadsCreated;tindex++)
     {
-    Request = TP->RequestsHead;
+    pthread_join(TP->ThreadInfo[tindex].ThreadHandle,NULL);
+    }
+
+  /* no worker is left - the deques can be drained without locking */
+
+  for (tindex = 0;tindex < TP->NumThreadsCreated;tindex++)
+    {
+    TI = &TP->ThreadInfo[tindex];
 
-    TP->RequestsHead = Request->Next;
+    while ((Request = __MTPPop(TI,TRUE)) != NULL)
+      {
+      free(Request);
+      }
 
-    free(Request);
+    pthread_cond_destroy(&TI->Signal);
+    pthread_mutex_destroy(&TI->Mutex);
+    pthread_key_delete(TI->DBHandleKey);
     }
 
+  TP->NumThreadsCreated = 0;
+
   return;
   } /* END MTPDestroyThreadPool() */
 
 
 
 
+/**
+ * Report thread pool counters (summed over the pool threads).
+ *
+ * NOTE: counters accumulate from MTPCreateThreadPool(), MaxQueueDepth and
+ *       MaxWaitUS are high-water marks over that period.
+ *
+ * @param Stats (O)
+ */
+
+int MTPGetStats(
+
+  mtpstats_t *Stats)  /* O */
+
+  {
+  mtpthreadinfo_t *TI;
+
+  int    tindex;
+
+  if (Stats == NULL)
+    {
+    return(FAILURE);
+    }
+
+  memset(Stats,0,sizeof(mtpstats_t));
+
+  Stats->NumThreads = TP->NumThreadsCreated;
+
+  /* NOTE: per-thread counters are read without locking - totals are 
+           approximate while the pool is busy */
+
+  for (tindex = 0;tindex < TP->NumThreadsCreated;tindex++)
+    {
+    TI = &TP->ThreadInfo[tindex];
+
+    Stats->QueueDepth   += TI->Depth;
+    Stats->MaxQueueDepth = MAX(Stats->MaxQueueDepth,TI->MaxDepth);
+    Stats->NumRequests  += TI->NumRequests;
+    Stats->NumSteals    += TI->NumSteals;
+    Stats->TotalWaitUS  += TI->TotalWaitUS;
+    Stats->MaxWaitUS     = MAX(Stats->MaxWaitUS,TI->MaxWaitUS);
+    }
+
+  Stats->AvgWaitUS = (Stats->NumRequests > 0) ? Stats->TotalWaitUS / Stats->NumRequests : 0;
+
+  return(SUCCESS);
+  }  /* END MTPGetStats() */
+
+
+
+
+/**
+ * Report the database handle of the calling pool thread (NULL if not
+ * called from a pool thread).
+ */
+
+mdb_t *MTPGetThreadDB()
+
+  {
+  mtpthreadinfo_t *TI;
+
+  pthread_once(&MTPThreadInfoKeyOnce,__MTPThreadInfoKeyCreate);
+
+  TI = (mtpthreadinfo_t *)pthread_getspecific(MTPThreadInfoKey);
+
+  if (TI == NULL)
+    {
+    return(NULL);
+    }
+
+  return((mdb_t *)pthread_getspecific(TI->DBHandleKey));
+  }  /* END MTPGetThreadDB() */
+
+
+
+
 #else /* ifndef __NOMCOMMTHREAD */
 int MTPAddRequest(
 
@@ -389,8 +995,26 @@ void MTPDestroyThreadPool(
   {
   }
 
-#endif /*ifndef __NOMCOMMTHREAD */
 
-/* END MTP.c */
 
 
+int MTPGetStats(
+
+  mtpstats_t *Stats)
+
+  {
+  return(FAILURE);
+  }
+
+
+
+
+mdb_t *MTPGetThreadDB()
+
+  {
+  return(NULL);
+  }
+
+#endif /*ifndef __NOMCOMMTHREAD */
+
+/* END MTP.c */
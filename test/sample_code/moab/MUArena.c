@@ -0,0 +1,520 @@
+/* HEADER */
+
+/**
+ * @file MUArena.c
+ *
+ * Per-iteration scratch arena (bump allocator) functions
+ *
+ * NOTE: memory is carved sequentially out of a chain of large blocks and is
+ *       never freed individually.  MUArenaRelease() rewinds to an earlier
+ *       MUArenaMark() and MUArenaReset() (called once per scheduling
+ *       iteration) rewinds everything, blocks are kept for reuse.
+ *
+ * NOTE: only the thread which last called MUArenaReset() may allocate from
+ *       the arena, requests from any other thread (or from an arena which has
+ *       not been reset yet) transparently fall back to MUCalloc().  Callers
+ *       must therefore always free through MUArenaFree(), passing the same
+ *       arena the memory was requested from.
+ *
+ * NOTE: every allocation requested from a non-NULL arena is preceded by a
+ *       small header recording the block it was carved from (NULL for heap
+ *       fallbacks) so that MUArenaFree() never has to search the blocks.
+ *
+ */
+
+#include "moab.h"
+#include "moab-proto.h"
+
+#ifndef __NOMCOMMTHREAD
+#include <pthread.h>
+#endif /* !__NOMCOMMTHREAD */
+
+#ifndef STATIC
+#define STATIC static
+#endif
+
+#define MARENA_ALIGN        16
+#define MARENA_ROUND(S)     (((S) + (MARENA_ALIGN - 1)) & ~((mulong)MARENA_ALIGN - 1))
+#define MARENA_HEADERSIZE   MARENA_ROUND(sizeof(marenablock_t))
+#define MARENA_DATA(B)      ((char *)(B) + MARENA_HEADERSIZE)
+#define MARENA_ALLOCHDR     MARENA_ROUND(sizeof(marenablock_t *))
+#define MARENA_OWNER(P)     (*(marenablock_t **)((char *)(P) - MARENA_ALLOCHDR))
+
+
+
+/**
+ * Returns TRUE if the calling thread may allocate from A.
+ *
+ * @param A (I)
+ */
+
+mbool_t __MUArenaIsOwner(
+
+  const marena_t *A) /* I */
+
+  {
+  if ((A == NULL) || (A->IsActive == FALSE))
+    return(FALSE);
+
+#ifndef __NOMCOMMTHREAD
+  if (A->Owner != (mulong)pthread_self())
+    return(FALSE);
+#endif /* !__NOMCOMMTHREAD */
+
+  return(TRUE);
+  }  /* END __MUArenaIsOwner() */
+
+
+
+
+/**
+ * Discard everything allocated from the arena and make the calling thread
+ * its owner.
+ *
+ * NOTE: invalidates all memory previously returned by MUArenaCalloc(A).
+ *
+ * @param A (I/O)
+ */
+
+int MUArenaReset(
+
+  marena_t *A) /* I/O */
+
+  {
+  if (A == NULL)
+    return(FAILURE);
+
+  if (A->BlockSize == 0)
+    A->BlockSize = MDEF_ARENABLOCKSIZE;
+
+#ifndef __NOMCOMMTHREAD
+  A->Owner = (mulong)pthread_self();
+#endif /* !__NOMCOMMTHREAD */
+
+  A->Cur = A->Head;
+
+  if (A->Cur != NULL)
+    A->Cur->Used = 0;
+
+  A->Depth      = 0;
+  A->BytesInUse = 0;
+  A->IsActive   = TRUE;
+
+  A->NumResets++;
+
+  return(SUCCESS);
+  }  /* END MUArenaReset() */
+
+
+
+
+/**
+ * Free all arena blocks.
+ *
+ * NOTE: arena is inactive (all requests fall back to MUCalloc()) until the
+ *       next MUArenaReset().
+ *
+ * @param A (I/O)
+ */
+
+int MUArenaDestroy(
+
+  marena_t *A) /* I/O */
+
+  {
+  marenablock_t *B;
+  marenablock_t *Next;
+
+  if (A == NULL)
+    return(FAILURE);
+
+  for (B = A->Head;B != NULL;B = Next)
+    {
+    Next = B->Next;
+
+    MUFree((char **)&B);
+    }
+
+  A->Head       = NULL;
+  A->Cur        = NULL;
+  A->Depth      = 0;
+  A->BytesInUse = 0;
+  A->IsActive   = FALSE;
+
+  return(SUCCESS);
+  }  /* END MUArenaDestroy() */
+
+
+
+
+/**
+ * Carve Size bytes (plus the allocation header) out of the arena.
+ *
+ * @param A    (I/O)
+ * @param Size (I)
+ */
+
+char *__MUArenaCarve(
+
+  marena_t *A,    /* I/O */
+  mulong    Size) /* I */
+
+  {
+  marenablock_t *B;
+  marenablock_t *Tail;
+
+  mulong BSize;
+  mulong Need;
+
+  char  *Ptr;
+
+  Need = MARENA_ALLOCHDR + MARENA_ROUND(MAX(Size,1));
+
+  /* NOTE:  every block past Cur is free */
+
+  B = A->Cur;
+
+  if ((B != NULL) && (B->Used + Need > B->Size))
+    {
+    for (B = B->Next;B != NULL;B = B->Next)
+      {
+      B->Used = 0;
+
+      if (Need <= B->Size)
+        break;
+      }
+    }
+
+  if (B == NULL)
+    {
+    BSize = MAX(A->BlockSize,Need);
+
+    B = (marenablock_t *)MUMalloc((int)(MARENA_HEADERSIZE + BSize));
+
+    if (B == NULL)
+      return(NULL);
+
+    B->Next = NULL;
+    B->Size = BSize;
+    B->Used = 0;
+
+    if (A->Head == NULL)
+      {
+      A->Head = B;
+      }
+    else
+      {
+      for (Tail = (A->Cur != NULL) ? A->Cur : A->Head;Tail->Next != NULL;Tail = Tail->Next);
+
+      Tail->Next = B;
+      }
+
+    A->NumBlocks++;
+    }  /* END if (B == NULL) */
+
+  A->Cur = B;
+
+  Ptr = MARENA_DATA(B) + B->Used + MARENA_ALLOCHDR;
+
+  MARENA_OWNER(Ptr) = B;
+
+  B->Used += Need;
+
+  A->NumAllocs++;
+
+  A->BytesInUse += Need;
+
+  if (A->BytesInUse > A->PeakBytes)
+    A->PeakBytes = A->BytesInUse;
+
+  return(Ptr);
+  }  /* END __MUArenaCarve() */
+
+
+
+
+/**
+ * Allocate Size bytes from the heap, tagged so that MUArenaFree(A) passes
+ * them to MUFree().
+ *
+ * @param A      (I) [optional]
+ * @param Size   (I)
+ * @param DoZero (I)
+ */
+
+char *__MUArenaHeapAlloc(
+
+  const marena_t *A,      /* I (optional) */
+  mulong          Size,   /* I */
+  mbool_t         DoZero) /* I */
+
+  {
+  char *Ptr;
+
+  if (A == NULL)
+    return((DoZero == TRUE) ? (char *)MUCalloc(1,(int)Size) : (char *)MUMalloc((int)Size));
+
+  Ptr = (DoZero == TRUE) ?
+    (char *)MUCalloc(1,(int)(MARENA_ALLOCHDR + Size)) :
+    (char *)MUMalloc((int)(MARENA_ALLOCHDR + Size));
+
+  if (Ptr == NULL)
+    return(NULL);
+
+  Ptr += MARENA_ALLOCHDR;
+
+  MARENA_OWNER(Ptr) = NULL;
+
+  return(Ptr);
+  }  /* END __MUArenaHeapAlloc() */
+
+
+
+
+/**
+ * Allocate zeroed memory for Count elements of Size bytes.
+ *
+ * Drop-in replacement for MUCalloc() - falls back to MUCalloc() if A is
+ * NULL, inactive or owned by another thread.  Release with MUArenaFree().
+ *
+ * @param A     (I/O) [optional]
+ * @param Count (I)
+ * @param Size  (I)
+ */
+
+void *MUArenaCalloc(
+
+  marena_t *A,     /* I/O (optional) */
+  int       Count, /* I */
+  int       Size)  /* I */
+
+  {
+  char *Ptr;
+
+  if ((__MUArenaIsOwner(A) == FALSE) ||
+      ((Ptr = __MUArenaCarve(A,(mulong)Count * (mulong)Size)) == NULL))
+    {
+    if (A != NULL)
+      A->NumFallbacks++;
+
+    return((void *)__MUArenaHeapAlloc(A,(mulong)Count * (mulong)Size,TRUE));
+    }
+
+  memset(Ptr,0,(mulong)Count * (mulong)Size);
+
+  return((void *)Ptr);
+  }  /* END MUArenaCalloc() */
+
+
+
+
+/**
+ * Allocate Size bytes of uninitialized memory.
+ *
+ * Drop-in replacement for MUMalloc() - see MUArenaCalloc().
+ *
+ * @param A    (I/O) [optional]
+ * @param Size (I)
+ */
+
+void *MUArenaMalloc(
+
+  marena_t *A,    /* I/O (optional) */
+  int       Size) /* I */
+
+  {
+  char *Ptr;
+
+  if ((__MUArenaIsOwner(A) == FALSE) ||
+      ((Ptr = __MUArenaCarve(A,(mulong)Size)) == NULL))
+    {
+    if (A != NULL)
+      A->NumFallbacks++;
+
+    return((void *)__MUArenaHeapAlloc(A,(mulong)Size,FALSE));
+    }
+
+  return((void *)Ptr);
+  }  /* END MUArenaMalloc() */
+
+
+
+
+/**
+ * Allocate zeroed heap memory which is released with MUArenaFree(A).
+ *
+ * For data owned by an arena-backed structure which must outlive the
+ * current MUArenaMark() scope.
+ *
+ * @param A     (I) [optional]
+ * @param Count (I)
+ * @param Size  (I)
+ */
+
+void *MUArenaHeapCalloc(
+
+  marena_t *A,     /* I (optional) */
+  int       Count, /* I */
+  int       Size)  /* I */
+
+  {
+  return((void *)__MUArenaHeapAlloc(A,(mulong)Count * (mulong)Size,TRUE));
+  }  /* END MUArenaHeapCalloc() */
+
+
+
+
+/**
+ * Free memory returned by MUArenaCalloc().
+ *
+ * Arena memory is left in place (it is reclaimed by MUArenaRelease() or
+ * MUArenaReset()), anything else is passed to MUFree().  *Ptr is always
+ * cleared.
+ *
+ * NOTE: A must be the arena the memory was requested from.
+ *
+ * @param A   (I) [optional]
+ * @param Ptr (I/O) [freed]
+ */
+
+int MUArenaFree(
+
+  marena_t  *A,   /* I (optional) */
+  char     **Ptr) /* I/O (freed) */
+
+  {
+  char *Base;
+
+  if ((Ptr == NULL) || (*Ptr == NULL))
+    return(SUCCESS);
+
+  if (A == NULL)
+    return(MUFree(Ptr));
+
+  if (MARENA_OWNER(*Ptr) != NULL)
+    {
+    *Ptr = NULL;
+
+    return(SUCCESS);
+    }
+
+  Base = *Ptr - MARENA_ALLOCHDR;
+
+  *Ptr = NULL;
+
+  return(MUFree(&Base));
+  }  /* END MUArenaFree() */
+
+
+
+
+/**
+ * Record the current arena position so that everything allocated after
+ * this point can be discarded by MUArenaRelease().
+ *
+ * NOTE: mark/release scopes must nest.  Memory allocated inside a scope
+ *       must not be used after it is released.
+ *
+ * @param A (I/O)
+ * @param M (O)
+ */
+
+int MUArenaMark(
+
+  marena_t     *A, /* I/O */
+  marenamark_t *M) /* O */
+
+  {
+  if (M == NULL)
+    return(FAILURE);
+
+  memset(M,0,sizeof(marenamark_t));
+
+  if (__MUArenaIsOwner(A) == FALSE)
+    return(FAILURE);
+
+  M->Block      = A->Cur;
+  M->Used       = (A->Cur != NULL) ? A->Cur->Used : 0;
+  M->BytesInUse = A->BytesInUse;
+  M->Depth      = A->Depth;
+  M->IsValid    = TRUE;
+
+  A->Depth++;
+
+  return(SUCCESS);
+  }  /* END MUArenaMark() */
+
+
+
+
+/**
+ * Discard everything allocated from A since M was recorded.
+ *
+ * @param A (I/O)
+ * @param M (I)
+ */
+
+int MUArenaRelease(
+
+  marena_t     *A, /* I/O */
+  marenamark_t *M) /* I */
+
+  {
+  if ((M == NULL) || (M->IsValid == FALSE))
+    return(FAILURE);
+
+  if (__MUArenaIsOwner(A) == FALSE)
+    return(FAILURE);
+
+  if (M->Block != NULL)
+    {
+    A->Cur = M->Block;
+    A->Cur->Used = M->Used;
+    }
+  else
+    {
+    A->Cur = A->Head;
+
+    if (A->Cur != NULL)
+      A->Cur->Used = 0;
+    }
+
+  A->BytesInUse = M->BytesInUse;
+  A->Depth      = M->Depth;
+
+  M->IsValid = FALSE;
+
+  return(SUCCESS);
+  }  /* END MUArenaRelease() */
+
+
+
+
+/**
+ * Close the scope opened by MUArenaMark(M), keeping everything allocated
+ * since (it now belongs to the enclosing scope).
+ *
+ * @param A (I/O)
+ * @param M (I)
+ */
+
+int MUArenaCommit(
+
+  marena_t     *A, /* I/O */
+  marenamark_t *M) /* I */
+
+  {
+  if ((M == NULL) || (M->IsValid == FALSE))
+    return(FAILURE);
+
+  if (__MUArenaIsOwner(A) == FALSE)
+    return(FAILURE);
+
+  A->Depth = M->Depth;
+
+  M->IsValid = FALSE;
+
+  return(SUCCESS);
+  }  /* END MUArenaCommit() */
+
+/* END MUArena.c */
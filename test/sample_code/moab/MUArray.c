@@ -18,53 +18,70 @@
 
 #define MEMPTYSLOT (void *)0x1
 
+/* smallest capacity __MUArrayListGrow() will allocate */
+
+#define MCONST_MARRAYMINSIZE 10
+
 
 /**
- * Grow the give array.
+ * Grow the given array geometrically (by half again) so that it can hold
+ * at least MinSize elements. The new part of the array is zeroed.
  *
- * @param ArrayP (I)
+ * Growing by a constant factor keeps appends amortized O(1) and leaves the
+ * elements contiguous, however many there are.
+ *
+ * @param ArrayP  (I) [modified]
+ * @param MinSize (I) required capacity
  */
 
 int __MUArrayListGrow(
 
-  marray_t *ArrayP)
+  marray_t *ArrayP,
+  int       MinSize)
 
   {
-  char  *Dst = NULL;
+  unsigned char *NewArray;
+
   int    OldArraySize;
+  int    NewArraySize;
 
   if (ArrayP == NULL)
     return(FAILURE);
-  
-  /* need to grow array */
-  
+
   OldArraySize = ArrayP->ArraySize;
 
-  if (OldArraySize >= 8)
-    {
-    ArrayP->ArraySize = (int)(ArrayP->ArraySize * 1.5);  /* this could be tweaked to help performance/heap fragmentation */
-    }
-  else
-    {
-    ArrayP->ArraySize = 10;  /* set array size to 10 to prevent having to re-allocate after every insertion */
-    }
+  if (MinSize <= OldArraySize)
+    return(SUCCESS);
 
-  ArrayP->Array = (unsigned char *)realloc(ArrayP->Array,ArrayP->ElementSize * ArrayP->ArraySize);
+  NewArraySize = OldArraySize + (OldArraySize >> 1);  /* this could be tweaked to help performance/heap fragmentation */
 
-#if 0
-  if (ArrayP->Array == NULL)
+  if (NewArraySize < MCONST_MARRAYMINSIZE)
+    NewArraySize = MCONST_MARRAYMINSIZE;  /* prevent having to re-allocate after every insertion */
+
+  if (NewArraySize < MinSize)
+    NewArraySize = MinSize;
+
+  NewArray = (unsigned char *)realloc(ArrayP->Array,(size_t)ArrayP->ElementSize * NewArraySize);
+
+  if (NewArray == NULL)
     {
-    MDB(1,fSTRUCT) MLog("ERROR:    error growing marray!\n");
+    /* leave the original array intact */
+
+    MDB(1,fSTRUCT) MLog("ERROR:    cannot grow marray to %d elements\n",
+      NewArraySize);
 
     return(FAILURE);
     }
-#endif
 
   /* intialize new part of array */
 
-  Dst = (char *)ArrayP->Array + (OldArraySize * ArrayP->ElementSize);
-  
-  memset(Dst,0x0,(ArrayP->ElementSize * (ArrayP->ArraySize - OldArraySize))); 
+  memset(
+    NewArray + ((size_t)OldArraySize * ArrayP->ElementSize),
+    0x0,
+    (size_t)ArrayP->ElementSize * (NewArraySize - OldArraySize)); 
+
+  ArrayP->Array = NewArray;
+  ArrayP->ArraySize = NewArraySize;
 
   return(SUCCESS);
   } /* END int __MUArrayListGrow() */
@@ -72,168 +89,47 @@ int __MUArrayListGrow(
 
 
 /**
- * Sets the arrays Empty Slots to reflect that the given index is empty.
+ * Record that the slot at Index is empty so a later MUArrayListInsertPtr()
+ * can reuse it.  The free list is a stack which grows like the array
+ * itself, so any number of removals is tracked in O(1) each.
  *
- * @param ArrayP (I)
+ * @param ArrayP (I) [modified]
  * @param Index  (I)
  */
 
-int __MUArrayListSetEmpty(
+int __MUArrayListPushFree(
 
   marray_t *ArrayP, /*I*/
   int       Index)  /*I*/
 
   {
-  int eindex;
-  int *EmptySlots;
-  int TotEmpty;
-  int oldIndex;
-
   if (ArrayP == NULL)
     {
     return(FAILURE);
     }
 
-  /* always sort going in */
-
-  EmptySlots = ArrayP->EmptyTable;
-
-  TotEmpty = ArrayP->NumEmptyItems;
-
-  for (eindex = 0;eindex <= TotEmpty;eindex++) /* <= because want to check even if TotEmpty == 0 */
+  if (ArrayP->NumFree >= ArrayP->FreeListSize)
     {
-    if (eindex == MCONST_MARRAYEMPTYSIZE) /* 1 past array */
-      break;
+    int *NewList;
+    int  NewSize;
 
-    if (Index < EmptySlots[eindex]) /* insert Index sorted low to high */
-      {
-      /* slide original values to down - to the right */
+    NewSize = MAX(MCONST_MARRAYMINSIZE,ArrayP->FreeListSize + (ArrayP->FreeListSize >> 1));
 
-      oldIndex = EmptySlots[eindex];
+    NewList = (int *)realloc(ArrayP->FreeList,sizeof(int) * NewSize);
 
-      EmptySlots[eindex] = Index;
-
-      Index = oldIndex;
-      }
-    else if ((EmptySlots[eindex] == -1) ||      /* end of empty items found, just add */
-             (eindex == ArrayP->NumEmptyItems)) /* end of empty items found, just add */
-      {
-      EmptySlots[eindex] = Index;
-      }
-    } /* for (eindex = 0;eindex <= TotEmpty;eindex++) */
-
-  ArrayP->NumEmptyItems++;
-
-  return(SUCCESS);
-  } /* END int __MUArrayListSetEmpty() */
-
-
-#if 0
-
-/* called by routines that are currently disabled due to possible buggy conditions
- */
-
-
-/**
- * Removes the index from the EmptySlots table if it exists inside.
- *
- * @param ArrayP (I)
- * @param Index (I)
- */
-
-int __MUArrayListSetFilled(
-
-  marray_t *ArrayP, /*I*/
-  int       Index)  /*I*/
-
-  {
-  int eindex;
-  
-  if (ArrayP == NULL)
-    return(FAILURE);
-
-  for (eindex = 0;eindex < ArrayP->NumEmptyItems;eindex++)
-    {
-    if (ArrayP->EmptyTable[eindex] == Index) /* if given index is in empty table */
+    if (NewList == NULL)
       {
-      /* slide trailing indexes down to fill in removed index */
-
-      for (;eindex < ArrayP->NumEmptyItems;eindex++)
-        {
-        if ((eindex == MCONST_MARRAYEMPTYSIZE - 1) || /* at end of table */
-            (ArrayP->EmptyTable[eindex + 1] == -1))   /* at last real index */
-          {
-          ArrayP->EmptyTable[eindex] = -1; 
-
-          break;
-          }
-
-        /* move index to the right to the current index */
-
-        ArrayP->EmptyTable[eindex] = ArrayP->EmptyTable[eindex + 1];
-        }
-      
-      break;
+      return(FAILURE);
       }
-    } /* END for (eindex = 0;eindex < ArrayP->NumItems;eindex++) */
-      
-  /* NumEmptyItems is 0 at creation, don't want to go negavtive. */
-
-  if (ArrayP->NumEmptyItems > 0)
-    ArrayP->NumEmptyItems--;
-
-  return(SUCCESS);
-  } /* int __MUArrayListSetFilled() */
-#endif   /* #if 0 buggy code */
-
-
-#if 0
-/**
- * Gets the index of an empty slot in the array.
- *
- * @param ArrayP (I)
- * @return Returns -1, if none are found.
- */
-
-int __MUArrayListGetEmptyIndex(
 
-  marray_t *ArrayP) /*I*/
-
-  {
-  int eindex;
-  void *item;
-
-  if (ArrayP == NULL)
-    return(-1);
-
-  if (ArrayP->NumEmptyItems == 0) /* there are no empty slots in the array - append */
-    return(ArrayP->NumItems);
-
-  if ((ArrayP->NumEmptyItems != 0) &&
-      (ArrayP->EmptyTable[0] != -1))
-    {
-    /* There exists an index in the empty table that point to an open spot. */
-
-    return(ArrayP->EmptyTable[0]);
+    ArrayP->FreeList = NewList;
+    ArrayP->FreeListSize = NewSize;
     }
 
-  /* EmptySlots are sorted with closest index at 0. */
-
-  eindex = 0;
-
-  /* search whole array for empty slot.*/
+  ArrayP->FreeList[ArrayP->NumFree++] = Index;
 
-  while((item = MUArrayListGet(ArrayP,eindex)) != NULL)
-    {
-    if (item == MEMPTYSLOT)
-      break;
-
-    eindex++;
-    }
-
-  return(eindex);
-  } /* END int __MUArrayListGetEmptyIndex() */
-#endif 
+  return(SUCCESS);
+  } /* END int __MUArrayListPushFree() */
 
 
 /**
@@ -244,7 +140,9 @@ int __MUArrayListGetEmptyIndex(
  * WARNING: This will NOT free any existing elements in an already
  * populated array!
  *
- * NOTE: marrays are NOT made to have items removed!!! They can only be added!!!
+ * NOTE: pointer marrays may have items removed (MUArrayListRemove()), which
+ * leaves empty slots that MUArrayListInsertPtr() reuses and
+ * MUArrayListCompact() squeezes out.
  *
  * @param ArrayP (I) This should be allocated already, can go on the stack (~10bytes).
  * @param ElementSize (I) Should be a "sizeof()" for the data type you wish to store in the array. (Ex. sizeof(mjob_t) or sizeof(char *))
@@ -275,8 +173,6 @@ int MUArrayListCreate(
 
   ArrayP->ElementSize = ElementSize;
 
-  ArrayP->NumEmptyItems = 0;
-
   ArrayP->Array = (unsigned char *)MUCalloc(1,ArrayP->ElementSize * ArrayP->ArraySize);
 
   if (ArrayP->Array == NULL)
@@ -342,6 +238,34 @@ int MUArrayListResize(
 
 
 
+/**
+ * Make sure Array can hold at least MinSize elements without reallocating.
+ * Unlike MUArrayListResize(), capacity grows geometrically (so calling this
+ * before every insertion stays cheap), never shrinks, and the new part of
+ * the array is zeroed.
+ *
+ * @param Array   (I) [modified]
+ * @param MinSize (I)
+ */
+
+int MUArrayListReserve(
+
+  marray_t *Array,
+  int       MinSize)
+
+  {
+  if ((Array == NULL) || (Array->ElementSize <= 0))
+    {
+    return(FAILURE);
+    }
+
+  return(__MUArrayListGrow(Array,MinSize));
+  } /* END MUArrayListReserve() */
+
+
+
+
+
 /**
  * Allocate space for an uninitialized element and return a pointer to it
  * 
@@ -355,8 +279,11 @@ void *MUArrayListAppendEmpty(
   {
   void *Result;
 
-  if (List->NumItems == List->ArraySize)
-    __MUArrayListGrow(List);
+  if ((List->NumItems == List->ArraySize) &&
+      (__MUArrayListGrow(List,List->NumItems + 1) == FAILURE))
+    {
+    return(NULL);
+    }
 
   Result = (void *)(List->Array + (List->NumItems * List->ElementSize));
   List->NumItems++;
@@ -406,7 +333,7 @@ int MUArrayListAppend(
 
   if (ArrayP->NumItems == ArrayP->ArraySize)
     {
-    if (__MUArrayListGrow(ArrayP) == FAILURE)
+    if (__MUArrayListGrow(ArrayP,ArrayP->NumItems + 1) == FAILURE)
       {
       MDB(1,fSTRUCT) MLog("ERROR:    error growing marray!\n");
       
@@ -461,27 +388,63 @@ int MUArrayListAppendPtr(
 
 
 
-#if 0
-
-/* no one uses this code and during unittest development, found some
- * bugs concerning increasing/decreasing empty counts.
+/**
+ * Appends Count objects, stored contiguously at Objects, to an marray with a
+ * single capacity check and a single copy. (Objects are copied as with
+ * MUArrayListAppend(); to append pointers, pass an array of pointers.)
  *
- * Suggest some code review before re-enabling this code
+ * @param ArrayP  (I) [modified]
+ * @param Objects (I) Count elements of the marray's element type
+ * @param Count   (I)
  */
 
+int MUArrayListAppendN(
+
+  marray_t *ArrayP,
+  void     *Objects,
+  int       Count)
+
+  {
+  if ((ArrayP == NULL) || (ArrayP->Array == NULL) || (Count < 0))
+    {
+    return(FAILURE);
+    }
+
+  if ((Count == 0) || (Objects == NULL))
+    {
+    return((Count == 0) ? SUCCESS : FAILURE);
+    }
+
+  if (__MUArrayListGrow(ArrayP,ArrayP->NumItems + Count) == FAILURE)
+    {
+    return(FAILURE);
+    }
+
+  memcpy(
+    ArrayP->Array + ((size_t)ArrayP->NumItems * ArrayP->ElementSize),
+    Objects,
+    (size_t)ArrayP->ElementSize * Count);
+
+  ArrayP->NumItems += Count;
+
+  return(SUCCESS);
+  }  /* END MUArrayListAppendN() */
+
+
+
+
 
 /**
  * Inserts the given pointer into an marray. (Copies the pointer value itself
- * into the array.) If the array has an empty slot, it will be inserted
- * in that slot. Otherwise, it will be appended to the end of the array.
- * Note that the Ptr should match the pointer data type that was originally used to create the marray!!!
- *
- * The array will automatically grow and reallocate memory dynamically as needed.
+ * into the array.) If the array has an empty slot (left by
+ * MUArrayListRemove()), the most recently emptied one is reused in O(1).
+ * Otherwise, the pointer is appended to the end of the array.
  *
- * WARNING: If you wish insert a non-pointer in an array use MUArrayListInsert() instead!
+ * WARNING: This does not preserve insertion order; use MUArrayListAppendPtr()
+ * if order matters.
  *
- * @param ArrayP (I)
- * @param Ptr (I)
+ * @param ArrayP (I) [modified]
+ * @param Ptr    (I)
  */
 
 int MUArrayListInsertPtr(
@@ -490,48 +453,24 @@ int MUArrayListInsertPtr(
   void     *Ptr)
 
   {
-  int    index;
-  char  *Dst = NULL;
-  void **tmpPtr;
-
-  if (ArrayP == NULL)
-    return(FAILURE);
-  
-  tmpPtr = (void **)&Ptr;
-
-  index = __MUArrayListGetEmptyIndex(ArrayP);
-
-  /* If index is the end of the array, then array should be 
-   * grown and index will be at an empty spot. */
-
-  /* check if we should grow array */
+  void **tmpArray;
 
-  if (ArrayP->NumItems == ArrayP->ArraySize)
+  if ((ArrayP == NULL) || (Ptr == NULL))
     {
-    if (__MUArrayListGrow(ArrayP) == FAILURE)
-      return(FAILURE);
+    return(FAILURE);
     }
 
-  if (index > ArrayP->ArraySize)
+  if (ArrayP->NumFree == 0)
     {
-    MDB(1,fSTRUCT) MLog("ERROR:    trying to insert element at index %d which is past the array size of %d\n",
-        index,
-        ArrayP->ArraySize);
-
-    return(FAILURE);
+    return(MUArrayListAppendPtr(ArrayP,Ptr));
     }
 
-  Dst = (char *)ArrayP->Array + (index * ArrayP->ElementSize);
-
-  memcpy(Dst,tmpPtr,ArrayP->ElementSize);
-
-  __MUArrayListSetFilled(ArrayP,index);
+  tmpArray = (void **)ArrayP->Array;
 
-  ArrayP->NumItems++;
+  tmpArray[ArrayP->FreeList[--ArrayP->NumFree]] = Ptr;
 
   return(SUCCESS);
   } /* END int MUArrayListInsertPtr() */
-#endif  /* #if 0 buggy code */
 
 
 #if 0
@@ -574,7 +513,7 @@ int MUArrayListInsertPtrAtIndex(
     {
     /* Need to grow the array to get to the index */
 
-    if (__MUArrayListGrow(ArrayP) == FAILURE)
+    if (__MUArrayListGrow(ArrayP,ArrayP->ArraySize + 1) == FAILURE)
       return(FAILURE);
     }
 
@@ -636,7 +575,7 @@ int MUArrayListInsertAtIndex(
     {
     /* Need to grow the array to get to the index */                                                   
     
-    if (__MUArrayListGrow(ArrayP) == FAILURE)                                                          
+    if (__MUArrayListGrow(ArrayP,ArrayP->ArraySize + 1) == FAILURE)                                                          
       return(FAILURE);                                                                                 
     }                                                                                                  
   
@@ -717,6 +656,10 @@ int MUArrayListFree(
   ArrayP->ElementSize = 0;
   ArrayP->ArraySize = 0;
 
+  MUFree((char **)&ArrayP->FreeList);
+  ArrayP->NumFree = 0;
+  ArrayP->FreeListSize = 0;
+
   return(SUCCESS);
   }  /* END MUArrayListFree() */
 
@@ -802,7 +745,14 @@ void *MUArrayListGetPtr(
 /*
  * Removes, and frees, the item at the given index.
  * Also marks the index as empty and available for further
- * insertions.
+ * insertions (see MUArrayListInsertPtr()).
+ *
+ * NOTE: NumItems still counts the empty slot, so loops over
+ * [0,NumItems) must skip MEMPTYSLOT entries (as
+ * MUArrayListFreePtrElements() does) until MUArrayListCompact() is called.
+ * The number of live items is NumItems - NumFree.
+ *
+ * WARNING: Only use on an Moab array list that stores pointers!
  *
  * @param ArrayP (I)The arraylist pointer.
  * @param Index (I) The index of the element to remove.
@@ -823,13 +773,25 @@ int MUArrayListRemove(
     return(FAILURE);
     }
 
-  if ((Index < 0) || (Index >= ArrayP->ArraySize -1)) /* ArrayP->ArraySize -1 is NULL */
+  if ((Index < 0) || (Index >= ArrayP->NumItems))
     {
     return(FAILURE);
     }
 
   tmpArray = (void **)ArrayP->Array;
 
+  if (tmpArray[Index] == MEMPTYSLOT)
+    {
+    /* already removed */
+
+    return(FAILURE);
+    }
+
+  if (__MUArrayListPushFree(ArrayP,Index) == FAILURE)
+    {
+    return(FAILURE);
+    }
+
   if (FreeItem == TRUE)
     {
     MUFree((char **)&tmpArray[Index]);
@@ -837,12 +799,94 @@ int MUArrayListRemove(
 
   tmpArray[Index] = MEMPTYSLOT; /* mark empty */
 
-  __MUArrayListSetEmpty(ArrayP,Index);
+  return(SUCCESS);
+  } /* END int MUArrayListRemove() */
+
+
+
+
+/**
+ * Removes Count items, by index, as with MUArrayListRemove().  Indexes that
+ * are out of range or already empty are skipped.
+ *
+ * @param ArrayP    (I) [modified]
+ * @param IndexList (I) Count indexes
+ * @param Count     (I)
+ * @param FreeItem  (I) Whether or not to free allocation memory.
+ * @return The number of items removed, or -1 on failure.
+ */
+
+int MUArrayListRemoveN(
+
+  marray_t *ArrayP,
+  int      *IndexList,
+  int       Count,
+  mbool_t   FreeItem)
+
+  {
+  int index;
+  int Removed = 0;
+
+  if ((ArrayP == NULL) || ((IndexList == NULL) && (Count > 0)))
+    {
+    return(-1);
+    }
+
+  for (index = 0;index < Count;index++)
+    {
+    if (MUArrayListRemove(ArrayP,IndexList[index],FreeItem) == SUCCESS)
+      Removed++;
+    }
+
+  return(Removed);
+  } /* END int MUArrayListRemoveN() */
+
+
+
+
+/**
+ * Squeezes the empty slots left by MUArrayListRemove() out of a pointer
+ * marray, keeping the live items in their original order, so the array can
+ * again be walked over [0,NumItems) without checking for empty slots.
+ *
+ * @param ArrayP (I) [modified]
+ */
+
+int MUArrayListCompact(
+
+  marray_t *ArrayP)
+
+  {
+  void **tmpArray;
+
+  int    sindex;
+  int    dindex;
+
+  if (ArrayP == NULL)
+    {
+    return(FAILURE);
+    }
+
+  if (ArrayP->NumFree == 0)
+    {
+    return(SUCCESS);
+    }
+
+  tmpArray = (void **)ArrayP->Array;
+
+  for (sindex = 0,dindex = 0;sindex < ArrayP->NumItems;sindex++)
+    {
+    if (tmpArray[sindex] != MEMPTYSLOT)
+      tmpArray[dindex++] = tmpArray[sindex];
+    }
+
+  memset(&tmpArray[dindex],0x0,sizeof(void *) * (ArrayP->NumItems - dindex));
 
-  ArrayP->NumItems--;
+  ArrayP->NumItems = dindex;
+  ArrayP->NumFree = 0;
 
   return(SUCCESS);
-  } /* END int MUArrayListRemove() */
+  } /* END int MUArrayListCompact() */
 
 
 /**
@@ -918,6 +962,18 @@ int MUArrayListCopy(
   DstList->ElementSize = SrcList->ElementSize;
   DstList->NumItems = SrcList->NumItems;
 
+  /* empty slots were copied too, so keep them reusable */
+
+  if (SrcList->NumFree > 0)
+    {
+    DstList->FreeList = (int *)MUMalloc(sizeof(int) * SrcList->NumFree);
+
+    memcpy(DstList->FreeList,SrcList->FreeList,sizeof(int) * SrcList->NumFree);
+
+    DstList->NumFree = SrcList->NumFree;
+    DstList->FreeListSize = SrcList->NumFree;
+    }
+
   return(SUCCESS);
   }  /* END MUArrayListCopy() */
 
@@ -987,6 +1043,13 @@ int MUArrayListCopyPtrElements(
 
     for (i = 0;i < SrcList->NumItems;i++)
       {
+      if (SrcA[i] == MEMPTYSLOT)
+        {
+        /* leave empty slots NULL */
+
+        continue;
+        }
+
       tmpPtr = MUMalloc(ObjectSize);
 
       memcpy(tmpPtr,SrcA[i],ObjectSize);
@@ -1001,7 +1064,8 @@ int MUArrayListCopyPtrElements(
 
     for (i = 0;i < SrcList->NumItems;i++)
       {
-      MUStrDup(&DstStrA[i],SrcStrA[i]);
+      if (SrcStrA[i] != (char *)MEMPTYSLOT)
+        MUStrDup(&DstStrA[i],SrcStrA[i]);
       }
     }
 
@@ -73,6 +73,13 @@ int MUIAcceptRequests(
   {
   msocket_t *S;
 
+  /* sockets dequeued in one batch but not yet serviced (kept across calls
+     so a request that ends the service loop early does not drop the rest) */
+
+  static msocket_t *SBatch[MDEF_SOCKETDEQUEUEBATCH];
+  static int        SBatchCount = 0;
+  static int        SBatchIndex = 0;
+
   long    now = 0;
 
   mulong  ETime;
@@ -284,8 +291,19 @@ int MUIAcceptRequests(
 
     /* service clients */
  
-    while (MSysDequeueSocket(&S) != FAILURE)
+    for (;;)
       {
+      if (SBatchIndex >= SBatchCount)
+        {
+        SBatchIndex = 0;
+        SBatchCount = MSysDequeueSocketBatch(SBatch,MDEF_SOCKETDEQUEUEBATCH);
+
+        if (SBatchCount <= 0)
+          break;
+        }
+
+      S = SBatch[SBatchIndex++];
+
       LogLevelOverridden = FALSE;
 
       if ((MSched.LogLevelOverride == TRUE) && 
@@ -432,7 +450,7 @@ int MUIAcceptRequests(
 
       MSUFree(S);
       MUFree((char **)&S);
-      }    /* END while (MSysDequeueSocket()) */
+      }    /* END for (;;) */
 
     if (MSched.EnableHighThroughput == TRUE)
       {
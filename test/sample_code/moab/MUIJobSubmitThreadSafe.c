@@ -40,6 +40,10 @@ int MUIJobSubmitThreadSafe(
 
   mjob_submit_t *JSubmit = NULL;
 
+  mtransjob_t *TJ = NULL;
+
+  mstring_t JString(MMAX_LINE);
+
   mxml_t *CE = NULL;
 	mxml_t *tmpJE = NULL;
 
@@ -74,15 +78,36 @@ int MUIJobSubmitThreadSafe(
 
   MUStrCpy(JSubmit->User,Auth,sizeof(JSubmit->User));
 
-  MSysAddJobSubmitToQueue(JSubmit,&ID,TRUE);
+  /* once queued, JSubmit and CE belong to the scheduler thread - build the
+     journal entry and the transition first, the job name follows the ID */
+
+  MXMLToMString(CE,&JString,NULL,TRUE);
+
+  MJobTransitionAllocate(&TJ);
 
-  JSubmit->ID = ID;
+  Name[0] = '\0';
 
-  MSysAddJobSubmitToJournal(JSubmit);
+  MJobXMLToTransitionStruct(CE,Name,TJ);
+
+  TJ->SubmitTime = MSched.Time;
+  TJ->QueueTime  = MSched.Time;
+
+  if (MSysAddJobSubmitToQueue(JSubmit,&ID,TRUE,&JString) == FAILURE)
+    {
+    MJobTransitionFree((void **)&TJ);
+
+    MJobSubmitDestroy(&JSubmit);
+
+    MUISAddData(S,"ERROR:    job submit queue is full - try again later\n");
+
+    return(FAILURE);
+    }
 
   snprintf(Name,sizeof(Name),"%d",ID);
 
-  MJobXMLTransition(CE,Name);
+  MUStrCpy(TJ->Name,Name,sizeof(TJ->Name));
+
+  MOExportTransition(mxoJob,TJ);
 
   MUISAddData(S,Name);
 
@@ -19,6 +19,292 @@
 #include "moab-const.h"
 
 
+/* NOTE:  once a list reaches MDEF_LLINDEXTHRESHOLD items, MULLAdd() attaches
+ *        an index to its head node so that MULLAdd(), MULLCheck() and
+ *        MULLCheckCS() find names by hash instead of walking the list.  The
+ *        list itself (and so iteration order) is unchanged.  Each lower-cased
+ *        name maps to the first node that carries it in any case, as the
+ *        case-insensitive walk would find; case-sensitive lookups continue
+ *        from there on the (rare) occasion that its case differs.  Names
+ *        too long for a key are not indexed and are always looked up by
+ *        walking.
+ *
+ *        The index moves with the head (MULLPrepend(), MULLRemove()) and is
+ *        kept up to date by the MULL* routines.  If the list is modified any
+ *        other way (ListSize or the tail no longer match) the index is
+ *        ignored by lookups and rebuilt by the next MULLAdd(). */
+
+typedef struct mlnindex_t {
+  mhash_t  NamesCI;   /* lower-cased name -> first node with that name in any case */
+  mln_t   *Tail;      /* last node in the list (MULLAdd() appends here) */
+  mln_t   *All;       /* first node named "ALL" in any case (MULLCheck() wildcard) */
+  int      ListSize;  /* head's ListSize when the index was last updated */
+  } mlnindex_t;
+
+
+
+
+/**
+ * Lower-case Name into Key.  Names that don't fit are not indexed.
+ *
+ * @param Name    (I)
+ * @param Key     (O)
+ * @param KeySize (I)
+ */
+
+int __MULLIndexKey(
+
+  char const *Name,
+  char       *Key,
+  int         KeySize)
+
+  {
+  size_t NameLen = strlen(Name);
+
+  if (NameLen >= (size_t)KeySize)
+    {
+    return(FAILURE);
+    }
+
+  memcpy(Key,Name,NameLen + 1);
+
+  MUStrToLower(Key);
+
+  return(SUCCESS);
+  }  /* END __MULLIndexKey() */
+
+
+
+
+/**
+ * Free the index on a list head (the list itself is untouched).
+ *
+ * @param Head (I) [modified]
+ */
+
+int __MULLIndexFree(
+
+  mln_t *Head)
+
+  {
+  if ((Head == NULL) || (Head->Index == NULL))
+    {
+    return(SUCCESS);
+    }
+
+  MUHTFree(&Head->Index->NamesCI,FALSE,NULL);
+
+  MUFree((char **)&Head->Index);
+
+  return(SUCCESS);
+  }  /* END __MULLIndexFree() */
+
+
+
+
+/**
+ * Report whether Head carries an index that still describes its list.
+ *
+ * @param Head (I)
+ */
+
+mbool_t __MULLIndexIsValid(
+
+  mln_t *Head)
+
+  {
+  mlnindex_t *Index;
+
+  if ((Head == NULL) || (Head->Index == NULL))
+    {
+    return(FALSE);
+    }
+
+  Index = Head->Index;
+
+  if ((Index->ListSize != Head->ListSize) ||
+      (Index->Tail == NULL) ||
+      (Index->Tail->Next != NULL))
+    {
+    return(FALSE);
+    }
+
+  return(TRUE);
+  }  /* END __MULLIndexIsValid() */
+
+
+
+
+/**
+ * Index Node by name.  If First is TRUE, Node is now the first node in the
+ * list (MULLPrepend()); otherwise it only becomes the entry for its name if
+ * that name has none yet.  Names too long for a key are skipped.
+ *
+ * @param Index (I) [modified]
+ * @param Node  (I)
+ * @param First (I)
+ */
+
+int __MULLIndexAddNode(
+
+  mlnindex_t *Index,
+  mln_t      *Node,
+  mbool_t     First)
+
+  {
+  char Key[MMAX_LINE];
+
+  if (Node->Name == NULL)
+    {
+    return(SUCCESS);
+    }
+
+  if (__MULLIndexKey(Node->Name,Key,sizeof(Key)) == FAILURE)
+    {
+    return(SUCCESS);
+    }
+
+  if ((First == TRUE) || (MUHTGet(&Index->NamesCI,Key,NULL,NULL) == FAILURE))
+    {
+    if (MUHTAdd(&Index->NamesCI,Key,(void *)Node,NULL,NULL) == FAILURE)
+      {
+      return(FAILURE);
+      }
+
+    if (!strcmp(Key,"all"))
+      Index->All = Node;
+    }
+
+  return(SUCCESS);
+  }  /* END __MULLIndexAddNode() */
+
+
+
+
+/**
+ * (Re)build the index for the list starting at Head.
+ *
+ * @param Head (I) [modified]
+ * @return FAILURE (and no index) if memory runs out.
+ */
+
+int __MULLIndexBuild(
+
+  mln_t *Head)
+
+  {
+  mln_t *ptr;
+
+  if (Head == NULL)
+    {
+    return(FAILURE);
+    }
+
+  __MULLIndexFree(Head);
+
+  if ((Head->Index = (mlnindex_t *)MUCalloc(1,sizeof(mlnindex_t))) == NULL)
+    {
+    return(FAILURE);
+    }
+
+  for (ptr = Head;ptr != NULL;ptr = ptr->Next)
+    {
+    if (__MULLIndexAddNode(Head->Index,ptr,FALSE) == FAILURE)
+      {
+      __MULLIndexFree(Head);
+
+      return(FAILURE);
+      }
+
+    Head->Index->Tail = ptr;
+    }
+
+  Head->Index->ListSize = Head->ListSize;
+
+  return(SUCCESS);
+  }  /* END __MULLIndexBuild() */
+
+
+
+
+/**
+ * Find the first node named exactly Name using Head's index.
+ *
+ * @param Head (I) list head with a valid index
+ * @param Name (I)
+ * @param Key  (I) Name lower-cased
+ * @return the node, or NULL if Name is not in the list.
+ */
+
+mln_t *__MULLIndexFind(
+
+  mln_t      *Head,
+  char const *Name,
+  char const *Key)
+
+  {
+  mln_t *ptr;
+
+  if (MUHTGet(&Head->Index->NamesCI,Key,(void **)&ptr,NULL) == FAILURE)
+    {
+    return(NULL);
+    }
+
+  /* ptr is the first node with this name in any case--usually Name itself */
+
+  for (;ptr != NULL;ptr = ptr->Next)
+    {
+    if ((ptr->Name != NULL) && !strcmp(ptr->Name,Name))
+      break;
+    }
+
+  return(ptr);
+  }  /* END __MULLIndexFind() */
+
+
+
+
+/**
+ * Replace the payload of an existing node, as MULLAdd() does when Name
+ * is already in the list.
+ *
+ * @param ptr  (I) [modified]
+ * @param DPtr (I) [optional]
+ * @param Fn   (I) [optional]
+ */
+
+void __MULLSetPtr(
+
+  mln_t  *ptr,
+  void   *DPtr,
+  int   (*Fn)(void **))
+
+  {
+  /* Check for an existing payload pointer, if none, set with new payload ptr */
+  if (ptr->Ptr == NULL)
+    {
+    ptr->Ptr = DPtr;
+    }
+  else if ((DPtr != NULL) && (DPtr != ptr->Ptr))
+    {
+    /* new payload pointer does NOT this control node's payload
+     * ptr, so need to deconstruct the old payload ptr THEN
+     * we set the new payload ptr into the existing control node
+     */
+
+    /* Check if payload pointer is present, if so go deconstruct it */
+    if ((ptr->Ptr != NULL) && (Fn != NULL))
+      {
+      (*Fn)(&ptr->Ptr);   /* call payload deconstructor w/payload ptr */
+      }
+
+    ptr->Ptr = DPtr;      /* set the new payload ptr into control node */
+    }
+
+  return;
+  }  /* END __MULLSetPtr() */
+
+
 /**
  * Creates a new head for a linked-list.
  *
@@ -104,18 +390,43 @@ int MULLPrepend(
   OldHead = *LHead;
 
   MUStrDup(&NewLink->Name,Name);
+  NewLink->NameLen = (Name != NULL) ? strlen(Name) : 0;
   NewLink->Ptr = DPtr;
   NewLink->Next = OldHead;
 
   if (OldHead != NULL)
+    {
     NewLink->ListSize = OldHead->ListSize + 1;
+
+    /* the index belongs to the head */
+
+    if (__MULLIndexIsValid(OldHead) == TRUE)
+      {
+      NewLink->Index = OldHead->Index;
+      OldHead->Index = NULL;
+      }
+    else
+      {
+      __MULLIndexFree(OldHead);
+      }
+    }
   else
+    {
     NewLink->ListSize = 1;
+    }
 
   *LHead = NewLink;
 
+  if (NewLink->Index != NULL)
+    {
+    NewLink->Index->ListSize = NewLink->ListSize;
+
+    if (__MULLIndexAddNode(NewLink->Index,NewLink,TRUE) == FAILURE)
+      __MULLIndexFree(NewLink);
+    }
+
   return(SUCCESS);
-  }
+  }  /* END MULLPrepend() */
 
 
 
@@ -137,6 +448,9 @@ int MULLPrepend(
  * NOTE:  DPtr is not allocated when attached to object
  * NOTE:  will override matching node
  * NOTE:  matching is case sensitive
+ * NOTE:  once the list holds MDEF_LLINDEXTHRESHOLD items, names are found
+ *        through a hash index on the head and new items are appended at
+ *        the remembered tail, so adds no longer walk the list
  * 
  * @param LHead (I/O) [modified] The head of the list--a new list is created 
  *    if *LHead == NULL.
@@ -160,6 +474,11 @@ int MULLAdd(
   mln_t *ptr;
   mln_t *prev;
 
+  mlnindex_t *Index = NULL;
+
+  char    Key[MMAX_LINE];
+  mbool_t Walk = TRUE;
+
   const char *FName = "MULLAdd";
 
   MDB(8,fSTRUCT) MLog("%s(%s,%s,%s,LP,%s)\n",
@@ -182,13 +501,38 @@ int MULLAdd(
 
   ptr = *LHead;
 
+  if ((ptr != NULL) && (ptr->ListSize >= MDEF_LLINDEXTHRESHOLD))
+    {
+    if ((__MULLIndexIsValid(ptr) == TRUE) || (__MULLIndexBuild(ptr) == SUCCESS))
+      Index = ptr->Index;
+    }
+
+  if ((Index != NULL) && (__MULLIndexKey(Name,Key,sizeof(Key)) == SUCCESS))
+    {
+    /* long list - look the name up instead of walking */
+
+    if ((ptr = __MULLIndexFind(*LHead,Name,Key)) != NULL)
+      {
+      if (LP != NULL)
+        *LP = ptr;
+
+      __MULLSetPtr(ptr,DPtr,Fn);
+
+      return(SUCCESS);
+      }
+
+    prev = Index->Tail;
+
+    Walk = FALSE;
+    }
+
   /* walk the list looking for:
    *  1) last node: then break out of loop
    *  2) If found a matching name, or an empty node, use it and return now
    *     An empty node is pre-allocated after a call to MULLCreate()
    *     has occurred, so this code handles this.
    */
-  while (ptr != NULL)
+  while ((Walk == TRUE) && (ptr != NULL))
     {
     /* If we encounter a control node w/o a name OR the new node name matches 
      * an existing node name, then set the new node's info into this existing 
@@ -214,26 +558,7 @@ int MULLAdd(
         (*LHead)->ListSize++;  /* we've added a new item to this list */
         }
 
-      /* Check for an existing payload pointer, if none, set with new payload ptr */
-      if (ptr->Ptr == NULL)
-        {
-        ptr->Ptr = DPtr;
-        }
-      else if ((DPtr != NULL) && (DPtr != ptr->Ptr))
-        {
-        /* new payload pointer does NOT this control node's payload
-         * ptr, so need to deconstruct the old payload ptr THEN
-         * we set the new payload ptr into the existing control node
-         */
-
-        /* Check if payload pointer is present, if so go deconstruct it */
-        if ((ptr->Ptr != NULL) && (Fn != NULL))
-          {
-          (*Fn)(&ptr->Ptr);   /* call payload deconstructor w/payload ptr */
-          }
-
-        ptr->Ptr = DPtr;      /* set the new payload ptr into control node */
-        }
+      __MULLSetPtr(ptr,DPtr,Fn);
 
       return(SUCCESS);
       }  /* END if (!strcmp(ptr->Name,Name)) */
@@ -278,6 +603,15 @@ int MULLAdd(
 
   (*LHead)->ListSize++;
 
+  if (Index != NULL)
+    {
+    Index->Tail = ptr;
+    Index->ListSize = (*LHead)->ListSize;
+
+    if (__MULLIndexAddNode(Index,ptr,FALSE) == FAILURE)
+      __MULLIndexFree(*LHead);
+    }
+
   if (LP != NULL)
     *LP = ptr;
 
@@ -413,7 +747,10 @@ int MULLRemove(
   mln_t *ptr;
   mln_t *next;
 
+  mln_t *FirstCI = NULL;  /* first remaining node matching Name in any case (indexed lists) */
+
   mbool_t FoundName = FALSE;
+  mbool_t Indexed;
 
   const char *FName = "MULLRemove";
 
@@ -434,15 +771,40 @@ int MULLRemove(
 
   MUStrDup(&tName,Name);
 
+  if (__MULLIndexIsValid(*LHead) == TRUE)
+    {
+    Indexed = TRUE;
+    }
+  else
+    {
+    Indexed = FALSE;
+
+    __MULLIndexFree(*LHead);
+    }
+
   for (ptr = *LHead;ptr != NULL;ptr = next)
     {
     if (ptr->Name == NULL)
+      {
+      /* the walk ends early, so the index can't be fixed up below */
+
+      if (Indexed == TRUE)
+        {
+        __MULLIndexFree(*LHead);
+
+        Indexed = FALSE;
+        }
+
       break;
+      }
 
     if (strcmp(ptr->Name,tName))
       {
       /* current node does not match */
 
+      if ((Indexed == TRUE) && (FirstCI == NULL) && !strcasecmp(ptr->Name,tName))
+        FirstCI = ptr;
+
       Prev = ptr;
 
       next = ptr->Next;
@@ -461,6 +823,16 @@ int MULLRemove(
       if (*LHead != NULL)
         {
         (*LHead)->ListSize = ptr->ListSize;
+
+        (*LHead)->Index = ptr->Index;
+
+        ptr->Index = NULL;
+        }
+      else
+        {
+        __MULLIndexFree(ptr);
+
+        Indexed = FALSE;
         }
       }
     else
@@ -490,6 +862,30 @@ int MULLRemove(
     FoundName = TRUE;
     }  /* END for (ptr) */
 
+  if ((Indexed == TRUE) && (FoundName == TRUE))
+    {
+    /* every node named tName is gone; the walk found the new first match
+       in any case and the new tail (Prev) */
+
+    char Key[MMAX_LINE];
+
+    mlnindex_t *Index = (*LHead)->Index;
+
+    if (__MULLIndexKey(tName,Key,sizeof(Key)) == SUCCESS)
+      {
+      MUHTRemove(&Index->NamesCI,Key,NULL);
+
+      if (FirstCI != NULL)
+        MUHTAdd(&Index->NamesCI,Key,(void *)FirstCI,NULL,NULL);
+
+      if (!strcmp(Key,"all"))
+        Index->All = FirstCI;
+      }
+
+    Index->Tail = Prev;
+    Index->ListSize = (*LHead)->ListSize;
+    }
+
   MUFree(&tName);
 
   if (FoundName == TRUE)
@@ -808,6 +1204,8 @@ int MULLFree(
     return(SUCCESS);
     }
 
+  __MULLIndexFree(*Head);
+
   /* Walk the entire list, cleaning each node on the list */
   for (ptr = *Head;ptr != NULL;ptr = next)
     {
@@ -875,6 +1273,8 @@ int MULLCheck(
   mln_t *ptr;
   int ValueLen;
 
+  char Key[MMAX_LINE];
+
   if (LP != NULL)
     *LP = NULL;
 
@@ -883,6 +1283,32 @@ int MULLCheck(
     return(FAILURE);
     }
 
+  if ((__MULLIndexIsValid(Head) == TRUE) &&
+      (__MULLIndexKey(Value,Key,sizeof(Key)) == SUCCESS))
+    {
+    mln_t *Match = NULL;
+    mln_t *All = Head->Index->All;
+
+    MUHTGet(&Head->Index->NamesCI,Key,(void **)&Match,NULL);
+
+    /* with both a match and an "ALL" node, only the walk knows which is first */
+
+    if ((Match == NULL) || (All == NULL) || (Match == All))
+      {
+      ptr = (Match != NULL) ? Match : All;
+
+      if (ptr == NULL)
+        {
+        return(FAILURE);
+        }
+
+      if (LP != NULL)
+        *LP = ptr;
+
+      return(SUCCESS);
+      }
+    }
+
   ValueLen = strlen(Value);
 
   for (ptr = Head;ptr != NULL;ptr = ptr->Next)
@@ -994,6 +1420,8 @@ int MULLCheckCS(
   mln_t *ptr;
   int ValueLen;
 
+  char Key[MMAX_LINE];
+
   if (LP != NULL)
     *LP = NULL;
 
@@ -1002,6 +1430,20 @@ int MULLCheckCS(
     return(FAILURE);
     }
 
+  if ((__MULLIndexIsValid(Head) == TRUE) &&
+      (__MULLIndexKey(Value,Key,sizeof(Key)) == SUCCESS))
+    {
+    if ((ptr = __MULLIndexFind(Head,Value,Key)) == NULL)
+      {
+      return(FAILURE);
+      }
+
+    if (LP != NULL)
+      *LP = ptr;
+
+    return(SUCCESS);
+    }
+
   ValueLen = strlen(Value);
 
   for (ptr = Head;ptr != NULL;ptr = ptr->Next)
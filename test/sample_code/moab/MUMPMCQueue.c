@@ -0,0 +1,400 @@
+/* HEADER */
+
+/**
+ * @file MUMPMCQueue.c
+ *
+ * Bounded lock-free multi-producer/multi-consumer queue functions
+ *
+ * NOTE: array of cells, each stamped with a sequence number (ticket).  A
+ *       producer owns cell (EnqueuePos & Mask) once Seq == EnqueuePos and it
+ *       wins the CAS on EnqueuePos, it then stores Data and publishes
+ *       Seq = pos + 1.  Consumers do the same against DequeuePos and hand
+ *       the cell back to the next lap's producer with Seq = pos + Size.  No
+ *       locks are taken and an enqueue never waits on a dequeue (or vice
+ *       versa) other than for a full/empty queue.  FullMutex/NotFull are
+ *       only used by producers that choose to block on a full queue
+ *       (MUMPMCQueueEnqueueWait()).
+ *
+ */
+
+#include "moab.h"
+#include "moab-proto.h"
+
+#ifndef STATIC
+#define STATIC static
+#endif
+
+
+
+/**
+ * Creates a new queue holding up to Size entries and returns it, or returns
+ * NULL on failure.
+ *
+ * @param Size (I) [rounded up to a power of 2]
+ */
+
+mmpmcq_t *MUMPMCQueueCreate(
+
+  unsigned int Size) /* I */
+
+  {
+  mmpmcq_t *Q;
+
+  mulong    cindex;
+  mulong    Capacity = 2;
+
+  while (Capacity < Size)
+    Capacity <<= 1;
+
+  Q = (mmpmcq_t *)MUCalloc(1,sizeof(mmpmcq_t));
+
+  if (Q == NULL)
+    return(NULL);
+
+  Q->Cell = (mmpmcqcell_t *)MUCalloc(Capacity,sizeof(mmpmcqcell_t));
+
+  if (Q->Cell == NULL)
+    {
+    MUFree((char **)&Q);
+
+    return(NULL);
+    }
+
+  for (cindex = 0;cindex < Capacity;cindex++)
+    {
+    Q->Cell[cindex].Seq  = cindex;
+    Q->Cell[cindex].Data = NULL;
+    }
+
+  Q->Mask       = Capacity - 1;
+  Q->EnqueuePos = 0;
+  Q->DequeuePos = 0;
+
+#ifdef MTHREADSAFE
+  Q->FullWaiters = 0;
+
+  pthread_mutex_init(&Q->FullMutex,NULL);
+  pthread_cond_init(&Q->NotFull,NULL);
+#endif /* MTHREADSAFE */
+
+  return(Q);
+  } /* END MUMPMCQueueCreate */
+
+
+
+
+/**
+ * Frees the queue and its cells.
+ * This does NOT free any data stored in the queue!
+ *
+ * NOTE: not thread safe - all producers/consumers must be done.
+ *
+ * @param Q (I) [freed]
+ */
+
+void MUMPMCQueueFree(
+
+  mmpmcq_t *Q) /* I */
+
+  {
+  if (Q == NULL)
+    return;
+
+#ifdef MTHREADSAFE
+  pthread_cond_destroy(&Q->NotFull);
+  pthread_mutex_destroy(&Q->FullMutex);
+#endif /* MTHREADSAFE */
+
+  MUFree((char **)&Q->Cell);
+  MUFree((char **)&Q);
+
+  return;
+  } /* END MUMPMCQueueFree */
+
+
+
+
+/**
+ * Append Data to the tail of the queue.
+ *
+ * @param Q    (I/O)
+ * @param Data (I)
+ *
+ * @return FAILURE if the queue is full.
+ */
+
+int MUMPMCQueueEnqueue(
+
+  mmpmcq_t *Q,    /* I/O */
+  void     *Data) /* I */
+
+  {
+  mmpmcqcell_t *C;
+
+  mulong pos;
+  mulong seq;
+  long   dif;
+
+  pos = Q->EnqueuePos;
+
+  for (;;)
+    {
+    C = &Q->Cell[pos & Q->Mask];
+
+    seq = C->Seq;
+
+    __sync_synchronize();
+
+    dif = (long)seq - (long)pos;
+
+    if (dif == 0)
+      {
+      /* cell is free for this ticket - try to claim it */
+
+      if (__sync_bool_compare_and_swap(&Q->EnqueuePos,pos,pos + 1))
+        break;
+
+      pos = Q->EnqueuePos;
+      }
+    else if (dif < 0)
+      {
+      /* previous lap's entry has not been dequeued - queue is full */
+
+      return(FAILURE);
+      }
+    else
+      {
+      /* another producer took this ticket */
+
+      pos = Q->EnqueuePos;
+      }
+    }  /* END for (;;) */
+
+  C->Data = Data;
+
+  __sync_synchronize();
+
+  C->Seq = pos + 1;
+
+  return(SUCCESS);
+  } /* END MUMPMCQueueEnqueue */
+
+
+
+
+/**
+ * Append Data to the tail of the queue, blocking while the queue is full.
+ * Blocked producers are woken once consumers have drained it to half full.
+ *
+ * NOTE: must not be called by the queue's only consumer.  Without thread
+ *       support this cannot wait and behaves like MUMPMCQueueEnqueue().
+ *
+ * @param Q    (I/O)
+ * @param Data (I)
+ *
+ * @return FAILURE if the queue is full and waiting is not possible.
+ */
+
+int MUMPMCQueueEnqueueWait(
+
+  mmpmcq_t *Q,    /* I/O */
+  void     *Data) /* I */
+
+  {
+  if (MUMPMCQueueEnqueue(Q,Data) == SUCCESS)
+    {
+    return(SUCCESS);
+    }
+
+#ifdef MTHREADSAFE
+  pthread_mutex_lock(&Q->FullMutex);
+
+  /* advertise the wait before retrying so a consumer that frees a cell
+     after our retry is guaranteed to see us and signal */
+
+  __sync_fetch_and_add(&Q->FullWaiters,1);
+
+  while (MUMPMCQueueEnqueue(Q,Data) == FAILURE)
+    {
+    pthread_cond_wait(&Q->NotFull,&Q->FullMutex);
+    }
+
+  __sync_fetch_and_sub(&Q->FullWaiters,1);
+
+  pthread_mutex_unlock(&Q->FullMutex);
+
+  return(SUCCESS);
+#else /* MTHREADSAFE */
+  return(FAILURE);
+#endif /* MTHREADSAFE */
+  } /* END MUMPMCQueueEnqueueWait */
+
+
+
+
+/**
+ * Remove the entry at the head of the queue.
+ *
+ * @param Q    (I/O)
+ * @param Data (O)
+ *
+ * @return FAILURE if the queue is empty.
+ */
+
+int MUMPMCQueueDequeue(
+
+  mmpmcq_t  *Q,    /* I/O */
+  void     **Data) /* O */
+
+  {
+  return((MUMPMCQueueDequeueBatch(Q,Data,1) == 1) ? SUCCESS : FAILURE);
+  } /* END MUMPMCQueueDequeue */
+
+
+
+
+/**
+ * Remove up to MaxCount consecutive entries from the head of the queue with
+ * a single CAS, preserving queue order in DataList.
+ *
+ * @param Q        (I/O)
+ * @param DataList (O) [minsize=MaxCount]
+ * @param MaxCount (I)
+ *
+ * @return number of entries removed (0 if the queue is empty).
+ */
+
+int MUMPMCQueueDequeueBatch(
+
+  mmpmcq_t  *Q,        /* I/O */
+  void     **DataList, /* O */
+  int        MaxCount) /* I */
+
+  {
+  mmpmcqcell_t *C;
+
+  mulong pos;
+  mulong seq;
+  long   dif;
+
+  int    count;
+  int    dindex;
+
+  if ((Q == NULL) || (DataList == NULL) || (MaxCount <= 0))
+    {
+    return(0);
+    }
+
+  pos = Q->DequeuePos;
+
+  for (;;)
+    {
+    /* count the run of published entries starting at our ticket */
+
+    for (count = 0;count < MaxCount;count++)
+      {
+      seq = Q->Cell[(pos + count) & Q->Mask].Seq;
+
+      if (seq != pos + count + 1)
+        break;
+      }
+
+    __sync_synchronize();
+
+    if (count == 0)
+      {
+      dif = (long)Q->Cell[pos & Q->Mask].Seq - (long)(pos + 1);
+
+      if (dif < 0)
+        {
+        /* head cell not yet published - queue is empty */
+
+        return(0);
+        }
+
+      /* another consumer took this ticket */
+
+      pos = Q->DequeuePos;
+
+      continue;
+      }
+
+    if (__sync_bool_compare_and_swap(&Q->DequeuePos,pos,pos + count))
+      break;
+
+    pos = Q->DequeuePos;
+    }  /* END for (;;) */
+
+  /* cells pos .. pos + count - 1 now belong to this consumer */
+
+  for (dindex = 0;dindex < count;dindex++)
+    {
+    C = &Q->Cell[(pos + dindex) & Q->Mask];
+
+    DataList[dindex] = C->Data;
+    }
+
+  __sync_synchronize();
+
+  for (dindex = 0;dindex < count;dindex++)
+    {
+    C = &Q->Cell[(pos + dindex) & Q->Mask];
+
+    C->Seq = pos + dindex + Q->Mask + 1;
+    }
+
+#ifdef MTHREADSAFE
+  __sync_synchronize();
+
+  if ((Q->FullWaiters > 0) &&
+      (MUMPMCQueueSize(Q) <= (int)((Q->Mask + 1) >> 1)))
+    {
+    /* wake producers blocked in MUMPMCQueueEnqueueWait() once the queue is
+       half drained - waking them per freed cell costs a switch per item */
+
+    pthread_mutex_lock(&Q->FullMutex);
+
+    pthread_cond_broadcast(&Q->NotFull);
+
+    pthread_mutex_unlock(&Q->FullMutex);
+    }
+#endif /* MTHREADSAFE */
+
+  return(count);
+  } /* END MUMPMCQueueDequeueBatch */
+
+
+
+
+/**
+ * Returns the number of entries in the queue.
+ *
+ * NOTE: approximate while producers/consumers are active.
+ *
+ * @param Q (I)
+ */
+
+int MUMPMCQueueSize(
+
+  mmpmcq_t *Q) /* I */
+
+  {
+  mulong dpos;
+  mulong epos;
+
+  if (Q == NULL)
+    return(0);
+
+  dpos = Q->DequeuePos;
+
+  __sync_synchronize();
+
+  epos = Q->EnqueuePos;
+
+  if (epos <= dpos)
+    return(0);
+
+  return((int)MIN(epos - dpos,Q->Mask + 1));
+  } /* END MUMPMCQueueSize */
+
+/* END MUMPMCQueue.c */
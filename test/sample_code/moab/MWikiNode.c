@@ -293,6 +293,140 @@ int MWikiNodeUpdate(
 
 
 
+/**
+ * Load the filesystem list reported in a WIKI AFS or CFS value.
+ *
+ * The value is scanned in place with the XML pull parser, no tree is built.
+ *
+ * FORMAT:  <fs id="X" size="X" io="Y" [rcount="X" wcount="X" ocount="X"]></fs>...
+ *
+ * @param N     (I) [modified]
+ * @param Value (I)
+ * @param IsCfg (I) configured (CFS) rather than available (AFS) values
+ */
+
+int __MWikiNodeLoadFS(
+
+  mnode_t    *N,
+  const char *Value,
+  mbool_t     IsCfg)
+
+  {
+  mxmlpull_t P;
+  mxmlview_t AVal;
+
+  enum MXMLPullEventEnum Event;
+
+  int     fsindex;
+
+  char    tmpLine[MMAX_LINE];
+
+  if ((N == NULL) || (Value == NULL))
+    {
+    return(FAILURE);
+    }
+
+  if (N->FSys == NULL)
+    {
+    N->FSys = (mfsys_t *)MUCalloc(1,sizeof(mfsys_t));
+    }
+
+  MXMLPullInit(&P,Value,-1);
+
+  while ((MXMLPullNext(&P,&Event) == SUCCESS) && (Event != mxpeEOF))
+    {
+    if (Event != mxpeStart)
+      continue;
+
+    if ((MXMLPullGetAttr(&P,"id",&AVal) == FAILURE) ||
+        (MXMLViewDecode(&AVal,tmpLine,sizeof(tmpLine)) == FAILURE))
+      {
+      MXMLPullSkip(&P);
+
+      continue;
+      }
+
+    for (fsindex = 0;fsindex < MMAX_FSYS;fsindex++)
+      {
+      if (N->FSys->Name[fsindex] == NULL)
+        {
+        /* add new filesystem */
+
+        MUStrDup(&N->FSys->Name[fsindex],tmpLine);
+
+        break;
+        }
+
+      if (!strcmp(N->FSys->Name[fsindex],tmpLine))
+        {
+        /* filesystem located */
+
+        break;
+        }
+      }    /* END for (fsindex) */
+
+    if (fsindex >= MMAX_FSYS)
+      {
+      /* max filesystem count exceeded */
+
+      /* ignore current filesystem */
+
+      MXMLPullSkip(&P);
+
+      continue;
+      }
+
+    if ((MXMLPullGetAttr(&P,"size",&AVal) == SUCCESS) &&
+        (MXMLViewDecode(&AVal,tmpLine,sizeof(tmpLine)) == SUCCESS))
+      {
+      if (IsCfg == TRUE)
+        N->FSys->CSize[fsindex] = (int)MURSpecToL(tmpLine,mvmMega,mvmKilo);
+      else
+        N->FSys->ASize[fsindex] = (int)MURSpecToL(tmpLine,mvmMega,mvmKilo);
+      }
+
+    if ((MXMLPullGetAttr(&P,"io",&AVal) == SUCCESS) &&
+        (MXMLViewDecode(&AVal,tmpLine,sizeof(tmpLine)) == SUCCESS))
+      {
+      if (IsCfg == TRUE)
+        N->FSys->CMaxIO[fsindex] = strtod(tmpLine,NULL);
+      else
+        N->FSys->AIO[fsindex] = strtod(tmpLine,NULL);
+      }
+
+    if (IsCfg == FALSE)
+      {
+      if ((MXMLPullGetAttr(&P,"rcount",&AVal) == SUCCESS) &&
+          (MXMLViewDecode(&AVal,tmpLine,sizeof(tmpLine)) == SUCCESS))
+        {
+        N->FSys->RJCount[fsindex] = (int)strtol(tmpLine,NULL,10);
+        }
+
+      if ((MXMLPullGetAttr(&P,"wcount",&AVal) == SUCCESS) &&
+          (MXMLViewDecode(&AVal,tmpLine,sizeof(tmpLine)) == SUCCESS))
+        {
+        N->FSys->WJCount[fsindex] = (int)strtol(tmpLine,NULL,10);
+        }
+
+      if ((MXMLPullGetAttr(&P,"ocount",&AVal) == SUCCESS) &&
+          (MXMLViewDecode(&AVal,tmpLine,sizeof(tmpLine)) == SUCCESS))
+        {
+        N->FSys->OJCount[fsindex] = (int)strtol(tmpLine,NULL,10);
+        }
+      }
+
+    /* nested elements are ignored */
+
+    if (MXMLPullSkip(&P) == FAILURE)
+      break;
+    }  /* END while (MXMLPullNext() == SUCCESS) */
+
+  return(SUCCESS);
+  }  /* END __MWikiNodeLoadFS() */
+
+
+
+
 /**
  * Update single node attribute from WIKI text string.
  *
@@ -433,90 +567,9 @@ int MWikiNodeUpdateAttr(
 
     case mwnaAFS:
 
-      {
-      mxml_t *E;
-      char   *tail;
-
-      int     fsindex;
-
-      char    tmpLine[MMAX_LINE];
-
       /* FORMAT:  <fs id="X" size="X" io="Y" rcount="X" wcount="X" ocount="X"></fs>... */
 
-      if (N->FSys == NULL)
-        {
-        N->FSys = (mfsys_t *)MUCalloc(1,sizeof(mfsys_t));
-        }
-
-      E = NULL;
-
-      tail = Value;
-
-      while (MXMLFromString(&E,tail,&tail,NULL) == SUCCESS)
-        {
-        if (MXMLGetAttr(E,"id",NULL,tmpLine,0) == FAILURE)
-          {
-          continue;
-          }
-
-        for (fsindex = 0;fsindex < MMAX_FSYS;fsindex++)
-          {
-          if (N->FSys->Name[fsindex] == NULL)
-            {
-            /* add new filesystem */
-
-            MUStrDup(&N->FSys->Name[fsindex],tmpLine);
-
-            break;
-            }
-
-          if (!strcmp(N->FSys->Name[fsindex],tmpLine))
-            {
-            /* filesystem located */
-
-            break;
-            }
-          }    /* END for (fsindex) */
-
-        if (fsindex >= MMAX_FSYS)
-          {
-          /* max filesystem count exceeded */
-
-          /* ignore current filesystem */
-
-          continue;
-          }
-
-        if (MXMLGetAttr(E,"size",NULL,tmpLine,0) == SUCCESS)
-          {
-          N->FSys->ASize[fsindex] = (int)MURSpecToL(tmpLine,mvmMega,mvmKilo);
-          }
-
-        if (MXMLGetAttr(E,"io",NULL,tmpLine,0) == SUCCESS)
-          {
-          N->FSys->AIO[fsindex] = strtod(tmpLine,NULL);
-          }
-
-        if (MXMLGetAttr(E,"rcount",NULL,tmpLine,0) == SUCCESS)
-          {
-          N->FSys->RJCount[fsindex] = (int)strtol(tmpLine,NULL,10);
-          }
-
-        if (MXMLGetAttr(E,"wcount",NULL,tmpLine,0) == SUCCESS)
-          {
-          N->FSys->WJCount[fsindex] = (int)strtol(tmpLine,NULL,10);
-          }
-
-        if (MXMLGetAttr(E,"ocount",NULL,tmpLine,0) == SUCCESS)
-          {
-          N->FSys->OJCount[fsindex] = (int)strtol(tmpLine,NULL,10);
-          }
-
-        fsindex++;
-
-        MXMLDestroyE(&E);
-        }  /* END while (MXMLFromString() == SUCCESS) */
-      }    /* END BLOCK (case mwnaAFS) */
+      __MWikiNodeLoadFS(N,Value,FALSE);
 
       break;
 
@@ -697,75 +750,11 @@ int MWikiNodeUpdateAttr(
 
     case mwnaCFS:
 
-      {
-      mxml_t *E;
-      char   *tail;
-
-      int     fsindex;
-
-      char    tmpLine[MMAX_LINE];
-
       /* NOTE:  order and quantity of fs's must not change over time */
 
       /* FORMAT:  <fs id="X" size="X" io="Y"></fs>... */
 
-      if (N->FSys == NULL)
-        {
-        N->FSys = (mfsys_t *)MUCalloc(1,sizeof(mfsys_t));
-        }
-
-      E = NULL;
-
-      tail = Value;
-
-      while (MXMLFromString(&E,tail,&tail,NULL) == SUCCESS)
-        {
-        if (MXMLGetAttr(E,"id",NULL,tmpLine,0) == FAILURE)
-          {
-          continue;
-          }
-
-        for (fsindex = 0;fsindex < MMAX_FSYS;fsindex++)
-          {
-          if (N->FSys->Name[fsindex] == NULL)
-            {
-            /* add new filesystem */
-
-            MUStrDup(&N->FSys->Name[fsindex],tmpLine);
-
-            break;
-            }
-
-          if (!strcmp(N->FSys->Name[fsindex],tmpLine))
-            {
-            /* filesystem located */
-
-            break;
-            }
-          }    /* END for (fsindex) */
-
-        if (fsindex >= MMAX_FSYS)
-          {
-          /* max filesystem count exceeded */
-
-          /* ignore current filesystem */
-
-          continue;
-          }
-
-        if (MXMLGetAttr(E,"size",NULL,tmpLine,0) == SUCCESS)
-          {
-          N->FSys->CSize[fsindex] = (int)MURSpecToL(tmpLine,mvmMega,mvmKilo);
-          }
-
-        if (MXMLGetAttr(E,"io",NULL,tmpLine,0) == SUCCESS)
-          {
-          N->FSys->CMaxIO[fsindex] = strtod(tmpLine,NULL);
-          }
-
-        MXMLDestroyE(&E);
-        }  /* END while (MXMLFromString() == SUCCESS) */
-      }    /* END BLOCK */
+      __MWikiNodeLoadFS(N,Value,TRUE);
 
       break;
 
@@ -22,6 +22,7 @@
  * int MXMLAddE(E,C)                        *
  * int MXMLToXString(E,Buf,BufSize,MaxBufSize,Tail,NoCompress) *
  * int MXMLToString(E,Buf,BufSize,TailP,NoCompress) *
+ * int MXMLToStringSize(E,SizeP)            *
  * int MXMLGetAttrF(E,AName,ATok,AVal,DFormat,VSize) *
  * int MXMLGetAttr(E,AName,ATok,AVal,VSize) *
  * int MXMLGetChild(E,CName,CTok,C)         *
@@ -39,124 +40,215 @@
 
 
 /**
- * Called when a source of data is too big for a destination
- * buffer. The buffer start is 'BufStart' and current position
- * pointer is 'BPtr', with 'BSpace' remaining in the buffer.
+ * Output length of each character in an attribute value ('<', '>', '&' and
+ * '"' are escaped).  The terminating NUL maps to 0 so a scan stops there.
  *
- * It is possible for:
- *   a) no space left in destination
- *   b) some space left in destionation
- *   c) current position is AT the buffer start
+ * @see __MXMLEscapeString() - to keep in sync
+ */
+
+static const unsigned char MXMLAttrEscapeLen[256] = {
+  0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,6,1,1,1,5,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,4,1,4,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1 };
+
+
+/**
+ * Output length of each character in an element value ('<', '>', '&' and
+ * ENVRS_ENCODED_CHAR are escaped, '"' is not).
  *
- * @param  BPtr       [I]  current buffer position pointer
- * @param  BSpace     [I]  remaining space of buffer before full
- * @param  BufStart   [I]  start of buffer
+ * @see __MXMLEscapeString() - to keep in sync
  */
 
-int __MXMLTerminateBufferNoSpace(
-    
-  char **BPtr,
-  int   *BSpace,
-  char  *BufStart)
+static const unsigned char MXMLValEscapeLen[256] = {
+  0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,4,1,
+  1,1,1,1,1,1,5,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,4,1,4,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
+  1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1 };
+
+
+
+
+/**
+ * Return the escape sequence for a character that MXMLAttrEscapeLen[] or
+ * MXMLValEscapeLen[] marks as special.
+ *
+ * @param C (I)
+ */
+
+const char *__MXMLEscapeString(
+
+  char C)  /* I */
 
   {
-  /* If there is absolutely NO space left in the buffer, then we
-   * try to null termiante at the just previous byte location 
-   * BUT......
-   */
-  if (*BSpace == 0)
+  switch (C)
     {
-    /* Only place the null byte if AFTER start of buffer */
-    if (*BPtr > BufStart)
-      {
-      (*BPtr)[-1] = '\0'; 
-      }
-    else
-      {
-      /* no room for terminator AT ALL so .... */
+    case '<':
 
-      /* NO-OP */
-      }
-    }
-  else
+      return("&lt;");
+
+      /*NOTREACHED*/
+
+      break;
+
+    case '>':
+
+      return("&gt;");
+
+      /*NOTREACHED*/
+
+      break;
+
+    case '&':
+
+      return("&amp;");
+
+      /*NOTREACHED*/
+
+      break;
+
+    case '"':
+
+      return("&quot;");
+
+      /*NOTREACHED*/
+
+      break;
+
+    case ENVRS_ENCODED_CHAR:
+
+      return(ENVRS_SYMBOLIC_STR);
+
+      /*NOTREACHED*/
+
+      break;
+
+    default:
+
+      break;
+    }  /* END switch (C) */
+
+  return(NULL);
+  }  /* END __MXMLEscapeString() */
+
+
+
+
+/**
+ * Return the number of bytes String occupies once escaped per Table.
+ *
+ * @param String (I) [optional]
+ * @param Table  (I) MXMLAttrEscapeLen or MXMLValEscapeLen
+ */
+
+long __MXMLEscapeSize(
+
+  const char          *String,  /* I (optional) */
+  const unsigned char *Table)   /* I */
+
+  {
+  long Size = 0;
+  int  Len;
+
+  if (String == NULL)
     {
-    /* Here there is some room in the buffer, so just place
-     * the null byte at current position
-     */
-    *BPtr[0] = '\0';
+    return(0);
     }
 
-  return(SUCCESS);
-  } /* END __MXMLTerminateBufferNoSpace() */
+  while ((Len = Table[(unsigned char)*String++]) != 0)
+    Size += Len;
+
+  return(Size);
+  }  /* END __MXMLEscapeSize() */
 
 
-/* Ensure the following is set to the largest encoding possible
- * in __MXMLEncodeEscapeChars()
- */
 
-#define  MXML_BIGGEST_ENCODING_SIZE    6
 
 /**
- * Map a 'special' character to an encoded char sequence and put
- * that sequence into the destination buffer OR
- * just copy the non-special character to the destination buffer
+ * Copy String to Dst, escaping per Table.  Runs of plain characters are
+ * copied with one memcpy().  Dst must hold __MXMLEscapeSize(String,Table)
+ * bytes; no terminator is written.
  *
- * Caller must ensure there is enough space for at least 6 characters
- * of encoded sequence
+ * Returns the position just past the copied text.
  *
- * @param AValue        [I]   [start of input buffer]
- * @param Dest          [I]   [start of output buffer]
- * @param DestCurrPtr   [I/O] [Index of current position into dest buffer]
+ * @param Dst    (O)
+ * @param String (I) [optional]
+ * @param Table  (I) MXMLAttrEscapeLen or MXMLValEscapeLen
  */
-int __MXMLEncodeEscapeChars(
-  
-  char AValue,
-  char *Dest,
-  int  *DestCurrPtr)
+
+char *__MXMLEscapeCopy(
+
+  char                *Dst,     /* O */
+  const char          *String,  /* I (optional) */
+  const unsigned char *Table)   /* I */
 
   {
-  int  index = *DestCurrPtr;
+  const char *Run;
+  int         Len;
 
-  if (AValue == '<')
+  if (String == NULL)
     {
-    Dest[index++] = '&';
-    Dest[index++] = 'l';
-    Dest[index++] = 't';
-    Dest[index++] = ';';
+    return(Dst);
     }
-  else if (AValue == '>')
-    {
-    Dest[index++] = '&';
-    Dest[index++] = 'g';
-    Dest[index++] = 't';
-    Dest[index++] = ';';
-    }
-  else if (AValue == '&')
-    {
-    Dest[index++] = '&';
-    Dest[index++] = 'a';
-    Dest[index++] = 'm';
-    Dest[index++] = 'p';
-    Dest[index++] = ';';
-    }
-  else if (AValue == '"')
-    {
-    Dest[index++] = '&';
-    Dest[index++] = 'q';
-    Dest[index++] = 'u';
-    Dest[index++] = 'o';
-    Dest[index++] = 't';
-    Dest[index++] = ';';
-    }
-  else
+
+  Run = String;
+
+  for (;;)
     {
-    Dest[index++] = AValue;
-    }
+    Len = Table[(unsigned char)*String];
 
-  *DestCurrPtr = index;
+    if (Len == 1)
+      {
+      String++;
 
-  return(SUCCESS);
-  } /* __MXMLEncodeEscapeChars() */
+      continue;
+      }
+
+    /* flush the pending run of plain characters */
+
+    if (String > Run)
+      {
+      memcpy(Dst,Run,String - Run);
+
+      Dst += String - Run;
+      }
+
+    if (Len == 0)
+      break;
+
+    memcpy(Dst,__MXMLEscapeString(*String),Len);
+
+    Dst += Len;
+
+    Run = ++String;
+    }  /* END for (;;) */
+
+  return(Dst);
+  }  /* END __MXMLEscapeCopy() */
 
 
 /**
@@ -166,7 +258,7 @@ int __MXMLEncodeEscapeChars(
  * Returns:
  *   SUCCESS if encoding map
  *
- * @see   __MXMLEncodeEscapeChars - to keep in sync
+ * @see   __MXMLEscapeString() - to keep in sync
  *
  * @param Pptr       [I/O]   pointer to buffer char pointer, update consumed pointer
  * @param mappedChar [O]     Original character with NULL terminated (Expects a size of 2 chars)
@@ -231,7 +323,7 @@ int __MXMLDecodeEscapeForBaseSet(
  * Returns:
  *   SUCCESS if encoding map
  *
- * @see   __MXMLEncodeEscapeChars - to keep in sync
+ * @see   __MXMLEscapeString() - to keep in sync
  *
  * @param Pptr       [I/O]   pointer to buffer char pointer, update consumed pointer
  * @param mappedChar [O]     Original character with NULL terminated (Expects a size of 2 chars)
@@ -278,7 +370,7 @@ int __MXMLDecodeEscapeForQuote(
  *   SUCCESS if encoding map
  *   FAILURE if char was NOT encoded
  *
- * @see   __MXMLEncodeEscapeChars - to keep in sync
+ * @see   __MXMLEscapeString() - to keep in sync
  *
  * @param Pptr       [I/O]   pointer to buffer char pointer, update consumed pointer
  * @param mappedChar [O]     Original character with NULL terminated (Expects a size of 2 chars)
@@ -328,7 +420,7 @@ int __MXMLDecodeEscapeForENVRS(
  * '&quot;' ->    '"'
  * '&apos;' ->    '''
  *
- * @see   __MXMLEncodeEscapeChars - to keep in sync
+ * @see   __MXMLEscapeString() - to keep in sync
  *
  * @param Buf (I) [modified]
  */
@@ -523,7 +615,7 @@ int MXMLAddE(
   mxml_t *C)
 
   {
-  if ((E == NULL) || (C == NULL))
+  if ((E == NULL) || (C == NULL) || (E->Arena != NULL))
     {
     return(FAILURE);
     }
@@ -597,6 +689,11 @@ int MXMLSetChild(
     return(SUCCESS);
     }
 
+  if (E->Arena != NULL)
+    {
+    return(FAILURE);
+    }
+
   /* create new child */
   
   if ((CE = (mxml_t *)MUCalloc(1,sizeof(mxml_t))) == NULL)
@@ -698,6 +795,15 @@ int MXMLDestroyE(
     return(SUCCESS);
     }
 
+  if (E->Arena != NULL)
+    {
+    /* built by MXMLFromStringArena(), released with its arena */
+
+    *EP = NULL;
+
+    return(SUCCESS);
+    }
+
   /* If any children, clean them up as well */
 
   if (E->C != NULL)
@@ -806,7 +912,7 @@ int MXMLSetAttr(
 
   /* NOTE:  overwrite existing attr if found */
 
-  if ((E == NULL) || (A == NULL))
+  if ((E == NULL) || (A == NULL) || (E->Arena != NULL))
     {
     return(FAILURE);
     }
@@ -1007,7 +1113,7 @@ int MXMLRemoveAttr(
   {
   int aindex;
 
-  if ((E == NULL) || (AName == NULL) || (AName[0] == '\0'))
+  if ((E == NULL) || (AName == NULL) || (AName[0] == '\0') || (E->Arena != NULL))
     {
     return(FAILURE);
     }
@@ -1069,7 +1175,7 @@ int MXMLAppendAttr(
 
   char  VBuf[MMAX_LINE];
 
-  if ((E == NULL) || (AName == NULL) || (AVal == NULL))
+  if ((E == NULL) || (AName == NULL) || (AVal == NULL) || (E->Arena != NULL))
     {
     return(FAILURE);
     }
@@ -1138,7 +1244,7 @@ int MXMLSetVal(
   char  tmpLine[MMAX_LINE];
   char *ptr;
 
-  if ((E == NULL) || (V == NULL))
+  if ((E == NULL) || (V == NULL) || (E->Arena != NULL))
     {
     return(FAILURE);
     }
@@ -1229,7 +1335,7 @@ int MXMLAddChild(
   if (CEP != NULL)
     *CEP = NULL;
 
-  if ((E == NULL) || (CName == NULL))
+  if ((E == NULL) || (CName == NULL) || (E->Arena != NULL))
     {
     return(FAILURE);
     }
@@ -1305,528 +1411,332 @@ int __MXMLCompressDataAttribute(
 
 
 /**
- * Convert an mxml_t structure tree to a valid XML String object
- *
- * This function will grow the given buffer (MOSrealloc)
- * on a per need basis.
+ * Return the exact length (excluding the terminator) of E's uncompressed
+ * XML serialization.
  *
- * NOTE:  Will fail if XML is corrupt or memory cannot be allocated.
+ * @see __MXMLToStringWrite() - to keep in sync
  *
- * @param E           (I)
- * @param Buf         (O) [populated/modified]
- * @param BufSizeP    (I/O)
- * @param MaxBufSize  (I)
- * @param Tail        (O)
- * @param NoCompress  (I)
+ * @param E (I)
  */
 
-int MXMLToXString(
+long __MXMLToStringSize(
 
-  mxml_t   *E,       
-  char    **Buf,    
-  int      *BufSizeP, 
-  int       MaxBufSize, 
-  char  const  **Tail,      
-  mbool_t   NoCompress) 
+  mxml_t *E)  /* I */
 
   {
-  int NewSize;
-  char *tmpPtr;  /* need this so caller can free Buf if needs be */
-  mstring_t tmpBuf(MMAX_LINE);
+  long Size;
+  long NameLen;
+  int  index;
 
-  /* NOTE:  MXMLToString() only fails due to lack of space */
+  NameLen = strlen((E->Name != NULL) ? E->Name : "NA");
 
-  if ((E == NULL) || (Buf == NULL))
-    {
-    return(FAILURE);
-    }
+  /* FORMAT:  <NAME[ ANAME="AVAL"]...>VAL[<![CDATA[...]]>]...[CHILD]...</NAME> */
 
-  /* allocate initial memory if required */
+  Size = NameLen * 2 + strlen("<></>");
 
-  if (*Buf == NULL)
+  for (index = 0;index < E->ACount;index++)
     {
-    NewSize = MMAX_BUFFER;
-
-    if ((tmpPtr = (char *)MUMalloc(NewSize)) == NULL)
-      {
-      /* cannot allocate buffer */
+    if (E->AName[index] != NULL)
+      Size += strlen(E->AName[index]);
 
-      return(FAILURE);
-      }
+    Size += strlen(" =\"\"") + __MXMLEscapeSize(E->AVal[index],MXMLAttrEscapeLen);
+    }
 
-    *Buf = tmpPtr;
+  Size += __MXMLEscapeSize(E->Val,MXMLValEscapeLen);
 
-    if (BufSizeP != NULL)
-      *BufSizeP = MMAX_BUFFER;
-    }
-  else
+  if (E->CData != NULL)
     {
-    if (BufSizeP != NULL)
-      {
-      NewSize = *BufSizeP;
-      }
-    else
+    for (index = 0;index < E->CDataCount;index++)
       {
-      return(FAILURE);
-      }
-    }
+      if (E->CData[index] == NULL)
+        break;
 
-  if (MXMLToMString(
-      E,
-      &tmpBuf,
-      Tail, /* O */
-      NoCompress) == FAILURE)
-    {
-    return(FAILURE);
+      Size += strlen(E->CData[index]) + strlen("<![CDATA[]]>");
+      }
     }
 
-  int bufSize = (int) tmpBuf.size();
-  if (bufSize >= NewSize)
+  for (index = 0;index < E->CCount;index++)
     {
-    NewSize = bufSize + 1;
+    if (E->C[index] == NULL)
+      continue;
 
-    if ((*Buf = (char *)MOSrealloc(*Buf,NewSize)) == NULL)
-      {
-      /* FAILURE - cannot allocate buffer */
-    
-      return(FAILURE);
-      }
+    Size += __MXMLToStringSize(E->C[index]);
+    }
 
-    if (BufSizeP != NULL)
-      *BufSizeP = NewSize;
-    }    /* END if (strlen(tmpBuf.c_str()) >= NewSize) */
+  return(Size);
+  }  /* END __MXMLToStringSize() */
 
-  strncpy(*Buf,tmpBuf.c_str(),NewSize);
 
-  return(SUCCESS);
-  }  /* END MXMLToXString() */
 
 
 /**
- * convert the 'AName' attribute and its 'AValue' value to XML output
+ * Report how many bytes MXMLToString() needs to serialize E (excluding the
+ * terminator).  Compression of a "Data" element can only make the actual
+ * output shorter.
  *
- * @param   AName        (I)   Attrib name
- * @param   AValue       (I)   Attrib value
- * @param   BufStart     (I/O) Buffer start address
- * @param   BPtr         (I/O) Current position pointer into buffer 
- * @param   BSpace       (I/O) Remaining space in buffer
+ * @param E     (I)
+ * @param SizeP (O)
  */
 
-int __MXMLToStringOneAttribute(
-  
-  char   *AName,
-  char   *AValue,
-  char   *BufStart,
-  char  **BPtr,
-  int    *BSpace)
+int MXMLToStringSize(
+
+  mxml_t *E,      /* I */
+  long   *SizeP)  /* O */
 
   {
-  char    NewLine[MMAX_BUFFER * 4];
-  int     len;
+  if (SizeP != NULL)
+    *SizeP = 0;
+
+  if ((E == NULL) || (SizeP == NULL))
+    {
+    return(FAILURE);
+    }
 
-  /* FORMAT:  <NAME>="<VAL>" */
+  *SizeP = __MXMLToStringSize(E);
 
-  *BPtr[0] = ' ';
- 
-  *BPtr   += 1;
-  *BSpace -= 1;
+  return(SUCCESS);
+  }  /* END MXMLToStringSize() */
 
-  len = strlen(AName);
 
-  /* must account for '=' and '"' */
 
-  if (len + 2 >= *BSpace)
-    {
-    /* insufficient space, so try to terminate with NULL byte if possible */
 
-    __MXMLTerminateBufferNoSpace(BPtr,BSpace,BufStart);
+/**
+ * Write E's XML serialization at *PtrP, which must have room for
+ * __MXMLToStringSize(E) + 1 bytes, and advance *PtrP past it.
+ *
+ * A large "Data" element is compressed in place once written.  The text
+ * compressed runs from Base, or from the element's own '<' if Base is NULL.
+ *
+ * @param E          (I)
+ * @param Base       (I) [optional]
+ * @param PtrP       (I/O)
+ * @param NoCompress (I)
+ */
 
-    return(FAILURE);
-    }
+int __MXMLToStringWrite(
 
-  /* Set the AName */
-  strcpy(*BPtr,AName);
+  mxml_t   *E,           /* I */
+  char     *Base,        /* I (optional) */
+  char    **PtrP,        /* I/O */
+  mbool_t   NoCompress)  /* I */
 
-  *BSpace -= len;
-  *BPtr   += len;
+  {
+  char       *Ptr;
+  char       *Start;
+  const char *Name;
+  int         index;
+  int         len;
 
-  /* Place a '=' */
-  *BPtr[0] = '=';
+  Ptr   = *PtrP;
+  Start = (Base != NULL) ? Base : Ptr;
+  Name  = (E->Name != NULL) ? E->Name : "NA";
 
-  *BPtr   += 1;
-  *BSpace -= 1;
+  /* display header */
 
-  /* Place a '"' */
-  *BPtr[0] = '"';
+  len = strlen(Name);
 
-  *BPtr   += 1;
-  *BSpace -= 1;
+  *Ptr++ = '<';
 
-  /* Now place the Attribute Value */
+  memcpy(Ptr,Name,len);
 
-  if ((AValue != NULL) &&
-     ((strchr(AValue,'<') != NULL) ||
-      (strchr(AValue,'>') != NULL) ||
-      (strchr(AValue,'"') != NULL) ||
-      (strchr(AValue,'&') != NULL)))
-    {
-    /* must replace '<' with '&lt;' and '>' with '&gt;' */
+  Ptr += len;
 
-    int   index1;
-    int   index2 = 0;
+  /* display attributes */
 
-    len = strlen(AValue);
+  for (index = 0;index < E->ACount;index++)
+    {
+    *Ptr++ = ' ';
 
-    if ((len >= (int)sizeof(NewLine)) || (len >= *BSpace))
+    if (E->AName[index] != NULL)
       {
-      /* insufficient space, so try to terminate with NULL byte if possible */
+      len = strlen(E->AName[index]);
 
-      __MXMLTerminateBufferNoSpace(BPtr,BSpace,BufStart);
+      memcpy(Ptr,E->AName[index],len);
 
-      return(FAILURE);
+      Ptr += len;
       }
 
-    /* Scan the AValue looking for special characters that need to be
-     * encoded
-     */
-    for (index1 = 0;index1 < len;index1++)
-      {
-      /* Make sure that there is enough space in the destination buffer
-       * for the encoded char sequence
-       */
-      if ((index2 + MXML_BIGGEST_ENCODING_SIZE) > (int)sizeof(NewLine))
-        {
-        /* insufficient space */
+    *Ptr++ = '=';
+    *Ptr++ = '"';
 
-        return(FAILURE);
-        }
+    Ptr = __MXMLEscapeCopy(Ptr,E->AVal[index],MXMLAttrEscapeLen);
+
+    *Ptr++ = '"';
+    }  /* END for (index) */
 
-      /* Examine character at AValue[index1] for encoding */
-      __MXMLEncodeEscapeChars(AValue[index1],NewLine,&index2);
-      }   /* END for (index1) */
+  *Ptr++ = '>';
 
-    NewLine[index2] = '\0';
+  /* display value */
 
-    len = strlen(NewLine);
+  Ptr = __MXMLEscapeCopy(Ptr,E->Val,MXMLValEscapeLen);
 
-    /* must account for closing '"' */
+  /* display CData */
 
-    if ((len + 1) >= *BSpace)
+  if (E->CData != NULL)
+    {
+    for (index = 0;index < E->CDataCount;index++)
       {
-      /* insufficient space, so try to terminate with NULL byte if possible */
+      if (E->CData[index] == NULL)
+        break;
 
-      __MXMLTerminateBufferNoSpace(BPtr,BSpace,BufStart);
+      len = strlen(E->CData[index]);
 
-      return(FAILURE);
-      }
+      memcpy(Ptr,"<![CDATA[",strlen("<![CDATA["));
 
-    strcpy(*BPtr,NewLine);
-    } /* END if (strchr(AValue,'<')...) */
-  else
-    {
-    if (AValue != NULL)
-      {
-      len = strlen(AValue);
-      }
-    else
-      {
-      len = 0;
-      }
+      Ptr += strlen("<![CDATA[");
 
-    /* must account for closing '"' */
+      memcpy(Ptr,E->CData[index],len);
 
-    if ((len + 1) >= *BSpace)
-      {
-      /* insufficient space, so try to terminate with NULL byte if possible */
+      Ptr += len;
 
-      __MXMLTerminateBufferNoSpace(BPtr,BSpace,BufStart);
+      memcpy(Ptr,"]]>",strlen("]]>"));
 
-      return(FAILURE);
+      Ptr += strlen("]]>");
       }
+    }
 
-    if (AValue != NULL)
-      strcpy(*BPtr,AValue);
-    }    /* END else */
+  /* display children */
 
-  *BSpace -= len;
-  *BPtr   += len;
+  for (index = 0;index < E->CCount;index++)
+    {
+    if (E->C[index] == NULL)
+      continue;
 
-  /* Terminate the Attribute Value */
-  *BPtr[0] = '"';
+    if (__MXMLToStringWrite(E->C[index],Base,&Ptr,NoCompress) == FAILURE)
+      {
+      *PtrP = Ptr;
 
-  *BPtr   += 1;
-  *BSpace -= 1;
+      return(FAILURE);
+      }
+    }  /* END for (index) */
 
-  return(SUCCESS);
-  }  /* END __MXMLToStringOneAttribute() */
+  /* display footer */
 
+  len = strlen(Name);
 
-/**
- * Given a char determine if it is 'special' char that must be encoded
- * with a 'encoded string'
- *
- * Single function to perform the encoding if needed
- *
- * @param chr   [I]    input char
- * @param NEptr [I/O]  pointer to char pointer to return encoded string [NULL if not encoded]
- * @param NElen [I/O]  pointer to int to return length of encoded string [0 if NEPtr is NULL]
- */
+  *Ptr++ = '<';
+  *Ptr++ = '/';
 
-void __MXMLEncodeSpecialChar(
+  memcpy(Ptr,Name,len);
 
-  const char   chr,
-  const char **NEptr,
-  int         *NElen)
+  Ptr += len;
 
-  {
-  switch (chr)
-    {
-    case '<':
+  *Ptr++ = '>';
 
-      *NElen = 4;
-      *NEptr = "&lt;";
+  *Ptr = '\0';
 
-      break;
+  /* Check if compression is requested, data is too big, item is "Data" */
 
-    case '>':
+  if ((NoCompress == FALSE) && (E->Name != NULL) && !strcmp(E->Name,"Data"))
+    {
+    int rc;
 
-      *NElen = 4;
-      *NEptr = "&gt;";
+    rc = __MXMLCompressDataAttribute(NoCompress,Start,Ptr - Start,(MMAX_BUFFER >> 1),E->Name,"Data");
 
-      break;
+    Ptr = Start + strlen(Start);
 
-    case '&':
+    if (rc == FAILURE)
+      {
+      *PtrP = Ptr;
 
-      *NElen = 5;
-      *NEptr = "&amp;";
+      return(FAILURE);
+      }
+    }
 
-      break;
+  *PtrP = Ptr;
 
-    case ENVRS_ENCODED_CHAR:
+  return(SUCCESS);
+  }  /* END __MXMLToStringWrite() */
 
-      *NElen = 4;
-      *NEptr = ENVRS_SYMBOLIC_STR;
-
-     break;
-
-    /* '"' not required to be parsed in node data per XML specification */
-    /*
-    case '"':
-
-      NElen = 6;
-      NEptr = "&quot;";
-
-      break;
-    */
-
-    default:
-
-      *NElen = 0;
-      *NEptr = NULL;
-
-      break;
-    }
-  } /* END __MXMLEncodeSpecialChar() */
 
 
 
 /**
- * For given 'Value' generate XML output into the buffer 
+ * Convert an mxml_t structure tree to a valid XML String object
  *
- * @param Val     (I)
- * @param Buf     (I/O) Buffer start address
- * @param BPtr    (O)
- * @param BSpace  (O)
- */
-
-int __MXMLValueToString(
-    
-  char   *Val,
-  char   *Buf,
-  char  **BPtr,
-  int    *BSpace)
-
-  {
-  int         len;
-  char       *ptr;
-  const char *NEptr;
-  int         NElen;
-
-  /* Do we have a Value ?? */
-
-  if (Val != NULL)
-    {
-    len = strlen(Val);
-
-    if (len >= *BSpace)
-      {
-      /* insufficient space, so try to terminate with NULL byte if possible */
-
-      __MXMLTerminateBufferNoSpace(BPtr,BSpace,Buf);
-
-      return(FAILURE);
-      }
-
-    NEptr = NULL;
-    NElen = 0;
-
-    ptr = Val;
-
-    while (*ptr != '\0')
-      {
-      /* Check current character if 'special' and return its escaped string and length */
-
-      __MXMLEncodeSpecialChar(*ptr,&NEptr,&NElen);
-
-      /* If Len is 0, then it is NOT encoded, so simply store it straight thru */
-      if (NElen == 0)
-        {
-        (*BPtr)[0] = *ptr;
-        (*BPtr)++;
-
-        BSpace--;
-        }
-      else
-        {
-        /* Special character and we have an encoded sequence to save */
-
-        len += NElen - 1;
-
-        if (len >= *BSpace)
-          {
-          /* insufficient space, so try to terminate with NULL byte if possible */
-
-          __MXMLTerminateBufferNoSpace(BPtr,BSpace,Buf);
-
-          return(FAILURE);
-          }
-        else
-          {
-          strncpy(*BPtr,NEptr,NElen);
-
-          *BPtr += NElen;
-          *BSpace -= NElen;
-          }
-        } /* END else */
-
-      ptr++;  /* Iterator bump */
-
-      } /* END while (*ptr != '\0') */
-    }  /* END if (Val != NULL) */
-
-  return(SUCCESS);
-  } /* END __MXMLValueToString() */
-
-
-/**
- * For the given Name string, generate XML into buffer
+ * This function will grow the given buffer (MOSrealloc) to the exact
+ * size of the output if it is too small.
  *
- * @param   Name    (I)
- * @param Buf     (I/O) Buffer start address
- * @param BPtr    (O)
- * @param BSpace  (O)
+ * NOTE:  Will fail if XML is corrupt or memory cannot be allocated.
  *
+ * @param E           (I)
+ * @param Buf         (O) [populated/modified]
+ * @param BufSizeP    (I/O)
+ * @param MaxBufSize  (I)
+ * @param Tail        (O)
+ * @param NoCompress  (I)
  */
 
-int __MXMLFooterToString(
+int MXMLToXString(
 
-  char   *Name,
-  char   *Buf,
-  char  **BPtr,
-  int    *BSpace)
+  mxml_t   *E,       
+  char    **Buf,    
+  int      *BufSizeP, 
+  int       MaxBufSize, 
+  char  const  **Tail,      
+  mbool_t   NoCompress) 
 
   {
-  int   len;
+  int   NewSize;
+  long  Size;
+  char *Ptr;
 
-  if (Name != NULL)
-    {
-    len = strlen(Name);
-    }
-  else
+  if ((E == NULL) || (Buf == NULL))
     {
-    len = strlen("NA");
+    return(FAILURE);
     }
 
-  if (*BSpace < len + 4)
+  if ((*Buf != NULL) && (BufSizeP == NULL))
     {
-    /* insufficient space, so try to terminate with NULL byte if possible */
-
-    __MXMLTerminateBufferNoSpace(BPtr,BSpace,Buf);
-
     return(FAILURE);
     }
 
-  (*BPtr)[0] = '<';
-
-  *BPtr   += 1;
-  *BSpace -= 1;;
+  Size = __MXMLToStringSize(E);
 
-  (*BPtr)[0] = '/';
-
-  *BPtr   += 1;
-  *BSpace -= 1;;
+  /* allocate initial memory if required */
 
-  if (Name != NULL)
-    {
-    strcpy(*BPtr,Name);
-    }
-  else
+  if (*Buf == NULL)
     {
-    strcpy(*BPtr,"NA");
-    }
- 
-  *BSpace -= len;
-  *BPtr   += len;
+    NewSize = MAX(MMAX_BUFFER,Size + 1);
 
-  (*BPtr)[0] = '>';   /* Terminate the phrase */
-
-  *BPtr   += 1;
-  *BSpace -= 1;;
-  
-  return(SUCCESS);
-  }
-
-
-/**
- * Helper function to print CData to a string
- *
- * No parameter checking
- *
- * @param CDataVal [I] - The value to print
- * @param Buf      [I] - The buffer (used to get length)
- * @param BPtr     [O] - Buffer to print to
- * @param BSpace   [I] - Space left in buffer
- */
-
-int __MXMLCDataToString(
+    if ((*Buf = (char *)MUMalloc(NewSize)) == NULL)
+      {
+      /* cannot allocate buffer */
 
-  const char *CDataVal,
-  char       *Buf,
-  char      **BPtr,
-  int        *BSpace)
+      return(FAILURE);
+      }
 
-  {
-  if (CDataVal != NULL)
+    if (BufSizeP != NULL)
+      *BufSizeP = NewSize;
+    }
+  else if (Size >= *BufSizeP)
     {
-    int len;
+    NewSize = Size + 1;
 
-    len = strlen(CDataVal) + strlen("<![CDATA[]]>");
-
-    if (len >= *BSpace)
+    if ((Ptr = (char *)MOSrealloc(*Buf,NewSize)) == NULL)
       {
-      /* insufficient space, so try to terminate with NULL byte if possible */
-
-      __MXMLTerminateBufferNoSpace(BPtr,BSpace,Buf);
-
+      /* FAILURE - cannot allocate buffer (caller still owns *Buf) */
+    
       return(FAILURE);
       }
 
-    MUSNPrintF(BPtr,BSpace,"<![CDATA[%s]]>",
-      CDataVal);
+    *Buf = Ptr;
+
+    *BufSizeP = NewSize;
     }
 
+  Ptr = *Buf;
+
+  if (__MXMLToStringWrite(E,*Buf,&Ptr,NoCompress) == FAILURE)
+    {
+    return(FAILURE);
+    }
+
+  if (Tail != NULL)
+    *Tail = Ptr;
+
   return(SUCCESS);
-  }  /* END __MXMLCDataToString() */
+  }  /* END MXMLToXString() */
 
 
 
@@ -1835,6 +1745,10 @@ int __MXMLCDataToString(
  * Convert an mxml_t structure tree to a valid XML String object
  * 
  * @see MXMLToMString() for more dynamic mstring_t based routine
+ * @see MXMLToStringSize() to size Buf up front
+ *
+ * NOTE:  if the output does not fit, Buf is left holding as much of it as
+ *        fits and FAILURE is returned.
  *
  * @param E           (I) The mxml_t struct to convert
  * @param Buf         (O) The buffer that the XML string will be stored in
@@ -1852,14 +1766,13 @@ int MXMLToString(
   mbool_t   NoCompress) 
 
   {
-  int index;
-  int BSpace;
+  long  Size;
+  long  len;
 
   char *BPtr;
-  char *tail;
+  char *tmpBuf;
 
   int   rc;
-  int   len;
 
   /* Check parameters for validity */
  
@@ -1879,357 +1792,66 @@ int MXMLToString(
     return(FAILURE);
     }
 
-  /* Initialize destination pointer and remaining space */
-
-  BPtr   = Buf;
-  BSpace = BufSize;
-
-  /* display header */
-
-  BPtr[0] = '<';
-
-  BPtr++;
-  BSpace--;
-
-  if (E->Name != NULL)
-    {
-    len = strlen(E->Name);
-
-    if (len >= BSpace)
-      {
-      /* insufficient space */
-
-      BPtr[0] = '\0';
+  Size = __MXMLToStringSize(E);
 
-      return(FAILURE);
-      }
-
-    strcpy(BPtr,E->Name);
-
-    BSpace -= len;
-    BPtr   += len;
-    }
-  else
+  if (Size < BufSize)
     {
-    strcpy(BPtr,"NA");
+    /* common case - serialize straight into Buf */
 
-    len = strlen("NA");
+    BPtr = Buf;
 
-    BPtr   += len;
-    BSpace -= len;
-    }
-
-  index = 0; /* So valgrind won't complain */
-
-  /* iterate over and display all attributes of this element */
-
-  for (index = 0;index < E->ACount;index++)
-    {
-    rc = __MXMLToStringOneAttribute(E->AName[index],E->AVal[index],Buf,&BPtr,&BSpace);
-    if (FAILURE == rc)
+    if (__MXMLToStringWrite(E,NULL,&BPtr,NoCompress) == FAILURE)
       {
       return(FAILURE);
       }
-    }  /* END for (index) */
-
-  BPtr[0] = '>';      /* terminate the output with trailing angle bracket */
-  BPtr++;
-  BSpace--;
-
-  /* ToString the element's 'Value' if any */
-
-  rc = __MXMLValueToString(E->Val,Buf,&BPtr,&BSpace);
-  if (FAILURE == rc)
-    {
-    return(FAILURE);
-    }
-
-  /* display CData */
-
-  if (E->CData != NULL)
-    {
-    for (index = 0;index < E->CDataCount;index++)
-      {
-      if (E->CData[index] == NULL)
-        break;
 
-      rc = __MXMLCDataToString(E->CData[index],Buf,&BPtr,&BSpace);
+    if (TailP != NULL)    /* Return pointer to any 'tail' of the input string */
+      *TailP = BPtr;
 
-      if (FAILURE == rc)
-        {
-        return(FAILURE);
-        }
-      }
+    return(SUCCESS);
     }
 
-  /* iterate over and display children of this element */
+  /* insufficient space - serialize aside (compression may still make it
+     fit) and return whatever fits */
 
-  for (index = 0;index < E->CCount;index++)
-    {
-    if (E->C[index] == NULL)
-      continue;
-
-    if (MXMLToString(E->C[index],BPtr,BSpace,&tail,NoCompress) == FAILURE)
-      {
-      return(FAILURE);
-      }
-
-    len = strlen(BPtr);
-
-    BSpace -= len;
-    BPtr   += len;
-    }  /* END for (index) */
-
-  /* display footer (element Name) */
-
-  rc = __MXMLFooterToString(E->Name,Buf,&BPtr,&BSpace);
-  if (FAILURE == rc)
+  if ((tmpBuf = (char *)MUMalloc(Size + 1)) == NULL)
     {
     return(FAILURE);
     }
 
-  /* terminate string */
-
-  BPtr[0] = '\0';
-
-  /* Wrap up */
-
-  if (TailP != NULL)    /* Return pointer to any 'tail' of the input string */
-    *TailP = BPtr;
-
-  /* Check if compression is requested, data is too big, item is "Data" */
-
-  if (__MXMLCompressDataAttribute(NoCompress,Buf,strlen(Buf),(MMAX_BUFFER >> 1),E->Name,"Data") == FAILURE)
-    return(FAILURE);
-
-  return(SUCCESS);
-  }  /* END MXMLToString() */
-
-
-/**
- * Given one Attribute value, toString it to a mstring_t
- *
- * @param  MString    [I/O]     destination buffer to store output string
- * @param  AName      [I]       Attribute Name
- * @param  AValue     [I]       Atrribute Value
- * @param  NewLine    [I]       already initialized temp buffer
- */
-
-int __MXMLToMStringOneAttribute(
-    
-  mstring_t   *MString,
-  char        *AName,
-  char        *AValue,
-  mstring_t   *NewLine)
-
-  {
-  int           RegCharCount;
-  int           len;
-  const char   *Encoded;
-
-  /* RegCharCount -
-      Before we were checking each character, and appending regular characters
-      (not '<', '>', '"', '&') one at a time via MStringAppendF because
-      MStringAppend only accepts strings.  This was very slow, since we were
-      calling a large function for every char.  RegCharCount is a count of 
-      the number of consecutive regular characters that we've had.  When we
-      hit an irregular character, we will append the entire string of regular
-      characters at once, and then append the irregular stuff.  This cuts
-      down calls to MStringAppendF significantly, and speeds up this function.
-      MStringAppendCount is used to append the regular chars, using
-      (<CurPtr> - RegCharCount) as the pointer. */
-
-  /* FORMAT:  <NAME>="<VAL>" */
-
-  /* Compose a simply string from the AName in the form:  AName="
-   * then set that to the MString
-   */
-  MStringAppendF(MString," %s=\"",AName);
-
-  RegCharCount = 0;
-
-  /* If the AValue is set and if any specials are in the AValue input string,
-   * then perform per character processing on the AValue for special encoding
-   */
-  if ((AValue != NULL) && (strpbrk(AValue,"<>\"&") != NULL))
-    {
-    /* must replace '<' with '&lt;' 
-     *          and '>' with '&gt;' 
-     *          and '&' with '&amp;' 
-     *          and '"' with '&quot;' 
-     */
-
-    int   index1;
-
-    MStringSet(NewLine,"");   /* Init the temp MString */
-
-    len = strlen(AValue);
-
-    for (index1 = 0;index1 < len;index1++)
-      {
-      switch (AValue[index1])
-        {
-        case '<':
-          Encoded = "&lt;";
-          break;
-
-        case '>':
-          Encoded = "&gt;";
-          break;
-
-        case '&':
-          Encoded = "&amp;";
-          break;
-
-        case '"':
-          Encoded = "&quot;";
-          break;
-
-        default:
-          Encoded = NULL;
-          break;
-        }
-
-      /* If no special characters then just bump the Reg char count */
-
-      if (NULL == Encoded)
-        {
-        /* Regular character, keep track of how many we've had in a row */
-
-        RegCharCount++;
-        }
-      else
-        {
-        /* We have a special char, so post any regular chars outstanding */
-        if (RegCharCount > 0)
-          {
-          MStringAppendCount(NewLine,&AValue[index1 - RegCharCount],RegCharCount);
-          }
-
-        /* Append the special character encoding string */
-        MStringAppend(NewLine,Encoded);
-        RegCharCount = 0;
-        }
-      } /* END for(index1...) */
-
-    if (RegCharCount > 0)
-      {
-      /* Regular chars until end of string */
-
-      MStringAppend(NewLine,&AValue[index1 - RegCharCount]);
-      }
+  BPtr = tmpBuf;
 
-    /* Transfer the temp MString to the destination MString */
+  rc = __MXMLToStringWrite(E,NULL,&BPtr,NoCompress);
 
-    MStringAppend(MString,NewLine->c_str());
+  len = BPtr - tmpBuf;
 
-    } /* END if (strchr(AValue,'<')...) */
-  else if (AValue != NULL)
+  if (len >= BufSize)
     {
-    MStringAppend(MString,AValue);
-    }    /* END else */
+    len = BufSize - 1;
 
-  MStringAppend(MString,"\"");
-
-  return(SUCCESS);
-  } /* END __MXMLToMStringOneAttribute() */
-
-
-/**
- * ToMString a Value item
- *
- */
-
-int __MXMLValueToMString(
-  
-  mstring_t   *MString, 
-  char        *Val)
-  {
-  const char  *NEptr;
-  int          NElen;
-  char        *ptr;
-  int          RegCharCount; /* Num of consecutive regular chars we've had */
-
-  /* If there is an Element Value, toMString it */
-
-  if (Val != NULL)
-    {
-    NEptr = NULL;
-    NElen = 0;
-
-    ptr = Val;
-    RegCharCount = 0;
-
-    while (*ptr != '\0')
-      {
-      /* Check current character if 'special' and return its escaped string and length */
-  
-      __MXMLEncodeSpecialChar(*ptr,&NEptr,&NElen);
-  
-      /* If not special, then copy character straight through */
-  
-      if (NEptr == NULL)
-        {
-        /* Regular character, keep track of how many we've had in a row */
-        RegCharCount++;
-        }
-      else
-        {
-        /* Irregular character, copy all of the past regular characters */
-  
-        if (RegCharCount > 0)
-          MStringAppendCount(MString,ptr - RegCharCount,RegCharCount);
-  
-        /* Now add the irregular stuff */
-  
-        MStringAppend(MString,NEptr);
-  
-        RegCharCount = 0;   /* reset the Regular character count outstanding */
-        }
-  
-      ptr++; /* Iterator bump */
-  
-      } /* END while (*ptr != '\0') */
-  
-    /* If any regular characters, append them to the buffer as well */
-    if (RegCharCount > 0)
-      {
-      /* Reg chars until end of string */
-  
-      MStringAppend(MString,ptr - RegCharCount);
-      }
+    rc = FAILURE;
     }
 
-  return(SUCCESS);
-  } /* END __MXMLValueToMString() */
+  memcpy(Buf,tmpBuf,len);
 
+  Buf[len] = '\0';
 
-/**
- *  Helper function to print CData to an MString.
- *  No error checking of the mstring
- *
- * @param MString  [O] - The mstring to print to
- * @param CDataVal [I] - The CData string to print
- */
+  MUFree(&tmpBuf);
 
-int __MXMLCDataToMString(
+  if ((rc == SUCCESS) && (TailP != NULL))
+    *TailP = Buf + len;
 
-  mstring_t *MString,
-  char      *CDataVal)
+  return(rc);
+  }  /* END MXMLToString() */
 
-  {
-  if (CDataVal != NULL)
-    {
-    MStringAppendF(MString,"<![CDATA[%s]]>",
-      CDataVal);
-    }
 
-  return(SUCCESS);
-  }  /* END __MXMLCDataToMString() */
 
 
 /**
  * Convert an mxml_t structure tree to a valid XML MString object
+ *
+ * The output is appended to MString.  It is sized up front and written
+ * into a single buffer, then MString is assigned once.
  * 
  * @param E           (I) The mxml_t struct to convert
  * @param MString     (O) The buffer that the XML string will be stored in (should already be initialized) 
@@ -2245,116 +1867,49 @@ int MXMLToMString(
   mbool_t     NoCompress)
 
   {
-  int       index;
-  int       len;
+  long  len;
+  long  Size;
 
-  char const *tail;
+  char *Buf;
+  char *BPtr;
+
+  int   rc;
 
   if ((E == NULL) || (MString == NULL))
     {
     return(FAILURE);
     }
 
-  /* start with: displaying the header */
-
-  MStringAppend(MString,"<");
-
-  if (E->Name != NULL)
-    {
-    MStringAppend(MString,E->Name);
-    }
-  else
-    {
-    MStringAppend(MString,"NA");
-    }
-
-  /* display the element's attributes if any */
+  len  = MString->length();
+  Size = __MXMLToStringSize(E);
 
-  if (E->ACount > 0)
+  if ((Buf = (char *)MUMalloc(len + Size + 1)) == NULL)
     {
-    mstring_t NewLine(MMAX_LINE);
-
-    /* Init temp Mstring one for all attributes and that save init/destroy on each one */
-
-    for (index = 0;index < E->ACount;index++)
-      {
-      __MXMLToMStringOneAttribute(MString,E->AName[index],E->AVal[index],&NewLine);
-      }  /* END for (index) */
-    }
-
-  MStringAppend(MString,">");   /* add the trailing attribute bracket */
-
-
-  /* If there is an Element Value, then output its contents into the MString */
-
-  __MXMLValueToMString(MString, E->Val);
-
-  /* display CData */
-
-  if (E->CData != NULL)
-    {
-    for (index = 0;index < E->CDataCount;index++)
-      {
-      if (E->CData[index] == NULL)
-        break;
-
-      __MXMLCDataToMString(MString,E->CData[index]);
-      }
+    return(FAILURE);
     }
 
-  /* recursively display children of this element */
+  /* a "Data" element compresses everything in MString, so keep the
+     existing contents in front of the new output */
 
-  for (index = 0;index < E->CCount;index++)
-    {
-    if (E->C[index] == NULL)
-      continue;
+  if (len > 0)
+    memcpy(Buf,MString->c_str(),len);
 
-    if (MXMLToMString(E->C[index],MString,&tail,NoCompress) == FAILURE)
-      {
-      return(FAILURE);
-      }
-    }  /* END for (index) */
+  BPtr = Buf + len;
 
+  rc = __MXMLToStringWrite(E,Buf,&BPtr,NoCompress);
 
-  /* display final footer */
+  *BPtr = '\0';
 
-  if (E->Name != NULL)
-    {
-    MStringAppend(MString,"</");
-    MStringAppend(MString,E->Name);
-    MStringAppend(MString,">");
-    }
-  else
-    {
-    MStringAppend(MString,"</NA>");
-    }
-
-
-  /* How big is the buffer to encode */
+  *MString = Buf;
 
-  len = MString->length();
+  MUFree(&Buf);
 
   /* Return pointer to any trailing data stream */
-  if (TailP != NULL)
-    *TailP = MString->c_str() + len;
-
-  /* Need a mutable string since mstring cannot be alter via c_str() method */
 
-  char *mutableString = NULL;
-  MUStrDup(&mutableString,MString->c_str());
-
-  /* Check if compression is requested, data is too big, item is "Data" */
-
-  int rc = __MXMLCompressDataAttribute(NoCompress,mutableString,len,(MMAX_BUFFER >> 1),E->Name,"Data");
-
-  *MString = mutableString;   /* replace the mstring with the new compressed mutable string */
-
-  MUFree(&mutableString);
- 
-  if (rc == FAILURE)
-    return(FAILURE);
+  if (TailP != NULL)
+    *TailP = MString->c_str() + MString->length();
 
-  return(SUCCESS);
+  return(rc);
   }  /* END MXMLToMString() */
 
 
@@ -3764,7 +3319,8 @@ int MXMLFromString(
 
   /* Check for 'bad' parameter */
 
-  if ((XMLString == NULL) || (EP == NULL))
+  if ((XMLString == NULL) || (EP == NULL) ||
+      ((*EP != NULL) && ((*EP)->Arena != NULL)))
     {
     __MXMLParseStringErrorCleanup("invalid arguments",EP,EMsg);
     return(FAILURE);
@@ -4147,7 +3703,7 @@ int MXMLAddCData(
   const char *CData)
 
   {
-  if ((E == NULL) || (CData == NULL))
+  if ((E == NULL) || (CData == NULL) || (E->Arena != NULL))
     return(FAILURE);
 
   if (E->CDataCount >= E->CDataSize)
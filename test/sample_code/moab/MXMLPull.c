@@ -0,0 +1,1340 @@
+/* HEADER */
+
+/**
+ * @file MXMLPull.c
+ *
+ * Zero-copy pull parser for XML strings, and an arena-backed mxml_t builder
+ * on top of it.
+ *
+ * NOTE: MXMLPullNext() steps through the input one event (start tag, value,
+ *       end tag) at a time.  Names, attributes and values are returned as
+ *       mxmlview_t's pointing into the caller's buffer - nothing is copied or
+ *       decoded until MXMLViewDecode() or MXMLViewToMString() is called, so
+ *       the buffer must outlive every view taken from it.
+ *
+ * NOTE: MXMLFromStringArena() builds the same tree as MXMLFromString() but
+ *       carves every element, string and array out of a caller-owned arena.
+ *       The tree is read-only and is released all at once with the arena.
+ */
+
+/*                                          *
+ * Contains:                                *
+ *                                          *
+ * int MXMLPullInit(P,Buf,BufSize)          *
+ * int MXMLPullNext(P,EventP)               *
+ * int MXMLPullNextAttr(P,AName,AVal)       *
+ * int MXMLPullGetAttr(P,AName,AVal)        *
+ * int MXMLPullSkip(P)                      *
+ * mbool_t MXMLViewIs(V,String)             *
+ * int MXMLViewDecode(V,Buf,BufSize)        *
+ * int MXMLViewToMString(V,String)          *
+ * int MXMLFromStringArena(EP,XMLString,A,Tail,EMsg) *
+ *                                          */
+
+
+#include "moab.h"
+#include "moab-const.h"
+#include "moab-proto.h"
+#include "moab-global.h"
+
+/* from MXML.c */
+
+int __MXMLStringConvertFromAmp(char *);
+
+
+
+/**
+ * Record a parse error at the current position.  The parser fails every
+ * later call.
+ *
+ * @param P   (I/O)
+ * @param Msg (I)
+ */
+
+int __MXMLPullError(
+
+  mxmlpull_t *P,   /* I/O */
+  const char *Msg) /* I */
+
+  {
+  snprintf(P->EMsg,sizeof(P->EMsg),"%s at offset %ld",
+    Msg,
+    (long)(P->Ptr - P->Buf));
+
+  P->IsFailed = TRUE;
+  P->Event    = mxpeNONE;
+
+  return(FAILURE);
+  }  /* END __MXMLPullError() */
+
+
+
+
+/**
+ * Locate String (of length Len) within [Ptr,End).
+ *
+ * @param Ptr    (I)
+ * @param End    (I)
+ * @param String (I)
+ * @param Len    (I)
+ */
+
+const char *__MXMLPullFind(
+
+  const char *Ptr,    /* I */
+  const char *End,    /* I */
+  const char *String, /* I */
+  int         Len)    /* I */
+
+  {
+  while (End - Ptr >= Len)
+    {
+    if ((Ptr = (const char *)memchr(Ptr,String[0],End - Ptr - Len + 1)) == NULL)
+      break;
+
+    if (!memcmp(Ptr,String,Len))
+      return(Ptr);
+
+    Ptr++;
+    }
+
+  return(NULL);
+  }  /* END __MXMLPullFind() */
+
+
+
+
+/**
+ * Skip the '<?...?>', '<!--...-->' or '<!...>' (w/optional '[...]' subset)
+ * element at P->Ptr.
+ *
+ * @param P (I/O)
+ */
+
+int __MXMLPullSkipMeta(
+
+  mxmlpull_t *P) /* I/O */
+
+  {
+  const char *ptr = P->Ptr;
+  const char *End = P->End;
+
+  if (ptr[1] == '?')
+    {
+    if ((ptr = __MXMLPullFind(ptr + 2,End,"?>",2)) == NULL)
+      return(__MXMLPullError(P,"cannot locate end of meta element"));
+
+    P->Ptr = ptr + 2;
+
+    return(SUCCESS);
+    }
+
+  if ((End - ptr >= 4) && !strncmp(ptr,"<!--",4))
+    {
+    if ((ptr = __MXMLPullFind(ptr + 4,End,"-->",3)) == NULL)
+      return(__MXMLPullError(P,"cannot locate comment termination marker"));
+
+    P->Ptr = ptr + 3;
+
+    return(SUCCESS);
+    }
+
+  /* '<!DOCTYPE ...>' or '<!DOCTYPE ... [...]>' */
+
+  for (ptr += 2;ptr < End;ptr++)
+    {
+    if (*ptr == '>')
+      break;
+
+    if (*ptr == '[')
+      {
+      if ((ptr = __MXMLPullFind(ptr,End,"]>",2)) == NULL)
+        break;
+
+      ptr++;
+
+      break;
+      }
+    }
+
+  if ((ptr == NULL) || (ptr >= End))
+    return(__MXMLPullError(P,"cannot locate end of declaration"));
+
+  P->Ptr = ptr + 1;
+
+  return(SUCCESS);
+  }  /* END __MXMLPullSkipMeta() */
+
+
+
+
+/**
+ * Prepare to pull events from Buf.
+ *
+ * NOTE: Buf is not copied, it must not change while P (or any view taken
+ *       from P) is in use.
+ *
+ * @param P       (O)
+ * @param Buf     (I)
+ * @param BufSize (I) [-1 = Buf is terminated]
+ */
+
+int MXMLPullInit(
+
+  mxmlpull_t *P,       /* O */
+  const char *Buf,     /* I */
+  int         BufSize) /* I */
+
+  {
+  if ((P == NULL) || (Buf == NULL))
+    {
+    return(FAILURE);
+    }
+
+  P->Buf = Buf;
+  P->Ptr = Buf;
+  P->End = Buf + ((BufSize >= 0) ? BufSize : (int)strlen(Buf));
+
+  P->Event      = mxpeNONE;
+  P->Depth      = 0;
+  P->IsEmptyTag = FALSE;
+  P->IsFailed   = FALSE;
+
+  P->AttrStart = NULL;
+  P->AttrPtr   = NULL;
+  P->AttrEnd   = NULL;
+
+  P->Name.Ptr = NULL;
+  P->Name.Len = 0;
+  P->Text.Ptr = NULL;
+  P->Text.Len = 0;
+
+  P->EMsg[0] = '\0';
+
+  return(SUCCESS);
+  }  /* END MXMLPullInit() */
+
+
+
+
+/**
+ * Advance to the next event.
+ *
+ * mxpeStart  P->Name is the element name, attributes are available through
+ *            MXMLPullNextAttr()/MXMLPullGetAttr() until the next call
+ * mxpeText   P->Text is the element value (leading whitespace removed,
+ *            entities still encoded).  Whitespace-only values are skipped.
+ * mxpeEnd    P->Name is the element name, '<Name/>' reports mxpeStart then
+ *            mxpeEnd
+ * mxpeEOF    no elements remain (P->Ptr is just past the last one)
+ *
+ * Meta elements, comments and declarations are skipped, as is anything
+ * outside of an element.  Returns FAILURE (w/P->EMsg) on malformed input,
+ * including an end tag which does not match its start tag.
+ *
+ * @param P      (I/O)
+ * @param EventP (O) [optional]
+ */
+
+int MXMLPullNext(
+
+  mxmlpull_t             *P,      /* I/O */
+  enum MXMLPullEventEnum *EventP) /* O (optional) */
+
+  {
+  const char *ptr;
+  const char *tag;
+  const char *End;
+
+  char        Quote;
+
+  if (EventP != NULL)
+    *EventP = mxpeNONE;
+
+  if ((P == NULL) || (P->IsFailed == TRUE))
+    {
+    return(FAILURE);
+    }
+
+  P->AttrStart = NULL;
+  P->AttrPtr   = NULL;
+  P->AttrEnd   = NULL;
+
+  if (P->IsEmptyTag == TRUE)
+    {
+    /* close '<Name/>' */
+
+    P->IsEmptyTag = FALSE;
+
+    P->Depth--;
+
+    P->Event = mxpeEnd;
+
+    if (EventP != NULL)
+      *EventP = mxpeEnd;
+
+    return(SUCCESS);
+    }
+
+  End = P->End;
+
+  for (;;)
+    {
+    ptr = P->Ptr;
+
+    if ((tag = (const char *)memchr(ptr,'<',End - ptr)) == NULL)
+      tag = End;
+
+    if (P->Depth > 0)
+      {
+      /* element value runs up to the next tag */
+
+      while ((ptr < tag) && isspace(*ptr))
+        ptr++;
+
+      if ((ptr < tag) && (tag < End))
+        {
+        P->Text.Ptr = ptr;
+        P->Text.Len = tag - ptr;
+
+        P->Ptr = tag;
+
+        P->Event = mxpeText;
+
+        if (EventP != NULL)
+          *EventP = mxpeText;
+
+        return(SUCCESS);
+        }
+      }
+
+    P->Ptr = tag;
+
+    if (tag >= End)
+      {
+      if (P->Depth > 0)
+        return(__MXMLPullError(P,"element is not terminated"));
+
+      P->Event = mxpeEOF;
+
+      if (EventP != NULL)
+        *EventP = mxpeEOF;
+
+      return(SUCCESS);
+      }
+
+    if (tag + 1 >= End)
+      return(__MXMLPullError(P,"tag is not terminated"));
+
+    if ((tag[1] == '?') || (tag[1] == '!'))
+      {
+      if (__MXMLPullSkipMeta(P) == FAILURE)
+        return(FAILURE);
+
+      continue;
+      }
+
+    break;
+    }  /* END for (;;) */
+
+  if (tag[1] == '/')
+    {
+    /* FORMAT:  '</Name>' */
+
+    if (P->Depth <= 0)
+      return(__MXMLPullError(P,"unexpected end tag"));
+
+    ptr = tag + 2;
+
+    P->Name.Ptr = ptr;
+
+    while ((ptr < End) && (*ptr != '>') && !isspace(*ptr))
+      ptr++;
+
+    P->Name.Len = ptr - P->Name.Ptr;
+
+    while ((ptr < End) && isspace(*ptr))
+      ptr++;
+
+    if ((ptr >= End) || (*ptr != '>'))
+      return(__MXMLPullError(P,"end tag is not terminated"));
+
+    if ((P->Name.Len != P->Open[P->Depth - 1].Len) ||
+        memcmp(P->Name.Ptr,P->Open[P->Depth - 1].Ptr,P->Name.Len))
+      return(__MXMLPullError(P,"end tag does not match start tag"));
+
+    P->Depth--;
+
+    P->Ptr = ptr + 1;
+
+    P->Event = mxpeEnd;
+
+    if (EventP != NULL)
+      *EventP = mxpeEnd;
+
+    return(SUCCESS);
+    }  /* END if (tag[1] == '/') */
+
+  /* FORMAT:  '<Name[ <ATTR>="<VAL>"]...[/]>' */
+
+  ptr = tag + 1;
+
+  P->Name.Ptr = ptr;
+
+  while ((ptr < End) && (*ptr != '>') && (*ptr != '/') && !isspace(*ptr))
+    ptr++;
+
+  P->Name.Len = ptr - P->Name.Ptr;
+
+  if (P->Name.Len == 0)
+    return(__MXMLPullError(P,"element name is empty"));
+
+  if (P->Depth >= MMAX_XMLDEPTH)
+    return(__MXMLPullError(P,"elements are nested too deeply"));
+
+  P->AttrStart = ptr;
+
+  /* locate the end of the tag, stepping over quoted attribute values
+     (a quote preceded by '\' does not end a value, as in MXMLFromString()) */
+
+  Quote = '\0';
+
+  for (;ptr < End;ptr++)
+    {
+    if (Quote != '\0')
+      {
+      if ((*ptr == Quote) && (ptr[-1] != '\\'))
+        Quote = '\0';
+      }
+    else if ((*ptr == '"') || (*ptr == '\''))
+      {
+      Quote = *ptr;
+      }
+    else if (*ptr == '>')
+      {
+      break;
+      }
+    }
+
+  if (ptr >= End)
+    return(__MXMLPullError(P,"start tag is not terminated"));
+
+  P->AttrEnd = ptr;
+
+  if ((ptr > P->AttrStart) && (ptr[-1] == '/'))
+    {
+    P->AttrEnd--;
+
+    P->IsEmptyTag = TRUE;
+    }
+
+  P->AttrPtr = P->AttrStart;
+
+  P->Open[P->Depth++] = P->Name;
+
+  P->Ptr = ptr + 1;
+
+  P->Event = mxpeStart;
+
+  if (EventP != NULL)
+    *EventP = mxpeStart;
+
+  return(SUCCESS);
+  }  /* END MXMLPullNext() */
+
+
+
+
+/**
+ * Return the next attribute of the current start tag.
+ *
+ * Returns FAILURE once no attributes remain (P->EMsg is also set, and P
+ * fails from then on, if the tag is malformed).
+ *
+ * @param P     (I/O)
+ * @param AName (O) [optional]
+ * @param AVal  (O) [optional, still encoded]
+ */
+
+int MXMLPullNextAttr(
+
+  mxmlpull_t *P,     /* I/O */
+  mxmlview_t *AName, /* O (optional) */
+  mxmlview_t *AVal)  /* O (optional) */
+
+  {
+  const char *ptr;
+  const char *End;
+  const char *NStart;
+  const char *NEnd;
+  const char *VStart;
+
+  char        Quote;
+
+  if ((P == NULL) || (P->AttrPtr == NULL))
+    {
+    return(FAILURE);
+    }
+
+  ptr = P->AttrPtr;
+  End = P->AttrEnd;
+
+  /* FORMAT:  <ATTR>="<VAL>" */
+
+  while ((ptr < End) && isspace(*ptr))
+    ptr++;
+
+  if (ptr >= End)
+    {
+    P->AttrPtr = End;
+
+    return(FAILURE);
+    }
+
+  NStart = ptr;
+
+  while ((ptr < End) && (*ptr != '=') && !isspace(*ptr))
+    ptr++;
+
+  NEnd = ptr;
+
+  while ((ptr < End) && isspace(*ptr))
+    ptr++;
+
+  if ((NEnd == NStart) || (ptr >= End) || (*ptr != '='))
+    {
+    P->AttrPtr = NULL;
+
+    P->Ptr = NStart;
+
+    return(__MXMLPullError(P,"attribute is malformed"));
+    }
+
+  ptr++;  /* skip '=' */
+
+  while ((ptr < End) && isspace(*ptr))
+    ptr++;
+
+  if ((ptr >= End) || ((*ptr != '"') && (*ptr != '\'')))
+    {
+    P->AttrPtr = NULL;
+
+    P->Ptr = NStart;
+
+    return(__MXMLPullError(P,"attribute value is not quoted"));
+    }
+
+  Quote = *(ptr++);
+
+  VStart = ptr;
+
+  while ((ptr < End) && ((*ptr != Quote) || (ptr[-1] == '\\')))
+    ptr++;
+
+  if (ptr >= End)
+    {
+    P->AttrPtr = NULL;
+
+    P->Ptr = NStart;
+
+    return(__MXMLPullError(P,"attribute value is not terminated"));
+    }
+
+  if (AName != NULL)
+    {
+    AName->Ptr = NStart;
+    AName->Len = NEnd - NStart;
+    }
+
+  if (AVal != NULL)
+    {
+    AVal->Ptr = VStart;
+    AVal->Len = ptr - VStart;
+    }
+
+  P->AttrPtr = ptr + 1;
+
+  return(SUCCESS);
+  }  /* END MXMLPullNextAttr() */
+
+
+
+
+/**
+ * Locate attribute AName (case sensitive) of the current start tag.
+ *
+ * NOTE: does not disturb MXMLPullNextAttr()
+ *
+ * @param P     (I/O)
+ * @param AName (I)
+ * @param AVal  (O) [optional, still encoded]
+ */
+
+int MXMLPullGetAttr(
+
+  mxmlpull_t *P,     /* I/O */
+  const char *AName, /* I */
+  mxmlview_t *AVal)  /* O (optional) */
+
+  {
+  const char *Saved;
+
+  mxmlview_t  tmpName;
+  mxmlview_t  tmpVal;
+
+  int         rc = FAILURE;
+
+  if ((P == NULL) || (AName == NULL) || (P->AttrStart == NULL))
+    {
+    return(FAILURE);
+    }
+
+  Saved = P->AttrPtr;
+
+  P->AttrPtr = P->AttrStart;
+
+  while (MXMLPullNextAttr(P,&tmpName,&tmpVal) == SUCCESS)
+    {
+    if (MXMLViewIs(&tmpName,AName) == TRUE)
+      {
+      if (AVal != NULL)
+        *AVal = tmpVal;
+
+      rc = SUCCESS;
+
+      break;
+      }
+    }
+
+  if (P->IsFailed == FALSE)
+    P->AttrPtr = Saved;
+
+  return(rc);
+  }  /* END MXMLPullGetAttr() */
+
+
+
+
+/**
+ * Skip the rest of the element whose mxpeStart was just returned,
+ * including all of its children, through its mxpeEnd.
+ *
+ * @param P (I/O)
+ */
+
+int MXMLPullSkip(
+
+  mxmlpull_t *P) /* I/O */
+
+  {
+  enum MXMLPullEventEnum Event;
+
+  int Depth;
+
+  if ((P == NULL) || (P->Event != mxpeStart))
+    {
+    return(FAILURE);
+    }
+
+  Depth = P->Depth - 1;
+
+  do
+    {
+    if (MXMLPullNext(P,&Event) == FAILURE)
+      return(FAILURE);
+    } while ((Event != mxpeEnd) || (P->Depth != Depth));
+
+  return(SUCCESS);
+  }  /* END MXMLPullSkip() */
+
+
+
+
+/**
+ * Returns TRUE if V is exactly String.
+ *
+ * @param V      (I)
+ * @param String (I)
+ */
+
+mbool_t MXMLViewIs(
+
+  const mxmlview_t *V,      /* I */
+  const char       *String) /* I */
+
+  {
+  if ((V == NULL) || (V->Ptr == NULL) || (String == NULL))
+    {
+    return(FALSE);
+    }
+
+  if (strncmp(V->Ptr,String,V->Len) || (String[V->Len] != '\0'))
+    {
+    return(FALSE);
+    }
+
+  return(TRUE);
+  }  /* END MXMLViewIs() */
+
+
+
+
+/**
+ * Decode [Ptr,End) into Buf, mapping the XML entities and '~rs;' the way
+ * MXMLFromString() does.  Returns the decoded length, or -1 if Buf is too
+ * small (Buf then holds as much as fit).
+ *
+ * NOTE: output is never longer than input, End - Ptr + 1 bytes always fit
+ *
+ * @param Ptr     (I)
+ * @param End     (I)
+ * @param DoQuote (I) map '&quot;' (attribute values do, element values don't)
+ * @param Buf     (O) [terminated]
+ * @param BufSize (I)
+ */
+
+int __MXMLViewDecode(
+
+  const char *Ptr,     /* I */
+  const char *End,     /* I */
+  mbool_t     DoQuote, /* I */
+  char       *Buf,     /* O */
+  int         BufSize) /* I */
+
+  {
+  int index = 0;
+
+  while (Ptr < End)
+    {
+    if (index >= BufSize - 1)
+      {
+      Buf[index] = '\0';
+
+      return(-1);
+      }
+
+    if (*Ptr == '&')
+      {
+      if ((End - Ptr >= 4) && !memcmp(Ptr,"&lt;",4))
+        {
+        Buf[index++] = '<';
+        Ptr += 4;
+
+        continue;
+        }
+
+      if ((End - Ptr >= 4) && !memcmp(Ptr,"&gt;",4))
+        {
+        Buf[index++] = '>';
+        Ptr += 4;
+
+        continue;
+        }
+
+      if ((End - Ptr >= 5) && !memcmp(Ptr,"&amp;",5))
+        {
+        Buf[index++] = '&';
+        Ptr += 5;
+
+        continue;
+        }
+
+      if ((End - Ptr >= 6) && !memcmp(Ptr,"&apos;",6))
+        {
+        Buf[index++] = '\'';
+        Ptr += 6;
+
+        continue;
+        }
+
+      if ((DoQuote == TRUE) && (End - Ptr >= 6) && !memcmp(Ptr,"&quot;",6))
+        {
+        Buf[index++] = '"';
+        Ptr += 6;
+
+        continue;
+        }
+      }
+    else if ((*Ptr == '~') && (End - Ptr >= 4) && !memcmp(Ptr,"~rs;",4))
+      {
+      Buf[index++] = ENVRS_ENCODED_CHAR;
+      Ptr += 4;
+
+      continue;
+      }
+
+    Buf[index++] = *(Ptr++);
+    }  /* END while (Ptr < End) */
+
+  Buf[index] = '\0';
+
+  return(index);
+  }  /* END __MXMLViewDecode() */
+
+
+
+
+/**
+ * Decode an attribute or element value into Buf.
+ *
+ * Maps '&lt;', '&gt;', '&amp;', '&apos;', '&quot;' and '~rs;'.  Returns
+ * FAILURE if Buf is too small (Buf then holds a truncated value).
+ *
+ * @param V       (I)
+ * @param Buf     (O) [terminated]
+ * @param BufSize (I)
+ */
+
+int MXMLViewDecode(
+
+  const mxmlview_t *V,       /* I */
+  char             *Buf,     /* O */
+  int               BufSize) /* I */
+
+  {
+  if ((V == NULL) || (Buf == NULL) || (BufSize <= 0))
+    {
+    return(FAILURE);
+    }
+
+  if (V->Ptr == NULL)
+    {
+    Buf[0] = '\0';
+
+    return(SUCCESS);
+    }
+
+  if (__MXMLViewDecode(V->Ptr,V->Ptr + V->Len,TRUE,Buf,BufSize) < 0)
+    {
+    return(FAILURE);
+    }
+
+  return(SUCCESS);
+  }  /* END MXMLViewDecode() */
+
+
+
+
+/**
+ * Decode an attribute or element value into String (see MXMLViewDecode()).
+ *
+ * @param V      (I)
+ * @param String (O) [replaced]
+ */
+
+int MXMLViewToMString(
+
+  const mxmlview_t *V,      /* I */
+  mstring_t        *String) /* O (replaced) */
+
+  {
+  char        tmpBuf[MMAX_LINE];
+
+  const char *ptr;
+  const char *End;
+  const char *ChunkEnd;
+
+  if ((V == NULL) || (String == NULL))
+    {
+    return(FAILURE);
+    }
+
+  MStringSet(String,"");
+
+  if (V->Ptr == NULL)
+    {
+    return(SUCCESS);
+    }
+
+  End = V->Ptr + V->Len;
+
+  /* decode in chunks, never splitting an entity across chunks */
+
+  for (ptr = V->Ptr;ptr < End;ptr = ChunkEnd)
+    {
+    ChunkEnd = ptr + MIN(End - ptr,(long)sizeof(tmpBuf) - 1);
+
+    if (ChunkEnd < End)
+      {
+      const char *Amp;
+
+      for (Amp = ChunkEnd - 1;(Amp > ptr) && (Amp > ChunkEnd - 6);Amp--)
+        {
+        if ((*Amp == '&') || (*Amp == '~'))
+          {
+          ChunkEnd = Amp;
+
+          break;
+          }
+        }
+      }
+
+    __MXMLViewDecode(ptr,ChunkEnd,TRUE,tmpBuf,sizeof(tmpBuf));
+
+    MStringAppend(String,tmpBuf);
+    }
+
+  return(SUCCESS);
+  }  /* END MXMLViewToMString() */
+
+
+
+
+/**
+ * Allocate Size bytes from A for an arena tree.
+ *
+ * NOTE: fails rather than fall back to the heap, anything which did not come
+ *       from the arena would leak when the arena is released.
+ *
+ * @param A      (I/O)
+ * @param Size   (I)
+ * @param DoZero (I)
+ */
+
+void *__MXMLArenaAlloc(
+
+  marena_t *A,      /* I/O */
+  int       Size,   /* I */
+  mbool_t   DoZero) /* I */
+
+  {
+  mulong Fallbacks = A->NumFallbacks;
+
+  char  *Ptr;
+
+  Ptr = (DoZero == TRUE) ? (char *)MUArenaCalloc(A,1,Size) : (char *)MUArenaMalloc(A,Size);
+
+  if (A->NumFallbacks != Fallbacks)
+    {
+    MUArenaFree(A,&Ptr);
+
+    return(NULL);
+    }
+
+  return((void *)Ptr);
+  }  /* END __MXMLArenaAlloc() */
+
+
+
+
+/**
+ * Copy V into A as a terminated string.
+ *
+ * @param A (I/O)
+ * @param V (I)
+ */
+
+char *__MXMLArenaStrDup(
+
+  marena_t         *A, /* I/O */
+  const mxmlview_t *V) /* I */
+
+  {
+  char *Ptr;
+
+  if ((Ptr = (char *)__MXMLArenaAlloc(A,V->Len + 1,FALSE)) == NULL)
+    return(NULL);
+
+  memcpy(Ptr,V->Ptr,V->Len);
+
+  Ptr[V->Len] = '\0';
+
+  return(Ptr);
+  }  /* END __MXMLArenaStrDup() */
+
+
+
+
+/**
+ * Create the element for the start tag P has just returned, with all of its
+ * attributes, in A.
+ *
+ * NOTE: attributes are ordered, replaced and dropped exactly as
+ *       MXMLSetAttr() does when MXMLFromString() adds them
+ *
+ * @param P  (I/O)
+ * @param A  (I/O)
+ * @param EP (O)
+ */
+
+int __MXMLArenaCreateE(
+
+  mxmlpull_t  *P,  /* I/O */
+  marena_t    *A,  /* I/O */
+  mxml_t     **EP) /* O */
+
+  {
+  mxml_t     *E;
+
+  mxmlview_t  AName;
+  mxmlview_t  AVal;
+
+  char       *Name;
+  char       *Val;
+
+  int         ACount;
+  int         aindex;
+  int         iindex;
+  int         rc;
+
+  if ((E = (mxml_t *)__MXMLArenaAlloc(A,sizeof(mxml_t),TRUE)) == NULL)
+    return(FAILURE);
+
+  E->Arena = A;
+
+  if ((E->Name = __MXMLArenaStrDup(A,&P->Name)) == NULL)
+    return(FAILURE);
+
+  for (ACount = 0;MXMLPullNextAttr(P,NULL,NULL) == SUCCESS;ACount++);
+
+  if (P->IsFailed == TRUE)
+    return(FAILURE);
+
+  *EP = E;
+
+  if (ACount == 0)
+    return(SUCCESS);
+
+  /* one extra slot for the terminator */
+
+  E->AName = (char **)__MXMLArenaAlloc(A,sizeof(char *) * (ACount + 1),TRUE);
+  E->AVal  = (char **)__MXMLArenaAlloc(A,sizeof(char *) * (ACount + 1),TRUE);
+
+  if ((E->AName == NULL) || (E->AVal == NULL))
+    return(FAILURE);
+
+  E->ASize = ACount + 1;
+
+  P->AttrPtr = P->AttrStart;
+
+  while (MXMLPullNextAttr(P,&AName,&AVal) == SUCCESS)
+    {
+    if (((Name = __MXMLArenaStrDup(A,&AName)) == NULL) ||
+        ((Val = (char *)__MXMLArenaAlloc(A,AVal.Len + 1,FALSE)) == NULL))
+      return(FAILURE);
+
+    __MXMLViewDecode(AVal.Ptr,AVal.Ptr + AVal.Len,TRUE,Val,AVal.Len + 1);
+
+    rc = 1;
+
+    for (aindex = 0;aindex < E->ACount;aindex++)
+      {
+      if ((rc = strcmp(E->AName[aindex],Name)) >= 0)
+        break;
+      }
+
+    if (rc == 0)
+      {
+      E->AVal[aindex] = Val;
+
+      continue;
+      }
+
+    if ((Val[0] == '\0') && (aindex >= E->ACount))
+      {
+      /* no action required for empty attribute */
+
+      continue;
+      }
+
+    for (iindex = E->ACount;iindex > aindex;iindex--)
+      {
+      E->AName[iindex] = E->AName[iindex - 1];
+      E->AVal[iindex]  = E->AVal[iindex - 1];
+      }
+
+    E->AName[aindex] = Name;
+    E->AVal[aindex]  = Val;
+
+    E->ACount++;
+    }  /* END while (MXMLPullNextAttr() == SUCCESS) */
+
+  return(SUCCESS);
+  }  /* END __MXMLArenaCreateE() */
+
+
+
+
+/**
+ * Add child C to arena element E.
+ *
+ * @param A (I/O)
+ * @param E (I/O)
+ * @param C (I)
+ */
+
+int __MXMLArenaAddE(
+
+  marena_t *A, /* I/O */
+  mxml_t   *E, /* I/O */
+  mxml_t   *C) /* I */
+
+  {
+  mxml_t **NewC;
+
+  int      NewSize;
+
+  if (E->CCount >= E->CSize)
+    {
+    /* arena memory cannot be realloc'd - copy into a larger array */
+
+    NewSize = (E->CSize > 0) ? E->CSize << 1 : 4;
+
+    if ((NewC = (mxml_t **)__MXMLArenaAlloc(A,sizeof(mxml_t *) * NewSize,FALSE)) == NULL)
+      return(FAILURE);
+
+    if (E->CCount > 0)
+      memcpy(NewC,E->C,sizeof(mxml_t *) * E->CCount);
+
+    E->C     = NewC;
+    E->CSize = NewSize;
+    }
+
+  E->C[E->CCount++] = C;
+
+  return(SUCCESS);
+  }  /* END __MXMLArenaAddE() */
+
+
+
+
+/**
+ * Set the value of arena element E from Text.
+ *
+ * NOTE: a value found before any children is decoded (and '\016' mapped
+ *       back to '<') while a value found after the last child is copied
+ *       as is, matching MXMLFromString().  Compressed values are rejected.
+ *
+ * @param A        (I/O)
+ * @param E        (I/O)
+ * @param Text     (I)
+ * @param DoDecode (I)
+ */
+
+int __MXMLArenaSetVal(
+
+  marena_t         *A,        /* I/O */
+  mxml_t           *E,        /* I/O */
+  const mxmlview_t *Text,     /* I */
+  mbool_t           DoDecode) /* I */
+
+  {
+  char *ptr;
+
+  /* NOTE:  CRYPTHEAD header indicates encryption/compression */
+
+  if ((MSysUICompressionIsDisabled() != TRUE) &&
+      (Text->Len >= (int)strlen(CRYPTHEAD)) &&
+      !strncmp(Text->Ptr,CRYPTHEAD,strlen(CRYPTHEAD)))
+    {
+    return(FAILURE);
+    }
+
+  if (DoDecode == FALSE)
+    {
+    if ((E->Val = __MXMLArenaStrDup(A,Text)) == NULL)
+      return(FAILURE);
+
+    return(SUCCESS);
+    }
+
+  if ((E->Val = (char *)__MXMLArenaAlloc(A,Text->Len + 1,FALSE)) == NULL)
+    return(FAILURE);
+
+  __MXMLViewDecode(Text->Ptr,Text->Ptr + Text->Len,FALSE,E->Val,Text->Len + 1);
+
+  if (strchr(E->Val,'&'))
+    {
+    /* convert value to only contain XML-friendly characters */
+
+    __MXMLStringConvertFromAmp(E->Val);
+    }
+
+  /* map any 'shift out' characters back to a '<' symbol */
+
+  for (ptr = strchr(E->Val,(char)XML_VALUE_ANGLE_BRACKET_INT);
+       ptr != NULL;
+       ptr = strchr(ptr,(char)XML_VALUE_ANGLE_BRACKET_INT))
+    *ptr = '<';
+
+  return(SUCCESS);
+  }  /* END __MXMLArenaSetVal() */
+
+
+
+
+/**
+ * Parse XML input into an mxml_t tree carved out of arena A.
+ *
+ * The tree matches the one MXMLFromString() builds for the same input, but
+ * every element, string and array comes from A, so building it costs a
+ * handful of pointer bumps instead of several mallocs per element.  The tree
+ * is read-only (MXMLSetAttr(), MXMLAddE(), etc. fail on it) and is released
+ * all at once by MUArenaRelease()/MUArenaReset() - MXMLDestroyE() only
+ * clears the caller's pointer.  Use MXMLDupE() to get a modifiable copy.
+ *
+ * NOTE: the calling thread must own A (see MUArenaReset()).  Nothing is left
+ *       allocated in A on failure.
+ *
+ * NOTE: compressed (CRYPTHEAD) values are not supported - returns FAILURE,
+ *       the caller may retry with MXMLFromString()
+ *
+ * @param EP        (O)
+ * @param XMLString (I)
+ * @param A         (I/O)
+ * @param Tail      (O) [optional] returned pointer to rest of input stream
+ * @param EMsg      (O) [optional,minsize=MMAX_LINE]
+ */
+
+int MXMLFromStringArena(
+
+  mxml_t     **EP,        /* O */
+  const char  *XMLString, /* I */
+  marena_t    *A,         /* I/O */
+  char       **Tail,      /* O (optional) */
+  char        *EMsg)      /* O (optional,minsize=MMAX_LINE) */
+
+  {
+  mxmlpull_t   P;
+  marenamark_t Mark;
+
+  mxml_t      *Stack[MMAX_XMLDEPTH];
+  mxmlview_t   Trailing[MMAX_XMLDEPTH];  /* value after the last child so far */
+
+  mxml_t      *E;
+  mxml_t      *Root = NULL;
+
+  enum MXMLPullEventEnum Event;
+
+  const char  *Msg = NULL;
+
+  if (EMsg != NULL)
+    EMsg[0] = '\0';
+
+  if (EP != NULL)
+    *EP = NULL;
+
+  if ((EP == NULL) || (XMLString == NULL) || (A == NULL))
+    {
+    if (EMsg != NULL)
+      strcpy(EMsg,"invalid arguments");
+
+    return(FAILURE);
+    }
+
+  if (MUArenaMark(A,&Mark) == FAILURE)
+    {
+    if (EMsg != NULL)
+      strcpy(EMsg,"arena is not owned by this thread");
+
+    return(FAILURE);
+    }
+
+  MXMLPullInit(&P,XMLString,-1);
+
+  while (Msg == NULL)
+    {
+    if (MXMLPullNext(&P,&Event) == FAILURE)
+      {
+      Msg = P.EMsg;
+
+      break;
+      }
+
+    if (Event == mxpeEOF)
+      break;
+
+    switch (Event)
+      {
+      case mxpeStart:
+
+        if (__MXMLArenaCreateE(&P,A,&E) == FAILURE)
+          {
+          Msg = (P.IsFailed == TRUE) ? P.EMsg : "cannot create XML element";
+
+          break;
+          }
+
+        if (P.Depth == 1)
+          {
+          Root = E;
+          }
+        else
+          {
+          /* a value seen before this child is not the trailing value */
+
+          Trailing[P.Depth - 2].Ptr = NULL;
+
+          if (__MXMLArenaAddE(A,Stack[P.Depth - 2],E) == FAILURE)
+            Msg = "cannot add child element";
+          }
+
+        Stack[P.Depth - 1] = E;
+
+        Trailing[P.Depth - 1].Ptr = NULL;
+
+        break;
+
+      case mxpeText:
+
+        E = Stack[P.Depth - 1];
+
+        if (E->Val != NULL)
+          break;
+
+        if (E->CCount > 0)
+          Trailing[P.Depth - 1] = P.Text;
+        else if (__MXMLArenaSetVal(A,E,&P.Text,TRUE) == FAILURE)
+          Msg = "cannot set value";
+
+        break;
+
+      case mxpeEnd:
+
+        E = Stack[P.Depth];
+
+        if ((Trailing[P.Depth].Ptr != NULL) &&
+            (__MXMLArenaSetVal(A,E,&Trailing[P.Depth],FALSE) == FAILURE))
+          Msg = "cannot set value";
+
+        break;
+
+      default:
+
+        /* NOTREACHED */
+
+        break;
+      }  /* END switch (Event) */
+
+    if ((Event == mxpeEnd) && (P.Depth == 0))
+      {
+      /* root element is complete */
+
+      break;
+      }
+    }    /* END while (Msg == NULL) */
+
+  if ((Msg == NULL) && (Root == NULL))
+    Msg = "no XML in string";
+
+  if (Msg != NULL)
+    {
+    if (EMsg != NULL)
+      MUStrCpy(EMsg,Msg,MMAX_LINE);
+
+    MUArenaRelease(A,&Mark);
+
+    return(FAILURE);
+    }
+
+  MUArenaCommit(A,&Mark);
+
+  *EP = Root;
+
+  if (Tail != NULL)
+    *Tail = (char *)P.Ptr;
+
+  return(SUCCESS);
+  }  /* END MXMLFromStringArena() */
+
+/* END MXMLPull.c */
@@ -0,0 +1,58 @@
+import os
+import shutil
+import tempfile
+import time
+import unittest
+
+import paths
+import codebase
+import symindex
+
+def write(path, txt, age=0):
+    f = open(path, 'w')
+    f.write(txt)
+    f.close()
+    when = time.time() - age
+    os.utime(path, (when, when))
+
+class SymbolIndexTest(unittest.TestCase):
+
+    def setUp(self):
+        # A minimal tree that codebase.find_root() accepts.
+        self.root = tempfile.mkdtemp()
+        os.mkdir(os.path.join(self.root, 'include'))
+        os.mkdir(os.path.join(self.root, '.git'))
+        write(os.path.join(self.root, 'Makefile'), '')
+        self.header = os.path.join(self.root, 'include', 'a.h')
+        write(self.header, 'int MFoo(int x);\ntypedef struct mbar_t {\n  int y;\n  } mbar_t;\n', age=100)
+        write(os.path.join(self.root, 'a.c'), '/* foo */\nint MFoo(\n  int x)\n  {\n  return(x);\n  }\n', age=100)
+        self.index = symindex.SymbolIndex(os.path.join(self.root, 'index', 'symbols.db'))
+
+    def tearDown(self):
+        self.index.close()
+        shutil.rmtree(self.root)
+
+    def test_find(self):
+        cb = codebase.Codebase(self.root)
+        self.assertEqual(2, self.index.update(cb))
+        found = [(s['category'], s['path'], s['line'], s['signature']) for s in self.index.find('MFoo')]
+        self.assertEqual([('function', 'a.c', 2, 'int MFoo(int x)'),
+                          ('prototype', 'include/a.h', 1, 'int MFoo(int x)')], found)
+        udt = self.index.find('mbar_t', 'udt')
+        self.assertEqual(1, len(udt))
+        self.assertEqual('struct mbar_t', udt[0]['signature'])
+        self.assertEqual((2, 4), (udt[0]['line'], udt[0]['end_line']))
+
+    def test_incremental(self):
+        cb = codebase.Codebase(self.root)
+        self.index.update(cb)
+        self.assertEqual(0, self.index.update(cb))
+        write(self.header, 'void MFoo2(void);\n')
+        self.assertEqual(1, self.index.update(cb))
+        self.assertEqual(['a.c'], [s['path'] for s in self.index.find('MFoo')])
+        self.assertEqual(1, len(self.index.find('MFoo2', 'prototype')))
+        self.assertEqual(0, len(self.index.find('mbar_t')))
+        os.remove(os.path.join(self.root, 'a.c'))
+        self.assertEqual(0, self.index.update_changed(cb, ['a.c']))
+        self.assertEqual(0, len(self.index.find('MFoo')))
+        self.assertEqual(1, self.index.file_count)